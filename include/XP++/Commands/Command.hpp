@@ -0,0 +1,226 @@
+#pragma once
+
+// STL includes
+#include <memory>
+#include <string>
+#include <vector>
+
+// XP++ includes
+#include "XP++/Diagnostics/TaggedAllocator.hpp"
+
+namespace XP
+{
+	// Pre-declarations
+	class Command;
+
+	/// <summary>
+	/// Phase of a command's execution
+	/// </summary>
+	/// <remarks>
+	/// A command is begun when the user presses a key or button bound
+	/// to it, continued every frame while it's held, then ended when released.
+	/// </remarks>
+	enum class CommandPhase : int
+	{
+		/// <summary>
+		/// The command is being started
+		/// </summary>
+		Begin		= 0,
+		/// <summary>
+		/// The command is continuing to execute
+		/// </summary>
+		Continue	= 1,
+		/// <summary>
+		/// The command has ended
+		/// </summary>
+		End			= 2
+	};
+
+	/// <summary>
+	/// Function called when a command is executed
+	/// </summary>
+	/// <remarks>
+	/// Handlers are plain function pointers paired with a user data pointer,
+	/// rather than <see cref="std::function"/> objects, so registering and
+	/// dispatching to a handler never allocates.
+	/// </remarks>
+	/// <param name="command">Command being executed</param>
+	/// <param name="phase">Phase of the command's execution</param>
+	/// <param name="userData">User data given when registering the handler</param>
+	/// <returns>
+	/// True to let X-Plane (and other handlers) continue to process the command,
+	/// false to consume it
+	/// </returns>
+	typedef bool (*CommandHandler)(Command& command, CommandPhase phase, void* userData);
+
+	/// <summary>
+	/// Identifies a handler registered to a <see cref="Command"/>
+	/// </summary>
+	class CommandHandlerID
+	{
+	public:
+		/// <summary>
+		/// Constructs an ID which doesn't refer to any handler
+		/// </summary>
+		CommandHandlerID() : m_index(-1), m_generation(0) {}
+
+		/// <summary>
+		/// Does this ID refer to a registered handler?
+		/// </summary>
+		/// <returns>True if this ID was returned by a successful registration</returns>
+		inline bool IsValid() const
+		{
+			return m_index >= 0;
+		}
+
+		inline bool operator==(const CommandHandlerID& rhs) const
+		{
+			return m_index == rhs.m_index && m_generation == rhs.m_generation;
+		}
+		inline bool operator!=(const CommandHandlerID& rhs) const
+		{
+			return !((*this) == rhs);
+		}
+
+	private:
+		friend Command;
+
+		CommandHandlerID(int index, unsigned int generation) :
+			m_index(index), m_generation(generation) {}
+
+		// Index of the handler within the handler table
+		int m_index;
+		// Generation of the handler table slot, to detect stale IDs
+		unsigned int m_generation;
+	};
+
+	/// <summary>
+	/// An action which can be bound to keys or joystick buttons by the user,
+	/// executed by X-Plane or other plug-ins
+	/// </summary>
+	/// <remarks>
+	/// <para>
+	/// Every handler registered through XP++ shares a single X-Plane callback.
+	/// The handler is looked up by its refcon within a flat, plug-in wide table,
+	/// so dispatching each phase is an index and an indirect call.
+	/// </para>
+	/// <para>
+	/// Handlers registered through a <see cref="Command"/> object are
+	/// unregistered when that object is destroyed.
+	/// </para>
+	/// </remarks>
+	class Command final : public TaggedObject<MemoryTag::Commands>
+	{
+	public:
+		/// <summary>
+		/// Finds an existing command
+		/// </summary>
+		/// <param name="name">Name of the command to find (E.g. sim/operation/pause_toggle)</param>
+		/// <returns>Found command, or NULL if none exist with the given name</returns>
+		static std::shared_ptr<Command> FindCommand(std::string name);
+		/// <summary>
+		/// Creates a new command
+		/// </summary>
+		/// <remarks>
+		/// If a command with the given name already exists, that command is returned instead.
+		/// </remarks>
+		/// <param name="name">Name of the command to create</param>
+		/// <param name="description">Human readable description of the command</param>
+		/// <returns>Created command</returns>
+		static std::shared_ptr<Command> CreateCommand(std::string name, std::string description);
+
+		/// <summary>
+		/// Starts the execution of this command
+		/// </summary>
+		/// <remarks>
+		/// The command is held down until <see cref="End"/> is called,
+		/// which must be called from the same plug-in.
+		/// </remarks>
+		void Begin();
+		/// <summary>
+		/// Ends the execution of this command, started by <see cref="Begin"/>
+		/// </summary>
+		void End();
+		/// <summary>
+		/// Executes this command for a single frame
+		/// </summary>
+		void Once();
+
+		/// <summary>
+		/// Registers a handler for this command
+		/// </summary>
+		/// <param name="handler">Function to call when the command is executed</param>
+		/// <param name="userData">Pointer passed back to the handler</param>
+		/// <param name="before">
+		/// True to be called before X-Plane handles the command, false for after
+		/// </param>
+		/// <returns>ID of the registered handler</returns>
+		CommandHandlerID RegisterHandler(CommandHandler handler, void* userData, bool before = true);
+		/// <summary>
+		/// Unregisters a handler previously registered to this command
+		/// </summary>
+		/// <param name="handlerID">ID of the handler to unregister</param>
+		void UnregisterHandler(CommandHandlerID handlerID);
+
+		/// <summary>
+		/// Name of this command
+		/// </summary>
+		/// <returns>String representing the name of this command</returns>
+		inline std::string GetName() const
+		{
+			return m_name;
+		}
+
+		/// <summary>
+		/// Internal X-Plane ID of this command
+		/// </summary>
+		/// <returns>X-Plane command reference</returns>
+		inline void* GetID() const
+		{
+			return m_id;
+		}
+
+	private:
+		Command(std::string name, void* id);
+		~Command();
+
+		Command(const Command&)				= delete;
+		Command& operator=(const Command&)	= delete;
+
+		// A registered handler, indexed by the refcon given to X-Plane
+		struct HandlerSlot
+		{
+			// Command the handler is registered to, or NULL if the slot is free
+			Command* command;
+			// Handler function
+			CommandHandler handler;
+			// User data given to the handler
+			void* userData;
+			// Was the handler registered before X-Plane's handling?
+			bool before;
+			// Incremented each time this slot is freed
+			unsigned int generation;
+			// Next free slot, when this slot is free
+			int nextFree;
+		};
+
+		// Name of this command
+		std::string m_name;
+		// Internal X-Plane ID of this command
+		void* m_id;
+		// Handlers registered through this object
+		std::vector<CommandHandlerID> m_handlers;
+
+		// Every handler registered by this plug-in
+		static std::vector<HandlerSlot, TaggedAllocator<HandlerSlot, MemoryTag::Commands>> m_handlerTable;
+		// First free slot within the handler table, or -1
+		static int m_firstFreeSlot;
+
+		// Creates the wrapper object for an X-Plane command
+		static std::shared_ptr<Command> CreateWrapper(std::string name, void* id);
+		// Frees a handler table slot, after unregistering it from X-Plane
+		static void FreeSlot(int index);
+		// X-Plane command callback shared by every handler
+		static int CommandCallback(void* inCommand, int inPhase, void* inRefcon);
+	};
+}
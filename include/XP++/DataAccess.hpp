@@ -1,5 +1,7 @@
 #pragma once
 
+#include "DataAccess/ArrayDataRefView.hpp"
+#include "DataAccess/ComputedDataRef.hpp"
 #include "DataAccess/DataRef.hpp"
 #include "DataAccess/DataRefType.hpp"
 #include "DataAccess/UserDataRef.hpp"
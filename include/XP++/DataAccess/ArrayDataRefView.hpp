@@ -0,0 +1,159 @@
+#pragma once
+
+// STL includes
+#include <memory>
+#include <vector>
+
+// XP++ includes
+#include "XP++/Diagnostics/TaggedAllocator.hpp"
+
+namespace XP
+{
+	// Pre-declarations
+	class DataRef;
+
+	/// <summary>
+	/// Cached slice of an integer or floating point array data ref, written back by difference
+	/// </summary>
+	/// <remarks>
+	/// <para>
+	/// The view covers <see cref="GetCount"/> elements of the data ref, starting at an offset
+	/// and a stride apart. It keeps the values last read from or written to X-Plane as a shadow
+	/// copy. Change the values freely through <see cref="Set"/> or <see cref="GetValues"/>, then
+	/// <see cref="Commit"/> compares them with the shadow copy, writing only the ranges which
+	/// changed, so an array with a few changes each frame costs a few small writes.
+	/// </para>
+	/// <para>
+	/// Views over strided slices write each changed element separately, as the
+	/// elements between them belong to someone else. Only use views from the sim thread.
+	/// </para>
+	/// </remarks>
+	/// <typeparam name="T">Type of the elements, either float or int</typeparam>
+	template<typename T>
+	class ArrayDataRefView final : public TaggedObject<MemoryTag::Caches>
+	{
+	public:
+		/// <summary>
+		/// Creates a view over a slice of an array data ref, reading its current values
+		/// </summary>
+		/// <param name="dataRef">Array data ref to view</param>
+		/// <param name="offset">Index of the first element of the slice within the data ref</param>
+		/// <param name="count">Number of elements within the slice, or -1 for every element after the offset</param>
+		/// <param name="stride">Number of data ref elements between each element of the slice</param>
+		/// <returns>Created view</returns>
+		static std::shared_ptr<ArrayDataRefView<T>> Create(std::shared_ptr<DataRef> dataRef, int offset = 0,
+															int count = -1, int stride = 1);
+
+		/// <summary>
+		/// Gets the number of elements within the view
+		/// </summary>
+		/// <returns>Number of elements</returns>
+		inline int GetCount() const
+		{
+			return static_cast<int>(m_values.size());
+		}
+		/// <summary>
+		/// Gets the value of an element, as last read or set
+		/// </summary>
+		/// <param name="index">Index of the element within the view</param>
+		/// <returns>Value of the element</returns>
+		inline T Get(int index) const
+		{
+			return m_values[index];
+		}
+		/// <summary>
+		/// Sets the value of an element, written by the next <see cref="Commit"/>
+		/// </summary>
+		/// <param name="index">Index of the element within the view</param>
+		/// <param name="value">Value of the element</param>
+		inline void Set(int index, T value)
+		{
+			m_values[index] = value;
+		}
+		/// <summary>
+		/// Gets the values of every element, to read or change in bulk
+		/// </summary>
+		/// <returns>Values of every element, changes being written by the next <see cref="Commit"/></returns>
+		inline T* GetValues()
+		{
+			return m_values.data();
+		}
+
+		/// <summary>
+		/// Reads a range of elements from X-Plane, discarding uncommitted changes within it
+		/// </summary>
+		/// <param name="offset">Index of the first element within the view</param>
+		/// <param name="count">Number of elements to read</param>
+		/// <returns>Values of the elements read, valid until the view is destroyed</returns>
+		const T* Read(int offset, int count);
+		/// <summary>
+		/// Reads every element from X-Plane, discarding uncommitted changes
+		/// </summary>
+		/// <returns>Values of every element</returns>
+		inline const T* Read()
+		{
+			return Read(0, GetCount());
+		}
+
+		/// <summary>
+		/// Writes the elements which changed since they were last read or committed
+		/// </summary>
+		/// <returns>Number of writes made to the data ref</returns>
+		int Commit();
+		/// <summary>
+		/// Sets the most unchanged elements between two changes written as one range
+		/// </summary>
+		/// <remarks>
+		/// <para>
+		/// Rewriting a few unchanged elements is cheaper than an extra call into X-Plane, but
+		/// rewrites them with the values this view last read or committed. If X-Plane or another
+		/// plug-in changed them since, those changes are clobbered. Only allow a gap when nothing
+		/// else writes the viewed elements, or re-read them before changing them each frame.
+		/// </para>
+		/// <para>
+		/// Defaults to 0, so only elements changed through this view are ever written.
+		/// Ignored for strided views.
+		/// </para>
+		/// </remarks>
+		/// <param name="maxGap">Most unchanged elements to rewrite between changes</param>
+		inline void SetMaxGap(int maxGap)
+		{
+			m_maxGap = maxGap < 0 ? 0 : maxGap;
+		}
+
+	private:
+		ArrayDataRefView(std::shared_ptr<DataRef> dataRef, int offset, int count, int stride);
+		~ArrayDataRefView() = default;
+
+		ArrayDataRefView(const ArrayDataRefView&)				= delete;
+		ArrayDataRefView& operator=(const ArrayDataRefView&)	= delete;
+
+		// Viewed data ref
+		std::shared_ptr<DataRef> m_dataRef;
+		// Index of the first element within the data ref
+		int m_offset;
+		// Number of data ref elements between each element of the view
+		int m_stride;
+		// Most unchanged elements between changes written as one range
+		int m_maxGap;
+		// Current values
+		std::vector<T, TaggedAllocator<T, MemoryTag::Caches>> m_values;
+		// Values last read from or written to X-Plane
+		std::vector<T, TaggedAllocator<T, MemoryTag::Caches>> m_shadow;
+		// Data ref elements covered by a strided read
+		std::vector<T, TaggedAllocator<T, MemoryTag::Caches>> m_readBuffer;
+	};
+
+	/// <summary>
+	/// View over a floating point array data ref
+	/// </summary>
+	typedef ArrayDataRefView<float> FloatArrayDataRefView;
+	/// <summary>
+	/// View over an integer array data ref
+	/// </summary>
+	typedef ArrayDataRefView<int> IntArrayDataRefView;
+
+	// Implemented for float and int only
+	extern template class ArrayDataRefView<float>;
+	extern template class ArrayDataRefView<int>;
+}
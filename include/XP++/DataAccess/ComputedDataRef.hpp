@@ -0,0 +1,197 @@
+#pragma once
+
+// STL includes
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+// XP++ includes
+#include "XP++/Diagnostics/TaggedAllocator.hpp"
+
+namespace XP
+{
+	// Pre-declarations
+	class DataRef;
+	class UserDataRef;
+
+	/// <summary>
+	/// A value evaluated at most once per frame, which an <see cref="ComputedDataRef"/> can depend on
+	/// </summary>
+	class ComputedValue : public TaggedObject<MemoryTag::Caches>
+	{
+	public:
+		virtual ~ComputedValue() = default;
+
+		/// <summary>
+		/// Gets the value for a frame, updating it on the first call of the frame
+		/// </summary>
+		/// <param name="cycleNumber">Cycle number of the frame</param>
+		/// <returns>Value for the frame</returns>
+		inline double Evaluate(int cycleNumber)
+		{
+			if (m_cycleNumber != cycleNumber)
+			{
+				Update(cycleNumber);
+				m_cycleNumber = cycleNumber;
+			}
+
+			return m_value;
+		}
+		/// <summary>
+		/// Gets the version of the value, which changes whenever the value changes
+		/// </summary>
+		/// <returns>Version of the value</returns>
+		inline uint64_t GetVersion() const
+		{
+			return m_version;
+		}
+
+	protected:
+		ComputedValue() :
+			m_value(0.0), m_version(0), m_cycleNumber(-1) {}
+
+		ComputedValue(const ComputedValue&)				= delete;
+		ComputedValue& operator=(const ComputedValue&)	= delete;
+
+		// Updates the value for a frame
+		virtual void Update(int cycleNumber) = 0;
+
+		// Sets the value, moving to a new version if it changed
+		inline void SetValue(double value)
+		{
+			// Compared by value, except NaNs which always differ, so they're still propagated
+			if (value != m_value || value != value)
+			{
+				m_value = value;
+				++m_version;
+			}
+		}
+
+	private:
+		// Value for the last frame evaluated
+		double m_value;
+		// Version of the value
+		uint64_t m_version;
+		// Cycle number of the last frame evaluated
+		int m_cycleNumber;
+	};
+
+	/// <summary>
+	/// An input of a <see cref="ComputedDataRef"/>, either a data ref or another computed data ref
+	/// </summary>
+	class ComputedInput final
+	{
+	public:
+		/// <summary>
+		/// Creates an input from a data ref or another computed data ref
+		/// </summary>
+		/// <param name="source">Data ref or computed data ref to read</param>
+		template<typename T>
+		ComputedInput(std::shared_ptr<T> source) :
+			m_value(Resolve(source)) {}
+
+		/// <summary>
+		/// Gets the value read by this input
+		/// </summary>
+		/// <returns>Value read by this input</returns>
+		inline const std::shared_ptr<ComputedValue>& GetValue() const
+		{
+			return m_value;
+		}
+
+	private:
+		// Value read by this input
+		std::shared_ptr<ComputedValue> m_value;
+
+		// Finds the value shared by every input reading a data ref
+		static std::shared_ptr<ComputedValue> Resolve(std::shared_ptr<DataRef> dataRef);
+		// Uses a computed value directly
+		static std::shared_ptr<ComputedValue> Resolve(std::shared_ptr<ComputedValue> value);
+	};
+
+	/// <summary>
+	/// A data ref computed from other data refs, recomputed only when its inputs change
+	/// </summary>
+	/// <remarks>
+	/// <para>
+	/// Every read within a frame (identified by its cycle number) returns the same memoized
+	/// value, so other plug-ins reading the data ref many times a frame only cost a load.
+	/// On the first read of a frame each input is evaluated, and the compute function only
+	/// runs if an input changed since it last ran. Data refs used as inputs are read once a
+	/// frame, however many computed data refs share them.
+	/// </para>
+	/// <para>
+	/// Inputs must be created before the computed data refs depending on them, so the order
+	/// of creation is a topological order of the dependency graph and cycles can't be formed.
+	/// The compute function must be pure, as it's skipped when the inputs are unchanged.
+	/// Frames are told apart with XPLMGetCycleNumber, so a read from a flight loop running
+	/// before <see cref="FrameTiming"/>'s still sees this frame's value. Only use computed data
+	/// refs from the sim thread.
+	/// </para>
+	/// </remarks>
+	/// <code>
+	/// auto trueAirspeed = XP::ComputedDataRef::Create("myplugin/tas", { indicatedAirspeed, densityRatio },
+	///		[](const double* inputs) { return inputs[0] / std::sqrt(inputs[1]); });
+	/// </code>
+	class ComputedDataRef final : public ComputedValue
+	{
+	public:
+		/// <summary>
+		/// Computes a value from the values of the inputs, in the order they were given
+		/// </summary>
+		typedef std::function<double(const double* inputs)> ComputeFunction;
+
+		/// <summary>
+		/// Creates a computed data ref, publishing it as a float and double data ref
+		/// </summary>
+		/// <param name="name">Name to publish the data ref as, or empty for an unpublished intermediate value</param>
+		/// <param name="inputs">Data refs and computed data refs the value is computed from</param>
+		/// <param name="compute">Pure function computing the value from the inputs</param>
+		/// <returns>Created computed data ref</returns>
+		static std::shared_ptr<ComputedDataRef> Create(std::string name, std::vector<ComputedInput> inputs,
+													   ComputeFunction compute);
+
+		/// <summary>
+		/// Gets the value for the current frame
+		/// </summary>
+		/// <returns>Value for the current frame</returns>
+		double GetValue();
+		/// <summary>
+		/// Gets the published data ref
+		/// </summary>
+		/// <returns>Published data ref, or NULL if unpublished</returns>
+		inline std::shared_ptr<UserDataRef> GetDataRef() const
+		{
+			return m_dataRef;
+		}
+		/// <summary>
+		/// Gets the number of times the value has been computed
+		/// </summary>
+		/// <returns>Number of times computed</returns>
+		inline uint64_t GetComputeCount() const
+		{
+			return m_computeCount;
+		}
+
+	private:
+		ComputedDataRef(std::vector<ComputedInput> inputs, ComputeFunction compute);
+		~ComputedDataRef() = default;
+
+		// Inputs, and the version of each when the value was last computed
+		std::vector<std::shared_ptr<ComputedValue>> m_inputs;
+		std::vector<uint64_t> m_inputVersions;
+		// Values of the inputs passed to the compute function
+		std::vector<double> m_inputValues;
+		// Computes the value
+		ComputeFunction m_compute;
+		// Number of times the value has been computed
+		uint64_t m_computeCount;
+		// Published data ref
+		std::shared_ptr<UserDataRef> m_dataRef;
+
+		// Recomputes the value if an input changed
+		void Update(int cycleNumber) override;
+	};
+}
@@ -4,7 +4,10 @@
 #include <memory>
 #include <functional>
 #include <string>
-#include <list>
+#include <unordered_map>
+
+// XP++ includes
+#include "XP++/Diagnostics/TaggedAllocator.hpp"
 
 namespace XP
 {
@@ -12,12 +15,31 @@ namespace XP
 	enum class DataType;
 	class DataRefType;
 
+	/// <summary>
+	/// How reads of a data ref's single values are cached
+	/// </summary>
+	enum class DataRefCacheMode : int
+	{
+		/// <summary>
+		/// Cached while <see cref="DataRef::SetCachingEnabled"/> is enabled
+		/// </summary>
+		Default		= 0,
+		/// <summary>
+		/// Cached for the rest of the frame once read
+		/// </summary>
+		PerFrame	= 1,
+		/// <summary>
+		/// Never cached, for data refs which change within a frame
+		/// </summary>
+		Volatile	= 2
+	};
+
 	/// <summary>
 	/// Data reference provides generic, flexible, high 
 	/// performance way to read and write data to and 
 	/// from X-Plane and other plug-ins
 	/// </summary>
-	class DataRef
+	class DataRef : public TaggedObject<MemoryTag::DataRefs>
 	{
 	public:
 		DataRef(const DataRef&)				= delete;
@@ -26,9 +48,30 @@ namespace XP
 		/// <summary>
 		/// Finds a data ref
 		/// </summary>
+		/// <remarks>
+		/// Data refs found through X-Plane are kept alive by XP++ until <see cref="ReleaseFoundDataRefs"/>,
+		/// so the returned pointer stays valid even if nothing locks it. Data refs registered by this
+		/// plug-in are found by name without asking X-Plane.
+		/// </remarks>
 		/// <param name="name">Name of the data ref to find</param>
 		/// <returns>Found data ref, or NULL if none found</returns>
 		static std::weak_ptr<DataRef> FindDataRef(std::string name);
+		/// <summary>
+		/// Stops keeping data refs found through X-Plane alive
+		/// </summary>
+		/// <remarks>
+		/// Call when the found data refs are no longer needed, such as when the user's aircraft
+		/// changes, or before the plug-in stops. Data refs still locked elsewhere remain valid.
+		/// </remarks>
+		static void ReleaseFoundDataRefs();
+		/// <summary>
+		/// Gets the number of data refs known by name
+		/// </summary>
+		/// <returns>Number of registry entries, including any expired entries not yet swept</returns>
+		static inline size_t GetRegistrySize()
+		{
+			return m_dataRefs.size();
+		}
 
 		/// <summary>
 		/// Checks if this Data Ref hasn't been orphaned
@@ -51,6 +94,51 @@ namespace XP
 		/// <returns>Object representing Data type(s) supported by this data ref</returns>
 		DataRefType GetType() const;
 
+		/// <summary>
+		/// Sets how reads of this data ref's single values are cached
+		/// </summary>
+		/// <remarks>
+		/// A cached data ref keeps the last integer, float and double value read along
+		/// with the frame's cycle number, so reading it again within the same frame doesn't
+		/// call into X-Plane (or the plug-in providing it). Writes through this object clear
+		/// the cache, but changes made by others aren't seen until the next frame. The frame
+		/// is checked against the cycle number <see cref="FrameTiming"/> samples once per frame,
+		/// falling back to XPLMGetCycleNumber on every read while it isn't running. Start
+		/// FrameTiming before registering flight loops which read cached data refs before the
+		/// flight model, or those running ahead of it may be given the previous frame's values.
+		/// </remarks>
+		/// <param name="mode">How reads are cached</param>
+		inline void SetCacheMode(DataRefCacheMode mode)
+		{
+			m_cacheMode = mode;
+			InvalidateCache();
+		}
+		/// <summary>
+		/// Gets how reads of this data ref's single values are cached
+		/// </summary>
+		/// <returns>How reads are cached</returns>
+		inline DataRefCacheMode GetCacheMode() const
+		{
+			return m_cacheMode;
+		}
+		/// <summary>
+		/// Enables or disables caching of every data ref left in the <see cref="DataRefCacheMode::Default"/> mode
+		/// </summary>
+		/// <remarks>
+		/// Set data refs which change within a frame to <see cref="DataRefCacheMode::Volatile"/>
+		/// to always read them from X-Plane. Disabled by default.
+		/// </remarks>
+		/// <param name="isEnabled">True to cache reads, otherwise false</param>
+		static void SetCachingEnabled(bool isEnabled);
+		/// <summary>
+		/// Is caching enabled for data refs in the <see cref="DataRefCacheMode::Default"/> mode?
+		/// </summary>
+		/// <returns>True if enabled, otherwise false</returns>
+		static inline bool IsCachingEnabled()
+		{
+			return m_isCachingEnabled;
+		}
+
 		/// <summary>
 		/// Reads Integer data from this data ref
 		/// </summary>
@@ -236,21 +324,70 @@ namespace XP
 	protected:
 		// Used for creating DataRefs externally managed and/or created by the consuming plug-in
 		DataRef(std::string name, void* id);
-		~DataRef();
+		~DataRef() = default;
 
 		inline void* GetID() const
 		{
 			return m_id;
 		}
 
-		// Created DataRefs
-		static std::list<std::weak_ptr<DataRef>> m_dataRefs;
+		// Adds a data ref to the registry, replacing any data ref of the same name
+		static void Register(const std::shared_ptr<DataRef>& dataRef, bool isOwned);
+		// Removes a destroyed data ref from the registry
+		static void Unregister(const DataRef* dataRef) noexcept;
 
 	private:
+		// A data ref within the registry
+		struct RegistryEntry
+		{
+			std::weak_ptr<DataRef> dataRef;
+			// Data refs found through X-Plane are owned by the registry, as nothing else need hold them
+			std::shared_ptr<DataRef> owner;
+		};
+		typedef std::unordered_map<std::string, RegistryEntry, std::hash<std::string>, std::equal_to<std::string>,
+								   TaggedAllocator<std::pair<const std::string, RegistryEntry>, MemoryTag::DataRefs>> Registry;
+
+		// Created data refs, by name
+		static Registry m_dataRefs;
+		// Registry size which triggers the next sweep of expired entries
+		static size_t m_sweepSize;
+
 		// Name/Path to this DataRef
 		std::string m_name;
 
 		// Internal X-Plane DataRef ID
 		void* m_id;
+
+		// Single values read within a frame, and the cycle number each was read at
+		struct ValueCache
+		{
+			int intCycleNumber;
+			int floatCycleNumber;
+			int doubleCycleNumber;
+			int intValue;
+			float floatValue;
+			double doubleValue;
+		};
+
+		// How reads are cached
+		DataRefCacheMode m_cacheMode;
+		// Values cached for the current frame
+		mutable ValueCache m_cache;
+		// Is caching enabled for data refs in the default mode?
+		static bool m_isCachingEnabled;
+
+		// Should reads be cached?
+		inline bool IsCaching() const
+		{
+			return m_cacheMode == DataRefCacheMode::PerFrame ||
+				   (m_cacheMode == DataRefCacheMode::Default && m_isCachingEnabled);
+		}
+		// Forgets the cached values
+		inline void InvalidateCache()
+		{
+			m_cache.intCycleNumber		= -1;
+			m_cache.floatCycleNumber	= -1;
+			m_cache.doubleCycleNumber	= -1;
+		}
 	};
 }
@@ -0,0 +1,8 @@
+#pragma once
+
+#include "Diagnostics/CallbackErrors.hpp"
+#include "Diagnostics/CallbackGuard.hpp"
+#include "Diagnostics/CallbackWatchdog.hpp"
+#include "Diagnostics/MemoryTracker.hpp"
+#include "Diagnostics/PeriodicReport.hpp"
+#include "Diagnostics/TaggedAllocator.hpp"
@@ -0,0 +1,132 @@
+#pragma once
+
+// STL includes
+#include <cstddef>
+#include <functional>
+
+namespace XP
+{
+	/// <summary>
+	/// Identifies which kind of X-Plane callback an error occurred within
+	/// </summary>
+	enum class CallbackType : int
+	{
+		/// <summary>
+		/// Plug-in entry point (XPluginStart, XPluginEnable, etc.)
+		/// </summary>
+		Plugin			= 0,
+		/// <summary>
+		/// <see cref="UserDataRef"/> read accessor
+		/// </summary>
+		DataRefRead		= 1,
+		/// <summary>
+		/// <see cref="UserDataRef"/> write accessor
+		/// </summary>
+		DataRefWrite	= 2,
+		/// <summary>
+		/// <see cref="FlightLoop"/> callback
+		/// </summary>
+		FlightLoop		= 3,
+		/// <summary>
+		/// <see cref="MenuItem"/> click handler
+		/// </summary>
+		Menu			= 4,
+		/// <summary>
+		/// <see cref="Command"/> handler
+		/// </summary>
+		Command			= 5,
+		/// <summary>
+		/// Destruction of an XP++ object
+		/// </summary>
+		Destructor		= 6
+	};
+
+	/// <summary>
+	/// An exception caught at the boundary between X-Plane and XP++
+	/// </summary>
+	struct CallbackError
+	{
+		/// <summary>
+		/// Maximum length of a recorded message, including the null terminator
+		/// </summary>
+		static const size_t MaxMessageLength = 128;
+
+		// Kind of callback the exception was thrown from
+		CallbackType type;
+		// Object the callback belonged to (the callback's refcon)
+		const void* object;
+		// Sim cycle the exception was thrown within, as sampled by FrameTiming (0 if never started)
+		int cycleNumber;
+		// Message of the exception, truncated to fit
+		char message[MaxMessageLength];
+	};
+
+	/// <summary>
+	/// Records exceptions caught within X-Plane callbacks
+	/// </summary>
+	/// <remarks>
+	/// <para>
+	/// Exceptions must never propagate into X-Plane, as unwinding through the
+	/// simulator's C code will crash it. XP++ catches them at every callback
+	/// (see <see cref="CallbackGuard"/>) and records them here instead.
+	/// </para>
+	/// <para>
+	/// Errors are stored within a fixed size, preallocated ring. Recording
+	/// never allocates or locks, so it's safe to do from any thread; once the
+	/// ring is full further errors are dropped and counted. Errors are reported
+	/// later, away from the failing callback, by <see cref="Drain"/> or
+	/// <see cref="StartReporting"/>.
+	/// </para>
+	/// </remarks>
+	class CallbackErrors final
+	{
+	public:
+		/// <summary>
+		/// Number of errors which can be held before errors are dropped
+		/// </summary>
+		static const size_t Capacity = 256;
+
+		/// <summary>
+		/// Records an error
+		/// </summary>
+		/// <param name="type">Kind of callback the error occurred within</param>
+		/// <param name="object">Object the callback belonged to</param>
+		/// <param name="message">Message describing the error</param>
+		static void Record(CallbackType type, const void* object, const char* message) noexcept;
+
+		/// <summary>
+		/// Removes all recorded errors, passing each to the given function
+		/// </summary>
+		/// <remarks>
+		/// Only one thread may drain errors at a time.
+		/// </remarks>
+		/// <param name="handler">Function called for each recorded error, oldest first</param>
+		/// <returns>Number of errors drained</returns>
+		static size_t Drain(std::function<void(const CallbackError&)> handler);
+
+		/// <summary>
+		/// Gets the number of errors dropped since the ring was full
+		/// </summary>
+		/// <returns>Total number of errors dropped</returns>
+		static size_t GetDroppedCount();
+
+		/// <summary>
+		/// Starts periodically writing recorded errors to the <see cref="Logger"/>, or changes the interval
+		/// </summary>
+		/// <remarks>
+		/// Errors are left recorded while the logger isn't running.
+		/// </remarks>
+		/// <param name="interval">Seconds between each report</param>
+		static void StartReporting(float interval = 1.0f);
+		/// <summary>
+		/// Stops the periodic reporting started by <see cref="StartReporting"/>
+		/// </summary>
+		static void StopReporting();
+
+	private:
+		CallbackErrors()									= delete;
+		~CallbackErrors()									= delete;
+		CallbackErrors(const CallbackErrors&)				= delete;
+		CallbackErrors& operator=(const CallbackErrors&)	= delete;
+	};
+}
@@ -0,0 +1,91 @@
+#pragma once
+
+// STL includes
+#include <exception>
+
+// XP++ includes
+#include "XP++/Diagnostics/CallbackErrors.hpp"
+#include "XP++/Diagnostics/CallbackWatchdog.hpp"
+
+namespace XP
+{
+	/// <summary>
+	/// Boundary between X-Plane's C callbacks and XP++/user code
+	/// </summary>
+	/// <remarks>
+	/// <para>
+	/// Every callback XP++ registers with X-Plane runs its body through
+	/// <see cref="Invoke"/>, which never throws. Any exception is recorded
+	/// with <see cref="CallbackErrors"/> and a fallback value is returned to
+	/// X-Plane instead. While the <see cref="CallbackWatchdog"/> is running,
+	/// the callback is also marked so long-running callbacks can be caught.
+	/// </para>
+	/// <para>
+	/// With table based exception handling (all 64-bit targets), entering the
+	/// try block costs nothing; only a thrown exception pays for unwinding.
+	/// </para>
+	/// </remarks>
+	class CallbackGuard final
+	{
+	public:
+		/// <summary>
+		/// Invokes a callback which returns a value
+		/// </summary>
+		/// <param name="type">Kind of callback being invoked</param>
+		/// <param name="object">Object the callback belongs to</param>
+		/// <param name="fallback">Value returned if the callback throws</param>
+		/// <param name="function">Callback to invoke</param>
+		/// <returns>Value returned by the callback, or the fallback value</returns>
+		template<typename Result, typename Function>
+		static Result Invoke(CallbackType type, const void* object, Result fallback, Function function) noexcept
+		{
+			CallbackWatchdog::Scope scope(type, object);
+
+			try
+			{
+				return function();
+			}
+			catch (const std::exception& exception)
+			{
+				CallbackErrors::Record(type, object, exception.what());
+			}
+			catch (...)
+			{
+				CallbackErrors::Record(type, object, "Unknown exception");
+			}
+
+			return fallback;
+		}
+
+		/// <summary>
+		/// Invokes a callback which doesn't return a value
+		/// </summary>
+		/// <param name="type">Kind of callback being invoked</param>
+		/// <param name="object">Object the callback belongs to</param>
+		/// <param name="function">Callback to invoke</param>
+		template<typename Function>
+		static void Invoke(CallbackType type, const void* object, Function function) noexcept
+		{
+			CallbackWatchdog::Scope scope(type, object);
+
+			try
+			{
+				function();
+			}
+			catch (const std::exception& exception)
+			{
+				CallbackErrors::Record(type, object, exception.what());
+			}
+			catch (...)
+			{
+				CallbackErrors::Record(type, object, "Unknown exception");
+			}
+		}
+
+	private:
+		CallbackGuard()									= delete;
+		~CallbackGuard()								= delete;
+		CallbackGuard(const CallbackGuard&)				= delete;
+		CallbackGuard& operator=(const CallbackGuard&)	= delete;
+	};
+}
@@ -0,0 +1,191 @@
+#pragma once
+
+// STL includes
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+// XP++ includes
+#include "XP++/Diagnostics/CallbackErrors.hpp"
+
+namespace XP
+{
+	/// <summary>
+	/// A stall of the sim thread caught by the <see cref="CallbackWatchdog"/>
+	/// </summary>
+	struct CallbackStall
+	{
+		/// <summary>
+		/// Maximum number of stack frames sampled
+		/// </summary>
+		static const int MaxFrames = 48;
+
+		// Was the sim thread within an XP++ callback? Otherwise a frame took too long
+		bool isInCallback;
+		// Kind of callback, and the object it belongs to
+		CallbackType type;
+		const void* object;
+		// Seconds the callback (or frame) had been running when caught
+		float duration;
+		// Stack of the sim thread, innermost first, or no frames if it couldn't be sampled
+		void* frames[MaxFrames];
+		int frameCount;
+		// Was the stall still going once the stack was sampled? Otherwise the stack is from after it
+		bool isStackValid;
+	};
+
+	/// <summary>
+	/// Watches the sim thread from a background thread, reporting callbacks which run for too long
+	/// </summary>
+	/// <remarks>
+	/// <para>
+	/// While started, <see cref="CallbackGuard"/> marks which callback the sim thread is within and
+	/// since when, and a flight loop writes a heartbeat each frame. The watchdog thread checks these
+	/// several times per threshold. Once a callback has run past the threshold its type and object
+	/// are recorded along with a sample of the sim thread's stack, taken by signalling the sim thread
+	/// (POSIX only) so the stack is captured into a preallocated buffer by its own signal handler.
+	/// Each stall is recorded once, logged with its symbolised stack, and kept for <see cref="Drain"/>.
+	/// </para>
+	/// <para>
+	/// When stopped, marking a callback costs a single relaxed load; when started, it also
+	/// reads the steady clock and writes a few atomics. Stacks aren't sampled on Windows.
+	/// </para>
+	/// <para>
+	/// Start the watchdog from the sim thread, as that's the thread it signals. While started, the
+	/// watchdog takes over <see cref="StackSampleSignal"/> (SIGUSR2) for the whole process, so nothing
+	/// else in X-Plane, or any other plug-in, may use that signal meanwhile.
+	/// </para>
+	/// <para>
+	/// A sampling signal may still be pending once stopped, if the sim thread had it blocked. So
+	/// stopping first ignores the signal, which discards a pending one, then restores a handler which
+	/// was installed before starting. If there was none, the signal is left ignored rather than
+	/// restored to its default action, which would terminate X-Plane.
+	/// </para>
+	/// </remarks>
+	class CallbackWatchdog final
+	{
+	public:
+		/// <summary>
+		/// Number of stalls which can be held before stalls are dropped
+		/// </summary>
+		static const size_t Capacity = 16;
+		/// <summary>
+		/// Signal sent to the sim thread to sample its stack (SIGUSR2)
+		/// </summary>
+		static const int StackSampleSignal;
+
+		/// <summary>
+		/// Marks the sim thread as within a callback for its lifetime
+		/// </summary>
+		/// <remarks>
+		/// Created by <see cref="CallbackGuard"/>. Nested callbacks restore the outer callback's
+		/// marker when they return, so the innermost running callback is always the one marked.
+		/// </remarks>
+		class Scope final
+		{
+		public:
+			inline Scope(CallbackType type, const void* object) noexcept :
+				m_isMarked(m_isWatching.load(std::memory_order_relaxed))
+			{
+				if (m_isMarked)
+				{
+					m_previousType		= m_markerType.load(std::memory_order_relaxed);
+					m_previousObject	= m_markerObject.load(std::memory_order_relaxed);
+					m_previousTime		= m_markerTime.load(std::memory_order_relaxed);
+					Mark(static_cast<int>(type), object, GetTime());
+				}
+			}
+			inline ~Scope()
+			{
+				if (m_isMarked)
+				{
+					Mark(m_previousType, m_previousObject, m_previousTime);
+				}
+			}
+
+			Scope(const Scope&)				= delete;
+			Scope& operator=(const Scope&)	= delete;
+
+		private:
+			// Was the callback marked? The watchdog may start or stop meanwhile
+			bool m_isMarked;
+			// Marker of the callback this one is nested within
+			int m_previousType;
+			const void* m_previousObject;
+			int64_t m_previousTime;
+		};
+
+		/// <summary>
+		/// Starts watching the sim thread, which must be the calling thread
+		/// </summary>
+		/// <param name="callbackThreshold">Seconds a callback may run before it's reported</param>
+		/// <param name="frameThreshold">Seconds between frames before the frame is reported, or 0 to not report frames</param>
+		static void Start(float callbackThreshold = 0.1f, float frameThreshold = 0.0f);
+		/// <summary>
+		/// Stops watching the sim thread
+		/// </summary>
+		/// <remarks>
+		/// Leaves <see cref="StackSampleSignal"/> ignored, unless a handler was installed before starting.
+		/// </remarks>
+		static void Stop();
+		/// <summary>
+		/// Is the sim thread being watched?
+		/// </summary>
+		/// <returns>True if started</returns>
+		static inline bool IsRunning()
+		{
+			return m_isWatching.load(std::memory_order_relaxed);
+		}
+
+		/// <summary>
+		/// Removes all recorded stalls, passing each to the given function
+		/// </summary>
+		/// <param name="handler">Function called for each recorded stall, oldest first</param>
+		/// <returns>Number of stalls drained</returns>
+		static size_t Drain(std::function<void(const CallbackStall&)> handler);
+		/// <summary>
+		/// Gets the number of stalls caught since first started, including any dropped
+		/// </summary>
+		/// <returns>Total number of stalls</returns>
+		static size_t GetStallCount();
+
+	private:
+		CallbackWatchdog()										= delete;
+		~CallbackWatchdog()										= delete;
+		CallbackWatchdog(const CallbackWatchdog&)				= delete;
+		CallbackWatchdog& operator=(const CallbackWatchdog&)	= delete;
+
+		// Are callbacks being marked?
+		static std::atomic<bool> m_isWatching;
+		// Callback the sim thread is within, guarded by a sequence number which is odd while being written
+		static std::atomic<uint32_t> m_markerSequence;
+		static std::atomic<int> m_markerType;
+		static std::atomic<const void*> m_markerObject;
+		// Steady clock time the callback was entered at, in nanoseconds, or 0 if not within one
+		static std::atomic<int64_t> m_markerTime;
+
+		// Reads the steady clock, in nanoseconds
+		static inline int64_t GetTime() noexcept
+		{
+			return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+		}
+		// Writes the marker, only ever from the sim thread
+		static inline void Mark(int type, const void* object, int64_t time) noexcept
+		{
+			uint32_t sequence = m_markerSequence.load(std::memory_order_relaxed);
+			m_markerSequence.store(sequence + 1, std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_release);
+
+			m_markerType.store(type, std::memory_order_relaxed);
+			m_markerObject.store(object, std::memory_order_relaxed);
+			m_markerTime.store(time, std::memory_order_relaxed);
+
+			m_markerSequence.store(sequence + 2, std::memory_order_release);
+		}
+
+		// Checks the sim thread until stopped
+		static void Watch(float callbackThreshold, float frameThreshold);
+	};
+}
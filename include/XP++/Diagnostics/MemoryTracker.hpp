@@ -0,0 +1,137 @@
+#pragma once
+
+// STL includes
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace XP
+{
+	/// <summary>
+	/// Subsystem memory is accounted to
+	/// </summary>
+	enum class MemoryTag : int
+	{
+		/// <summary>
+		/// <see cref="DataRef"/> and <see cref="UserDataRef"/> wrappers, and their registry
+		/// </summary>
+		DataRefs	= 0,
+		/// <summary>
+		/// <see cref="Command"/> wrappers and their handler tables
+		/// </summary>
+		Commands	= 1,
+		/// <summary>
+		/// <see cref="FlightLoop"/> wrappers
+		/// </summary>
+		FlightLoops	= 2,
+		/// <summary>
+		/// <see cref="Menu"/> and <see cref="MenuItem"/> wrappers
+		/// </summary>
+		Menus		= 3,
+		/// <summary>
+		/// Inter-plugin message subscriptions
+		/// </summary>
+		Messages	= 4,
+		/// <summary>
+		/// Caches of values read from X-Plane
+		/// </summary>
+		Caches		= 5,
+		/// <summary>
+		/// Allocations tagged by the plug-in itself
+		/// </summary>
+		User		= 6,
+		/// <summary>
+		/// Number of tags
+		/// </summary>
+		Count		= 7
+	};
+
+	/// <summary>
+	/// Memory accounted to a <see cref="MemoryTag"/>
+	/// </summary>
+	struct MemoryUsage
+	{
+		// Bytes currently allocated
+		size_t liveBytes;
+		// Most bytes allocated at once, since started or peaks were reset
+		size_t peakBytes;
+		// Number of allocations not yet freed
+		size_t liveAllocations;
+		// Number of allocations ever made
+		uint64_t totalAllocations;
+	};
+
+	/// <summary>
+	/// Counts the memory allocated by each subsystem
+	/// </summary>
+	/// <remarks>
+	/// <para>
+	/// Allocations made through <see cref="TaggedAllocator"/> and <see cref="TaggedObject"/>
+	/// are counted against their tag. Counting is a few relaxed atomic operations on
+	/// counters which are zero-initialised before any static constructor runs, so it's
+	/// safe from any thread and at any time.
+	/// </para>
+	/// <para>
+	/// Only memory allocated by XP++ (or tagged by the plug-in) is seen; memory allocated
+	/// internally by members such as strings and std::function targets isn't counted.
+	/// A live count which grows steadily while the plug-in is idle points at a leak.
+	/// </para>
+	/// </remarks>
+	class MemoryTracker final
+	{
+	public:
+		/// <summary>
+		/// Counts an allocation
+		/// </summary>
+		/// <param name="tag">Tag to count the allocation against</param>
+		/// <param name="size">Size of the allocation, in bytes</param>
+		static void RecordAllocation(MemoryTag tag, size_t size) noexcept;
+		/// <summary>
+		/// Counts an allocation being freed
+		/// </summary>
+		/// <param name="tag">Tag the allocation was counted against</param>
+		/// <param name="size">Size of the allocation, in bytes</param>
+		static void RecordFree(MemoryTag tag, size_t size) noexcept;
+
+		/// <summary>
+		/// Gets the memory accounted to a tag
+		/// </summary>
+		/// <param name="tag">Tag to get the usage of</param>
+		/// <returns>Usage of the tag</returns>
+		static MemoryUsage GetUsage(MemoryTag tag) noexcept;
+		/// <summary>
+		/// Gets the total memory accounted to every tag
+		/// </summary>
+		/// <remarks>
+		/// The peak is the sum of each tag's peak, which may not have happened at the same time.
+		/// </remarks>
+		/// <returns>Usage of every tag combined</returns>
+		static MemoryUsage GetTotalUsage() noexcept;
+		/// <summary>
+		/// Resets the peak of every tag to its live bytes
+		/// </summary>
+		static void ResetPeaks() noexcept;
+		/// <summary>
+		/// Gets the name of a tag
+		/// </summary>
+		/// <param name="tag">Tag to name</param>
+		/// <returns>Name of the tag</returns>
+		static const char* GetTagName(MemoryTag tag) noexcept;
+
+		/// <summary>
+		/// Starts periodically writing the usage of each tag to the <see cref="Logger"/>, or changes the interval
+		/// </summary>
+		/// <param name="interval">Seconds between each report</param>
+		static void StartReporting(float interval = 60.0f);
+		/// <summary>
+		/// Stops the periodic reporting started by <see cref="StartReporting"/>
+		/// </summary>
+		static void StopReporting();
+
+	private:
+		MemoryTracker()									= delete;
+		~MemoryTracker()								= delete;
+		MemoryTracker(const MemoryTracker&)				= delete;
+		MemoryTracker& operator=(const MemoryTracker&)	= delete;
+	};
+}
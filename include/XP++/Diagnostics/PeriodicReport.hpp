@@ -0,0 +1,65 @@
+#pragma once
+
+// STL includes
+#include <functional>
+#include <memory>
+
+namespace XP
+{
+	class FlightLoop;
+
+	/// <summary>
+	/// Calls a report function at a regular interval, from the sim thread
+	/// </summary>
+	/// <remarks>
+	/// Reports are written through the <see cref="Logger"/>, so the report is skipped
+	/// while it isn't running; whatever the report would have written waits for the next.
+	/// Intended to be held with static storage duration, as it's called back through
+	/// a raw pointer.
+	/// </remarks>
+	class PeriodicReport final
+	{
+	public:
+		/// <summary>
+		/// Function writing a report
+		/// </summary>
+		typedef std::function<void()> ReportCallback;
+
+		/// <summary>
+		/// Constructs a new periodic report, which isn't started
+		/// </summary>
+		/// <param name="report">Function writing the report</param>
+		explicit PeriodicReport(ReportCallback report);
+		~PeriodicReport()									= default;
+
+		PeriodicReport(const PeriodicReport&)				= delete;
+		PeriodicReport& operator=(const PeriodicReport&)	= delete;
+
+		/// <summary>
+		/// Starts reporting, or changes the interval if already started
+		/// </summary>
+		/// <param name="interval">Seconds between each report</param>
+		void Start(float interval);
+		/// <summary>
+		/// Stops reporting
+		/// </summary>
+		void Stop();
+
+		/// <summary>
+		/// Is this reporting?
+		/// </summary>
+		/// <returns>True if started</returns>
+		inline bool IsRunning() const
+		{
+			return m_flightLoop != nullptr;
+		}
+
+	private:
+		// Function writing the report
+		ReportCallback m_report;
+		// Seconds between each report, returned by the flight loop so a restart takes effect
+		float m_interval;
+		// Flight loop calling the report
+		std::shared_ptr<FlightLoop> m_flightLoop;
+	};
+}
@@ -0,0 +1,103 @@
+#pragma once
+
+// STL includes
+#include <cstddef>
+#include <new>
+
+// XP++ includes
+#include "XP++/Diagnostics/MemoryTracker.hpp"
+
+namespace XP
+{
+	/// <summary>
+	/// Standard allocator counting its allocations against a <see cref="MemoryTag"/>
+	/// </summary>
+	/// <remarks>
+	/// Use for containers owned by a subsystem, or as the control block allocator of a
+	/// shared_ptr. Allocates with the global operator new, so only adds the counting.
+	/// </remarks>
+	/// <code>
+	/// std::vector&lt;int, XP::TaggedAllocator&lt;int, XP::MemoryTag::User&gt;&gt; values;
+	/// </code>
+	template<typename T, MemoryTag Tag>
+	class TaggedAllocator
+	{
+	public:
+		typedef T value_type;
+
+		template<typename U>
+		struct rebind
+		{
+			typedef TaggedAllocator<U, Tag> other;
+		};
+
+		TaggedAllocator() noexcept {}
+		template<typename U>
+		TaggedAllocator(const TaggedAllocator<U, Tag>&) noexcept {}
+
+		/// <summary>
+		/// Allocates space for a number of values
+		/// </summary>
+		/// <param name="count">Number of values</param>
+		/// <returns>Allocated space</returns>
+		T* allocate(size_t count)
+		{
+			T* values = static_cast<T*>(::operator new(count * sizeof(T)));
+			MemoryTracker::RecordAllocation(Tag, count * sizeof(T));
+			return values;
+		}
+		/// <summary>
+		/// Frees space allocated by <see cref="allocate"/>
+		/// </summary>
+		/// <param name="values">Allocated space</param>
+		/// <param name="count">Number of values the space was allocated for</param>
+		void deallocate(T* values, size_t count) noexcept
+		{
+			MemoryTracker::RecordFree(Tag, count * sizeof(T));
+			::operator delete(values);
+		}
+	};
+
+	template<typename T, typename U, MemoryTag Tag>
+	inline bool operator==(const TaggedAllocator<T, Tag>&, const TaggedAllocator<U, Tag>&) noexcept
+	{
+		return true;
+	}
+
+	template<typename T, typename U, MemoryTag Tag>
+	inline bool operator!=(const TaggedAllocator<T, Tag>&, const TaggedAllocator<U, Tag>&) noexcept
+	{
+		return false;
+	}
+
+	/// <summary>
+	/// Base class counting every allocation of the derived class against a <see cref="MemoryTag"/>
+	/// </summary>
+	/// <remarks>
+	/// Replaces the class's operator new and delete, so objects created with new are counted
+	/// at the size of their most derived type. Adds nothing to the size of the object.
+	/// </remarks>
+	template<MemoryTag Tag>
+	class TaggedObject
+	{
+	public:
+		static void* operator new(size_t size)
+		{
+			void* object = ::operator new(size);
+			MemoryTracker::RecordAllocation(Tag, size);
+			return object;
+		}
+		static void operator delete(void* object, size_t size) noexcept
+		{
+			if (object != nullptr)
+			{
+				MemoryTracker::RecordFree(Tag, size);
+				::operator delete(object);
+			}
+		}
+
+	protected:
+		TaggedObject() = default;
+		~TaggedObject() = default;
+	};
+}
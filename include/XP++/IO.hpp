@@ -0,0 +1,5 @@
+#pragma once
+
+#include "IO/AssetLoader.hpp"
+#include "IO/BufferPool.hpp"
+#include "IO/FileIOService.hpp"
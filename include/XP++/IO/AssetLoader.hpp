@@ -0,0 +1,331 @@
+#pragma once
+
+// STL includes
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// XP++ includes
+#include "XP++/IO/BufferPool.hpp"
+#include "XP++/IO/FileIOService.hpp"
+
+namespace XP
+{
+	// Pre-declarations
+	class FrameLoop;
+	class ThreadPool;
+
+	/// <summary>
+	/// Identifies a load queued with an <see cref="AssetLoader"/>
+	/// </summary>
+	typedef uint64_t AssetLoadID;
+
+	/// <summary>
+	/// Layout of the pixels of a decoded image
+	/// </summary>
+	enum class ImageFormat : int
+	{
+		/// <summary>
+		/// 8 bits per channel, red first
+		/// </summary>
+		RGBA8	= 0,
+		/// <summary>
+		/// 8 bits per channel, blue first
+		/// </summary>
+		BGRA8	= 1,
+		/// <summary>
+		/// Block compressed, as DXT1
+		/// </summary>
+		BC1		= 2,
+		/// <summary>
+		/// Block compressed, as DXT3
+		/// </summary>
+		BC2		= 3,
+		/// <summary>
+		/// Block compressed, as DXT5
+		/// </summary>
+		BC3		= 4,
+		/// <summary>
+		/// Block compressed, high quality RGBA
+		/// </summary>
+		BC7		= 5
+	};
+
+	/// <summary>
+	/// One mipmap level of a decoded image
+	/// </summary>
+	struct ImageLevel
+	{
+		int width;
+		int height;
+		// Pixels of the level, ready to upload
+		PooledBuffer pixels;
+	};
+
+	/// <summary>
+	/// Image decoded by an <see cref="AssetLoader"/>
+	/// </summary>
+	struct DecodedImage
+	{
+		ImageFormat format;
+		// Size of the first level
+		int width;
+		int height;
+		// Mipmap levels, largest first
+		std::vector<ImageLevel> levels;
+	};
+
+	/// <summary>
+	/// Outcome of loading an asset
+	/// </summary>
+	struct AssetLoadResult
+	{
+		// Path of the file loaded
+		std::string filePath;
+		// Decoded image, without levels if loading failed
+		DecodedImage image;
+		// Description of the error, or an empty string if loading succeeded
+		std::string error;
+	};
+
+	/// <summary>
+	/// Counters of the loads made by an <see cref="AssetLoader"/>
+	/// </summary>
+	struct AssetLoaderStatistics
+	{
+		// Loads which succeeded and failed
+		uint64_t loadedCount;
+		uint64_t failedCount;
+		// Bytes read from files, and bytes of decoded pixels
+		uint64_t bytesRead;
+		uint64_t bytesDecoded;
+		// Seconds spent decoding, summed over the worker threads
+		double decodeTime;
+		// Most bytes held by loads at once
+		size_t peakInFlightBytes;
+	};
+
+	/// <summary>
+	/// Reads and decodes images on worker threads, handing them to the sim thread within a frame budget
+	/// </summary>
+	/// <remarks>
+	/// <para>
+	/// Files are read by a <see cref="FileIOService"/> and decoded on a <see cref="ThreadPool"/>
+	/// by the decoder registered for their extension. DDS files are decoded by
+	/// <see cref="DecodeDDS"/>, which keeps the (block compressed) levels within the file's own
+	/// buffer. PNG files are decoded by <see cref="DecodePNG"/> into RGBA. Other formats need a
+	/// decoder registered with <see cref="RegisterDecoder"/>, writing into buffers taken from the
+	/// given pool.
+	/// </para>
+	/// <para>
+	/// Bytes held by a load, from its file being read until its handler returns, count against
+	/// the memory cap. Loads are queued and only started while the bytes held are under the cap
+	/// (one is always allowed to run, so any asset can load), so queuing a whole livery doesn't
+	/// read and decode it all at once. As sizes aren't known until loaded, loads being read or
+	/// decoded are counted as large as the largest so far, and the number running is ramped up
+	/// as loads finish reading, so the cap is approximate.
+	/// </para>
+	/// <para>
+	/// Handlers are called on the sim thread at the start of a frame until the frame budget is
+	/// spent (at least one each frame), and the rest wait for the next frame. Each time the queue
+	/// empties, the count, size and decode throughput of the loads are logged.
+	/// </para>
+	/// </remarks>
+	class AssetLoader final
+	{
+	public:
+		/// <summary>
+		/// Handles a loaded asset, on the sim thread
+		/// </summary>
+		typedef std::function<void(const AssetLoadResult& result)> LoadHandler;
+		/// <summary>
+		/// Decodes the bytes of a file, on a worker thread, throwing if they're invalid
+		/// </summary>
+		typedef std::function<DecodedImage(const PooledBuffer& file, BufferPool& pool)> ImageDecoder;
+
+		/// <summary>
+		/// Creates an asset loader
+		/// </summary>
+		/// <param name="memoryCap">Most bytes held by loads before further loads wait</param>
+		/// <param name="fileIOService">Service to read files with, or NULL to create one</param>
+		/// <param name="threadPool">Pool to decode on, or NULL for the shared pool</param>
+		/// <returns>Created asset loader</returns>
+		static std::shared_ptr<AssetLoader> Create(size_t memoryCap = 256 * 1024 * 1024,
+												   std::shared_ptr<FileIOService> fileIOService = nullptr,
+												   std::shared_ptr<ThreadPool> threadPool = nullptr);
+
+		/// <summary>
+		/// Registers the decoder of files with an extension, replacing any already registered
+		/// </summary>
+		/// <param name="extension">Extension including the dot, matched regardless of case (e.g. ".png")</param>
+		/// <param name="decoder">Decoder of the files</param>
+		void RegisterDecoder(std::string extension, ImageDecoder decoder);
+
+		/// <summary>
+		/// Queues an image to load
+		/// </summary>
+		/// <param name="filePath">Path of the file</param>
+		/// <param name="handler">Called on the sim thread with the result</param>
+		/// <returns>ID of the load</returns>
+		AssetLoadID Load(std::string filePath, LoadHandler handler);
+		/// <summary>
+		/// Cancels a load, so its handler is never called
+		/// </summary>
+		/// <param name="loadID">ID of the load to cancel</param>
+		void Cancel(AssetLoadID loadID);
+
+		/// <summary>
+		/// Sets the most bytes held by loads before further loads wait
+		/// </summary>
+		/// <param name="memoryCap">Memory cap, in bytes</param>
+		void SetMemoryCap(size_t memoryCap);
+		/// <summary>
+		/// Sets the time handlers may take each frame
+		/// </summary>
+		/// <param name="frameBudget">Seconds of handlers per frame</param>
+		void SetFrameBudget(float frameBudget);
+
+		/// <summary>
+		/// Gets the number of loads whose handler hasn't been called yet
+		/// </summary>
+		/// <returns>Number of pending loads</returns>
+		inline size_t GetPendingCount() const
+		{
+			return m_loads.size();
+		}
+		/// <summary>
+		/// Gets the bytes currently held by loads
+		/// </summary>
+		/// <returns>Bytes held by loads</returns>
+		inline size_t GetInFlightBytes() const
+		{
+			return m_inFlightBytes;
+		}
+		/// <summary>
+		/// Gets the counters of the loads made so far
+		/// </summary>
+		/// <returns>Load counters</returns>
+		AssetLoaderStatistics GetStatistics() const;
+
+		/// <summary>
+		/// Decodes a DDS file, keeping its levels within the file's buffer
+		/// </summary>
+		/// <remarks>
+		/// Supports 2D textures in DXT1/3/5, BC7 (through the DX10 header) and 32-bit RGBA or BGRA.
+		/// </remarks>
+		/// <param name="file">Bytes of the file</param>
+		/// <param name="pool">Pool to take buffers from (unused, as nothing is copied)</param>
+		/// <returns>Decoded image</returns>
+		static DecodedImage DecodeDDS(const PooledBuffer& file, BufferPool& pool);
+
+		/// <summary>
+		/// Decodes a PNG file into a single RGBA level
+		/// </summary>
+		/// <remarks>
+		/// Supports every colour type and bit depth, transparency and interlacing. 16-bit samples
+		/// are reduced to 8 bits, and ancillary chunks other than transparency are ignored.
+		/// </remarks>
+		/// <param name="file">Bytes of the file</param>
+		/// <param name="pool">Pool to take the pixels and working buffers from</param>
+		/// <returns>Decoded image</returns>
+		static DecodedImage DecodePNG(const PooledBuffer& file, BufferPool& pool);
+
+	private:
+		AssetLoader(size_t memoryCap, std::shared_ptr<FileIOService> fileIOService, std::shared_ptr<ThreadPool> threadPool);
+		~AssetLoader();
+
+		AssetLoader(const AssetLoader&)				= delete;
+		AssetLoader& operator=(const AssetLoader&)	= delete;
+
+		// Stage a load has reached
+		enum class LoadStage
+		{
+			Queued,
+			Reading,
+			Decoding,
+			Decoded
+		};
+
+		// A load whose handler hasn't been called yet
+		struct PendingLoad
+		{
+			std::string filePath;
+			// Handler, or NULL once cancelled part way through decoding
+			LoadHandler handler;
+			LoadStage stage;
+			// Read made for the load, while reading
+			FileReadID readID;
+			// Bytes held by the load, counted against the cap
+			size_t heldBytes;
+		};
+
+		// A finished load, waiting for its handler to be called
+		struct DecodedLoad
+		{
+			AssetLoadID loadID;
+			AssetLoadResult result;
+			// Bytes held by the decoded image
+			size_t heldBytes;
+			// Bytes of the file, and of the decoded pixels
+			size_t fileBytes;
+			size_t decodedBytes;
+			// Seconds spent decoding
+			double decodeTime;
+		};
+
+		// State shared with the worker threads, which may outlive the loader
+		struct SharedState;
+
+		// Services reads and decodes are made with
+		std::shared_ptr<FileIOService> m_fileIOService;
+		std::shared_ptr<ThreadPool> m_threadPool;
+		// State shared with the worker threads
+		std::shared_ptr<SharedState> m_state;
+		// Decoders, by lowercase extension
+		std::unordered_map<std::string, ImageDecoder> m_decoders;
+		// Pending loads, those not started yet in the order queued, and those waiting for their handler
+		std::unordered_map<AssetLoadID, PendingLoad> m_loads;
+		std::deque<AssetLoadID> m_queuedLoads;
+		std::deque<DecodedLoad> m_decodedLoads;
+		// Last load ID handed out
+		AssetLoadID m_lastLoadID;
+		// Number of loads being read and decoded, and the bytes of the files being decoded
+		size_t m_readingCount;
+		size_t m_decodingCount;
+		size_t m_decodingBytes;
+		// Number of files read so far, and the most bytes held by a single load
+		uint64_t m_measuredLoadCount;
+		size_t m_largestLoadBytes;
+		// Bytes held by loads, and the most allowed before loads wait
+		size_t m_inFlightBytes;
+		size_t m_memoryCap;
+		// Seconds of handlers per frame
+		float m_frameBudget;
+		// Counters of the loads handled
+		AssetLoaderStatistics m_statistics;
+		// Counters as of the queue last being empty, and the time it stopped being
+		AssetLoaderStatistics m_reportedStatistics;
+		std::chrono::steady_clock::time_point m_busyStartTime;
+		// Frame loop calling handlers, only awake while loads are pending
+		std::shared_ptr<FrameLoop> m_frameLoop;
+
+		// Starts queued loads while under the memory cap
+		void StartLoads();
+		// Queues decoding a read file on a worker thread
+		void Decode(AssetLoadID loadID, const FileReadResult& result);
+		// Queues a load which failed before being decoded
+		void Fail(AssetLoadID loadID, std::string error);
+		// Calls handlers of decoded loads within the frame budget
+		void DispatchCompletions();
+		// Logs the loads made since the queue was last empty
+		void ReportThroughput();
+		// Gets the decoder of a file, or NULL if its extension has none
+		const ImageDecoder* FindDecoder(const std::string& filePath) const;
+	};
+}
@@ -0,0 +1,142 @@
+#pragma once
+
+// STL includes
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+namespace XP
+{
+	/// <summary>
+	/// Bytes held in a buffer borrowed from a <see cref="BufferPool"/>
+	/// </summary>
+	/// <remarks>
+	/// Copies and slices share the same bytes. The buffer is handed back to the pool
+	/// once the last copy is destroyed, so keep it no longer than needed.
+	/// </remarks>
+	class PooledBuffer final
+	{
+	public:
+		PooledBuffer() :
+			m_storage(), m_data(nullptr), m_size(0) {}
+		PooledBuffer(std::shared_ptr<char> storage, size_t size) :
+			m_storage(storage), m_data(storage.get()), m_size(size) {}
+
+		/// <summary>
+		/// Gets the bytes of the buffer
+		/// </summary>
+		/// <returns>First byte, or NULL if the buffer is empty</returns>
+		inline char* GetData()
+		{
+			return m_data;
+		}
+		inline const char* GetData() const
+		{
+			return m_data;
+		}
+		/// <summary>
+		/// Gets the number of bytes in the buffer
+		/// </summary>
+		/// <returns>Number of bytes</returns>
+		inline size_t GetSize() const
+		{
+			return m_size;
+		}
+
+		/// <summary>
+		/// Gets part of the buffer, sharing its bytes
+		/// </summary>
+		/// <param name="offset">Offset of the first byte of the part</param>
+		/// <param name="size">Number of bytes in the part</param>
+		/// <returns>Part of the buffer</returns>
+		inline PooledBuffer Slice(size_t offset, size_t size) const
+		{
+			if (offset > m_size || size > m_size - offset)
+			{
+				throw std::out_of_range("Slice is outside the bounds of the buffer");
+			}
+
+			PooledBuffer slice;
+			slice.m_storage	= m_storage;
+			slice.m_data	= m_data + offset;
+			slice.m_size	= size;
+			return slice;
+		}
+
+	private:
+		// Pooled storage, shared with other copies and slices
+		std::shared_ptr<char> m_storage;
+		// Bytes of this buffer within the storage
+		char* m_data;
+		size_t m_size;
+	};
+
+	/// <summary>
+	/// Pool of byte buffers, reused rather than allocated for each read or decode
+	/// </summary>
+	/// <remarks>
+	/// Buffers are pooled in power-of-two sizes from 4 KB to 16 MB; larger ones are
+	/// allocated at their exact size and freed once released. Released buffers are kept
+	/// until the pool holds its capacity of free buffers. Every buffer is counted against
+	/// <see cref="MemoryTag::Caches"/>. Buffers may be acquired and released from any thread,
+	/// and keep the pool alive until released.
+	/// </remarks>
+	class BufferPool final : public std::enable_shared_from_this<BufferPool>
+	{
+	public:
+		/// <summary>
+		/// Creates a buffer pool
+		/// </summary>
+		/// <param name="capacity">Most bytes of free buffers to keep</param>
+		/// <returns>Created buffer pool</returns>
+		static std::shared_ptr<BufferPool> Create(size_t capacity = 32 * 1024 * 1024);
+
+		/// <summary>
+		/// Takes a buffer from the pool, allocating one if none are free
+		/// </summary>
+		/// <param name="size">Number of bytes needed</param>
+		/// <returns>Buffer of the given size, with undefined contents</returns>
+		PooledBuffer Acquire(size_t size);
+
+		/// <summary>
+		/// Sets the most bytes of free buffers to keep, freeing any beyond it
+		/// </summary>
+		/// <param name="capacity">Most bytes of free buffers to keep</param>
+		void SetCapacity(size_t capacity);
+
+		/// <summary>
+		/// Gets the bytes of free buffers held by the pool
+		/// </summary>
+		/// <returns>Bytes of free buffers</returns>
+		size_t GetPooledBytes() const;
+		/// <summary>
+		/// Gets the number of buffers taken from the pool rather than allocated
+		/// </summary>
+		/// <returns>Number of reused buffers</returns>
+		uint64_t GetReuseCount() const;
+
+	private:
+		BufferPool(size_t capacity);
+		~BufferPool();
+
+		BufferPool(const BufferPool&)				= delete;
+		BufferPool& operator=(const BufferPool&)	= delete;
+
+		// Smallest and largest pooled sizes, as powers of two
+		static const int MinimumShift = 12;
+		static const int MaximumShift = 24;
+
+		mutable std::mutex m_mutex;
+		// Free buffers of each pooled size
+		std::vector<char*> m_freeBuffers[MaximumShift - MinimumShift + 1];
+		size_t m_pooledBytes;
+		size_t m_capacity;
+		uint64_t m_reuseCount;
+
+		// Keeps a released buffer, unless it isn't pooled or the pool is full
+		void Release(char* buffer, size_t capacity);
+	};
+}
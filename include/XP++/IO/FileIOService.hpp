@@ -0,0 +1,188 @@
+#pragma once
+
+// STL includes
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+// XP++ includes
+#include "XP++/IO/BufferPool.hpp"
+
+namespace XP
+{
+	// Pre-declarations
+	class FrameLoop;
+	class ThreadPool;
+
+	/// <summary>
+	/// Identifies a batch of reads queued with a <see cref="FileIOService"/>
+	/// </summary>
+	typedef uint64_t FileReadID;
+
+	/// <summary>
+	/// Part of a file to read
+	/// </summary>
+	struct FileReadRequest
+	{
+		// Path of the file
+		std::string filePath;
+		// Offset of the first byte to read
+		uint64_t offset;
+		// Number of bytes to read, or 0 to read to the end of the file
+		size_t size;
+	};
+
+	/// <summary>
+	/// Outcome of a <see cref="FileReadRequest"/>
+	/// </summary>
+	struct FileReadResult
+	{
+		// Request that was read
+		FileReadRequest request;
+		// Bytes read, empty if the read failed; fewer than requested if the end of the file was reached first
+		PooledBuffer buffer;
+		// Description of the error, or an empty string if the read succeeded
+		std::string error;
+	};
+
+	/// <summary>
+	/// Counters of the reads made by a <see cref="FileIOService"/>
+	/// </summary>
+	struct FileIOStatistics
+	{
+		// Requests completed, including those answered by read-ahead
+		uint64_t requestCount;
+		// Reads made from the disk, and the bytes they returned
+		uint64_t diskReadCount;
+		uint64_t diskBytesRead;
+		// Requests answered entirely from read-ahead
+		uint64_t readAheadHitCount;
+		// Buffers taken from the pool rather than allocated
+		uint64_t pooledBufferReuseCount;
+		// Bytes of free buffers held by the pool
+		size_t pooledBytes;
+	};
+
+	/// <summary>
+	/// Reads files on worker threads, delivering the bytes back on the sim thread
+	/// </summary>
+	/// <remarks>
+	/// <para>
+	/// Reads are queued from the sim thread in batches, each read by a single task on a
+	/// <see cref="ThreadPool"/>. Within a batch each file is opened once and read in order
+	/// of offset with positioned reads (pread, or ReadFile with an offset on Windows), so
+	/// nothing touches the disk on the sim thread. Completion handlers are called on the sim
+	/// thread at the start of the next frame, once the whole batch has been read, with the
+	/// results in the order they were requested. Queue independent reads as separate batches
+	/// so they're read in parallel.
+	/// </para>
+	/// <para>
+	/// Buffers come from a <see cref="BufferPool"/>, so streaming reads of similar sizes
+	/// stop allocating once warmed up. Each read of a known size also reads the next
+	/// read-ahead bytes of the file, copied into a buffer of their own; a following request
+	/// lying within them is answered without reading the file, as long as its size and
+	/// modification time are unchanged. Read-ahead is kept for the 8 files read most recently.
+	/// </para>
+	/// <para>
+	/// Destroying the service skips any batches not yet read, and drops their completions.
+	/// It mustn't be destroyed from within one of its own handlers.
+	/// </para>
+	/// </remarks>
+	class FileIOService final
+	{
+	public:
+		/// <summary>
+		/// Handles the results of a batch, on the sim thread
+		/// </summary>
+		typedef std::function<void(const std::vector<FileReadResult>& results)> BatchHandler;
+		/// <summary>
+		/// Handles the result of a single read, on the sim thread
+		/// </summary>
+		typedef std::function<void(const FileReadResult& result)> ReadHandler;
+
+		/// <summary>
+		/// Creates a file I/O service
+		/// </summary>
+		/// <param name="threadPool">Pool to read on, or NULL for the shared pool</param>
+		/// <returns>Created file I/O service</returns>
+		static std::shared_ptr<FileIOService> Create(std::shared_ptr<ThreadPool> threadPool = nullptr);
+
+		/// <summary>
+		/// Queues a single read
+		/// </summary>
+		/// <param name="request">Part of the file to read</param>
+		/// <param name="handler">Called on the sim thread with the result</param>
+		/// <returns>ID of the read</returns>
+		FileReadID Read(FileReadRequest request, ReadHandler handler);
+		/// <summary>
+		/// Queues a batch of reads, read together on one worker thread
+		/// </summary>
+		/// <param name="requests">Parts of files to read</param>
+		/// <param name="handler">Called on the sim thread with every result, once all are read</param>
+		/// <returns>ID of the batch</returns>
+		FileReadID ReadBatch(std::vector<FileReadRequest> requests, BatchHandler handler);
+		/// <summary>
+		/// Cancels a read or batch, so its handler is never called
+		/// </summary>
+		/// <remarks>
+		/// A batch not yet started isn't read at all; one already being read finishes first.
+		/// </remarks>
+		/// <param name="readID">ID of the read or batch to cancel</param>
+		void Cancel(FileReadID readID);
+
+		/// <summary>
+		/// Sets the number of bytes read beyond each request
+		/// </summary>
+		/// <param name="readAheadSize">Bytes to read ahead, or 0 to disable read-ahead</param>
+		void SetReadAheadSize(size_t readAheadSize);
+		/// <summary>
+		/// Sets the most bytes of free buffers kept by the pool
+		/// </summary>
+		/// <param name="poolCapacity">Bytes of free buffers to keep</param>
+		void SetPoolCapacity(size_t poolCapacity);
+
+		/// <summary>
+		/// Gets the number of batches whose handler hasn't been called yet
+		/// </summary>
+		/// <returns>Number of pending batches</returns>
+		inline size_t GetPendingCount() const
+		{
+			return m_pendingReadIDs.size();
+		}
+		/// <summary>
+		/// Gets the counters of the reads made so far
+		/// </summary>
+		/// <returns>Read counters</returns>
+		FileIOStatistics GetStatistics() const;
+
+	private:
+		FileIOService(std::shared_ptr<ThreadPool> threadPool);
+		~FileIOService();
+
+		FileIOService(const FileIOService&)				= delete;
+		FileIOService& operator=(const FileIOService&)	= delete;
+
+		// State shared with the worker threads, which may outlive the service
+		struct SharedState;
+
+		// Pool reads are made on
+		std::shared_ptr<ThreadPool> m_threadPool;
+		// State shared with the worker threads
+		std::shared_ptr<SharedState> m_state;
+		// Batches whose handler hasn't been called yet
+		std::unordered_set<FileReadID> m_pendingReadIDs;
+		// Last batch ID handed out
+		FileReadID m_lastReadID;
+		// Frame loop calling completion handlers, only awake while batches are pending
+		std::shared_ptr<FrameLoop> m_frameLoop;
+
+		// Calls the handlers of every completed batch
+		void DispatchCompletions();
+		// Reads a batch, on a worker thread
+		static void ReadRequests(SharedState& state, const std::vector<FileReadRequest>& requests, std::vector<FileReadResult>& results);
+	};
+}
@@ -0,0 +1,5 @@
+#pragma once
+
+#include "Logging/LogCategory.hpp"
+#include "Logging/LogRecord.hpp"
+#include "Logging/Logger.hpp"
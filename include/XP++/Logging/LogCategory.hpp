@@ -0,0 +1,134 @@
+#pragma once
+
+// STL includes
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+namespace XP
+{
+	/// <summary>
+	/// Severity of a logged message
+	/// </summary>
+	enum class LogLevel : int
+	{
+		/// <summary>
+		/// Detailed information used while developing
+		/// </summary>
+		Debug	= 0,
+		/// <summary>
+		/// General information
+		/// </summary>
+		Info	= 1,
+		/// <summary>
+		/// Something unexpected which was recovered from
+		/// </summary>
+		Warning	= 2,
+		/// <summary>
+		/// Something failed
+		/// </summary>
+		Error	= 3
+	};
+
+	/// <summary>
+	/// A named group of log messages, with its own level filter and rate limit
+	/// </summary>
+	/// <remarks>
+	/// Categories are referenced by every message logged to them until the message
+	/// is written, so they should have static storage duration (or otherwise outlive
+	/// <see cref="Logger::Stop"/>).
+	/// </remarks>
+	class LogCategory final
+	{
+	public:
+		/// <summary>
+		/// Constructs a new log category
+		/// </summary>
+		/// <param name="name">Name of the category, written with each message</param>
+		/// <param name="minimumLevel">Messages below this level are discarded</param>
+		/// <param name="maxPerSecond">Maximum messages logged per second, or 0 for no limit</param>
+		LogCategory(std::string name, LogLevel minimumLevel = LogLevel::Info, int maxPerSecond = 0);
+		~LogCategory()								= default;
+
+		LogCategory(const LogCategory&)				= delete;
+		LogCategory& operator=(const LogCategory&)	= delete;
+
+		/// <summary>
+		/// Gets the name of this category
+		/// </summary>
+		/// <returns>Name of this category</returns>
+		inline const std::string& GetName() const
+		{
+			return m_name;
+		}
+
+		/// <summary>
+		/// Gets the minimum level logged for this category
+		/// </summary>
+		/// <returns>Minimum level logged</returns>
+		inline LogLevel GetMinimumLevel() const
+		{
+			return static_cast<LogLevel>(m_minimumLevel.load(std::memory_order_relaxed));
+		}
+		/// <summary>
+		/// Sets the minimum level logged for this category
+		/// </summary>
+		/// <param name="level">Minimum level to log</param>
+		inline void SetMinimumLevel(LogLevel level)
+		{
+			m_minimumLevel.store(static_cast<int>(level), std::memory_order_relaxed);
+		}
+
+		/// <summary>
+		/// Sets the maximum number of messages logged per second
+		/// </summary>
+		/// <param name="maxPerSecond">Maximum messages per second, or 0 for no limit</param>
+		inline void SetRateLimit(int maxPerSecond)
+		{
+			m_maxPerSecond.store(maxPerSecond, std::memory_order_relaxed);
+		}
+
+		/// <summary>
+		/// Gets the number of messages discarded by the rate limit
+		/// </summary>
+		/// <returns>Total number of rate limited messages</returns>
+		inline uint64_t GetRateLimitedCount() const
+		{
+			return m_rateLimitedCount.load(std::memory_order_relaxed);
+		}
+
+		/// <summary>
+		/// Checks whether a message at the given level should be logged right now
+		/// </summary>
+		/// <param name="level">Level of the message</param>
+		/// <param name="timestamp">Time of the message, in steady clock nanoseconds</param>
+		/// <returns>True if the message passes the level filter and rate limit</returns>
+		inline bool ShouldLog(LogLevel level, int64_t timestamp)
+		{
+			if (static_cast<int>(level) < m_minimumLevel.load(std::memory_order_relaxed))
+			{
+				return false;
+			}
+
+			int maxPerSecond = m_maxPerSecond.load(std::memory_order_relaxed);
+			return maxPerSecond <= 0 || TakeRateLimitToken(maxPerSecond, timestamp);
+		}
+
+	private:
+		// Name of this category
+		std::string m_name;
+		// Minimum level logged
+		std::atomic<int> m_minimumLevel;
+		// Maximum messages per second (0 for no limit)
+		std::atomic<int> m_maxPerSecond;
+		// Second the current rate limit window started at
+		std::atomic<int64_t> m_windowSecond;
+		// Messages logged within the current window
+		std::atomic<int> m_windowCount;
+		// Messages discarded by the rate limit
+		std::atomic<uint64_t> m_rateLimitedCount;
+
+		// Counts a message against the rate limit, returning false if over the limit
+		bool TakeRateLimitToken(int maxPerSecond, int64_t timestamp);
+	};
+}
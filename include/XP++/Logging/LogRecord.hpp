@@ -0,0 +1,250 @@
+#pragma once
+
+// STL includes
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+// XP++ includes
+#include "XP++/Logging/LogCategory.hpp"
+
+namespace XP
+{
+	/// <summary>
+	/// Type of an argument captured within a <see cref="LogRecord"/>
+	/// </summary>
+	enum class LogArgumentType : uint8_t
+	{
+		Signed		= 0,
+		Unsigned	= 1,
+		Double		= 2,
+		Bool		= 3,
+		Pointer		= 4,
+		Text		= 5
+	};
+
+	/// <summary>
+	/// A logged message in its binary form, before formatting
+	/// </summary>
+	/// <remarks>
+	/// Only the pointer to the format string is stored, so formats must be
+	/// string literals. Text arguments are copied into the record, and
+	/// truncated once <see cref="MaxTextLength"/> is reached.
+	/// </remarks>
+	struct LogRecord
+	{
+		/// <summary>
+		/// Maximum number of arguments per message
+		/// </summary>
+		static const int MaxArguments = 8;
+		/// <summary>
+		/// Total space for copies of text arguments
+		/// </summary>
+		static const size_t MaxTextLength = 96;
+
+		// A single captured argument
+		union Value
+		{
+			int64_t signedValue;
+			uint64_t unsignedValue;
+			double doubleValue;
+			const void* pointerValue;
+			struct
+			{
+				uint16_t offset;
+				uint16_t length;
+			} text;
+		};
+
+		// Time of the message, in steady clock nanoseconds
+		int64_t timestamp;
+		// Category the message was logged to
+		const LogCategory* category;
+		// Format string literal
+		const char* format;
+		// Level of the message
+		LogLevel level;
+		// Number of arguments captured
+		uint8_t argumentCount;
+		// Bytes used within text
+		uint16_t textLength;
+		// Types of the captured arguments
+		LogArgumentType argumentTypes[MaxArguments];
+		// Values of the captured arguments
+		Value values[MaxArguments];
+		// Storage for text arguments
+		char text[MaxTextLength];
+
+		// Argument capture for each supported type
+		inline void Capture(int value)						{ CaptureSigned(value); }
+		inline void Capture(long value)						{ CaptureSigned(value); }
+		inline void Capture(long long value)				{ CaptureSigned(value); }
+		inline void Capture(unsigned int value)				{ CaptureUnsigned(value); }
+		inline void Capture(unsigned long value)			{ CaptureUnsigned(value); }
+		inline void Capture(unsigned long long value)		{ CaptureUnsigned(value); }
+		inline void Capture(float value)					{ CaptureDouble(value); }
+		inline void Capture(double value)					{ CaptureDouble(value); }
+		inline void Capture(const std::string& value)		{ CaptureText(value.c_str(), value.size()); }
+		inline void Capture(const char* value)
+		{
+			value == nullptr ? CaptureText("(null)", 6) : CaptureText(value, std::strlen(value));
+		}
+		inline void Capture(bool value)
+		{
+			values[argumentCount].unsignedValue	= value ? 1 : 0;
+			argumentTypes[argumentCount++]		= LogArgumentType::Bool;
+		}
+		inline void Capture(const void* value)
+		{
+			values[argumentCount].pointerValue	= value;
+			argumentTypes[argumentCount++]		= LogArgumentType::Pointer;
+		}
+
+		// Captures every argument, in order
+		inline void CaptureAll() {}
+		template<typename First, typename... Rest>
+		inline void CaptureAll(const First& first, const Rest&... rest)
+		{
+			Capture(first);
+			CaptureAll(rest...);
+		}
+
+	private:
+		inline void CaptureSigned(int64_t value)
+		{
+			values[argumentCount].signedValue	= value;
+			argumentTypes[argumentCount++]		= LogArgumentType::Signed;
+		}
+		inline void CaptureUnsigned(uint64_t value)
+		{
+			values[argumentCount].unsignedValue	= value;
+			argumentTypes[argumentCount++]		= LogArgumentType::Unsigned;
+		}
+		inline void CaptureDouble(double value)
+		{
+			values[argumentCount].doubleValue	= value;
+			argumentTypes[argumentCount++]		= LogArgumentType::Double;
+		}
+		inline void CaptureText(const char* value, size_t length)
+		{
+			size_t available	= MaxTextLength - textLength;
+			size_t copied		= length < available ? length : available;
+			std::memcpy(text + textLength, value, copied);
+
+			values[argumentCount].text.offset	= textLength;
+			values[argumentCount].text.length	= static_cast<uint16_t>(copied);
+			argumentTypes[argumentCount++]		= LogArgumentType::Text;
+			textLength							= static_cast<uint16_t>(textLength + copied);
+		}
+	};
+
+	/// <summary>
+	/// Single producer, single consumer ring of <see cref="LogRecord"/>s
+	/// </summary>
+	/// <remarks>
+	/// Each thread which logs owns one ring, so producers never contend.
+	/// </remarks>
+	class LogRing final
+	{
+	public:
+		/// <summary>
+		/// Number of records each ring holds, must be a power of two
+		/// </summary>
+		static const size_t Capacity = 1024;
+
+		LogRing() :
+			m_writePosition(0), m_readPosition(0), m_isAbandoned(false), m_sampleCounter(0) {}
+
+		LogRing(const LogRing&)				= delete;
+		LogRing& operator=(const LogRing&)	= delete;
+
+		/// <summary>
+		/// Gets the next record to write, or NULL if the ring is full
+		/// </summary>
+		inline LogRecord* BeginWrite()
+		{
+			size_t position = m_writePosition.load(std::memory_order_relaxed);
+			if (position - m_readPosition.load(std::memory_order_acquire) >= Capacity)
+			{
+				return nullptr;
+			}
+
+			return &m_records[position & (Capacity - 1)];
+		}
+		/// <summary>
+		/// Publishes the record returned by <see cref="BeginWrite"/>
+		/// </summary>
+		inline void EndWrite()
+		{
+			m_writePosition.store(m_writePosition.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+		}
+
+		/// <summary>
+		/// Gets the oldest unread record, or NULL if the ring is empty
+		/// </summary>
+		inline const LogRecord* BeginRead() const
+		{
+			size_t position = m_readPosition.load(std::memory_order_relaxed);
+			if (position == m_writePosition.load(std::memory_order_acquire))
+			{
+				return nullptr;
+			}
+
+			return &m_records[position & (Capacity - 1)];
+		}
+		/// <summary>
+		/// Releases the record returned by <see cref="BeginRead"/>
+		/// </summary>
+		inline void EndRead()
+		{
+			m_readPosition.store(m_readPosition.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+		}
+
+		/// <summary>
+		/// Gets the number of records waiting to be read
+		/// </summary>
+		inline size_t GetSize() const
+		{
+			return m_writePosition.load(std::memory_order_relaxed) - m_readPosition.load(std::memory_order_relaxed);
+		}
+
+		/// <summary>
+		/// Marks this ring as no longer written to, as its thread has exited
+		/// </summary>
+		inline void Abandon()
+		{
+			m_isAbandoned.store(true, std::memory_order_release);
+		}
+		/// <summary>
+		/// Has this ring's thread exited?
+		/// </summary>
+		inline bool IsAbandoned() const
+		{
+			return m_isAbandoned.load(std::memory_order_acquire);
+		}
+
+		/// <summary>
+		/// Counter used by the owning thread when sampling messages
+		/// </summary>
+		inline unsigned int NextSample()
+		{
+			return m_sampleCounter++;
+		}
+
+	private:
+		// Records within this ring
+		LogRecord m_records[Capacity];
+		// Total records written
+		std::atomic<size_t> m_writePosition;
+		// Keeps the positions on separate cache lines, so the writer thread doesn't stall the producer
+		char m_padding[64];
+		// Total records read
+		std::atomic<size_t> m_readPosition;
+		// Has the writing thread exited?
+		std::atomic<bool> m_isAbandoned;
+		// Sampling counter, only used by the writing thread
+		unsigned int m_sampleCounter;
+	};
+}
@@ -0,0 +1,247 @@
+#pragma once
+
+// STL includes
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+// XP++ includes
+#include "XP++/Logging/LogCategory.hpp"
+#include "XP++/Logging/LogRecord.hpp"
+
+namespace XP
+{
+	/// <summary>
+	/// Counts the "{}" placeholders within a format string at compile time
+	/// </summary>
+	/// <param name="format">Format string to count</param>
+	/// <param name="count">Placeholders counted so far</param>
+	/// <returns>Number of placeholders within the format string</returns>
+	constexpr int CountLogPlaceholders(const char* format, int count = 0)
+	{
+		return format[0] == '\0' ? count :
+			   (format[0] == '{' && format[1] == '}') ? CountLogPlaceholders(format + 2, count + 1) :
+			   CountLogPlaceholders(format + 1, count);
+	}
+
+	/// <summary>
+	/// A format string, tagged with its placeholder count
+	/// </summary>
+	/// <remarks>
+	/// Created by the XP_LOG macros, so the number of placeholders can
+	/// be checked against the number of arguments at compile time.
+	/// </remarks>
+	template<int PlaceholderCount>
+	struct LogFormat
+	{
+		constexpr explicit LogFormat(const char* text) : text(text) {}
+
+		// Format string literal
+		const char* text;
+	};
+
+	/// <summary>
+	/// What to do with messages logged faster than they can be written
+	/// </summary>
+	enum class LogBackPressure : int
+	{
+		/// <summary>
+		/// Messages are dropped only once a thread's ring is full
+		/// </summary>
+		Drop	= 0,
+		/// <summary>
+		/// Once a thread's ring is half full, only every Nth message is kept
+		/// </summary>
+		Sample	= 1
+	};
+
+	/// <summary>
+	/// Asynchronous logger which never blocks the calling thread
+	/// </summary>
+	/// <remarks>
+	/// <para>
+	/// Logging a message only checks the category's level and rate limit, then
+	/// copies the format string pointer and arguments in binary form into a ring
+	/// owned by the calling thread. A background thread formats the messages and
+	/// writes them to the log file in batches, so no formatting, locking or disk
+	/// I/O happens on the sim thread.
+	/// </para>
+	/// <para>
+	/// Use the XP_LOG_* macros rather than <see cref="Write"/> directly; these
+	/// check the number of "{}" placeholders against the arguments at compile time.
+	/// </para>
+	/// <code>
+	/// static XP::LogCategory g_navLog("Navigation");
+	/// XP_LOG_INFO(g_navLog, "Loaded {} navaids in {} ms", count, milliseconds);
+	/// </code>
+	/// </remarks>
+	class Logger final
+	{
+	public:
+		/// <summary>
+		/// Starts the background writer, writing to the given file
+		/// </summary>
+		/// <param name="filePath">Path of the log file, which is truncated</param>
+		/// <returns>True if the file was opened and the writer started</returns>
+		static bool Start(std::string filePath);
+		/// <summary>
+		/// Writes all pending messages, then stops the background writer
+		/// </summary>
+		/// <remarks>
+		/// Every thread's ring is freed once written, so call this once no other thread is
+		/// logging (after stopping any <see cref="ThreadPool"/>), such as from
+		/// <see cref="UserPlugin::OnStop"/>.
+		/// </remarks>
+		static void Stop();
+		/// <summary>
+		/// Is the background writer running?
+		/// </summary>
+		/// <returns>True if messages are currently being written</returns>
+		static inline bool IsRunning()
+		{
+			return m_isRunning.load(std::memory_order_acquire);
+		}
+
+		/// <summary>
+		/// Releases the calling thread's ring, to be freed once everything within has been written
+		/// </summary>
+		/// <remarks>
+		/// Call this from threads which logged before they exit; rings aren't released
+		/// automatically, as a thread_local destructor would stop the plug-in from unloading.
+		/// A ring not released is freed by <see cref="Stop"/>.
+		/// </remarks>
+		static void ReleaseThreadRing();
+
+		/// <summary>
+		/// Sets what happens to messages logged faster than they can be written
+		/// </summary>
+		/// <param name="policy">Back-pressure policy</param>
+		/// <param name="sampleRate">When sampling, one of every sampleRate messages is kept</param>
+		static void SetBackPressure(LogBackPressure policy, unsigned int sampleRate = 8);
+
+		/// <summary>
+		/// Gets the number of messages dropped because a ring was full
+		/// </summary>
+		/// <returns>Total number of dropped messages</returns>
+		static inline uint64_t GetDroppedCount()
+		{
+			return m_droppedCount.load(std::memory_order_relaxed);
+		}
+		/// <summary>
+		/// Gets the number of messages discarded by sampling
+		/// </summary>
+		/// <returns>Total number of sampled out messages</returns>
+		static inline uint64_t GetSampledOutCount()
+		{
+			return m_sampledOutCount.load(std::memory_order_relaxed);
+		}
+
+		/// <summary>
+		/// Logs a message
+		/// </summary>
+		/// <remarks>
+		/// Use the XP_LOG_* macros instead of calling this directly.
+		/// </remarks>
+		/// <param name="category">Category to log to</param>
+		/// <param name="level">Level of the message</param>
+		/// <param name="format">Format string literal, using "{}" as placeholders</param>
+		/// <param name="arguments">Arguments to substitute into the placeholders</param>
+		template<int PlaceholderCount, typename... Arguments>
+		static inline void Write(LogCategory& category, LogLevel level,
+								 LogFormat<PlaceholderCount> format, const Arguments&... arguments)
+		{
+			static_assert(PlaceholderCount == sizeof...(Arguments),
+						  "Number of {} placeholders doesn't match the number of arguments");
+			static_assert(sizeof...(Arguments) <= LogRecord::MaxArguments,
+						  "Too many arguments for a single log message");
+
+			if (!IsRunning())
+			{
+				return;
+			}
+
+			int64_t timestamp = std::chrono::duration_cast<std::chrono::nanoseconds>(
+				std::chrono::steady_clock::now().time_since_epoch()).count();
+			if (!category.ShouldLog(level, timestamp))
+			{
+				return;
+			}
+
+			LogRing* ring = GetThreadRing();
+			if (ring == nullptr || !ShouldAccept(*ring))
+			{
+				return;
+			}
+
+			LogRecord* record = ring->BeginWrite();
+			if (record == nullptr)
+			{
+				m_droppedCount.fetch_add(1, std::memory_order_relaxed);
+				return;
+			}
+
+			record->timestamp		= timestamp;
+			record->category		= &category;
+			record->format			= format.text;
+			record->level			= level;
+			record->argumentCount	= 0;
+			record->textLength		= 0;
+			record->CaptureAll(arguments...);
+
+			ring->EndWrite();
+		}
+
+	private:
+		Logger()							= delete;
+		~Logger()							= delete;
+		Logger(const Logger&)				= delete;
+		Logger& operator=(const Logger&)	= delete;
+
+		// Is the background writer running?
+		static std::atomic<bool> m_isRunning;
+		// Back-pressure policy
+		static std::atomic<int> m_backPressure;
+		// Sampling rate, when sampling
+		static std::atomic<unsigned int> m_sampleRate;
+		// Messages dropped because a ring was full
+		static std::atomic<uint64_t> m_droppedCount;
+		// Messages discarded by sampling
+		static std::atomic<uint64_t> m_sampledOutCount;
+
+		// Gets (creating if needed) the calling thread's ring
+		static LogRing* GetThreadRing();
+
+		// Applies the sampling back-pressure policy
+		static inline bool ShouldAccept(LogRing& ring)
+		{
+			if (m_backPressure.load(std::memory_order_relaxed) != static_cast<int>(LogBackPressure::Sample) ||
+				ring.GetSize() < LogRing::Capacity / 2)
+			{
+				return true;
+			}
+
+			if (ring.NextSample() % m_sampleRate.load(std::memory_order_relaxed) == 0)
+			{
+				return true;
+			}
+
+			m_sampledOutCount.fetch_add(1, std::memory_order_relaxed);
+			return false;
+		}
+	};
+}
+
+/// <summary>
+/// Logs a message at the given level, checking the format string at compile time
+/// </summary>
+/// <param name="category">LogCategory to log to</param>
+/// <param name="level">LogLevel of the message</param>
+/// <param name="format">Format string literal, using "{}" as placeholders</param>
+#define XP_LOG(category, level, format, ...) \
+	::XP::Logger::Write((category), (level), ::XP::LogFormat<::XP::CountLogPlaceholders(format)>(format), ##__VA_ARGS__)
+
+#define XP_LOG_DEBUG(category, format, ...)		XP_LOG(category, ::XP::LogLevel::Debug, format, ##__VA_ARGS__)
+#define XP_LOG_INFO(category, format, ...)		XP_LOG(category, ::XP::LogLevel::Info, format, ##__VA_ARGS__)
+#define XP_LOG_WARNING(category, format, ...)	XP_LOG(category, ::XP::LogLevel::Warning, format, ##__VA_ARGS__)
+#define XP_LOG_ERROR(category, format, ...)		XP_LOG(category, ::XP::LogLevel::Error, format, ##__VA_ARGS__)
@@ -102,7 +102,7 @@ namespace XP
 		Message(int id, void* data);
 		~Message()									= default;
 		Message(const Message&)						= default;
-		Message& Message::operator=(const Message&) = default;
+		Message& operator=(const Message&) = default;
 
 		inline int GetID() const
 		{
@@ -0,0 +1,141 @@
+#pragma once
+
+// STL includes
+#include <cstdint>
+#include <functional>
+#include <utility>
+#include <vector>
+
+// XP++ includes
+#include "XP++/Diagnostics/TaggedAllocator.hpp"
+#include "XP++/Message.hpp"
+#include "XP++/Plugins/PluginID.hpp"
+
+namespace XP
+{
+	/// <summary>
+	/// Handles a message sent to the plug-in
+	/// </summary>
+	typedef std::function<void(PluginID from, const Message& message)> MessageHandler;
+
+	/// <summary>
+	/// Where a message handler runs
+	/// </summary>
+	enum class MessageDelivery : int
+	{
+		/// <summary>
+		/// On the sim thread, while X-Plane waits
+		/// </summary>
+		Immediate	= 0,
+		/// <summary>
+		/// On the shared <see cref="ThreadPool"/>, so X-Plane doesn't wait
+		/// </summary>
+		/// <remarks>
+		/// Deferred handlers must not call the X-Plane SDK, and only receive
+		/// the message's data pointer as a value; anything it points to may
+		/// be gone by the time the handler runs.
+		/// </remarks>
+		Deferred	= 1
+	};
+
+	/// <summary>
+	/// Identifies a subscription, to unsubscribe it
+	/// </summary>
+	typedef uint64_t MessageSubscriptionID;
+
+	/// <summary>
+	/// Routes messages received by the plug-in to the handlers subscribed to them
+	/// </summary>
+	/// <remarks>
+	/// <para>
+	/// Handlers subscribe to a single message ID, optionally only from one sender, so
+	/// only interested handlers run for each message. X-Plane's own messages are found by
+	/// direct indexing, and other messages by a binary search over a sorted table.
+	/// </para>
+	/// <para>
+	/// <see cref="REGISTER_PLUGIN"/> dispatches every message received, before calling
+	/// <see cref="UserPlugin::OnReceiveMessage"/>. Subscribe and unsubscribe from the sim
+	/// thread; handlers may do so while being dispatched.
+	/// </para>
+	/// </remarks>
+	class MessageDispatcher final
+	{
+	public:
+		/// <summary>
+		/// Subscribes a handler to an X-Plane message
+		/// </summary>
+		/// <param name="type">Type of message to handle</param>
+		/// <param name="handler">Handler to call</param>
+		/// <param name="delivery">Where the handler runs</param>
+		/// <param name="from">Only handle messages from this plug-in, or the null ID for any</param>
+		/// <returns>ID of the subscription</returns>
+		static MessageSubscriptionID Subscribe(XPLMMessageType type, MessageHandler handler,
+											   MessageDelivery delivery = MessageDelivery::Immediate,
+											   PluginID from = PluginID::GetNullID());
+		/// <summary>
+		/// Subscribes a handler to a message by ID, such as a plug-in defined message
+		/// </summary>
+		/// <param name="messageID">ID of the message to handle</param>
+		/// <param name="handler">Handler to call</param>
+		/// <param name="delivery">Where the handler runs</param>
+		/// <param name="from">Only handle messages from this plug-in, or the null ID for any</param>
+		/// <returns>ID of the subscription</returns>
+		static MessageSubscriptionID Subscribe(int messageID, MessageHandler handler,
+											   MessageDelivery delivery = MessageDelivery::Immediate,
+											   PluginID from = PluginID::GetNullID());
+		/// <summary>
+		/// Removes a subscription
+		/// </summary>
+		/// <param name="subscriptionID">ID returned when subscribing</param>
+		static void Unsubscribe(MessageSubscriptionID subscriptionID);
+		/// <summary>
+		/// Removes every subscription
+		/// </summary>
+		static void Clear();
+
+		/// <summary>
+		/// Calls every handler subscribed to a message
+		/// </summary>
+		/// <param name="from">ID of the plug-in which sent the message</param>
+		/// <param name="messageID">ID of the message</param>
+		/// <param name="param">Data sent with the message</param>
+		static void Dispatch(int from, int messageID, void* param);
+
+	private:
+		MessageDispatcher()										= delete;
+		~MessageDispatcher()									= delete;
+		MessageDispatcher(const MessageDispatcher&)				= delete;
+		MessageDispatcher& operator=(const MessageDispatcher&)	= delete;
+
+		// A subscribed handler
+		struct Subscriber
+		{
+			MessageSubscriptionID id;
+			MessageHandler handler;
+			MessageDelivery delivery;
+			int from;
+		};
+		typedef std::vector<Subscriber, TaggedAllocator<Subscriber, MemoryTag::Messages>> SubscriberList;
+
+		// First message ID sent by X-Plane
+		static const int FirstXPlaneMessage = static_cast<int>(XPLMMessageType::PlaneCrashed);
+		// Number of messages sent by X-Plane
+		static const int XPlaneMessageCount = static_cast<int>(XPLMMessageType::ExitingVR) - FirstXPlaneMessage + 1;
+
+		// Subscribers to X-Plane's messages, indexed by message ID
+		static SubscriberList m_xplaneSubscribers[XPlaneMessageCount];
+		// Subscribers to other messages, sorted by message ID
+		static std::vector<std::pair<int, SubscriberList>, TaggedAllocator<std::pair<int, SubscriberList>, MemoryTag::Messages>> m_otherSubscribers;
+		// Last subscription ID handed out
+		static MessageSubscriptionID m_lastSubscriptionID;
+		// Number of dispatches in progress
+		static int m_dispatchDepth;
+		// Were subscribers removed during a dispatch?
+		static bool m_hasRemovedSubscribers;
+
+		// Finds the subscribers to a message, creating the list if requested
+		static SubscriberList* FindSubscribers(int messageID, bool create);
+		// Removes unsubscribed handlers, once no dispatch is in progress
+		static void RemoveUnsubscribed();
+	};
+}
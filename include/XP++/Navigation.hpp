@@ -0,0 +1,4 @@
+#pragma once
+
+#include "Navigation/NavDatabase.hpp"
+#include "Navigation/NavSnapshot.hpp"
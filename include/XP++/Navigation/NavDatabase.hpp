@@ -0,0 +1,80 @@
+#pragma once
+
+// STL includes
+#include <cstdint>
+#include <memory>
+#include <string>
+
+// XP++ includes
+#include "XP++/Navigation/NavSnapshot.hpp"
+
+namespace XP
+{
+	/// <summary>
+	/// Snapshots X-Plane's navaid database for fast spatial queries
+	/// </summary>
+	/// <remarks>
+	/// <para>
+	/// Call <see cref="Load"/> from the sim thread once scenery has loaded
+	/// (on <see cref="XPLMMessageType::SceneryLoaded"/>), which reads every navaid
+	/// through the SDK once. Queries are then answered from the snapshot.
+	/// </para>
+	/// <para>
+	/// Snapshots are immutable and reference counted, so any thread may take
+	/// one with <see cref="GetSnapshot"/> and query it while a newer one is loaded.
+	/// </para>
+	/// <para>
+	/// To keep the snapshot across <see cref="Plugins::Reload"/>, <see cref="Save"/> it from
+	/// <see cref="UserPlugin::OnStop"/> and <see cref="Attach"/> to it from
+	/// <see cref="UserPlugin::OnStart"/>, only calling <see cref="Load"/> if that fails.
+	/// </para>
+	/// </remarks>
+	class NavDatabase final
+	{
+	public:
+		/// <summary>
+		/// Reads every navaid from X-Plane into a new snapshot, replacing the current one
+		/// </summary>
+		/// <remarks>
+		/// Must be called from the sim thread.
+		/// </remarks>
+		/// <returns>The new snapshot</returns>
+		static std::shared_ptr<const NavSnapshot> Load();
+		/// <summary>
+		/// Saves the current snapshot through a <see cref="StateHandoff"/>, for the next instance of the plug-in
+		/// </summary>
+		/// <param name="filePath">Path of the file to save to</param>
+		/// <param name="versionHash">Hash of what the navaids depend on, such as the navigation data cycle</param>
+		/// <returns>True if saved, otherwise false (no snapshot is loaded, or the reason being logged)</returns>
+		static bool Save(const std::string& filePath, uint64_t versionHash);
+		/// <summary>
+		/// Attaches to a snapshot saved by a previous instance of the plug-in, replacing the current one
+		/// </summary>
+		/// <remarks>
+		/// The snapshot's arrays are used in place within the mapped file, so nothing is rebuilt.
+		/// </remarks>
+		/// <param name="filePath">Path of the file the snapshot was saved to</param>
+		/// <param name="versionHash">Hash the snapshot was saved with</param>
+		/// <returns>The attached snapshot, or NULL if none was saved with the same version</returns>
+		static std::shared_ptr<const NavSnapshot> Attach(const std::string& filePath, uint64_t versionHash);
+		/// <summary>
+		/// Releases the current snapshot
+		/// </summary>
+		static void Unload();
+
+		/// <summary>
+		/// Gets the current snapshot, from any thread
+		/// </summary>
+		/// <returns>Current snapshot, or NULL if none has been loaded</returns>
+		static std::shared_ptr<const NavSnapshot> GetSnapshot();
+
+	private:
+		NavDatabase()								= delete;
+		~NavDatabase()								= delete;
+		NavDatabase(const NavDatabase&)				= delete;
+		NavDatabase& operator=(const NavDatabase&)	= delete;
+
+		// Current snapshot, only accessed atomically
+		static std::shared_ptr<const NavSnapshot> m_snapshot;
+	};
+}
@@ -0,0 +1,197 @@
+#pragma once
+
+// STL includes
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+// XP++ includes
+#include "XP++/Plugins/StateHandoff.hpp"
+
+namespace XP
+{
+	/// <summary>
+	/// Type of a navaid, which can be combined to match several types
+	/// </summary>
+	enum class NavAidType : int
+	{
+		Unknown			= 0,
+		Airport			= 1,
+		NDB				= 2,
+		VOR				= 4,
+		ILS				= 8,
+		Localizer		= 16,
+		GlideSlope		= 32,
+		OuterMarker		= 64,
+		MiddleMarker	= 128,
+		InnerMarker		= 256,
+		Fix				= 512,
+		DME				= 1024,
+		LatLon			= 2048,
+		/// <summary>
+		/// Matches every type
+		/// </summary>
+		All				= 4095
+	};
+
+	inline NavAidType operator|(NavAidType lhs, NavAidType rhs)
+	{
+		return static_cast<NavAidType>(static_cast<int>(lhs) | static_cast<int>(rhs));
+	}
+	inline NavAidType operator&(NavAidType lhs, NavAidType rhs)
+	{
+		return static_cast<NavAidType>(static_cast<int>(lhs) & static_cast<int>(rhs));
+	}
+
+	/// <summary>
+	/// A navaid found by a spatial query
+	/// </summary>
+	struct NavAidMatch
+	{
+		// Index of the navaid within the snapshot
+		int index;
+		// Great circle distance to the navaid, in meters
+		float distance;
+	};
+
+	/// <summary>
+	/// Immutable copy of X-Plane's navaid database, indexed for spatial queries
+	/// </summary>
+	/// <remarks>
+	/// <para>
+	/// Navaids are stored as one array per field, grouped by type, and each type's
+	/// navaids are ordered as an implicit k-d tree over their positions as unit
+	/// vectors, so queries need no projection and work across the poles and the
+	/// antimeridian.
+	/// </para>
+	/// <para>
+	/// A snapshot is never modified once built, so it can be queried from any thread.
+	/// It can be handed to the next instance of the plug-in with <see cref="Save"/>,
+	/// which then attaches to the arrays in place instead of rebuilding them.
+	/// </para>
+	/// </remarks>
+	class NavSnapshot final
+	{
+	public:
+		/// <summary>
+		/// A navaid as read from X-Plane, used to build a snapshot
+		/// </summary>
+		struct Entry
+		{
+			NavAidType type;
+			float latitude;
+			float longitude;
+			float elevation;
+			int frequency;
+			float heading;
+			int navRef;
+			std::string id;
+			std::string name;
+		};
+
+		/// <summary>
+		/// Builds a snapshot from the given navaids
+		/// </summary>
+		/// <param name="entries">Navaids to include, reordered while building</param>
+		NavSnapshot(std::vector<Entry> entries);
+		/// <summary>
+		/// Attaches to a snapshot written by <see cref="Save"/>, without copying it
+		/// </summary>
+		/// <remarks>
+		/// Throws an <see cref="XPException"/> if the handed off snapshot is invalid.
+		/// </remarks>
+		/// <param name="reader">Reader of the handed off state, positioned at the snapshot</param>
+		NavSnapshot(HandoffReader& reader);
+		~NavSnapshot()								= default;
+
+		NavSnapshot(const NavSnapshot&)				= delete;
+		NavSnapshot& operator=(const NavSnapshot&)	= delete;
+
+		/// <summary>
+		/// Gets the number of navaids within this snapshot
+		/// </summary>
+		/// <returns>Number of navaids</returns>
+		inline int GetCount() const
+		{
+			return static_cast<int>(m_type.size);
+		}
+
+		/// <summary>
+		/// Writes this snapshot, to be attached to by the next instance of the plug-in
+		/// </summary>
+		/// <param name="writer">Writer of the handed off state</param>
+		void Save(HandoffWriter& writer) const;
+
+		// Fields of the navaid at the given index
+		inline NavAidType GetType(int index) const		{ return m_type[index]; }
+		inline float GetLatitude(int index) const		{ return m_latitude[index]; }
+		inline float GetLongitude(int index) const		{ return m_longitude[index]; }
+		inline float GetElevation(int index) const		{ return m_elevation[index]; }
+		inline int GetFrequency(int index) const		{ return m_frequency[index]; }
+		inline float GetHeading(int index) const		{ return m_heading[index]; }
+		inline int GetNavRef(int index) const			{ return m_navRef[index]; }
+		inline const char* GetID(int index) const		{ return m_text.data + m_idOffset[index]; }
+		inline const char* GetName(int index) const		{ return m_text.data + m_nameOffset[index]; }
+
+		/// <summary>
+		/// Finds the navaids closest to a position
+		/// </summary>
+		/// <param name="latitude">Latitude to search from, in degrees</param>
+		/// <param name="longitude">Longitude to search from, in degrees</param>
+		/// <param name="count">Maximum number of navaids to find</param>
+		/// <param name="types">Types of navaid to find</param>
+		/// <returns>Navaids found, closest first</returns>
+		std::vector<NavAidMatch> FindNearest(double latitude, double longitude, int count,
+											 NavAidType types = NavAidType::All) const;
+		/// <summary>
+		/// Finds every navaid within a distance of a position
+		/// </summary>
+		/// <param name="latitude">Latitude to search from, in degrees</param>
+		/// <param name="longitude">Longitude to search from, in degrees</param>
+		/// <param name="radius">Distance to search within, in meters</param>
+		/// <param name="types">Types of navaid to find</param>
+		/// <returns>Navaids found, closest first</returns>
+		std::vector<NavAidMatch> FindWithinRadius(double latitude, double longitude, double radius,
+												  NavAidType types = NavAidType::All) const;
+
+	private:
+		// Number of distinct navaid types (bits of NavAidType)
+		static const int TypeCount = 12;
+
+		// Arrays of a snapshot built from entries
+		struct Storage;
+
+		// Owner of the arrays, either the storage they were built in or the mapped file they were handed off in
+		std::shared_ptr<const void> m_storage;
+
+		// Navaid fields
+		HandoffArray<NavAidType> m_type;
+		HandoffArray<float> m_latitude;
+		HandoffArray<float> m_longitude;
+		HandoffArray<float> m_elevation;
+		HandoffArray<int> m_frequency;
+		HandoffArray<float> m_heading;
+		HandoffArray<int> m_navRef;
+		HandoffArray<uint32_t> m_idOffset;
+		HandoffArray<uint32_t> m_nameOffset;
+		// IDs and names, null terminated
+		HandoffArray<char> m_text;
+
+		// Positions as unit vectors, in k-d tree order
+		HandoffArray<float> m_pointX;
+		HandoffArray<float> m_pointY;
+		HandoffArray<float> m_pointZ;
+		// Axis each k-d tree node splits on
+		HandoffArray<uint8_t> m_splitAxis;
+		// First and one past the last index of each type's k-d tree
+		int m_typeBegin[TypeCount];
+		int m_typeEnd[TypeCount];
+
+		// Orders the entries between begin and end as a k-d tree
+		static void BuildTree(std::vector<int>& order, const std::vector<float>* points, std::vector<uint8_t>& splitAxis, int begin, int end);
+		// Visits every point of a k-d tree closer than the visitor's current limit
+		template<typename Visitor>
+		void VisitTree(const float* query, int begin, int end, Visitor& visitor) const;
+	};
+}
@@ -1,18 +1,63 @@
 #pragma once
 
+// STL includes
+#include <functional>
+
 namespace XP
 {
 	class PluginID;
 
+	/// <summary>
+	/// Provides control over X-Plane's multiplayer and AI aircraft
+	/// </summary>
 	class Planes final
 	{
 	public:
-		static void Count(int& totalAircraft, int& activeAircraft, PluginID controller);
+		/// <summary>
+		/// Counts the aircraft X-Plane currently has loaded
+		/// </summary>
+		/// <param name="totalAircraft">Receives the number of aircraft, including the user's</param>
+		/// <param name="activeAircraft">Receives the number of aircraft currently being drawn</param>
+		/// <param name="controller">Receives the plug-in controlling the aircraft, or the null ID</param>
+		static void Count(int& totalAircraft, int& activeAircraft, PluginID& controller);
+
+		/// <summary>
+		/// Takes exclusive control of the multiplayer aircraft
+		/// </summary>
+		/// <remarks>
+		/// If another plug-in has the aircraft, false is returned and
+		/// onAvailable is called once they have been released, at which
+		/// point acquiring them can be tried again.
+		/// </remarks>
+		/// <param name="onAvailable">Called once the aircraft become available, may be NULL</param>
+		/// <returns>True if the aircraft were acquired</returns>
+		static bool Acquire(std::function<void()> onAvailable);
+		/// <summary>
+		/// Releases control of the multiplayer aircraft
+		/// </summary>
+		static void Release();
+
+		/// <summary>
+		/// Sets how many aircraft X-Plane draws, which must have been acquired
+		/// </summary>
+		/// <param name="count">Number of aircraft, including the user's</param>
+		static void SetActiveCount(int count);
+		/// <summary>
+		/// Stops X-Plane's AI from flying the given aircraft
+		/// </summary>
+		/// <param name="index">Index of the aircraft, 1 being the first non-user aircraft</param>
+		static void DisableAI(int index);
 
 	private:
-		Planes()									= delete;
-		~Planes()									= delete;
-		Planes(const Planes&)						= delete;
-		Planes& Planes::operator=(const Planes&)	= delete;
+		Planes()							= delete;
+		~Planes()							= delete;
+		Planes(const Planes&)				= delete;
+		Planes& operator=(const Planes&)	= delete;
+
+		// Called once the aircraft have been released by another plug-in
+		static std::function<void()> m_onAvailable;
+
+		// X-Plane callback for when the aircraft become available
+		static void PlanesAvailableCallback(void* inRefcon);
 	};
 }
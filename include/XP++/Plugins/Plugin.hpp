@@ -25,7 +25,7 @@ namespace XP
 		Plugin(int id) : m_id(id) {}
 		~Plugin()											= default;
 		Plugin(const Plugin&)								= default;
-		Plugin& Plugin::operator=(const Plugin&)			= default;
+		Plugin& operator=(const Plugin&)			= default;
 
 		PluginInfo GetInfo() const;
 
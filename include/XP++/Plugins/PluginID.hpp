@@ -27,10 +27,29 @@ namespace XP
 			return PluginID(-1);
 		}
 
-		inline int GetIndex() const;
+		/// <summary>
+		/// Gets the internal X-Plane ID of this plugin
+		/// </summary>
+		/// <returns>Internal X-Plane ID, or -1 for the null ID</returns>
+		inline int GetIndex() const
+		{
+			return m_id;
+		}
 
-		inline bool PluginID::operator==(const PluginID& rhs);
-		inline bool PluginID::operator!=(const PluginID& rhs)
+		/// <summary>
+		/// Is this the null ID, referring to no plug-in?
+		/// </summary>
+		/// <returns>True if this ID doesn't refer to a plug-in</returns>
+		inline bool IsNull() const
+		{
+			return m_id < 0;
+		}
+
+		inline bool operator==(const PluginID& rhs) const
+		{
+			return m_id == rhs.m_id;
+		}
+		inline bool operator!=(const PluginID& rhs) const
 		{
 			return !((*this) == rhs);
 		}
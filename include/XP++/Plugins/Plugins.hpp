@@ -65,7 +65,8 @@ namespace XP
 		/// you were within (e.g. a menu select callback) you will receive
 		/// your <see cref="Plugin::Disable"/> and <see cref="Plugin::Stop"/>
 		/// callbacks and your DLL will be unloaded, then the start process 
-		/// happens as if the sim was starting up.
+		/// happens as if the sim was starting up. Use <see cref="StateHandoff"/>
+		/// to keep expensive caches across the reload.
 		/// </remarks>
 		static void Reload();
 
@@ -126,6 +127,6 @@ namespace XP
 		Plugins()									= delete;
 		~Plugins()									= delete;
 		Plugins(const Plugins&)						= delete;
-		Plugins& Plugins::operator=(const Plugins&) = delete;
+		Plugins& operator=(const Plugins&) = delete;
 	};
 }
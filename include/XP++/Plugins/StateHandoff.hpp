@@ -0,0 +1,281 @@
+#pragma once
+
+// STL includes
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+// XP++ includes
+#include "XP++/Exceptions/XPException.hpp"
+
+namespace XP
+{
+	/// <summary>
+	/// Writes the state handed to the next instance of the plug-in
+	/// </summary>
+	/// <remarks>
+	/// Values are written as raw bytes, so only trivially copyable types without
+	/// pointers can be written; store offsets or indices instead of pointers.
+	/// </remarks>
+	class HandoffWriter final
+	{
+	public:
+		/// <summary>
+		/// Writes raw bytes
+		/// </summary>
+		/// <param name="data">Bytes to write</param>
+		/// <param name="size">Number of bytes to write</param>
+		/// <param name="alignment">Alignment of the bytes within the file, a power of 2</param>
+		void Write(const void* data, size_t size, size_t alignment = 1);
+
+		/// <summary>
+		/// Writes a single value
+		/// </summary>
+		/// <param name="value">Value to write</param>
+		template<typename T>
+		inline void WriteValue(const T& value)
+		{
+			static_assert(std::is_trivially_copyable<T>::value, "Only trivially copyable types can be handed off");
+			Write(&value, sizeof(T), alignof(T));
+		}
+		/// <summary>
+		/// Writes an array of values, preceded by its size
+		/// </summary>
+		/// <param name="values">Values to write</param>
+		/// <param name="count">Number of values to write</param>
+		template<typename T>
+		inline void WriteArray(const T* values, size_t count)
+		{
+			static_assert(std::is_trivially_copyable<T>::value, "Only trivially copyable types can be handed off");
+			WriteValue<uint64_t>(count);
+			Write(values, count * sizeof(T), alignof(T) > 8 ? alignof(T) : 8);
+		}
+		/// <summary>
+		/// Writes an array of values, preceded by its size
+		/// </summary>
+		/// <param name="values">Values to write</param>
+		template<typename T>
+		inline void WriteArray(const std::vector<T>& values)
+		{
+			WriteArray(values.data(), values.size());
+		}
+		/// <summary>
+		/// Writes a string, preceded by its length
+		/// </summary>
+		/// <param name="value">String to write</param>
+		inline void WriteString(const std::string& value)
+		{
+			WriteArray(value.data(), value.size());
+		}
+
+		/// <summary>
+		/// Gets the number of bytes written so far
+		/// </summary>
+		/// <returns>Number of bytes written</returns>
+		inline uint64_t GetSize() const
+		{
+			return m_offset;
+		}
+
+	private:
+		friend class StateHandoff;
+
+		HandoffWriter(FILE* file, uint64_t offset);
+		~HandoffWriter() = default;
+
+		HandoffWriter(const HandoffWriter&)				= delete;
+		HandoffWriter& operator=(const HandoffWriter&)	= delete;
+
+		// File being written
+		FILE* m_file;
+		// Offset of the next byte within the file
+		uint64_t m_offset;
+	};
+
+	/// <summary>
+	/// Array within handed off state, pointing directly into the mapped file
+	/// </summary>
+	template<typename T>
+	struct HandoffArray
+	{
+		/// <summary>
+		/// First value of the array
+		/// </summary>
+		const T* data;
+		/// <summary>
+		/// Number of values within the array
+		/// </summary>
+		size_t size;
+
+		inline const T* begin() const				{ return data; }
+		inline const T* end() const					{ return data + size; }
+		inline const T& operator[](size_t i) const	{ return data[i]; }
+	};
+
+	/// <summary>
+	/// Reads the state handed over by the previous instance of the plug-in, without copying it
+	/// </summary>
+	/// <remarks>
+	/// Values are read in the same order they were written. Arrays and strings point
+	/// into the mapped file, and remain valid while the reader, or the mapping from
+	/// <see cref="GetMapping"/>, is kept alive. Pages are only loaded from the file as
+	/// they're first touched.
+	/// </remarks>
+	class HandoffReader final
+	{
+	public:
+		/// <summary>
+		/// Reads raw bytes
+		/// </summary>
+		/// <param name="size">Number of bytes to read</param>
+		/// <param name="alignment">Alignment the bytes were written with</param>
+		/// <returns>Pointer to the bytes within the mapped file</returns>
+		const void* Read(size_t size, size_t alignment = 1);
+
+		/// <summary>
+		/// Reads a single value
+		/// </summary>
+		/// <returns>Value read</returns>
+		template<typename T>
+		inline T ReadValue()
+		{
+			static_assert(std::is_trivially_copyable<T>::value, "Only trivially copyable types can be handed off");
+			return *static_cast<const T*>(Read(sizeof(T), alignof(T)));
+		}
+		/// <summary>
+		/// Reads an array of values, written by <see cref="HandoffWriter::WriteArray"/>
+		/// </summary>
+		/// <returns>Array pointing into the mapped file</returns>
+		template<typename T>
+		inline HandoffArray<T> ReadArray()
+		{
+			static_assert(std::is_trivially_copyable<T>::value, "Only trivially copyable types can be handed off");
+			uint64_t count = ReadValue<uint64_t>();
+			if (count > (m_size - m_offset) / sizeof(T))
+			{
+				throw XPException("Handed off array is larger than the file");
+			}
+
+			HandoffArray<T> values;
+			values.data = static_cast<const T*>(Read(static_cast<size_t>(count) * sizeof(T), alignof(T) > 8 ? alignof(T) : 8));
+			values.size = static_cast<size_t>(count);
+			return values;
+		}
+		/// <summary>
+		/// Reads a string, written by <see cref="HandoffWriter::WriteString"/>
+		/// </summary>
+		/// <returns>Copy of the string</returns>
+		inline std::string ReadString()
+		{
+			HandoffArray<char> text = ReadArray<char>();
+			return std::string(text.data, text.size);
+		}
+
+		/// <summary>
+		/// Checks if every value has been read
+		/// </summary>
+		/// <returns>True if at the end of the state, otherwise false</returns>
+		inline bool IsAtEnd() const
+		{
+			return m_offset == m_size;
+		}
+		/// <summary>
+		/// Gets the mapped file, to keep arrays read from it valid after the reader is released
+		/// </summary>
+		/// <returns>Mapped file, unmapped once no longer referenced</returns>
+		inline std::shared_ptr<const void> GetMapping() const
+		{
+			return m_mapping;
+		}
+
+	private:
+		friend class StateHandoff;
+
+		HandoffReader(std::shared_ptr<const char> mapping, size_t size, size_t offset);
+
+		HandoffReader(const HandoffReader&)				= delete;
+		HandoffReader& operator=(const HandoffReader&)	= delete;
+
+		// Mapped file
+		std::shared_ptr<const char> m_mapping;
+		// Size of the mapped file
+		size_t m_size;
+		// Offset of the next byte to read
+		size_t m_offset;
+	};
+
+	/// <summary>
+	/// Hands large, immutable state over to the next instance of the plug-in through a mapped file
+	/// </summary>
+	/// <remarks>
+	/// <para>
+	/// Rebuilding caches such as navaid indices or terrain heights on every start makes
+	/// reloading a plug-in slow. Instead, <see cref="Save"/> them from <see cref="UserPlugin::OnStop"/>,
+	/// and <see cref="Attach"/> to them from <see cref="UserPlugin::OnStart"/>. Attaching maps the
+	/// file read-only instead of reading it, so only the pages used are ever loaded.
+	/// </para>
+	/// <para>
+	/// State is only attached if it was saved with the same version hash. Build the hash
+	/// from everything the state depends on (format of the state, plug-in version, navigation
+	/// data cycle, etc.) with <see cref="HashVersion"/>.
+	/// </para>
+	/// <para>
+	/// The file is replaced as a single step, so a crash while saving leaves the previous
+	/// state. On Windows a file can't be replaced while it's mapped, so release readers
+	/// attached to the file before saving over it.
+	/// </para>
+	/// </remarks>
+	/// <code>
+	/// uint64_t version = XP::StateHandoff::HashVersion("nav v3", XP::StateHandoff::HashVersion(airacCycle));
+	/// std::shared_ptr&lt;XP::HandoffReader&gt; state = XP::StateHandoff::Attach(path, version);
+	/// if (state != nullptr)
+	/// {
+	///		XP::HandoffArray&lt;float&gt; latitudes = state->ReadArray&lt;float&gt;();
+	/// }
+	/// </code>
+	class StateHandoff final
+	{
+	public:
+		/// <summary>
+		/// Combines text into a version hash
+		/// </summary>
+		/// <param name="text">Text to hash</param>
+		/// <param name="hash">Hash to combine with</param>
+		/// <returns>Combined hash</returns>
+		static uint64_t HashVersion(const std::string& text, uint64_t hash = 14695981039346656037ull);
+
+		/// <summary>
+		/// Saves state to a file, replacing any state previously saved there
+		/// </summary>
+		/// <param name="filePath">Path of the file to save to</param>
+		/// <param name="versionHash">Hash identifying the version of the state</param>
+		/// <param name="serialize">Writes the state</param>
+		/// <returns>True if saved, otherwise false (the reason being logged)</returns>
+		static bool Save(const std::string& filePath, uint64_t versionHash, std::function<void(HandoffWriter&)> serialize);
+		/// <summary>
+		/// Attaches to state saved by a previous instance of the plug-in
+		/// </summary>
+		/// <param name="filePath">Path of the file the state was saved to</param>
+		/// <param name="versionHash">Hash identifying the version of the state</param>
+		/// <returns>
+		/// Reader of the state, or NULL if there's no state or
+		/// it was saved by a different version
+		/// </returns>
+		static std::shared_ptr<HandoffReader> Attach(const std::string& filePath, uint64_t versionHash);
+		/// <summary>
+		/// Deletes saved state, so it isn't attached to again
+		/// </summary>
+		/// <param name="filePath">Path of the file the state was saved to</param>
+		static void Discard(const std::string& filePath);
+
+	private:
+		StateHandoff()								= delete;
+		~StateHandoff()								= delete;
+		StateHandoff(const StateHandoff&)			= delete;
+		StateHandoff& operator=(const StateHandoff&) = delete;
+	};
+}
@@ -0,0 +1,189 @@
+#pragma once
+
+// STL includes
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+// XP++ includes
+#include "XP++/Processing/ThreadPool.hpp"
+
+namespace XP
+{
+	/// <summary>
+	/// Thread a subsystem starts on
+	/// </summary>
+	enum class SubsystemThread : int
+	{
+		/// <summary>
+		/// On the thread pool, in parallel with other subsystems. Must not call the X-Plane SDK
+		/// </summary>
+		Worker	= 0,
+		/// <summary>
+		/// On the sim thread, which may call the X-Plane SDK
+		/// </summary>
+		Sim		= 1
+	};
+
+	/// <summary>
+	/// Outcome of starting a subsystem
+	/// </summary>
+	enum class SubsystemStatus : int
+	{
+		/// <summary>
+		/// Not started yet
+		/// </summary>
+		Pending		= 0,
+		/// <summary>
+		/// Started successfully
+		/// </summary>
+		Started		= 1,
+		/// <summary>
+		/// Threw while starting
+		/// </summary>
+		Failed		= 2,
+		/// <summary>
+		/// Not started, as a dependency didn't start
+		/// </summary>
+		Skipped		= 3
+	};
+
+	/// <summary>
+	/// Startup timing of a subsystem
+	/// </summary>
+	struct SubsystemTiming
+	{
+		/// <summary>
+		/// Name of the subsystem
+		/// </summary>
+		std::string name;
+		/// <summary>
+		/// Thread the subsystem started on
+		/// </summary>
+		SubsystemThread thread;
+		/// <summary>
+		/// Outcome of starting the subsystem
+		/// </summary>
+		SubsystemStatus status;
+		/// <summary>
+		/// Time from the registry starting until the subsystem started
+		/// </summary>
+		std::chrono::microseconds offset;
+		/// <summary>
+		/// Time the subsystem took to start
+		/// </summary>
+		std::chrono::microseconds duration;
+		/// <summary>
+		/// What went wrong, if the subsystem failed
+		/// </summary>
+		std::string error;
+	};
+
+	/// <summary>
+	/// Starts a plug-in's subsystems in dependency order, running independent ones in parallel
+	/// </summary>
+	/// <remarks>
+	/// <para>
+	/// Each subsystem declares the subsystems it depends on and which thread it needs.
+	/// <see cref="Start"/> runs a subsystem once all its dependencies have started. Worker
+	/// subsystems (loading files, building databases) run in parallel on a thread pool, while
+	/// sim subsystems (finding datarefs, building menus) run in order on the calling thread,
+	/// overlapping with the workers.
+	/// </para>
+	/// <para>
+	/// Call <see cref="Start"/> from <see cref="UserPlugin::OnStart"/> or
+	/// <see cref="UserPlugin::OnEnable"/>, and <see cref="Stop"/> from the matching
+	/// <see cref="UserPlugin::OnStop"/> or <see cref="UserPlugin::OnDisable"/>.
+	/// </para>
+	/// </remarks>
+	class SubsystemRegistry final
+	{
+	public:
+		/// <summary>
+		/// Creates an empty subsystem registry
+		/// </summary>
+		/// <returns>Created subsystem registry</returns>
+		static std::shared_ptr<SubsystemRegistry> Create();
+
+		/// <summary>
+		/// Adds a subsystem
+		/// </summary>
+		/// <remarks>
+		/// Dependencies may be added after the subsystems depending on them, as
+		/// they're only resolved by <see cref="Start"/>.
+		/// </remarks>
+		/// <param name="name">Unique name of the subsystem</param>
+		/// <param name="dependencies">Names of the subsystems which must start first</param>
+		/// <param name="thread">Thread the subsystem starts on</param>
+		/// <param name="start">Starts the subsystem, throwing if it fails</param>
+		/// <param name="stop">Stops the subsystem on the sim thread, or NULL if there's nothing to stop</param>
+		void Add(std::string name, std::vector<std::string> dependencies, SubsystemThread thread,
+				 std::function<void()> start, std::function<void()> stop = nullptr);
+
+		/// <summary>
+		/// Starts every subsystem, returning once all have started or been skipped
+		/// </summary>
+		/// <remarks>
+		/// A subsystem which throws is marked failed, and the subsystems depending on it
+		/// are skipped; the others still start. Throws if a dependency isn't registered or
+		/// the dependencies form a cycle, before any subsystem starts. Call <see cref="Stop"/>
+		/// before starting again, even if this failed.
+		/// </remarks>
+		/// <param name="threadPool">Pool running the worker subsystems, or NULL for the shared pool</param>
+		/// <returns>True if every subsystem started, otherwise false</returns>
+		bool Start(std::shared_ptr<ThreadPool> threadPool = nullptr);
+		/// <summary>
+		/// Stops the started subsystems, in the reverse order they started
+		/// </summary>
+		void Stop();
+
+		/// <summary>
+		/// Gets the startup timing of each subsystem, in the order they were added
+		/// </summary>
+		/// <returns>Startup timing of each subsystem</returns>
+		std::vector<SubsystemTiming> GetTimings() const;
+		/// <summary>
+		/// Gets the time the last <see cref="Start"/> took
+		/// </summary>
+		/// <returns>Time the last start took</returns>
+		inline std::chrono::microseconds GetStartDuration() const
+		{
+			return m_startDuration;
+		}
+		/// <summary>
+		/// Formats the startup timings as a human readable report
+		/// </summary>
+		/// <returns>Report with a line per subsystem, in the order they started</returns>
+		std::string GetReport() const;
+
+	private:
+		SubsystemRegistry();
+		~SubsystemRegistry() = default;
+
+		SubsystemRegistry(const SubsystemRegistry&)				= delete;
+		SubsystemRegistry& operator=(const SubsystemRegistry&)	= delete;
+
+		// A registered subsystem
+		struct Subsystem
+		{
+			std::vector<std::string> dependencyNames;
+			std::function<void()> start;
+			std::function<void()> stop;
+			// Indices of the subsystems depending on this one, resolved when starting
+			std::vector<size_t> dependents;
+			SubsystemTiming timing;
+		};
+
+		// Registered subsystems, in the order they were added
+		std::vector<Subsystem> m_subsystems;
+		// Indices of the started subsystems, in the order they started
+		std::vector<size_t> m_startOrder;
+		// Time the last start took
+		std::chrono::microseconds m_startDuration;
+
+		// Resolves dependencies into dependents, returning the number of dependencies of each subsystem
+		std::vector<size_t> ResolveDependencies();
+	};
+}
@@ -1,4 +1,10 @@
 #pragma once
 
 #include "Processing/FlightLoop.hpp"
+#include "Processing/FrameLoop.hpp"
+#include "Processing/FrameScheduler.hpp"
+#include "Processing/FrameTiming.hpp"
+#include "Processing/LoadShedder.hpp"
+#include "Processing/ThreadPool.hpp"
+#include "Processing/TimerWheel.hpp"
 #include "Processing/Timing.hpp"
@@ -5,6 +5,9 @@
 #include <memory>
 #include <list>
 
+// XP++ includes
+#include "XP++/Diagnostics/TaggedAllocator.hpp"
+
 namespace XP
 {
 	/// <summary>
@@ -55,7 +58,7 @@ namespace XP
 	/// you can use a post-flight loop callback to update your own off-screen FBOs.)
 	/// </para>
 	/// </remarks>
-	class FlightLoop
+	class FlightLoop : public TaggedObject<MemoryTag::FlightLoops>
 	{
 	public:
 		/// <summary>
@@ -123,5 +126,13 @@ namespace XP
 		void* m_id;
 		// Function to be called by this FlightLoop
 		std::function<float(float, float, int)> m_callback;
+		// Interval last returned by the callback, reused if the callback throws
+		float m_lastInterval;
+
+		// X-Plane flight loop callback shared by every FlightLoop
+		static float FlightLoopCallback(float inElapsedSinceLastCall,
+										float inElapsedTimeSinceLastFlightLoop,
+										int inCounter,
+										void* inRefcon);
 	};
 }
@@ -0,0 +1,59 @@
+#pragma once
+
+// STL includes
+#include <functional>
+#include <memory>
+
+// XP++ includes
+#include "XP++/Processing/FlightLoop.hpp"
+
+namespace XP
+{
+	/// <summary>
+	/// Flight loop calling back every frame on behalf of the object owning it
+	/// </summary>
+	/// <remarks>
+	/// <para>
+	/// Services keep their frame loop as a member, so it's destroyed along with them
+	/// and X-Plane never calls back into a destroyed service. The callback can therefore
+	/// use the service through a raw pointer, without keeping it alive.
+	/// </para>
+	/// <para>
+	/// Returning false from the callback pauses the loop until <see cref="Wake"/> is called,
+	/// so services with nothing to do cost nothing per frame.
+	/// </para>
+	/// </remarks>
+	class FrameLoop final
+	{
+	public:
+		/// <summary>
+		/// Called every frame with the time since the last frame, in seconds, returning
+		/// true to be called again next frame or false to pause until woken
+		/// </summary>
+		typedef std::function<bool(float)> FrameCallback;
+
+		/// <summary>
+		/// Creates a frame loop
+		/// </summary>
+		/// <param name="phase">Phase of the frame to call back in</param>
+		/// <param name="callback">Callback to call every frame</param>
+		/// <param name="isAwake">True to call back from the next frame, false to wait for <see cref="Wake"/></param>
+		/// <returns>Created frame loop, stopped once released</returns>
+		static std::shared_ptr<FrameLoop> Create(FlightLoopPhaseType phase, FrameCallback callback, bool isAwake = true);
+
+		/// <summary>
+		/// Calls back from the next frame, if paused
+		/// </summary>
+		void Wake();
+
+	private:
+		FrameLoop();
+		~FrameLoop()							= default;
+
+		FrameLoop(const FrameLoop&)				= delete;
+		FrameLoop& operator=(const FrameLoop&)	= delete;
+
+		// Flight loop calling back every frame
+		std::shared_ptr<FlightLoop> m_flightLoop;
+	};
+}
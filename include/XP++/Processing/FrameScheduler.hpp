@@ -0,0 +1,144 @@
+#pragma once
+
+// STL includes
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace XP
+{
+	// Pre-declarations
+	class FrameLoop;
+
+	/// <summary>
+	/// Identifies a job added to a <see cref="FrameScheduler"/>
+	/// </summary>
+	typedef uint64_t ScheduledJobID;
+
+	/// <summary>
+	/// Runs jobs every N frames (or at a rate), staggered so they don't all land on the same frame
+	/// </summary>
+	/// <remarks>
+	/// <para>
+	/// Jobs given their own <see cref="FlightLoop"/> intervals tend to line up and run on
+	/// the same frame, causing a spike every second. Instead, each job here is given a phase
+	/// within its interval, chosen to minimise the expected time of the jobs it collides with.
+	/// Each job's time is measured as it runs, so expensive jobs are kept apart.
+	/// </para>
+	/// <para>
+	/// Phases are chosen when a job is added, and every phase is chosen again when one is
+	/// removed, or when a job's rate needs a different number of frames as the frame rate
+	/// changes. <see cref="GetFrameLoads"/> reports the time spent in jobs each frame.
+	/// </para>
+	/// </remarks>
+	class FrameScheduler final
+	{
+	public:
+		/// <summary>
+		/// Number of frames reported by <see cref="GetFrameLoads"/>
+		/// </summary>
+		static const int HistorySize = 128;
+
+		/// <summary>
+		/// A scheduled job, given the time since it last ran in seconds
+		/// </summary>
+		typedef std::function<void(float elapsedSinceLastRun)> Job;
+
+		/// <summary>
+		/// Creates a scheduler, running its jobs every frame before the flight model
+		/// </summary>
+		/// <returns>Created scheduler</returns>
+		static std::shared_ptr<FrameScheduler> Create();
+
+		/// <summary>
+		/// Adds a job run once every N frames
+		/// </summary>
+		/// <param name="frameInterval">Number of frames between each run</param>
+		/// <param name="job">Job to run</param>
+		/// <returns>ID of the job</returns>
+		ScheduledJobID AddEveryFrames(int frameInterval, Job job);
+		/// <summary>
+		/// Adds a job run at a rate, converted into frames using the measured frame rate
+		/// </summary>
+		/// <param name="hertz">Number of runs per second</param>
+		/// <param name="job">Job to run</param>
+		/// <returns>ID of the job</returns>
+		ScheduledJobID AddAtRate(float hertz, Job job);
+		/// <summary>
+		/// Removes a job, spreading the remaining jobs again
+		/// </summary>
+		/// <param name="jobID">ID of the job to remove</param>
+		void Remove(ScheduledJobID jobID);
+
+		/// <summary>
+		/// Chooses the phase of every job again, most expensive first
+		/// </summary>
+		void Rebalance();
+
+		/// <summary>
+		/// Gets the time spent running jobs on each of the last <see cref="HistorySize"/> frames
+		/// </summary>
+		/// <returns>Milliseconds spent each frame, oldest first</returns>
+		std::vector<float> GetFrameLoads() const;
+		/// <summary>
+		/// Gets the number of jobs scheduled
+		/// </summary>
+		/// <returns>Number of jobs</returns>
+		inline int GetJobCount() const
+		{
+			return static_cast<int>(m_jobs.size());
+		}
+
+	private:
+		FrameScheduler();
+		~FrameScheduler() = default;
+
+		FrameScheduler(const FrameScheduler&)				= delete;
+		FrameScheduler& operator=(const FrameScheduler&)	= delete;
+
+		// A scheduled job
+		struct ScheduledJob
+		{
+			ScheduledJobID id;
+			// Shared, so a job adding jobs can't move the job being run
+			std::shared_ptr<Job> job;
+			// Rate of the job, or 0 if run every set number of frames
+			float hertz;
+			// Number of frames between each run, and the frame within them it runs on
+			int frameInterval;
+			int phase;
+			// Smoothed time the job takes, in seconds
+			double cost;
+			std::chrono::steady_clock::time_point lastRunTime;
+			bool isRemoved;
+		};
+
+		// Scheduled jobs
+		std::vector<ScheduledJob> m_jobs;
+		// Last job ID handed out
+		ScheduledJobID m_lastJobID;
+		// Number of frames run
+		uint64_t m_frameNumber;
+		// Smoothed frame time, in seconds
+		double m_frameTime;
+		// Time since job rates were last converted into frames
+		float m_timeSinceRateCheck;
+		// Is a frame being run? Removed jobs are only erased afterwards
+		bool m_isRunning;
+		// Time spent running jobs on recent frames, in seconds
+		float m_frameLoads[HistorySize];
+		// Frame loop running the jobs
+		std::shared_ptr<FrameLoop> m_frameLoop;
+
+		// Adds a job, choosing its phase
+		ScheduledJobID Add(float hertz, int frameInterval, Job job);
+		// Chooses the phase of a job, avoiding the other jobs
+		void ChoosePhase(size_t index);
+		// Converts a rate into a number of frames at the measured frame rate
+		int ToFrameInterval(float hertz) const;
+		// Runs the jobs due this frame
+		void RunFrame(float frameDelta);
+	};
+}
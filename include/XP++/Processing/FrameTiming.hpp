@@ -0,0 +1,145 @@
+#pragma once
+
+// STL includes
+#include <atomic>
+#include <chrono>
+#include <memory>
+
+namespace XP
+{
+	// Pre-declarations
+	class FrameLoop;
+
+	/// <summary>
+	/// Frame time statistics over the most recent frames
+	/// </summary>
+	struct FrameStatistics
+	{
+		// Number of frames the statistics cover
+		int sampleCount;
+		// Mean frame time, in seconds
+		float mean;
+		// 95th percentile frame time, in seconds
+		float percentile95;
+		// Longest frame time, in seconds
+		float maximum;
+		// Frames which took longer than the jank threshold
+		int jankCount;
+	};
+
+	/// <summary>
+	/// Samples X-Plane's timing once per frame, so it can be read anywhere without an SDK call
+	/// </summary>
+	/// <remarks>
+	/// <para>
+	/// Once started, a flight loop samples the time before the flight model runs
+	/// each frame. Every getter is an inline load of the value cached for the
+	/// current frame, so every caller within a frame sees the same time.
+	/// </para>
+	/// <para>
+	/// Values are updated on the sim thread and should only be read from it, except for
+	/// the cycle number, which may be read from any thread.
+	/// </para>
+	/// </remarks>
+	class FrameTiming final
+	{
+	public:
+		/// <summary>
+		/// Number of frames the rolling statistics cover
+		/// </summary>
+		static const int WindowSize = 128;
+
+		/// <summary>
+		/// Starts sampling every frame
+		/// </summary>
+		static void Start();
+		/// <summary>
+		/// Stops sampling, leaving the last sampled values in place
+		/// </summary>
+		static void Stop();
+		/// <summary>
+		/// Is timing being sampled every frame?
+		/// </summary>
+		/// <returns>True if started</returns>
+		static inline bool IsRunning()
+		{
+			return m_sampleLoop != nullptr;
+		}
+
+		/// <summary>
+		/// Gets the time since the sim started, as of this frame
+		/// </summary>
+		/// <remarks>
+		/// Accumulated in double precision, so unlike <see cref="XP::GetElapsedTime"/>
+		/// this keeps sub-millisecond precision after many hours.
+		/// </remarks>
+		/// <returns>Elapsed time, in seconds</returns>
+		static inline double GetElapsedTime()
+		{
+			return m_elapsedTime;
+		}
+		/// <summary>
+		/// Gets the time taken by the previous frame
+		/// </summary>
+		/// <returns>Frame time, in seconds</returns>
+		static inline float GetFrameDelta()
+		{
+			return m_frameDelta;
+		}
+		/// <summary>
+		/// Gets this frame's cycle number
+		/// </summary>
+		/// <returns>Cycle number</returns>
+		static inline int GetCycleNumber()
+		{
+			return m_cycleNumber.load(std::memory_order_relaxed);
+		}
+		/// <summary>
+		/// Gets this frame's cycle number, reading it from X-Plane if timing isn't being sampled
+		/// </summary>
+		/// <returns>Cycle number</returns>
+		static int GetCurrentCycleNumber();
+		/// <summary>
+		/// Gets the monotonic wall clock time this frame was sampled at
+		/// </summary>
+		/// <returns>Steady clock time of this frame</returns>
+		static inline std::chrono::steady_clock::time_point GetFrameTime()
+		{
+			return m_frameTime;
+		}
+
+		/// <summary>
+		/// Gets frame time statistics over the last <see cref="WindowSize"/> frames
+		/// </summary>
+		/// <returns>Rolling frame time statistics</returns>
+		static inline const FrameStatistics& GetStatistics()
+		{
+			return m_statistics;
+		}
+
+		/// <summary>
+		/// Sets when a frame counts as a jank
+		/// </summary>
+		/// <param name="meanMultiple">Frames longer than this multiple of the mean frame time are janks</param>
+		static void SetJankThreshold(float meanMultiple);
+
+	private:
+		FrameTiming()								= delete;
+		~FrameTiming()								= delete;
+		FrameTiming(const FrameTiming&)				= delete;
+		FrameTiming& operator=(const FrameTiming&)	= delete;
+
+		// Values cached for the current frame
+		static double m_elapsedTime;
+		static float m_frameDelta;
+		static std::atomic<int> m_cycleNumber;
+		static std::chrono::steady_clock::time_point m_frameTime;
+		static FrameStatistics m_statistics;
+
+		// Flight loop sampling the time, while started
+		static std::shared_ptr<FrameLoop> m_sampleLoop;
+
+		// Samples the time and updates the statistics
+		static void Sample(float frameDelta);
+	};
+}
@@ -0,0 +1,177 @@
+#pragma once
+
+// STL includes
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace XP
+{
+	// Pre-declarations
+	class FrameLoop;
+
+	/// <summary>
+	/// Identifies a task registered with a <see cref="LoadShedder"/>
+	/// </summary>
+	typedef uint64_t SheddableTaskID;
+
+	/// <summary>
+	/// A change of quality level made by a <see cref="LoadShedder"/>, and its effect
+	/// </summary>
+	struct LoadSheddingDecision
+	{
+		// Sim elapsed time the decision was made at, in seconds
+		double time;
+		// Quality level before and after the decision
+		int fromQuality;
+		int toQuality;
+		// 95th percentile frame time before the decision, in seconds
+		float frameTimeBefore;
+		// 95th percentile frame time once the window refilled after the decision, or negative until then
+		float frameTimeAfter;
+	};
+
+	/// <summary>
+	/// Lowers the quality of registered work while frames are over budget, and restores it once they recover
+	/// </summary>
+	/// <remarks>
+	/// <para>
+	/// Quality is a level from 0 (least work) to the highest level (full work), starting at the
+	/// highest. Each registered task is told the level whenever it changes, and degrades its own
+	/// work to match, such as by updating less often or in smaller batches.
+	/// </para>
+	/// <para>
+	/// Every frame the 95th percentile frame time from <see cref="FrameTiming"/> is compared with
+	/// the target. Quality is lowered one level once frames have been over the degrade threshold
+	/// for the degrade delay, and raised one level once under the (lower) restore threshold for
+	/// the (longer) restore delay. After each change the rolling window is left to refill before
+	/// the next decision, so a change is judged on frames made at the new level. Each decision
+	/// and its measured effect are logged, and kept for <see cref="GetDecisions"/>.
+	/// </para>
+	/// </remarks>
+	class LoadShedder final
+	{
+	public:
+		/// <summary>
+		/// Number of decisions kept for <see cref="GetDecisions"/>
+		/// </summary>
+		static const int HistorySize = 32;
+
+		/// <summary>
+		/// Adjusts a task's work to a quality level
+		/// </summary>
+		typedef std::function<void(int quality)> QualityHandler;
+
+		/// <summary>
+		/// Creates a load shedder, starting <see cref="FrameTiming"/> if needed
+		/// </summary>
+		/// <param name="targetFrameTime">Frame time budget, in seconds</param>
+		/// <param name="qualityLevels">Number of quality levels</param>
+		/// <returns>Created load shedder</returns>
+		static std::shared_ptr<LoadShedder> Create(float targetFrameTime = 1.0f / 30.0f, int qualityLevels = 4);
+
+		/// <summary>
+		/// Registers degradable work, calling the handler with the current quality straight away
+		/// </summary>
+		/// <param name="name">Name of the task, used in logs</param>
+		/// <param name="handler">Called whenever the quality changes</param>
+		/// <returns>ID of the task</returns>
+		SheddableTaskID AddTask(std::string name, QualityHandler handler);
+		/// <summary>
+		/// Removes a task
+		/// </summary>
+		/// <param name="taskID">ID of the task to remove</param>
+		void RemoveTask(SheddableTaskID taskID);
+
+		/// <summary>
+		/// Sets the frame time budget
+		/// </summary>
+		/// <param name="targetFrameTime">Frame time budget, in seconds</param>
+		void SetTargetFrameTime(float targetFrameTime);
+		/// <summary>
+		/// Sets the thresholds, as multiples of the target, quality is lowered above and raised below
+		/// </summary>
+		/// <param name="degradeRatio">Frames above this multiple of the target are under pressure</param>
+		/// <param name="restoreRatio">Frames below this multiple of the target have headroom; must be below degradeRatio</param>
+		void SetThresholds(float degradeRatio, float restoreRatio);
+		/// <summary>
+		/// Sets how long frames must stay over or under the thresholds before the quality changes
+		/// </summary>
+		/// <param name="degradeDelay">Seconds under pressure before lowering the quality</param>
+		/// <param name="restoreDelay">Seconds with headroom before raising the quality</param>
+		void SetDelays(float degradeDelay, float restoreDelay);
+
+		/// <summary>
+		/// Gets the current quality level
+		/// </summary>
+		/// <returns>Quality, from 0 (least work) to <see cref="GetQualityLevels"/> - 1 (full work)</returns>
+		inline int GetQuality() const
+		{
+			return m_quality;
+		}
+		/// <summary>
+		/// Gets the number of quality levels
+		/// </summary>
+		/// <returns>Number of quality levels</returns>
+		inline int GetQualityLevels() const
+		{
+			return m_qualityLevels;
+		}
+		/// <summary>
+		/// Gets the most recent decisions, oldest first
+		/// </summary>
+		/// <returns>Up to <see cref="HistorySize"/> decisions</returns>
+		std::vector<LoadSheddingDecision> GetDecisions() const;
+
+	private:
+		LoadShedder(float targetFrameTime, int qualityLevels);
+		~LoadShedder() = default;
+
+		LoadShedder(const LoadShedder&)				= delete;
+		LoadShedder& operator=(const LoadShedder&)	= delete;
+
+		// A registered task
+		struct SheddableTask
+		{
+			SheddableTaskID id;
+			std::string name;
+			// Shared, so a handler adding tasks can't move the handler being called
+			std::shared_ptr<QualityHandler> handler;
+		};
+
+		// Registered tasks
+		std::vector<SheddableTask> m_tasks;
+		// Last task ID handed out
+		SheddableTaskID m_lastTaskID;
+		// Current quality, and the number of levels
+		int m_quality;
+		int m_qualityLevels;
+		// Frame time budget, in seconds
+		float m_targetFrameTime;
+		// Thresholds, as multiples of the target
+		float m_degradeRatio;
+		float m_restoreRatio;
+		// Seconds frames must stay over or under the thresholds
+		float m_degradeDelay;
+		float m_restoreDelay;
+		// Seconds frames have been over or under the thresholds
+		float m_pressureTime;
+		float m_headroomTime;
+		// Frames since the quality last changed
+		int m_framesSinceChange;
+		// Recent decisions
+		std::deque<LoadSheddingDecision> m_decisions;
+		// Frame loop watching the frame time
+		std::shared_ptr<FrameLoop> m_frameLoop;
+
+		// Watches the frame time, changing the quality if needed
+		void Update(float frameDelta);
+		// Changes the quality, telling every task
+		void SetQuality(int quality, float frameTime);
+		// Tells a task the quality
+		void Notify(const SheddableTask& task);
+	};
+}
@@ -0,0 +1,119 @@
+#pragma once
+
+// STL includes
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace XP
+{
+	/// <summary>
+	/// Fixed set of worker threads running queued tasks
+	/// </summary>
+	/// <remarks>
+	/// Tasks must not call the X-Plane SDK, which may only be used from the
+	/// sim thread. Hand results back to the sim thread (for example through a
+	/// future checked from a <see cref="FlightLoop"/>) to apply them.
+	/// </remarks>
+	class ThreadPool final
+	{
+	public:
+		/// <summary>
+		/// Creates a thread pool
+		/// </summary>
+		/// <param name="threadCount">Number of worker threads, or 0 for one less than the number of cores</param>
+		/// <returns>Created thread pool</returns>
+		static std::shared_ptr<ThreadPool> Create(unsigned int threadCount = 0);
+
+		/// <summary>
+		/// Gets the pool shared by XP++, creating it if needed
+		/// </summary>
+		/// <returns>Shared thread pool</returns>
+		static std::shared_ptr<ThreadPool> GetShared();
+		/// <summary>
+		/// Releases the shared pool, joining its threads once no longer used
+		/// </summary>
+		/// <remarks>
+		/// Called by <see cref="REGISTER_PLUGIN"/> once <see cref="UserPlugin::OnStop"/> returns, as
+		/// threads mustn't be joined while the plug-in is unloaded. Services using the pool should
+		/// be destroyed by then, or the threads are only joined once the last of them is.
+		/// </remarks>
+		static void ReleaseShared();
+
+		/// <summary>
+		/// Gets the number of worker threads
+		/// </summary>
+		/// <returns>Number of worker threads</returns>
+		inline unsigned int GetThreadCount() const
+		{
+			return static_cast<unsigned int>(m_threads.size());
+		}
+
+		/// <summary>
+		/// Queues a task to run on a worker thread
+		/// </summary>
+		/// <param name="task">Task to run</param>
+		void Enqueue(std::function<void()> task);
+
+		/// <summary>
+		/// Queues a task to run on a worker thread, returning its result through a future
+		/// </summary>
+		/// <param name="task">Task to run</param>
+		/// <returns>Future receiving the result, or exception, of the task</returns>
+		template<typename Function>
+		std::future<typename std::result_of<Function()>::type> Submit(Function task)
+		{
+			typedef typename std::result_of<Function()>::type Result;
+
+			std::shared_ptr<std::packaged_task<Result()>> packagedTask = std::make_shared<std::packaged_task<Result()>>(task);
+			std::future<Result> result = packagedTask->get_future();
+			Enqueue([packagedTask]()
+			{
+				(*packagedTask)();
+			});
+
+			return result;
+		}
+
+		/// <summary>
+		/// Runs a body over a range split into chunks, on the worker threads and the calling thread
+		/// </summary>
+		/// <remarks>
+		/// Returns once every chunk has run. If the body throws, the first
+		/// exception is rethrown once the remaining chunks have run.
+		/// </remarks>
+		/// <param name="begin">First index of the range</param>
+		/// <param name="end">One past the last index of the range</param>
+		/// <param name="grainSize">Number of indices per chunk</param>
+		/// <param name="body">Called with the first and one past the last index of each chunk</param>
+		void ParallelFor(int begin, int end, int grainSize, std::function<void(int, int)> body);
+
+	private:
+		ThreadPool(unsigned int threadCount);
+		~ThreadPool();
+
+		ThreadPool(const ThreadPool&)				= delete;
+		ThreadPool& operator=(const ThreadPool&)	= delete;
+
+		// Worker threads
+		std::vector<std::thread> m_threads;
+		// Queued tasks, guarded by the mutex
+		std::mutex m_mutex;
+		std::condition_variable m_wakeup;
+		std::deque<std::function<void()>> m_tasks;
+		bool m_isStopping;
+
+		// Pool shared by XP++
+		static std::shared_ptr<ThreadPool> m_shared;
+		static std::mutex m_sharedMutex;
+
+		// Runs tasks until stopped
+		void WorkerThread();
+	};
+}
@@ -0,0 +1,192 @@
+#pragma once
+
+// STL includes
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace XP
+{
+	// Pre-declarations
+	class FrameLoop;
+
+	/// <summary>
+	/// Clock a timer counts down against
+	/// </summary>
+	enum class TimerClock : int
+	{
+		/// <summary>
+		/// Sim time, which stops while the sim is paused
+		/// </summary>
+		Sim		= 0,
+		/// <summary>
+		/// Monotonic wall clock time
+		/// </summary>
+		Wall	= 1
+	};
+
+	/// <summary>
+	/// Identifies a timer, to cancel it
+	/// </summary>
+	typedef uint64_t TimerID;
+
+	/// <summary>
+	/// Thousands of one-shot and periodic timers driven by a single flight loop
+	/// </summary>
+	/// <remarks>
+	/// <para>
+	/// Timers are kept in a hierarchical timer wheel for each clock: 4 levels of 256
+	/// slots, the first level covering 256 ticks, and each level above covering 256 times
+	/// the one below. Adding and cancelling a timer is O(1), and each tick only looks at
+	/// the timers due within it, plus the timers cascading down from the level above once
+	/// every 256 ticks. Timer nodes are pooled and linked by index, so timers don't
+	/// allocate once the pool has grown.
+	/// </para>
+	/// <para>
+	/// Timers fire at the first tick at or after they're due, so up to a tick late. Callbacks
+	/// run on the sim thread, and may add and cancel timers (including their own).
+	/// </para>
+	/// </remarks>
+	class TimerWheel final
+	{
+	public:
+		/// <summary>
+		/// Creates a timer wheel, advanced every frame by a flight loop
+		/// </summary>
+		/// <param name="tickLength">Resolution of the timers, in seconds</param>
+		/// <returns>Created timer wheel</returns>
+		static std::shared_ptr<TimerWheel> Create(double tickLength = 0.01);
+
+		/// <summary>
+		/// Adds a timer firing once after a delay
+		/// </summary>
+		/// <param name="clock">Clock the delay counts down against</param>
+		/// <param name="delay">Delay, in seconds</param>
+		/// <param name="callback">Called when the timer fires</param>
+		/// <returns>ID of the timer</returns>
+		TimerID After(TimerClock clock, double delay, std::function<void()> callback);
+		/// <summary>
+		/// Adds a timer firing repeatedly, until cancelled
+		/// </summary>
+		/// <param name="clock">Clock the interval counts down against</param>
+		/// <param name="interval">Time between each firing, in seconds</param>
+		/// <param name="callback">Called each time the timer fires</param>
+		/// <returns>ID of the timer</returns>
+		TimerID Every(TimerClock clock, double interval, std::function<void()> callback);
+		/// <summary>
+		/// Cancels a timer
+		/// </summary>
+		/// <param name="timerID">ID of the timer to cancel</param>
+		/// <returns>True if cancelled, or false if it already fired or was cancelled</returns>
+		bool Cancel(TimerID timerID);
+		/// <summary>
+		/// Checks if a timer is still waiting to fire
+		/// </summary>
+		/// <param name="timerID">ID of the timer</param>
+		/// <returns>True if the timer will still fire, otherwise false</returns>
+		bool IsPending(TimerID timerID) const;
+
+		/// <summary>
+		/// Gets the number of timers waiting to fire
+		/// </summary>
+		/// <returns>Number of timers</returns>
+		inline size_t GetPendingCount() const
+		{
+			return m_pendingCount;
+		}
+		/// <summary>
+		/// Gets the time of a clock, as of the last advance
+		/// </summary>
+		/// <param name="clock">Clock to get the time of</param>
+		/// <returns>Time of the clock, in seconds</returns>
+		inline double GetTime(TimerClock clock) const
+		{
+			return m_wheels[static_cast<int>(clock)].time;
+		}
+
+		/// <summary>
+		/// Advances a clock, firing the timers due up to the new time
+		/// </summary>
+		/// <remarks>
+		/// Called every frame by the flight loop, so there's no need to call this
+		/// unless driving the wheel from somewhere else (such as a replay).
+		/// </remarks>
+		/// <param name="clock">Clock to advance</param>
+		/// <param name="time">New time of the clock, in seconds</param>
+		void Advance(TimerClock clock, double time);
+
+	private:
+		TimerWheel(double tickLength);
+		~TimerWheel() = default;
+
+		TimerWheel(const TimerWheel&)				= delete;
+		TimerWheel& operator=(const TimerWheel&)	= delete;
+
+		// Layout of each wheel
+		static const int LevelCount		= 4;
+		static const int SlotBits		= 8;
+		static const int SlotCount		= 1 << SlotBits;
+		static const uint32_t NullNode	= 0xFFFFFFFF;
+		// List timers are moved to while being fired
+		static const int FiringList		= LevelCount * SlotCount;
+
+		// A pooled timer
+		struct TimerNode
+		{
+			// Neighbours within the list it's in
+			uint32_t previous;
+			uint32_t next;
+			// Incremented each time the node is freed, so stale IDs are recognised
+			uint32_t generation;
+			// List the node is in, or -1 if free
+			int list;
+			TimerClock clock;
+			uint64_t dueTick;
+			// Ticks between firings, or 0 if firing once
+			uint64_t intervalTicks;
+			std::function<void()> callback;
+		};
+
+		// Timers of a single clock
+		struct Wheel
+		{
+			// Time of the clock, and the time at tick 0
+			double time;
+			double origin;
+			uint64_t currentTick;
+			size_t pendingCount;
+			// Head of each slot's list, then the list being fired
+			uint32_t lists[LevelCount * SlotCount + 1];
+		};
+
+		// Length of a tick, in seconds
+		double m_tickLength;
+		// Wheel of each clock
+		Wheel m_wheels[2];
+		// Pooled timers, and the head of the list of free ones
+		std::vector<TimerNode> m_nodes;
+		uint32_t m_freeNodes;
+		// Number of timers waiting to fire
+		size_t m_pendingCount;
+		// Frame loop advancing the clocks
+		std::shared_ptr<FrameLoop> m_frameLoop;
+
+		// Adds a timer, returning its ID
+		TimerID Add(TimerClock clock, double delay, uint64_t intervalTicks, std::function<void()> callback);
+		// Finds the node of a timer, or NULL if it's no longer pending
+		TimerNode* FindNode(TimerID timerID);
+		// Links a node into the slot of its due tick
+		void Schedule(Wheel& wheel, uint32_t node);
+		// Links a node into a list
+		void Link(Wheel& wheel, int list, uint32_t node);
+		// Unlinks a node from its list
+		void Unlink(Wheel& wheel, uint32_t node);
+		// Returns a node to the pool
+		void Free(uint32_t node);
+		// Moves the timers of a slot down into the levels below
+		void Cascade(Wheel& wheel, int level);
+		// Fires the timers of the current tick
+		void Fire(Wheel& wheel);
+	};
+}
@@ -15,6 +15,10 @@ namespace XP
 	/// and its source. Do not attempt to use it for timing critical applications
 	/// like network multiplayer.
 	/// </para>
+	/// <para>
+	/// <see cref="FrameTiming::GetElapsedTime"/> provides a double precision
+	/// time, cached once per frame.
+	/// </para>
 	/// </remarks>
 	/// <returns>
 	/// 
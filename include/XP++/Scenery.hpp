@@ -0,0 +1,4 @@
+#pragma once
+
+#include "Scenery/InstanceSet.hpp"
+#include "Scenery/TerrainProbe.hpp"
@@ -0,0 +1,145 @@
+#pragma once
+
+// STL includes
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace XP
+{
+	// Pre-declarations
+	class ThreadPool;
+
+	/// <summary>
+	/// Arrays of an <see cref="InstanceSet"/>, handed to the compute function
+	/// </summary>
+	/// <remarks>
+	/// Index i of every array refers to the same instance. Dataref values are
+	/// stored per instance, so instance i's values start at i * valueCount.
+	/// Set isDirty[i] to 1 for every instance changed.
+	/// </remarks>
+	struct InstanceArrays
+	{
+		float* x;
+		float* y;
+		float* z;
+		float* pitch;
+		float* heading;
+		float* roll;
+		float* values;
+		int valueCount;
+		uint8_t* isDirty;
+	};
+
+	/// <summary>
+	/// Many instances of one object, updated in batches
+	/// </summary>
+	/// <remarks>
+	/// <para>
+	/// Transforms and dataref values are kept in one array per field, and each
+	/// instance has a dirty flag, so <see cref="Flush"/> only pushes the instances
+	/// which changed to X-Plane.
+	/// </para>
+	/// <para>
+	/// <see cref="Compute"/> splits the instances across a <see cref="ThreadPool"/> to
+	/// calculate their transforms, after which a single <see cref="Flush"/> on the sim
+	/// thread pushes the changes. Every other method must be called from the sim thread.
+	/// </para>
+	/// </remarks>
+	class InstanceSet final
+	{
+	public:
+		/// <summary>
+		/// Creates an instance set, loading its object
+		/// </summary>
+		/// <param name="objectPath">Path of the object, relative to the X-Plane folder</param>
+		/// <param name="dataRefs">Names of the datarefs each instance has its own value of</param>
+		/// <returns>Created instance set</returns>
+		static std::shared_ptr<InstanceSet> Create(std::string objectPath, std::vector<std::string> dataRefs);
+
+		/// <summary>
+		/// Gets the number of instances
+		/// </summary>
+		/// <returns>Number of instances</returns>
+		inline int GetCount() const
+		{
+			return static_cast<int>(m_instances.size());
+		}
+
+		/// <summary>
+		/// Adds an instance
+		/// </summary>
+		/// <returns>Index of the new instance</returns>
+		int Add();
+		/// <summary>
+		/// Removes an instance
+		/// </summary>
+		/// <remarks>
+		/// The last instance is moved into the removed instance's index.
+		/// </remarks>
+		/// <param name="index">Index of the instance to remove</param>
+		void Remove(int index);
+
+		/// <summary>
+		/// Sets the transform of an instance
+		/// </summary>
+		/// <param name="index">Index of the instance</param>
+		/// <param name="x">Local X coordinate</param>
+		/// <param name="y">Local Y coordinate</param>
+		/// <param name="z">Local Z coordinate</param>
+		/// <param name="pitch">Pitch, in degrees</param>
+		/// <param name="heading">Heading, in degrees</param>
+		/// <param name="roll">Roll, in degrees</param>
+		void SetTransform(int index, float x, float y, float z, float pitch, float heading, float roll);
+		/// <summary>
+		/// Sets one of an instance's dataref values
+		/// </summary>
+		/// <param name="index">Index of the instance</param>
+		/// <param name="dataRefIndex">Index of the dataref, as given on creation</param>
+		/// <param name="value">Value of the dataref</param>
+		void SetValue(int index, int dataRefIndex, float value);
+
+		/// <summary>
+		/// Updates instances in parallel
+		/// </summary>
+		/// <param name="threadPool">Pool to run the compute function on</param>
+		/// <param name="grainSize">Number of instances per call of the compute function</param>
+		/// <param name="compute">Called with the arrays and the range of instances to update</param>
+		void Compute(ThreadPool& threadPool, int grainSize, std::function<void(InstanceArrays&, int, int)> compute);
+		/// <summary>
+		/// Pushes every changed instance to X-Plane
+		/// </summary>
+		/// <returns>Number of instances pushed</returns>
+		int Flush();
+
+	private:
+		InstanceSet(void* objectRef, std::vector<std::string> dataRefs);
+		~InstanceSet();
+
+		InstanceSet(const InstanceSet&)				= delete;
+		InstanceSet& operator=(const InstanceSet&)	= delete;
+
+		// X-Plane object every instance draws
+		void* m_objectRef;
+		// Names of the per-instance datarefs
+		std::vector<std::string> m_dataRefs;
+		// X-Plane instances
+		std::vector<void*> m_instances;
+		// Transforms
+		std::vector<float> m_x;
+		std::vector<float> m_y;
+		std::vector<float> m_z;
+		std::vector<float> m_pitch;
+		std::vector<float> m_heading;
+		std::vector<float> m_roll;
+		// Dataref values, m_dataRefs.size() per instance
+		std::vector<float> m_values;
+		// Has each instance changed since the last flush? (bytes, so instances can be flagged in parallel)
+		std::vector<uint8_t> m_isDirty;
+
+		// Validates an instance index
+		void CheckIndex(int index) const;
+	};
+}
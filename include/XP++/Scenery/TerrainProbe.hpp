@@ -0,0 +1,229 @@
+#pragma once
+
+// STL includes
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+// XP++ includes
+#include "XP++/MessageDispatcher.hpp"
+
+namespace XP
+{
+	// Pre-declarations
+	class FrameLoop;
+
+	/// <summary>
+	/// Result of probing the terrain at a point
+	/// </summary>
+	struct ProbeResult
+	{
+		// Was terrain found below the point?
+		bool isHit;
+		// Is the terrain water?
+		bool isWet;
+		// Point on the terrain, in local OpenGL coordinates
+		float x;
+		float y;
+		float z;
+		// Normal of the terrain at the point
+		float normalX;
+		float normalY;
+		float normalZ;
+	};
+
+	/// <summary>
+	/// Counters for tuning a <see cref="TerrainProbe"/>
+	/// </summary>
+	struct ProbeStatistics
+	{
+		// Points asked for
+		uint64_t requestCount;
+		// Points answered from the cache
+		uint64_t cacheHitCount;
+		// Probes actually made through the SDK (or probe function)
+		uint64_t probeCount;
+	};
+
+	/// <summary>
+	/// Probes terrain height in batches, reusing recent results for nearby points
+	/// </summary>
+	/// <remarks>
+	/// <para>
+	/// Points are quantized to a grid of cells, and each probe result is cached for its
+	/// cell for a limited time, so aircraft and objects near each other (or the same
+	/// point asked for on consecutive frames) cost a single probe.
+	/// </para>
+	/// <para>
+	/// <see cref="Probe"/> answers immediately and must be called from the sim thread.
+	/// <see cref="Request"/> may be called from any thread; requests are answered in one
+	/// batch each frame once <see cref="Start"/> has been called.
+	/// </para>
+	/// <para>
+	/// Cached results are in local coordinates, which X-Plane moves when it shifts
+	/// scenery, so the cache clears itself whenever scenery is loaded. Create probes
+	/// from the sim thread, as they subscribe through the <see cref="MessageDispatcher"/>.
+	/// </para>
+	/// </remarks>
+	class TerrainProbe final
+	{
+	public:
+		/// <summary>
+		/// Function probing the terrain below a point, returning false if it failed
+		/// </summary>
+		typedef std::function<bool(float x, float y, float z, ProbeResult& outResult)> ProbeFunction;
+
+		/// <summary>
+		/// Creates a terrain probe using X-Plane's terrain
+		/// </summary>
+		/// <param name="cellSize">Size of each cache cell, in meters</param>
+		/// <param name="timeToLive">How long results are cached for, in seconds</param>
+		/// <returns>Created terrain probe</returns>
+		static std::shared_ptr<TerrainProbe> Create(float cellSize = 1.0f, float timeToLive = 1.0f);
+		/// <summary>
+		/// Creates a terrain probe using the given probe function, such as a synthetic heightfield
+		/// </summary>
+		/// <param name="probeFunction">Function probing the terrain</param>
+		/// <param name="cellSize">Size of each cache cell, in meters</param>
+		/// <param name="timeToLive">How long results are cached for, in seconds</param>
+		/// <returns>Created terrain probe</returns>
+		static std::shared_ptr<TerrainProbe> Create(ProbeFunction probeFunction, float cellSize, float timeToLive);
+
+		/// <summary>
+		/// Probes the terrain below a point
+		/// </summary>
+		/// <param name="x">Local X coordinate</param>
+		/// <param name="y">Local Y coordinate</param>
+		/// <param name="z">Local Z coordinate</param>
+		/// <returns>Terrain below the point</returns>
+		ProbeResult Probe(float x, float y, float z);
+		/// <summary>
+		/// Probes the terrain below many points at once
+		/// </summary>
+		/// <param name="x">Local X coordinate of each point</param>
+		/// <param name="y">Local Y coordinate of each point</param>
+		/// <param name="z">Local Z coordinate of each point</param>
+		/// <param name="outResults">Receives the terrain below each point</param>
+		/// <param name="count">Number of points</param>
+		void Probe(const float* x, const float* y, const float* z, ProbeResult* outResults, int count);
+
+		/// <summary>
+		/// Asks for the terrain below a point, answered within the next frame
+		/// </summary>
+		/// <param name="x">Local X coordinate</param>
+		/// <param name="y">Local Y coordinate</param>
+		/// <param name="z">Local Z coordinate</param>
+		/// <returns>Future receiving the terrain below the point</returns>
+		std::future<ProbeResult> Request(float x, float y, float z);
+		/// <summary>
+		/// Answers every pending request
+		/// </summary>
+		/// <remarks>
+		/// Called each frame once started, but may be called directly from the sim thread.
+		/// </remarks>
+		void ProcessRequests();
+
+		/// <summary>
+		/// Starts answering requests each frame
+		/// </summary>
+		void Start();
+		/// <summary>
+		/// Stops answering requests each frame
+		/// </summary>
+		void Stop();
+
+		/// <summary>
+		/// Discards every cached result
+		/// </summary>
+		/// <remarks>
+		/// Called whenever scenery is loaded (including when X-Plane shifts the local origin).
+		/// </remarks>
+		void Clear();
+
+		/// <summary>
+		/// Gets the counters of this probe
+		/// </summary>
+		/// <returns>Counters since creation or the last reset</returns>
+		inline const ProbeStatistics& GetStatistics() const
+		{
+			return m_statistics;
+		}
+		/// <summary>
+		/// Gets the fraction of points answered from the cache
+		/// </summary>
+		/// <returns>Cache hit ratio, from 0 to 1</returns>
+		inline float GetCacheHitRatio() const
+		{
+			return m_statistics.requestCount == 0 ? 0.0f :
+				static_cast<float>(m_statistics.cacheHitCount) / static_cast<float>(m_statistics.requestCount);
+		}
+		/// <summary>
+		/// Resets the counters of this probe
+		/// </summary>
+		inline void ResetStatistics()
+		{
+			m_statistics = ProbeStatistics();
+		}
+
+	private:
+		TerrainProbe(ProbeFunction probeFunction, float cellSize, float timeToLive);
+		~TerrainProbe();
+
+		TerrainProbe(const TerrainProbe&)				= delete;
+		TerrainProbe& operator=(const TerrainProbe&)	= delete;
+
+		typedef std::chrono::steady_clock Clock;
+
+		// A cached probe result
+		struct CacheEntry
+		{
+			ProbeResult result;
+			Clock::time_point expiry;
+		};
+
+		// A point asked for through Request
+		struct PendingRequest
+		{
+			float x;
+			float y;
+			float z;
+			std::promise<ProbeResult> promise;
+		};
+
+		// Function probing the terrain
+		ProbeFunction m_probeFunction;
+		// X-Plane probe, when probing X-Plane's terrain
+		void* m_probeRef;
+		// Size of each cache cell, in meters
+		float m_cellSize;
+		// How long results are cached for
+		Clock::duration m_timeToLive;
+		// Cached results by cell
+		std::unordered_map<uint64_t, CacheEntry> m_cache;
+		// Time expired results are next removed
+		Clock::time_point m_nextSweep;
+		// Counters
+		ProbeStatistics m_statistics;
+
+		// Requests waiting for the next frame, guarded by the mutex
+		std::mutex m_pendingMutex;
+		std::vector<PendingRequest> m_pending;
+		// Requests being answered, kept to reuse their storage
+		std::vector<PendingRequest> m_processing;
+
+		// Per-frame processing, while started
+		std::shared_ptr<FrameLoop> m_processLoop;
+		// Subscription clearing the cache when scenery is loaded
+		MessageSubscriptionID m_sceneryLoadedID;
+
+		// Probes a point through the cache
+		ProbeResult ProbeCached(float x, float y, float z, Clock::time_point now);
+		// Removes expired results
+		void Sweep(Clock::time_point now);
+	};
+}
@@ -0,0 +1,213 @@
+#pragma once
+
+// STL includes
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+
+namespace XP
+{
+	// Pre-declarations
+	class Message;
+
+	/// <summary>
+	/// Type of a stored setting
+	/// </summary>
+	enum class SettingType : uint8_t
+	{
+		/// <summary>
+		/// Setting was removed (only found within the file)
+		/// </summary>
+		Removed	= 0,
+		Bool	= 1,
+		Integer	= 2,
+		Double	= 3,
+		String	= 4
+	};
+
+	/// <summary>
+	/// Name and default value of a setting, giving it a type
+	/// </summary>
+	/// <code>
+	/// static const XP::SettingKey&lt;int64_t&gt; WindowWidth = { "window/width", 800 };
+	/// int64_t width = settings->Get(WindowWidth);
+	/// </code>
+	template<typename T>
+	struct SettingKey
+	{
+		// Name of the setting
+		const char* name;
+		// Value when the setting hasn't been stored (or has another type)
+		T defaultValue;
+	};
+
+	/// <summary>
+	/// Persistent settings, stored in an append-only log file
+	/// </summary>
+	/// <remarks>
+	/// <para>
+	/// Every setting is held in memory, so reads never touch the disk. The file is
+	/// memory-mapped and decoded once when opened. Changes are appended to the file
+	/// as checksummed records by a background thread when <see cref="Flush"/> is called,
+	/// so the sim never waits on the disk, and a crash part way through a write
+	/// loses only the records being written.
+	/// </para>
+	/// <para>
+	/// Once most of the file is made up of overwritten records, the live settings
+	/// are rewritten to a new file in the background, which then replaces the old one.
+	/// </para>
+	/// <para>
+	/// Settings should only be read and written from the sim thread. Pass messages to
+	/// <see cref="HandleMessage"/> to flush whenever X-Plane writes its preferences.
+	/// </para>
+	/// </remarks>
+	class SettingsStore final
+	{
+	public:
+		/// <summary>
+		/// Opens a settings file, creating it if it doesn't exist
+		/// </summary>
+		/// <remarks>
+		/// A file damaged by a crash, even part way through writing its header, is opened with
+		/// the settings that survived and rewritten. Throws if the file isn't a settings file.
+		/// </remarks>
+		/// <param name="filePath">Path of the settings file</param>
+		/// <returns>Opened settings store</returns>
+		static std::shared_ptr<SettingsStore> Open(std::string filePath);
+
+		/// <summary>
+		/// Checks if a setting has been stored
+		/// </summary>
+		/// <param name="name">Name of the setting</param>
+		/// <returns>True if the setting has a value</returns>
+		bool Contains(const std::string& name) const;
+
+		// Reads a setting, returning the default if not stored or of another type
+		bool GetBool(const std::string& name, bool defaultValue) const;
+		int64_t GetInteger(const std::string& name, int64_t defaultValue) const;
+		double GetDouble(const std::string& name, double defaultValue) const;
+		std::string GetString(const std::string& name, const std::string& defaultValue) const;
+
+		// Writes a setting, persisted by the next flush
+		void SetBool(const std::string& name, bool value);
+		void SetInteger(const std::string& name, int64_t value);
+		void SetDouble(const std::string& name, double value);
+		void SetString(const std::string& name, const std::string& value);
+
+		/// <summary>
+		/// Removes a setting
+		/// </summary>
+		/// <param name="name">Name of the setting</param>
+		void Remove(const std::string& name);
+
+		/// <summary>
+		/// Reads a typed setting
+		/// </summary>
+		/// <param name="key">Setting to read</param>
+		/// <returns>Value of the setting, or its default</returns>
+		template<typename T>
+		T Get(const SettingKey<T>& key) const
+		{
+			return Read(key.name, key.defaultValue);
+		}
+		/// <summary>
+		/// Writes a typed setting
+		/// </summary>
+		/// <param name="key">Setting to write</param>
+		/// <param name="value">Value to write</param>
+		template<typename T>
+		void Set(const SettingKey<T>& key, const T& value)
+		{
+			Write(key.name, value);
+		}
+
+		/// <summary>
+		/// Writes changes to the file in the background
+		/// </summary>
+		/// <remarks>
+		/// Also starts compacting the file, once it has grown enough.
+		/// </remarks>
+		void Flush();
+		/// <summary>
+		/// Waits for every background write to finish
+		/// </summary>
+		void WaitForWrites();
+
+		/// <summary>
+		/// Flushes when X-Plane is about to write its preferences
+		/// </summary>
+		/// <param name="message">Message received by the plug-in</param>
+		/// <returns>True if the message was handled</returns>
+		bool HandleMessage(const Message& message);
+
+		/// <summary>
+		/// Gets the error of the last failed background write
+		/// </summary>
+		/// <returns>Description of the error, or an empty string</returns>
+		std::string GetLastError() const;
+
+	private:
+		SettingsStore(std::string filePath);
+		~SettingsStore();
+
+		SettingsStore(const SettingsStore&)				= delete;
+		SettingsStore& operator=(const SettingsStore&)	= delete;
+
+		// Value of a setting held in memory
+		struct Entry
+		{
+			SettingType type;
+			int64_t integer;
+			double real;
+			std::string text;
+		};
+
+		// Path of the settings file
+		std::string m_filePath;
+		// Every setting
+		std::unordered_map<std::string, Entry> m_entries;
+		// Records not yet written
+		std::string m_pending;
+		// Size of the file, once every queued write has finished
+		uint64_t m_fileSize;
+		// Size the file would be with only the live settings
+		uint64_t m_liveSize;
+
+		// Background writes, run in order by the writer thread
+		std::thread m_writerThread;
+		mutable std::mutex m_writerMutex;
+		std::condition_variable m_writerWakeup;
+		std::condition_variable m_writerIdle;
+		std::deque<std::function<void()>> m_writes;
+		bool m_isWriting;
+		bool m_isStopping;
+		std::string m_lastError;
+
+		// Decodes the file into memory, returning false if its end was damaged
+		bool Load();
+		// Stores an entry, queuing its record
+		void Store(const std::string& name, const Entry& entry);
+		// Queues a background write
+		void QueueWrite(std::function<void()> write);
+		// Queues rewriting the file with only the live settings
+		void QueueCompaction();
+		// Runs background writes until stopped
+		void WriterThread();
+
+		// Overloads used by the typed Get and Set
+		inline bool Read(const char* name, bool defaultValue) const						{ return GetBool(name, defaultValue); }
+		inline int64_t Read(const char* name, int64_t defaultValue) const				{ return GetInteger(name, defaultValue); }
+		inline double Read(const char* name, double defaultValue) const					{ return GetDouble(name, defaultValue); }
+		inline std::string Read(const char* name, const std::string& defaultValue) const	{ return GetString(name, defaultValue); }
+		inline void Write(const char* name, bool value)									{ SetBool(name, value); }
+		inline void Write(const char* name, int64_t value)								{ SetInteger(name, value); }
+		inline void Write(const char* name, double value)								{ SetDouble(name, value); }
+		inline void Write(const char* name, const std::string& value)					{ SetString(name, value); }
+	};
+}
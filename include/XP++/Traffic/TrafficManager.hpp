@@ -0,0 +1,204 @@
+#pragma once
+
+// STL includes
+#include <memory>
+#include <vector>
+
+namespace XP
+{
+	// Pre-declarations
+	class FrameLoop;
+
+	/// <summary>
+	/// State of every managed aircraft, stored as one array per field
+	/// </summary>
+	/// <remarks>
+	/// Index i of every array refers to the same aircraft, which is
+	/// X-Plane's aircraft i + 1 (aircraft 0 being the user's).
+	/// </remarks>
+	struct TrafficState
+	{
+		// Position in world coordinates (degrees and meters MSL)
+		std::vector<double> latitude;
+		std::vector<double> longitude;
+		std::vector<double> elevation;
+		// Position in local OpenGL coordinates (meters)
+		std::vector<float> x;
+		std::vector<float> y;
+		std::vector<float> z;
+		// Velocity in local OpenGL coordinates (meters per second)
+		std::vector<float> velocityX;
+		std::vector<float> velocityY;
+		std::vector<float> velocityZ;
+		// Attitude (degrees)
+		std::vector<float> pitch;
+		std::vector<float> roll;
+		std::vector<float> heading;
+		// 1 if the aircraft's position wasn't set this frame and should be extrapolated, otherwise 0
+		std::vector<float> isStale;
+	};
+
+	/// <summary>
+	/// Drives X-Plane's multiplayer aircraft from a plug-in, in batches
+	/// </summary>
+	/// <remarks>
+	/// <para>
+	/// Aircraft state is kept in a <see cref="TrafficState"/> and exchanged with
+	/// X-Plane through the TCAS target arrays (X-Plane 11.50 or later), using one
+	/// array call per field for every aircraft rather than one call per aircraft
+	/// per field as with the per-plane "sim/multiplayer/position/planeN_*" datarefs.
+	/// X-Plane mirrors the TCAS targets into the multiplayer datarefs.
+	/// </para>
+	/// <para>
+	/// Once started, every frame aircraft which haven't been given a fresh position
+	/// are extrapolated along their velocity, then every aircraft is written to X-Plane.
+	/// </para>
+	/// </remarks>
+	class TrafficManager final
+	{
+	public:
+		/// <summary>
+		/// Maximum number of aircraft, not including the user's
+		/// </summary>
+		static const int MaxAircraft = 63;
+
+		/// <summary>
+		/// Creates a traffic manager
+		/// </summary>
+		/// <param name="aircraftCount">Number of aircraft to manage, not including the user's</param>
+		/// <returns>Created traffic manager</returns>
+		static std::shared_ptr<TrafficManager> Create(int aircraftCount);
+
+		/// <summary>
+		/// Takes control of X-Plane's multiplayer aircraft
+		/// </summary>
+		/// <returns>True if the aircraft were acquired, false if another plug-in has them</returns>
+		bool Acquire();
+		/// <summary>
+		/// Stops updating and returns control of the multiplayer aircraft to X-Plane
+		/// </summary>
+		void Release();
+		/// <summary>
+		/// Are the multiplayer aircraft controlled by this manager?
+		/// </summary>
+		/// <returns>True if the aircraft have been acquired</returns>
+		inline bool IsAcquired() const
+		{
+			return m_isAcquired;
+		}
+
+		/// <summary>
+		/// Starts extrapolating and writing every aircraft each frame
+		/// </summary>
+		void Start();
+		/// <summary>
+		/// Stops the per-frame update
+		/// </summary>
+		void Stop();
+
+		/// <summary>
+		/// Gets the number of aircraft managed
+		/// </summary>
+		/// <returns>Number of aircraft, not including the user's</returns>
+		inline int GetAircraftCount() const
+		{
+			return m_aircraftCount;
+		}
+
+		/// <summary>
+		/// Gets the state of every aircraft
+		/// </summary>
+		/// <returns>State of every aircraft</returns>
+		inline const TrafficState& GetState() const
+		{
+			return m_state;
+		}
+
+		/// <summary>
+		/// Sets a fresh position of an aircraft, which won't be extrapolated this frame
+		/// </summary>
+		/// <param name="index">Index of the aircraft, from 0</param>
+		/// <param name="latitude">Latitude, in degrees</param>
+		/// <param name="longitude">Longitude, in degrees</param>
+		/// <param name="elevation">Elevation, in meters MSL</param>
+		void SetPosition(int index, double latitude, double longitude, double elevation);
+		/// <summary>
+		/// Sets the velocity of an aircraft
+		/// </summary>
+		/// <param name="index">Index of the aircraft, from 0</param>
+		/// <param name="x">Velocity along local X, in meters per second</param>
+		/// <param name="y">Velocity along local Y, in meters per second</param>
+		/// <param name="z">Velocity along local Z, in meters per second</param>
+		void SetVelocity(int index, float x, float y, float z);
+		/// <summary>
+		/// Sets the attitude of an aircraft
+		/// </summary>
+		/// <param name="index">Index of the aircraft, from 0</param>
+		/// <param name="pitch">Pitch, in degrees</param>
+		/// <param name="roll">Roll, in degrees</param>
+		/// <param name="heading">True heading, in degrees</param>
+		void SetAttitude(int index, float pitch, float roll, float heading);
+
+		/// <summary>
+		/// Reads the state of every aircraft from X-Plane
+		/// </summary>
+		void ReadAll();
+		/// <summary>
+		/// Writes the state of every aircraft to X-Plane
+		/// </summary>
+		void WriteAll();
+		/// <summary>
+		/// Moves every stale aircraft along its velocity
+		/// </summary>
+		/// <remarks>
+		/// The local position is advanced, and the world position recalculated from it.
+		/// </remarks>
+		/// <param name="elapsed">Time to extrapolate over, in seconds</param>
+		void Extrapolate(float elapsed);
+
+	private:
+		TrafficManager(int aircraftCount);
+		~TrafficManager();
+
+		TrafficManager(const TrafficManager&)				= delete;
+		TrafficManager& operator=(const TrafficManager&)	= delete;
+
+		// Fields exchanged with X-Plane, one array dataref each
+		enum Field
+		{
+			FieldX = 0,
+			FieldY,
+			FieldZ,
+			FieldVelocityX,
+			FieldVelocityY,
+			FieldVelocityZ,
+			FieldPitch,
+			FieldRoll,
+			FieldHeading,
+			FieldLatitude,
+			FieldLongitude,
+			FieldElevation,
+			FieldCount
+		};
+
+		// Number of aircraft managed
+		int m_aircraftCount;
+		// State of every aircraft
+		TrafficState m_state;
+		// Scratch array for converting the double precision fields
+		std::vector<float> m_scratch;
+		// X-Plane datarefs for each field
+		void* m_fieldDataRefs[FieldCount];
+		// X-Plane dataref overriding the TCAS targets
+		void* m_overrideDataRef;
+		// Have the multiplayer aircraft been acquired?
+		bool m_isAcquired;
+		// Per-frame update, while started
+		std::shared_ptr<FrameLoop> m_updateLoop;
+
+		// Per-frame update: extrapolates, writes, then marks every aircraft stale
+		void Update(float elapsed);
+		// Validates an aircraft index
+		void CheckIndex(int index) const;
+	};
+}
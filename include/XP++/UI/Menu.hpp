@@ -1,22 +1,25 @@
 #pragma once
 
 // STL includes
-#include <list>
 #include <functional>
 #include <memory>
 #include <string>
 #include <vector>
 
+// XP++ includes
+#include "XP++/Diagnostics/TaggedAllocator.hpp"
+
 namespace XP
 {
 	// Pre-declarations
 	class Command;
 	class MenuItem;
+	struct MenuItemDefinition;
 
 	/// <summary>
 	/// Menu containing menu items
 	/// </summary>
-	class Menu final
+	class Menu final : public std::enable_shared_from_this<Menu>, public TaggedObject<MemoryTag::Menus>
 	{
 	public:
 		friend MenuItem;
@@ -109,6 +112,10 @@ namespace XP
 		/// <summary>
 		/// Removes the given menu item from this menu
 		/// </summary>
+		/// <remarks>
+		/// Items below the removed item move up by one, and their 
+		/// <see cref="MenuItem::GetIndex"/> is updated to match X-Plane.
+		/// </remarks>
 		/// <param name="menuItem">Menu item to remove</param>
 		void RemoveMenuItem(std::weak_ptr<MenuItem> menuItem);
 		/// <summary>
@@ -118,6 +125,38 @@ namespace XP
 		/// Use this function if you need to change the number of items on a menu.
 		/// </remarks>
 		void ClearAllMenuItems();
+		/// <summary>
+		/// Updates this menu to match the given list of definitions
+		/// </summary>
+		/// <remarks>
+		/// <para>
+		/// Existing menu items are reused in place; X-Plane is only called for 
+		/// names, check states or enabled states which differ from the definition. 
+		/// Items are only appended or removed at the point where the structure 
+		/// (item vs. separator) of the menu first differs, and removal starts 
+		/// from the bottom of the menu so no remaining indices need to shift.
+		/// </para>
+		/// <para>
+		/// Child menus of reused menu items are kept.
+		/// </para>
+		/// </remarks>
+		/// <param name="definitions">Desired items of this menu, from top to bottom</param>
+		void Rebuild(const std::vector<MenuItemDefinition>& definitions);
+
+		/// <summary>
+		/// Gets the number of entries (menu items and separators) in this menu
+		/// </summary>
+		/// <returns>Number of entries in this menu</returns>
+		inline int GetEntryCount() const
+		{
+			return static_cast<int>(m_menuItems.size());
+		}
+		/// <summary>
+		/// Gets the menu item at the given index
+		/// </summary>
+		/// <param name="index">Index of the entry within this menu</param>
+		/// <returns>Menu item at the given index, or null if the entry is a separator</returns>
+		std::shared_ptr<MenuItem> GetMenuItem(int index) const;
 
 	private:
 		Menu(std::string name,
@@ -128,22 +167,25 @@ namespace XP
 		~Menu();
 
 		Menu(const Menu&)					= delete;
-		Menu& Menu::operator=(const Menu&)	= delete;
+		Menu& operator=(const Menu&)	= delete;
 
 		// Internal X-Plane ID
 		void* m_id;
-		// Child parent menu items
+		// Was the X-Plane menu created by this object? (False for the 
+		// plug-ins and aircraft menus, which are owned by X-Plane)
+		bool m_isOwned;
+		// Child menu items, indexed by their X-Plane index within this menu
+		// (separators are stored as null entries to keep indices aligned)
 		std::vector<std::shared_ptr<MenuItem>> m_menuItems;
 		// MenuItem that this menu is a child of
-		std::shared_ptr<MenuItem> m_parentMenuItem;
+		std::weak_ptr<MenuItem> m_parentMenuItem;
 		// Name of the menu
 		std::string m_name;
 
-		// All created menus
-		static std::list<std::weak_ptr<Menu>> m_menus;
-
-		// Finds the shared pointer to this menu
-		std::shared_ptr<Menu> GetPtrToThisMenu() const;
+		// Removes the entry at the given index, updating the indices of the entries below
+		void RemoveEntryAt(int index);
+		// Removes all entries from the given index to the bottom of the menu
+		void TruncateEntries(int count);
 		// Creates the aircraft menu object
 		static std::shared_ptr<Menu> CreateAircraftMenu();
 		// Creates the plug-in menu object
@@ -4,12 +4,16 @@
 #include <functional>
 #include <memory>
 #include <string>
-#include <list>
+
+// XP++ includes
+#include "XP++/Diagnostics/TaggedAllocator.hpp"
 
 namespace XP
 {
 	// Pre-declarations
+	class Command;
 	class Menu;
+	class MenuItem;
 
 	/// <summary>
 	/// Represents the various 'check' states for an X-Plane Menu Item
@@ -37,36 +41,72 @@ namespace XP
 	};
 
 	/// <summary>
-	/// Represents a click-able item within a <see cref="Menu"/>
+	/// Describes the desired state of a single entry within a <see cref="Menu"/>
 	/// </summary>
-	class MenuItem final
+	/// <remarks>
+	/// Used with <see cref="Menu::Rebuild"/>, which compares a list of 
+	/// definitions against the menu's current items and only calls into 
+	/// X-Plane for the entries which actually differ.
+	/// </remarks>
+	struct MenuItemDefinition
 	{
-	public:
-		friend Menu;
+		/// <summary>
+		/// Defines a click-able menu item
+		/// </summary>
+		/// <param name="name">Name of the menu item</param>
+		/// <param name="onClick">Function to execute when the user clicks this menu item</param>
+		/// <param name="checkState">Check state of the menu item</param>
+		/// <param name="isEnabled">True if the menu item can be clicked</param>
+		MenuItemDefinition(std::string name,
+						   std::function<void(MenuItem&)> onClick	= std::function<void(MenuItem&)>(),
+						   MenuCheck checkState						= MenuCheck::NoCheck,
+						   bool isEnabled							= true) :
+			name(name), onClick(onClick), checkState(checkState), 
+			isEnabled(isEnabled), isSeparator(false)
+		{
+
+		}
 
 		/// <summary>
-		/// Appends a new MenuItem to the menu bar of X-Plane
+		/// Defines a separator
 		/// </summary>
-		/// <param name="name">Name of this MenuItem</param>
-		/// <param name="onClick">Function to execute upon clicking this MenuItem</param>
-		/// <returns>Created MenuItem</returns>
-		inline static std::shared_ptr<MenuItem> AppendToMenubar(std::string name, 
-																std::function<void(MenuItem&)> onClick)
+		/// <returns>Definition of a menu separator</returns>
+		static MenuItemDefinition Separator()
 		{
-			std::shared_ptr<MenuItem> menuItem(new MenuItem(std::weak_ptr<Menu>(), name, onClick), [](MenuItem* menuItem)
-			{
-				delete menuItem;
-			});
-			m_menuItems.push_back(menuItem);
+			MenuItemDefinition separator("");
+			separator.isSeparator = true;
 
-			return menuItem;
+			return separator;
 		}
 
+		// Name of the menu item
+		std::string name;
+		// Function to execute when the menu item is clicked
+		std::function<void(MenuItem&)> onClick;
+		// Check state of the menu item
+		MenuCheck checkState;
+		// Is the menu item enabled?
+		bool isEnabled;
+		// Is this entry a separator rather than a menu item?
+		bool isSeparator;
+	};
+
+	/// <summary>
+	/// Represents a click-able item within a <see cref="Menu"/>
+	/// </summary>
+	class MenuItem final : public std::enable_shared_from_this<MenuItem>, public TaggedObject<MemoryTag::Menus>
+	{
+	public:
+		friend Menu;
+
 		/// <summary>
 		/// Returns a reference to the parent <see cref="Menu"/> 
 		/// of this menu item
 		/// </summary>
-		/// <returns>Reference to the parent <see cref="Menu"/></returns>
+		/// <returns>
+		/// Reference to the parent <see cref="Menu"/>, or null if 
+		/// this menu item has been removed from its menu
+		/// </returns>
 		inline std::weak_ptr<Menu> GetParentMenu() const
 		{
 			return m_parentMenu;
@@ -138,7 +178,10 @@ namespace XP
 		/// Gets whether the menu item is currently checked or not
 		/// </summary>
 		/// <returns>Current check state</returns>
-		MenuCheck GetCheckState() const;
+		inline MenuCheck GetCheckState() const
+		{
+			return m_checkState;
+		}
 		/// <summary>
 		/// Sets this menu item's check state
 		/// </summary>
@@ -168,6 +211,10 @@ namespace XP
 		/// <summary>
 		/// Gets the index of this menu item within its parent <see cref="Menu"/>
 		/// </summary>
+		/// <remarks>
+		/// The index is kept up to date as other items are removed from 
+		/// the parent menu. Returns -1 once this item has been removed.
+		/// </remarks>
 		/// <returns>Index of this menu item</returns>
 		inline int GetIndex() const
 		{
@@ -178,10 +225,13 @@ namespace XP
 		MenuItem(std::weak_ptr<Menu> menu,
 				 std::string name,
 				 std::function<void(MenuItem&)> onClick);
+		MenuItem(std::weak_ptr<Menu> menu,
+				 std::string name,
+				 std::weak_ptr<Command> command);
 		~MenuItem();
 
 		MenuItem(const MenuItem&)						= delete;
-		MenuItem& MenuItem::operator=(const MenuItem&)	= delete;
+		MenuItem& operator=(const MenuItem&)	= delete;
 
 		// Index of this menu item within the parent menu
 		// (refers to the plug-in relative index, if in a menu 
@@ -189,17 +239,24 @@ namespace XP
 		int m_index;
 		// Is this menu item currently enabled?
 		bool m_isEnabled;
+		// Current check state of this menu item
+		MenuCheck m_checkState;
 		// Name of thus menu-item
 		std::string m_name;
 
 		// Parent menu of this menu item
-		std::shared_ptr<Menu> m_parentMenu;
+		std::weak_ptr<Menu> m_parentMenu;
+		// Internal X-Plane ID of the parent menu, cached so 
+		// X-Plane calls don't need to lock the parent menu
+		void* m_parentMenuID;
 		// Child menu of this menu item
 		std::shared_ptr<Menu> m_childMenu;
 		// Event function for when this menu item is clicked
 		std::function<void(MenuItem&)> m_onClick;
 
-		// Created MenuItems
-		static std::list<std::weak_ptr<MenuItem>> m_menuItems;
+		// Applies the given definition, only calling X-Plane for changed state
+		void Apply(const MenuItemDefinition& definition);
+		// Detaches this menu item from its parent menu, once removed from X-Plane
+		void Detach();
 	};
 }
@@ -2,3 +2,4 @@
 
 #include "Menu.hpp"
 #include "MenuItem.hpp"
+#include "PagedMenu.hpp"
@@ -0,0 +1,152 @@
+#pragma once
+
+// STL includes
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace XP
+{
+	// Pre-declarations
+	class Menu;
+	class MenuItem;
+
+	/// <summary>
+	/// Displays a very large list of entries within a <see cref="Menu"/>,
+	/// one page at a time
+	/// </summary>
+	/// <remarks>
+	/// <para>
+	/// Entries are never stored by the paged menu; they're requested from
+	/// the given data source functions only for the page currently shown.
+	/// Only a single page of <see cref="MenuItem"/>s ever exists, and changing
+	/// page reuses those items through <see cref="Menu::Rebuild"/>, so the cost
+	/// of building and paging the menu is independent of the size of the source.
+	/// </para>
+	/// <para>
+	/// When alphabetic buckets are enabled, the data source must be sorted by
+	/// name (case-insensitive). Entries starting with anything but a letter are
+	/// under '#'. Buckets are found by binary searching the source, and are only
+	/// recalculated when a page is built after the entry count changed (X-Plane
+	/// doesn't say when a menu is opened, so they can't wait until then).
+	/// </para>
+	/// </remarks>
+	class PagedMenu final
+	{
+	public:
+		/// <summary>
+		/// Creates a paged menu which takes over the items of the given menu
+		/// </summary>
+		/// <param name="menu">Menu to display the pages within</param>
+		/// <param name="pageSize">Maximum number of entries shown per page</param>
+		/// <param name="getCount">Returns the number of entries within the data source</param>
+		/// <param name="getName">Returns the name of the entry at the given index</param>
+		/// <param name="onSelect">Called with the index of the entry the user clicked</param>
+		/// <returns>Created paged menu, showing the first page</returns>
+		static std::shared_ptr<PagedMenu> Create(std::weak_ptr<Menu> menu,
+												 int pageSize,
+												 std::function<int()> getCount,
+												 std::function<std::string(int)> getName,
+												 std::function<void(int)> onSelect);
+
+		/// <summary>
+		/// Re-reads the entry count from the data source and rebuilds the current page
+		/// </summary>
+		/// <remarks>
+		/// Call this whenever the data source changes.
+		/// </remarks>
+		void Refresh();
+
+		/// <summary>
+		/// Shows the given page
+		/// </summary>
+		/// <param name="page">Page to show, clamped to the available pages</param>
+		void ShowPage(int page);
+		/// <summary>
+		/// Shows the next page, if any
+		/// </summary>
+		inline void NextPage()
+		{
+			ShowPage(m_page + 1);
+		}
+		/// <summary>
+		/// Shows the previous page, if any
+		/// </summary>
+		inline void PreviousPage()
+		{
+			ShowPage(m_page - 1);
+		}
+		/// <summary>
+		/// Shows the page containing the entry at the given index
+		/// </summary>
+		/// <param name="index">Index of the entry within the data source</param>
+		void ShowEntry(int index);
+
+		/// <summary>
+		/// Gets the page currently shown
+		/// </summary>
+		/// <returns>Zero based index of the current page</returns>
+		inline int GetPage() const
+		{
+			return m_page;
+		}
+		/// <summary>
+		/// Gets the number of pages available
+		/// </summary>
+		/// <returns>Number of pages, at least one</returns>
+		int GetPageCount() const;
+
+		/// <summary>
+		/// Enables or disables the "Jump to" menu of alphabetic buckets
+		/// </summary>
+		/// <param name="enabled">True to show alphabetic buckets</param>
+		void SetBucketsEnabled(bool enabled);
+		/// <summary>
+		/// Are alphabetic buckets shown?
+		/// </summary>
+		/// <returns>True if alphabetic buckets are shown</returns>
+		inline bool AreBucketsEnabled() const
+		{
+			return m_areBucketsEnabled;
+		}
+
+	private:
+		PagedMenu(std::weak_ptr<Menu> menu,
+				  int pageSize,
+				  std::function<int()> getCount,
+				  std::function<std::string(int)> getName,
+				  std::function<void(int)> onSelect);
+		~PagedMenu();
+
+		PagedMenu(const PagedMenu&)				= delete;
+		PagedMenu& operator=(const PagedMenu&)	= delete;
+
+		// Menu the pages are shown in
+		std::weak_ptr<Menu> m_menu;
+		// Maximum number of entries per page
+		int m_pageSize;
+		// Page currently shown
+		int m_page;
+		// Number of entries within the data source, as of the last refresh
+		int m_count;
+		// Are alphabetic buckets shown?
+		bool m_areBucketsEnabled;
+		// Entry count the buckets were last calculated for (-1 if never)
+		int m_bucketCount;
+
+		// Returns the number of entries within the data source
+		std::function<int()> m_getCount;
+		// Returns the name of an entry within the data source
+		std::function<std::string(int)> m_getName;
+		// Called when an entry is clicked
+		std::function<void(int)> m_onSelect;
+
+		// Rebuilds the menu for the current page
+		void Build();
+		// Rebuilds the "Jump to" menu, if the data source changed size
+		void BuildBuckets(std::shared_ptr<MenuItem> jumpToItem);
+		// Finds the first entry whose name sorts at or after the given letter
+		int FindFirstEntry(unsigned char letter) const;
+	};
+}
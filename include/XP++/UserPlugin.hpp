@@ -4,8 +4,11 @@
 #include <string>
 
 // XP++ includes
+#include "XP++/Diagnostics/CallbackGuard.hpp"
 #include "XP++/Message.hpp"
+#include "XP++/MessageDispatcher.hpp"
 #include "XP++/Plugins/Plugin.hpp"
+#include "XP++/Processing/ThreadPool.hpp"
 
 namespace XP
 {
@@ -160,10 +163,12 @@ namespace XP
 UserPlugin* g_userPlugin;																			\
 extern "C" __declspec(dllexport) int XPluginStart(char* outName, char* outSig, char* outDesc)		\
 {																									\
-	g_userPlugin = new UserPlugin();																\
-																									\
 	std::string name, signature, description;														\
-	bool status = g_userPlugin->OnStart(name, signature, description);								\
+	bool status = XP::CallbackGuard::Invoke(XP::CallbackType::Plugin, nullptr, false, [&]()			\
+	{																								\
+		g_userPlugin = new UserPlugin();															\
+		return g_userPlugin->OnStart(name, signature, description);									\
+	});																								\
 																									\
 	strcpy(outName, name.c_str());																	\
 	strcpy(outSig, signature.c_str());																\
@@ -174,21 +179,36 @@ extern "C" __declspec(dllexport) int XPluginStart(char* outName, char* outSig, c
 																									\
 extern "C" __declspec(dllexport) void XPluginStop()													\
 {																									\
-	g_userPlugin->OnStop();																			\
+	XP::CallbackGuard::Invoke(XP::CallbackType::Plugin, g_userPlugin, [&]()							\
+	{																								\
+		g_userPlugin->OnStop();																		\
+	});																								\
+																									\
+	/* Join the shared pool's threads now, rather than while the DLL is unloaded */				\
+	XP::ThreadPool::ReleaseShared();																\
 }																									\
 																									\
 extern "C" __declspec(dllexport) void XPluginDisable()												\
 {																									\
-	g_userPlugin->Disable();																		\
+	XP::CallbackGuard::Invoke(XP::CallbackType::Plugin, g_userPlugin, [&]()							\
+	{																								\
+		g_userPlugin->OnDisable();																	\
+	});																								\
 }																									\
 																									\
 extern "C" __declspec(dllexport) int XPluginEnable()												\
 {																									\
-	return static_cast<int>(g_userPlugin->OnEnable());												\
+	return static_cast<int>(XP::CallbackGuard::Invoke(XP::CallbackType::Plugin, g_userPlugin, false, [&]()\
+	{																								\
+		return g_userPlugin->OnEnable();															\
+	}));																							\
 }																									\
 																									\
 extern "C" __declspec(dllexport) void XPluginReceiveMessage(int inFrom, int inMsg, void* inParam)	\
 {																									\
-	g_userPlugin->OnReceiveMessage(XP::Plugin(inFrom), XP::Message(inMsg, inParam), inParam);		\
+	XP::MessageDispatcher::Dispatch(inFrom, inMsg, inParam);										\
+	XP::CallbackGuard::Invoke(XP::CallbackType::Plugin, g_userPlugin, [&]()							\
+	{																								\
+		g_userPlugin->OnReceiveMessage(XP::Plugin(inFrom), XP::Message(inMsg, inParam), inParam);	\
+	});																								\
 }
-																									
@@ -0,0 +1,176 @@
+#include "XP++/Commands/Command.hpp"
+
+// STL includes
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+
+// XP++ includes
+#include "XP++/Diagnostics/CallbackGuard.hpp"
+#include "XP++/Exceptions/XPException.hpp"
+
+// X-Plane SDK includes
+#include "XPLMUtilities.h"
+
+std::vector<XP::Command::HandlerSlot, XP::TaggedAllocator<XP::Command::HandlerSlot, XP::MemoryTag::Commands>> XP::Command::m_handlerTable;
+int XP::Command::m_firstFreeSlot = -1;
+
+XP::Command::Command(std::string name, void* id) :
+	m_name(name), m_id(id), m_handlers()
+{
+
+}
+
+XP::Command::~Command()
+{
+	// Unregister all handlers registered through this object
+	for (const CommandHandlerID& handlerID : m_handlers)
+	{
+		FreeSlot(handlerID.m_index);
+	}
+}
+
+std::shared_ptr<XP::Command> XP::Command::FindCommand(std::string name)
+{
+	XPLMCommandRef commandRef = XPLMFindCommand(name.c_str());
+	if (commandRef == nullptr)
+	{
+		// Requested command doesn't exist
+		return std::shared_ptr<Command>(nullptr);
+	}
+
+	return CreateWrapper(name, commandRef);
+}
+
+std::shared_ptr<XP::Command> XP::Command::CreateCommand(std::string name, std::string description)
+{
+	XPLMCommandRef commandRef = XPLMCreateCommand(name.c_str(), description.c_str());
+	if (commandRef == nullptr)
+	{
+		throw XPException("Failed to create Command: " + name);
+	}
+
+	return CreateWrapper(name, commandRef);
+}
+
+void XP::Command::Begin()
+{
+	XPLMCommandBegin(m_id);
+}
+
+void XP::Command::End()
+{
+	XPLMCommandEnd(m_id);
+}
+
+void XP::Command::Once()
+{
+	XPLMCommandOnce(m_id);
+}
+
+XP::CommandHandlerID XP::Command::RegisterHandler(CommandHandler handler, void* userData, bool before)
+{
+	// Ensure arguments are valid
+	if (handler == nullptr)
+	{
+		throw std::invalid_argument("handler is NULL");
+	}
+
+	// Reuse a free slot if possible, keeping the table compact
+	int index = m_firstFreeSlot;
+	if (index >= 0)
+	{
+		m_firstFreeSlot = m_handlerTable[index].nextFree;
+	}
+	else
+	{
+		HandlerSlot newSlot = {};
+		m_handlerTable.push_back(newSlot);
+		index = static_cast<int>(m_handlerTable.size()) - 1;
+	}
+
+	HandlerSlot& slot	= m_handlerTable[index];
+	slot.command		= this;
+	slot.handler		= handler;
+	slot.userData		= userData;
+	slot.before			= before;
+	slot.nextFree		= -1;
+
+	// The refcon is the index into the handler table
+	XPLMRegisterCommandHandler(m_id,
+							   &Command::CommandCallback,
+							   static_cast<int>(before),
+							   reinterpret_cast<void*>(static_cast<intptr_t>(index)));
+
+	CommandHandlerID handlerID(index, slot.generation);
+	m_handlers.push_back(handlerID);
+
+	return handlerID;
+}
+
+void XP::Command::UnregisterHandler(CommandHandlerID handlerID)
+{
+	// Ensure the handler was registered through this object
+	auto foundHandler = std::find(m_handlers.begin(), m_handlers.end(), handlerID);
+	if (foundHandler == m_handlers.end())
+	{
+		return;
+	}
+	m_handlers.erase(foundHandler);
+
+	FreeSlot(handlerID.m_index);
+}
+
+std::shared_ptr<XP::Command> XP::Command::CreateWrapper(std::string name, void* id)
+{
+	std::shared_ptr<Command> command(new Command(name, id), [](Command* command)
+	{
+		delete command;
+	}, TaggedAllocator<Command, MemoryTag::Commands>());
+
+	return command;
+}
+
+void XP::Command::FreeSlot(int index)
+{
+	HandlerSlot& slot = m_handlerTable[index];
+
+	XPLMUnregisterCommandHandler(slot.command->m_id,
+								 &Command::CommandCallback,
+								 static_cast<int>(slot.before),
+								 reinterpret_cast<void*>(static_cast<intptr_t>(index)));
+
+	slot.command	= nullptr;
+	slot.handler	= nullptr;
+	slot.userData	= nullptr;
+	slot.generation++;
+	slot.nextFree	= m_firstFreeSlot;
+	m_firstFreeSlot	= index;
+}
+
+int XP::Command::CommandCallback(void*, int inPhase, void* inRefcon)
+{
+	size_t index = static_cast<size_t>(reinterpret_cast<intptr_t>(inRefcon));
+	if (index >= m_handlerTable.size())
+	{
+		// Unknown handler, let X-Plane continue
+		return 1;
+	}
+
+	// Copy out of the table, as the handler may register
+	// other handlers and cause the table to grow
+	const HandlerSlot& slot	= m_handlerTable[index];
+	Command* command		= slot.command;
+	CommandHandler handler	= slot.handler;
+	void* userData			= slot.userData;
+	if (command == nullptr)
+	{
+		return 1;
+	}
+
+	// Let X-Plane continue processing the command if the handler throws
+	return CallbackGuard::Invoke(CallbackType::Command, command, 1, [=]()
+	{
+		return static_cast<int>(handler(*command, static_cast<CommandPhase>(inPhase), userData));
+	});
+}
@@ -0,0 +1,217 @@
+#include "XP++/DataAccess/ArrayDataRefView.hpp"
+
+// STL includes
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+
+// XP++ includes
+#include "XP++/DataAccess/DataRef.hpp"
+
+// Platform includes
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define XPPLUSPLUS_SSE2 1
+#include <emmintrin.h>
+#endif
+
+namespace
+{
+	// Reads array data of either element type
+	inline int GetArrayData(XP::DataRef& dataRef, float* outValues, int offset, int max)
+	{
+		return dataRef.GetFloatArrayData(outValues, offset, max);
+	}
+	inline int GetArrayData(XP::DataRef& dataRef, int* outValues, int offset, int max)
+	{
+		return dataRef.GetIntArrayData(outValues, offset, max);
+	}
+
+	// Writes array data of either element type
+	inline void SetArrayData(XP::DataRef& dataRef, float* inValues, int offset, int count)
+	{
+		dataRef.SetFloatArrayData(inValues, offset, count);
+	}
+	inline void SetArrayData(XP::DataRef& dataRef, int* inValues, int offset, int count)
+	{
+		dataRef.SetIntArrayData(inValues, offset, count);
+	}
+
+	// Finds the first index from start where the values are (or aren't) bitwise equal, or count if there's none
+	template<bool IsFindingEqual>
+	int FindNext(const uint32_t* values, const uint32_t* shadow, int start, int count)
+	{
+		int i = start;
+
+#ifdef XPPLUSPLUS_SSE2
+		// Compares 4 elements at a time, only looking at single elements within a block which has a match
+		for (; i + 4 <= count; i += 4)
+		{
+			__m128i equal	= _mm_cmpeq_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(values + i)),
+											  _mm_loadu_si128(reinterpret_cast<const __m128i*>(shadow + i)));
+			int equalMask	= _mm_movemask_ps(_mm_castsi128_ps(equal));
+			int matchMask	= IsFindingEqual ? equalMask : (~equalMask & 0xF);
+			if (matchMask != 0)
+			{
+				int lane = 0;
+				while ((matchMask & (1 << lane)) == 0)
+				{
+					++lane;
+				}
+				return i + lane;
+			}
+		}
+#else
+		// Compares 2 elements at a time, then finds which one matched
+		for (; i + 2 <= count; i += 2)
+		{
+			uint64_t value, shadowValue;
+			std::memcpy(&value, values + i, sizeof(value));
+			std::memcpy(&shadowValue, shadow + i, sizeof(shadowValue));
+			if (IsFindingEqual ? (values[i] == shadow[i] || values[i + 1] == shadow[i + 1]) : value != shadowValue)
+			{
+				break;
+			}
+		}
+#endif
+
+		for (; i < count; ++i)
+		{
+			if ((values[i] == shadow[i]) == IsFindingEqual)
+			{
+				return i;
+			}
+		}
+
+		return count;
+	}
+}
+
+template<typename T>
+XP::ArrayDataRefView<T>::ArrayDataRefView(std::shared_ptr<DataRef> dataRef, int offset, int count, int stride) :
+	m_dataRef(dataRef), m_offset(offset), m_stride(stride), m_maxGap(0),
+	m_values(count), m_shadow(count), m_readBuffer()
+{
+
+}
+
+template<typename T>
+std::shared_ptr<XP::ArrayDataRefView<T>> XP::ArrayDataRefView<T>::Create(std::shared_ptr<DataRef> dataRef,
+																		 int offset, int count, int stride)
+{
+	// Ensure arguments are valid
+	if (dataRef == nullptr)
+	{
+		throw std::invalid_argument("dataRef is NULL");
+	}
+	if (offset < 0)
+	{
+		throw std::invalid_argument("offset must not be negative");
+	}
+	if (stride < 1)
+	{
+		throw std::invalid_argument("stride must be at least 1");
+	}
+
+	if (count < 0)
+	{
+		// Passing NULL returns the size of the array
+		int size	= GetArrayData(*dataRef, static_cast<T*>(nullptr), 0, 0);
+		count		= size > offset ? (size - offset + stride - 1) / stride : 0;
+	}
+
+	std::shared_ptr<ArrayDataRefView<T>> view(new ArrayDataRefView<T>(dataRef, offset, count, stride), [](ArrayDataRefView<T>* view)
+	{
+		delete view;
+	}, TaggedAllocator<ArrayDataRefView<T>, MemoryTag::Caches>());
+	view->Read();
+
+	return view;
+}
+
+template<typename T>
+const T* XP::ArrayDataRefView<T>::Read(int offset, int count)
+{
+	// Ensure arguments are valid
+	if (offset < 0 || count < 0 || offset + count > GetCount())
+	{
+		throw std::out_of_range("Range is outside of the view");
+	}
+	if (count == 0)
+	{
+		return m_values.data() + offset;
+	}
+
+	int dataRefOffset = m_offset + offset * m_stride;
+	if (m_stride == 1)
+	{
+		int readCount = GetArrayData(*m_dataRef, m_values.data() + offset, dataRefOffset, count);
+
+		// Elements past the end of a shorter data ref read as 0
+		std::fill(m_values.begin() + offset + std::max(readCount, 0), m_values.begin() + offset + count, T());
+	}
+	else
+	{
+		// Read everything spanned by the slice in one call, then pick out the slice's elements
+		int spanCount = (count - 1) * m_stride + 1;
+		m_readBuffer.assign(spanCount, T());
+		GetArrayData(*m_dataRef, m_readBuffer.data(), dataRefOffset, spanCount);
+
+		for (int i = 0; i < count; ++i)
+		{
+			m_values[offset + i] = m_readBuffer[i * m_stride];
+		}
+	}
+
+	std::copy(m_values.begin() + offset, m_values.begin() + offset + count, m_shadow.begin() + offset);
+
+	return m_values.data() + offset;
+}
+
+template<typename T>
+int XP::ArrayDataRefView<T>::Commit()
+{
+	static_assert(sizeof(T) == sizeof(uint32_t), "Elements are compared as 32 bit patterns");
+
+	// Compared bitwise, so a NaN left alone isn't rewritten every frame
+	const uint32_t* values	= reinterpret_cast<const uint32_t*>(m_values.data());
+	const uint32_t* shadow	= reinterpret_cast<const uint32_t*>(m_shadow.data());
+	const int count			= GetCount();
+	// Strided elements can't be written together, as the elements between them aren't ours
+	const int maxGap		= m_stride == 1 ? m_maxGap : 0;
+
+	int writeCount = 0;
+	for (int start = FindNext<false>(values, shadow, 0, count); start < count;)
+	{
+		// Extend the range over changes separated by small enough gaps
+		int end		= FindNext<true>(values, shadow, start + 1, count);
+		int next	= FindNext<false>(values, shadow, end, count);
+		while (next < count && next - end <= maxGap)
+		{
+			end		= FindNext<true>(values, shadow, next + 1, count);
+			next	= FindNext<false>(values, shadow, end, count);
+		}
+
+		if (m_stride == 1)
+		{
+			SetArrayData(*m_dataRef, m_values.data() + start, m_offset + start, end - start);
+			++writeCount;
+		}
+		else
+		{
+			for (int i = start; i < end; ++i)
+			{
+				SetArrayData(*m_dataRef, m_values.data() + i, m_offset + i * m_stride, 1);
+				++writeCount;
+			}
+		}
+
+		std::copy(m_values.begin() + start, m_values.begin() + end, m_shadow.begin() + start);
+		start = next;
+	}
+
+	return writeCount;
+}
+
+template class XP::ArrayDataRefView<float>;
+template class XP::ArrayDataRefView<int>;
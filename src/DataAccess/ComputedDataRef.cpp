@@ -0,0 +1,183 @@
+#include "XP++/DataAccess/ComputedDataRef.hpp"
+
+// STL includes
+#include <stdexcept>
+#include <unordered_map>
+
+// XP++ includes
+#include "XP++/DataAccess/DataRefType.hpp"
+#include "XP++/DataAccess/UserDataRef.hpp"
+
+// X-Plane SDK includes
+#include "XPLMProcessing.h"
+
+namespace
+{
+	// A data ref read once a frame
+	class DataRefValue final : public XP::ComputedValue
+	{
+	public:
+		DataRefValue(std::shared_ptr<XP::DataRef> dataRef) :
+			m_dataRef(dataRef), m_type(XP::DataType::Unknown)
+		{
+			// Read in the most precise type offered
+			XP::DataRefType type = dataRef->GetType();
+			if (type.SupportsDouble())
+			{
+				m_type = XP::DataType::Double;
+			}
+			else if (type.SupportsFloat())
+			{
+				m_type = XP::DataType::Float;
+			}
+			else if (type.SupportsInteger())
+			{
+				m_type = XP::DataType::Int;
+			}
+			else
+			{
+				throw std::invalid_argument("Data ref isn't a number: " + dataRef->GetName());
+			}
+		}
+
+	private:
+		// Data ref read
+		std::shared_ptr<XP::DataRef> m_dataRef;
+		// Type the data ref is read as
+		XP::DataType m_type;
+
+		void Update(int) override
+		{
+			switch (m_type)
+			{
+			case XP::DataType::Double:
+				SetValue(m_dataRef->GetDoubleData());
+				break;
+			case XP::DataType::Float:
+				SetValue(m_dataRef->GetFloatData());
+				break;
+			default:
+				SetValue(m_dataRef->GetIntData());
+				break;
+			}
+		}
+	};
+
+	// Values of the data refs used as inputs, shared between the computed data refs reading them
+	std::unordered_map<XP::DataRef*, std::weak_ptr<XP::ComputedValue>, std::hash<XP::DataRef*>, std::equal_to<XP::DataRef*>,
+		XP::TaggedAllocator<std::pair<XP::DataRef* const, std::weak_ptr<XP::ComputedValue>>, XP::MemoryTag::Caches>> g_dataRefValues;
+}
+
+std::shared_ptr<XP::ComputedValue> XP::ComputedInput::Resolve(std::shared_ptr<DataRef> dataRef)
+{
+	// Ensure arguments are valid
+	if (dataRef == nullptr)
+	{
+		throw std::invalid_argument("dataRef is NULL");
+	}
+
+	std::weak_ptr<ComputedValue>& sharedValue = g_dataRefValues[dataRef.get()];
+	std::shared_ptr<ComputedValue> value = sharedValue.lock();
+	if (value == nullptr)
+	{
+		DataRef* key = dataRef.get();
+		value = std::shared_ptr<ComputedValue>(new DataRefValue(dataRef), [key](ComputedValue* value)
+		{
+			// Only forget the data ref if it hasn't been shared again since expiring
+			auto foundValue = g_dataRefValues.find(key);
+			if (foundValue != g_dataRefValues.end() && foundValue->second.expired())
+			{
+				g_dataRefValues.erase(foundValue);
+			}
+
+			delete value;
+		}, TaggedAllocator<ComputedValue, MemoryTag::Caches>());
+		sharedValue = value;
+	}
+
+	return value;
+}
+
+std::shared_ptr<XP::ComputedValue> XP::ComputedInput::Resolve(std::shared_ptr<ComputedValue> value)
+{
+	// Ensure arguments are valid
+	if (value == nullptr)
+	{
+		throw std::invalid_argument("value is NULL");
+	}
+
+	return value;
+}
+
+XP::ComputedDataRef::ComputedDataRef(std::vector<ComputedInput> inputs, ComputeFunction compute) :
+	ComputedValue(), m_inputs(), m_inputVersions(inputs.size(), 0),
+	m_inputValues(inputs.size(), 0.0), m_compute(compute), m_computeCount(0), m_dataRef()
+{
+	m_inputs.reserve(inputs.size());
+	for (const ComputedInput& input : inputs)
+	{
+		m_inputs.push_back(input.GetValue());
+	}
+}
+
+std::shared_ptr<XP::ComputedDataRef> XP::ComputedDataRef::Create(std::string name, std::vector<ComputedInput> inputs,
+																 ComputeFunction compute)
+{
+	// Ensure arguments are valid
+	if (compute == nullptr)
+	{
+		throw std::invalid_argument("compute is NULL");
+	}
+
+	std::shared_ptr<ComputedDataRef> computedDataRef(new ComputedDataRef(inputs, compute), [](ComputedDataRef* computedDataRef)
+	{
+		delete computedDataRef;
+	}, TaggedAllocator<ComputedDataRef, MemoryTag::Caches>());
+
+	if (!name.empty())
+	{
+		// The data ref is owned by the computed data ref, so never outlives it
+		ComputedDataRef* value = computedDataRef.get();
+		computedDataRef->m_dataRef = UserDataRef::RegisterDataAccessor(name,
+			DataRefType(static_cast<int>(DataType::Float) | static_cast<int>(DataType::Double)), false);
+		computedDataRef->m_dataRef->SetOnReadFloat([value]()
+		{
+			return static_cast<float>(value->GetValue());
+		});
+		computedDataRef->m_dataRef->SetOnReadDouble([value]()
+		{
+			return value->GetValue();
+		});
+	}
+
+	return computedDataRef;
+}
+
+double XP::ComputedDataRef::GetValue()
+{
+	return Evaluate(XPLMGetCycleNumber());
+}
+
+void XP::ComputedDataRef::Update(int cycleNumber)
+{
+	// Inputs are evaluated first, so the graph is walked in dependency order
+	bool isChanged = m_computeCount == 0;
+	for (size_t i = 0; i < m_inputs.size(); ++i)
+	{
+		m_inputValues[i]	= m_inputs[i]->Evaluate(cycleNumber);
+		isChanged			= isChanged || m_inputs[i]->GetVersion() != m_inputVersions[i];
+	}
+	if (!isChanged)
+	{
+		return;
+	}
+
+	SetValue(m_compute(m_inputValues.data()));
+	++m_computeCount;
+
+	// Only once computed, so a compute which threw is retried next frame
+	for (size_t i = 0; i < m_inputs.size(); ++i)
+	{
+		m_inputVersions[i] = m_inputs[i]->GetVersion();
+	}
+}
@@ -2,85 +2,107 @@
 
 // STL includes
 #include <algorithm>
+#include <iterator>
 #include <stdexcept>
 
 // XP++ includes
 #include "XP++/DataAccess/DataRefType.hpp"
 #include "XP++/Exceptions/XPException.hpp"
+#include "XP++/Processing/FrameTiming.hpp"
 
 // X-Plane SDK includes
 #include "XPLMDataAccess.h"
 
-std::list<std::weak_ptr<XP::DataRef>> XP::DataRef::m_dataRefs;
+XP::DataRef::Registry XP::DataRef::m_dataRefs;
+size_t XP::DataRef::m_sweepSize = 0;
+bool XP::DataRef::m_isCachingEnabled = false;
 
-XP::DataRef::DataRef(std::string name, void* id) :
-	m_id(id), m_name(name)
+namespace
 {
-
+	// Registry size below which expired entries aren't swept
+	const size_t MinimumSweepSize = 64;
 }
 
-XP::DataRef::~DataRef()
+XP::DataRef::DataRef(std::string name, void* id) :
+	m_name(name), m_id(id), m_cacheMode(DataRefCacheMode::Default), m_cache()
 {
-	// Destroy X-Plane Data Ref
-	XPLMUnregisterDataAccessor(m_id);
+	InvalidateCache();
 }
 
 std::weak_ptr<XP::DataRef> XP::DataRef::FindDataRef(std::string name)
 {
 	// Attempt to find created data ref
-	auto foundDataRefItr = std::find_if(m_dataRefs.begin(), m_dataRefs.end(), [&name](const std::weak_ptr<DataRef>& dataRef)
+	auto foundEntry = m_dataRefs.find(name);
+	if (foundEntry != m_dataRefs.end() && !foundEntry->second.dataRef.expired())
+	{
+		// Found requested DataRef
+		return foundEntry->second.dataRef;
+	}
+
+	// Requested DataRef not found, create it
+	void* foundDataRef = XPLMFindDataRef(name.c_str());
+	if (foundDataRef == nullptr)
+	{
+		// Requested DataRef doesn't exist
+		return std::shared_ptr<DataRef>(nullptr);
+	}
+
+	// Create wrapper object, owned by the registry; it may be destroyed while the registry is, so mustn't touch it
+	std::shared_ptr<DataRef> dataRef(new DataRef(name, foundDataRef), [](DataRef* dataRefToDelete)
+	{
+		delete dataRefToDelete;
+	}, TaggedAllocator<DataRef, MemoryTag::DataRefs>());
+	Register(dataRef, true);
+
+	return dataRef;
+}
+
+void XP::DataRef::ReleaseFoundDataRefs()
+{
+	for (auto entry = m_dataRefs.begin(); entry != m_dataRefs.end();)
 	{
-		if (dataRef.expired())
+		entry->second.owner.reset();
+
+		// Data refs still locked elsewhere keep their entry until swept
+		if (entry->second.dataRef.expired())
 		{
-			return false;
+			entry = m_dataRefs.erase(entry);
 		}
 		else
 		{
-			std::shared_ptr<DataRef> lockedDataRef = dataRef.lock();
-			return lockedDataRef->GetName() == name;
+			++entry;
 		}
-	});
-
-	if (foundDataRefItr != m_dataRefs.end())
-	{
-		// Found requested DataRef
-		return (*foundDataRefItr);
 	}
-	else
+
+	m_sweepSize = std::max(MinimumSweepSize, m_dataRefs.size() * 2);
+}
+
+void XP::DataRef::Register(const std::shared_ptr<DataRef>& dataRef, bool isOwned)
+{
+	// Entries of released data refs expire without being erased, so are swept each time the registry
+	// doubles in size, keeping the cost amortised O(1) per registration
+	if (m_dataRefs.size() >= m_sweepSize)
 	{
-		// Requested DataRef not found, create it
-		void* foundDataRef = XPLMFindDataRef(name.c_str());
-		if (foundDataRef == nullptr)
+		for (auto entry = m_dataRefs.begin(); entry != m_dataRefs.end();)
 		{
-			// Requested DataRef doesn't exist
-			return std::shared_ptr<DataRef>(nullptr);
+			entry = entry->second.dataRef.expired() ? m_dataRefs.erase(entry) : std::next(entry);
 		}
 
-		// Create wrapper object
-		std::shared_ptr<DataRef> dataRef(new DataRef(name, foundDataRef), [](DataRef* dataRefToDelete)
-		{
-			// Remove DataRef from master list
-			auto foundDataRef = std::remove_if(m_dataRefs.begin(), m_dataRefs.end(), [dataRefToDelete](const std::weak_ptr<DataRef>& dataRefToRemove)
-			{
-				if (dataRefToRemove.expired())
-				{
-					return false;
-				}
-
-				std::shared_ptr<DataRef> lockedDataRef = dataRefToRemove.lock();
-				return lockedDataRef.get() == dataRefToDelete;
-			});
-			if (foundDataRef == m_dataRefs.end())
-			{
-				throw XPException("Unable to destroy DataRef: Wasn't found in master list");
-			}
-
-			// Destroy DataRef
-			delete dataRefToDelete;
-		});
-		m_dataRefs.push_back(dataRef);
-
-		return dataRef;
+		m_sweepSize = std::max(MinimumSweepSize, m_dataRefs.size() * 2);
+	}
+
+	RegistryEntry& entry	= m_dataRefs[dataRef->m_name];
+	entry.dataRef			= dataRef;
+	entry.owner				= isOwned ? dataRef : nullptr;
+}
+
+void XP::DataRef::Unregister(const DataRef* dataRef) noexcept
+{
+	// Only erased if expired, as another data ref of the same name may have been registered since
+	auto foundEntry = m_dataRefs.find(dataRef->m_name);
+	if (foundEntry != m_dataRefs.end() && foundEntry->second.dataRef.expired())
+	{
+		m_dataRefs.erase(foundEntry);
 	}
 }
 
@@ -98,34 +120,78 @@ XP::DataRefType XP::DataRef::GetType() const
 	return DataRefType(static_cast<int>(xplmType));
 }
 
+void XP::DataRef::SetCachingEnabled(bool isEnabled)
+{
+	m_isCachingEnabled = isEnabled;
+}
+
 int XP::DataRef::GetIntData() const
 {
-	return XPLMGetDatai(m_id);
+	if (!IsCaching())
+	{
+		return XPLMGetDatai(m_id);
+	}
+
+	int cycleNumber = FrameTiming::GetCurrentCycleNumber();
+	if (m_cache.intCycleNumber != cycleNumber)
+	{
+		m_cache.intValue		= XPLMGetDatai(m_id);
+		m_cache.intCycleNumber	= cycleNumber;
+	}
+
+	return m_cache.intValue;
 }
 
 void XP::DataRef::SetIntData(int value)
 {
 	XPLMSetDatai(m_id, value);
+	InvalidateCache();
 }
 
 float XP::DataRef::GetFloatData() const
 {
-	return XPLMGetDataf(m_id);
+	if (!IsCaching())
+	{
+		return XPLMGetDataf(m_id);
+	}
+
+	int cycleNumber = FrameTiming::GetCurrentCycleNumber();
+	if (m_cache.floatCycleNumber != cycleNumber)
+	{
+		m_cache.floatValue			= XPLMGetDataf(m_id);
+		m_cache.floatCycleNumber	= cycleNumber;
+	}
+
+	return m_cache.floatValue;
 }
 
 void XP::DataRef::SetFloatData(float value)
 {
 	XPLMSetDataf(m_id, value);
+	InvalidateCache();
 }
 
 double XP::DataRef::GetDoubleData() const
 {
-	return XPLMGetDatad(m_id);
+	if (!IsCaching())
+	{
+		return XPLMGetDatad(m_id);
+	}
+
+	int cycleNumber = FrameTiming::GetCurrentCycleNumber();
+	if (m_cache.doubleCycleNumber != cycleNumber)
+	{
+		m_cache.doubleValue			= XPLMGetDatad(m_id);
+		m_cache.doubleCycleNumber	= cycleNumber;
+	}
+
+	return m_cache.doubleValue;
 }
 
 void XP::DataRef::SetDoubleData(double value)
 {
 	XPLMSetDatad(m_id, value);
+	InvalidateCache();
 }
 
 int XP::DataRef::GetIntArrayData(int* outValues, int offset, int max)
@@ -1,7 +1,11 @@
 #include "XP++/DataAccess/UserDataRef.hpp"
 
+// STL includes
+#include <stdexcept>
+
 // XP++ includes
 #include "XP++/DataAccess/DataRefType.hpp"
+#include "XP++/Diagnostics/CallbackGuard.hpp"
 #include "XP++/Exceptions/XPException.hpp"
 
 // X-Plane SDK includes
@@ -34,29 +38,14 @@ std::shared_ptr<XP::UserDataRef> XP::UserDataRef::RegisterDataAccessor(std::stri
 {
 	std::shared_ptr<UserDataRef> dataRef(new UserDataRef(name, static_cast<int>(type), isWriteable), [](UserDataRef* userDataRef)
 	{
-		DataRef* dataRefToDelete = reinterpret_cast<DataRef*>(userDataRef);
-
-		// Remove DataRef from master list
-		auto foundDataRef = std::remove_if(m_dataRefs.begin(), m_dataRefs.end(), [dataRefToDelete](const std::weak_ptr<DataRef>& dataRefToRemove)
-		{
-			if (dataRefToRemove.expired())
-			{
-				return false;
-			}
-
-			std::shared_ptr<DataRef> lockedDataRef = dataRefToRemove.lock();
-			return lockedDataRef.get() == dataRefToDelete;
-		});
-		if (foundDataRef == m_dataRefs.end())
-		{
-			throw XPException("Unable to destroy DataRef: Wasn't found in master list");
-		}
+		// Remove DataRef from the registry
+		Unregister(userDataRef);
 
 		// Destroy DataRef
 		delete userDataRef;
-	});
+	}, TaggedAllocator<UserDataRef, MemoryTag::DataRefs>());
 
-	m_dataRefs.push_back(dataRef);
+	Register(dataRef, false);
 
 	return dataRef;
 }
@@ -66,16 +55,17 @@ int XP::UserDataRef::GetDatai(void* inRefCon)
 	// Get pointer to DataRef
 	UserDataRef* dataRef = static_cast<UserDataRef*>(inRefCon);
 
-	if (dataRef->m_onReadInt == nullptr)
-	{
-		// No function assigned, return default value
-		return 0;
-	}
-	else
+	return CallbackGuard::Invoke(CallbackType::DataRefRead, dataRef, 0, [dataRef]()
 	{
+		if (dataRef->m_onReadInt == nullptr)
+		{
+			// No function assigned, return default value
+			return 0;
+		}
+
 		// Return DataRef data
 		return dataRef->m_onReadInt();
-	}
+	});
 }
 
 void XP::UserDataRef::SetDatai(void* inRefCon, int inValue)
@@ -83,14 +73,17 @@ void XP::UserDataRef::SetDatai(void* inRefCon, int inValue)
 	// Get pointer to DataRef
 	UserDataRef* dataRef = static_cast<UserDataRef*>(inRefCon);
 
-	if (dataRef->m_onWriteInt == nullptr)
+	CallbackGuard::Invoke(CallbackType::DataRefWrite, dataRef, [dataRef, inValue]()
 	{
-		// No function assigned
-		return;
-	}
+		if (dataRef->m_onWriteInt == nullptr)
+		{
+			// No function assigned
+			return;
+		}
 
-	// Set DataRef data
-	dataRef->m_onWriteInt(inValue);
+		// Set DataRef data
+		dataRef->m_onWriteInt(inValue);
+	});
 }
 
 float XP::UserDataRef::GetDataf(void* inRefCon)
@@ -98,16 +91,17 @@ float XP::UserDataRef::GetDataf(void* inRefCon)
 	// Get pointer to DataRef
 	UserDataRef* dataRef = static_cast<UserDataRef*>(inRefCon);
 
-	if (dataRef->m_onReadFloat == nullptr)
-	{
-		// No function assigned, return default value
-		return 0.0f;
-	}
-	else
+	return CallbackGuard::Invoke(CallbackType::DataRefRead, dataRef, 0.0f, [dataRef]()
 	{
+		if (dataRef->m_onReadFloat == nullptr)
+		{
+			// No function assigned, return default value
+			return 0.0f;
+		}
+
 		// Return DataRef data
 		return dataRef->m_onReadFloat();
-	}
+	});
 }
 
 void XP::UserDataRef::SetDataf(void* inRefCon, float inValue)
@@ -115,14 +109,17 @@ void XP::UserDataRef::SetDataf(void* inRefCon, float inValue)
 	// Get pointer to DataRef
 	UserDataRef* dataRef = static_cast<UserDataRef*>(inRefCon);
 
-	if (dataRef->m_onWriteFloat == nullptr)
+	CallbackGuard::Invoke(CallbackType::DataRefWrite, dataRef, [dataRef, inValue]()
 	{
-		// No function assigned
-		return;
-	}
+		if (dataRef->m_onWriteFloat == nullptr)
+		{
+			// No function assigned
+			return;
+		}
 
-	// Set DataRef data
-	dataRef->m_onWriteFloat(inValue);
+		// Set DataRef data
+		dataRef->m_onWriteFloat(inValue);
+	});
 }
 
 double XP::UserDataRef::GetDatad(void* inRefCon)
@@ -130,16 +127,17 @@ double XP::UserDataRef::GetDatad(void* inRefCon)
 	// Get pointer to DataRef
 	UserDataRef* dataRef = static_cast<UserDataRef*>(inRefCon);
 
-	if (dataRef->m_onReadDouble == nullptr)
-	{
-		// No function assigned, return default value
-		return 0.0;
-	}
-	else
+	return CallbackGuard::Invoke(CallbackType::DataRefRead, dataRef, 0.0, [dataRef]()
 	{
+		if (dataRef->m_onReadDouble == nullptr)
+		{
+			// No function assigned, return default value
+			return 0.0;
+		}
+
 		// Return DataRef data
 		return dataRef->m_onReadDouble();
-	}
+	});
 }
 
 void XP::UserDataRef::SetDatad(void* inRefCon, double inValue)
@@ -147,14 +145,17 @@ void XP::UserDataRef::SetDatad(void* inRefCon, double inValue)
 	// Get pointer to DataRef
 	UserDataRef* dataRef = static_cast<UserDataRef*>(inRefCon);
 
-	if (dataRef->m_onWriteDouble == nullptr)
+	CallbackGuard::Invoke(CallbackType::DataRefWrite, dataRef, [dataRef, inValue]()
 	{
-		// No function given
-		return;
-	}
+		if (dataRef->m_onWriteDouble == nullptr)
+		{
+			// No function given
+			return;
+		}
 
-	// Set DataRef data
-	dataRef->m_onWriteDouble(inValue);
+		// Set DataRef data
+		dataRef->m_onWriteDouble(inValue);
+	});
 }
 
 int XP::UserDataRef::GetDatavi(void* inRefCon, int* outValues, int inOffset, int inMax)
@@ -162,17 +163,17 @@ int XP::UserDataRef::GetDatavi(void* inRefCon, int* outValues, int inOffset, int
 	// Get pointer to DataRef
 	UserDataRef* dataRef = static_cast<UserDataRef*>(inRefCon);
 
-	outValues = nullptr;
-	if (dataRef->m_onReadIntArray == nullptr)
+	return CallbackGuard::Invoke(CallbackType::DataRefRead, dataRef, 0, [=]()
 	{
-		// No function assigned
-		return static_cast<int>(false);
-	}
-	else
-	{
-		// Get array data
+		if (dataRef->m_onReadIntArray == nullptr)
+		{
+			// No function assigned
+			return static_cast<int>(false);
+		}
+
+		// Get array data (a NULL outValues requests the array size)
 		return dataRef->m_onReadIntArray(outValues, inOffset, inMax);
-	}
+	});
 }
 
 void XP::UserDataRef::SetDatavi(void* inRefCon, int* inValues, int inOffset, int inCount)
@@ -180,20 +181,23 @@ void XP::UserDataRef::SetDatavi(void* inRefCon, int* inValues, int inOffset, int
 	// Get pointer to DataRef
 	UserDataRef* dataRef = static_cast<UserDataRef*>(inRefCon);
 
-	// Ensure inValues isn't a NULL pointer
-	if (inValues == nullptr)
+	CallbackGuard::Invoke(CallbackType::DataRefWrite, dataRef, [=]()
 	{
-		throw std::invalid_argument("inValues is NULL");
-	}
+		// Ensure inValues isn't a NULL pointer
+		if (inValues == nullptr)
+		{
+			throw std::invalid_argument("inValues is NULL");
+		}
 
-	if (dataRef->m_onWriteIntArray == nullptr)
-	{
-		// No function assigned
-		return;
-	}
+		if (dataRef->m_onWriteIntArray == nullptr)
+		{
+			// No function assigned
+			return;
+		}
 
-	// Set array data
-	dataRef->m_onWriteIntArray(inValues, inOffset, inCount);
+		// Set array data
+		dataRef->m_onWriteIntArray(inValues, inOffset, inCount);
+	});
 }
 
 int XP::UserDataRef::GetDatavf(void* inRefCon, float* outValues, int inOffset, int inMax)
@@ -201,17 +205,17 @@ int XP::UserDataRef::GetDatavf(void* inRefCon, float* outValues, int inOffset, i
 	// Get pointer to DataRef
 	UserDataRef* dataRef = static_cast<UserDataRef*>(inRefCon);
 
-	outValues = nullptr;
-	if (dataRef->m_onReadFloatArray == nullptr)
-	{
-		// No function assigned
-		return static_cast<int>(false);
-	}
-	else
+	return CallbackGuard::Invoke(CallbackType::DataRefRead, dataRef, 0, [=]()
 	{
-		// Get array data
+		if (dataRef->m_onReadFloatArray == nullptr)
+		{
+			// No function assigned
+			return static_cast<int>(false);
+		}
+
+		// Get array data (a NULL outValues requests the array size)
 		return dataRef->m_onReadFloatArray(outValues, inOffset, inMax);
-	}
+	});
 }
 
 void XP::UserDataRef::SetDatavf(void* inRefCon, float* inValues, int inOffset, int inCount)
@@ -219,20 +223,23 @@ void XP::UserDataRef::SetDatavf(void* inRefCon, float* inValues, int inOffset, i
 	// Get pointer to DataRef
 	UserDataRef* dataRef = static_cast<UserDataRef*>(inRefCon);
 
-	// Ensure inValues isn't a NULL pointer
-	if (inValues == nullptr)
+	CallbackGuard::Invoke(CallbackType::DataRefWrite, dataRef, [=]()
 	{
-		throw std::invalid_argument("inValues is NULL");
-	}
+		// Ensure inValues isn't a NULL pointer
+		if (inValues == nullptr)
+		{
+			throw std::invalid_argument("inValues is NULL");
+		}
 
-	if (dataRef->m_onWriteFloatArray == nullptr)
-	{
-		// No function assigned
-		return;
-	}
+		if (dataRef->m_onWriteFloatArray == nullptr)
+		{
+			// No function assigned
+			return;
+		}
 
-	// Set array data
-	dataRef->m_onWriteFloatArray(inValues, inOffset, inCount);
+		// Set array data
+		dataRef->m_onWriteFloatArray(inValues, inOffset, inCount);
+	});
 }
 
 int XP::UserDataRef::GetDatab(void* inRefCon, void* outValue, int inOffset, int inMaxLength)
@@ -240,17 +247,17 @@ int XP::UserDataRef::GetDatab(void* inRefCon, void* outValue, int inOffset, int
 	// Get pointer to DataRef
 	UserDataRef* dataRef = static_cast<UserDataRef*>(inRefCon);
 
-	outValue = nullptr;
-	if (dataRef->m_onReadDataArray == nullptr)
+	return CallbackGuard::Invoke(CallbackType::DataRefRead, dataRef, 0, [=]()
 	{
-		// No function assigned
-		return static_cast<int>(false);
-	}
-	else
-	{
-		// Get array data
+		if (dataRef->m_onReadDataArray == nullptr)
+		{
+			// No function assigned
+			return static_cast<int>(false);
+		}
+
+		// Get array data (a NULL outValue requests the array size)
 		return dataRef->m_onReadDataArray(outValue, inOffset, inMaxLength);
-	}
+	});
 }
 
 void XP::UserDataRef::SetDatab(void* inRefCon, void* inValue, int inOffset, int inLength)
@@ -258,18 +265,21 @@ void XP::UserDataRef::SetDatab(void* inRefCon, void* inValue, int inOffset, int
 	// Get pointer to DataRef
 	UserDataRef* dataRef = static_cast<UserDataRef*>(inRefCon);
 
-	// Ensure inValues isn't a NULL pointer
-	if (inValue == nullptr)
+	CallbackGuard::Invoke(CallbackType::DataRefWrite, dataRef, [=]()
 	{
-		throw std::invalid_argument("inValues is NULL");
-	}
+		// Ensure inValues isn't a NULL pointer
+		if (inValue == nullptr)
+		{
+			throw std::invalid_argument("inValues is NULL");
+		}
 
-	if (dataRef->m_onWriteDataArray == nullptr)
-	{
-		// No function assigned
-		return;
-	}
+		if (dataRef->m_onWriteDataArray == nullptr)
+		{
+			// No function assigned
+			return;
+		}
 
-	// Set array data
-	dataRef->m_onWriteDataArray(inValue, inOffset, inLength);
+		// Set array data
+		dataRef->m_onWriteDataArray(inValue, inOffset, inLength);
+	});
 }
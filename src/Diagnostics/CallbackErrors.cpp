@@ -0,0 +1,177 @@
+#include "XP++/Diagnostics/CallbackErrors.hpp"
+
+// STL includes
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+
+// XP++ includes
+#include "XP++/Diagnostics/PeriodicReport.hpp"
+#include "XP++/Logging/Logger.hpp"
+#include "XP++/Processing/FrameTiming.hpp"
+
+namespace
+{
+	// Bounded multiple producer ring of errors (Vyukov's bounded queue),
+	// each slot's sequence number says whether it's free to write or read
+	struct ErrorRing
+	{
+		struct Slot
+		{
+			std::atomic<size_t> sequence;
+			XP::CallbackError error;
+		};
+
+		ErrorRing() :
+			writePosition(0), readPosition(0), droppedCount(0)
+		{
+			for (size_t i = 0; i < XP::CallbackErrors::Capacity; ++i)
+			{
+				slots[i].sequence.store(i, std::memory_order_relaxed);
+			}
+		}
+
+		Slot slots[XP::CallbackErrors::Capacity];
+		std::atomic<size_t> writePosition;
+		size_t readPosition;
+		std::atomic<size_t> droppedCount;
+	};
+
+	static_assert((XP::CallbackErrors::Capacity & (XP::CallbackErrors::Capacity - 1)) == 0,
+				  "Capacity must be a power of two");
+
+	ErrorRing& GetRing()
+	{
+		static ErrorRing ring;
+		return ring;
+	}
+
+	const char* GetCallbackTypeName(XP::CallbackType type)
+	{
+		switch (type)
+		{
+		case XP::CallbackType::Plugin:			return "Plug-in";
+		case XP::CallbackType::DataRefRead:		return "DataRef read";
+		case XP::CallbackType::DataRefWrite:	return "DataRef write";
+		case XP::CallbackType::FlightLoop:		return "FlightLoop";
+		case XP::CallbackType::Menu:			return "Menu";
+		case XP::CallbackType::Command:			return "Command";
+		case XP::CallbackType::Destructor:		return "Destructor";
+		default:								return "Unknown";
+		}
+	}
+
+	XP::LogCategory g_callbackLog("Callbacks");
+
+	// Dropped error count as of the last report
+	size_t g_reportedDroppedCount = 0;
+
+	void ReportErrors()
+	{
+		XP::CallbackErrors::Drain([](const XP::CallbackError& error)
+		{
+			XP_LOG_ERROR(g_callbackLog, "{} callback ({}) threw during cycle {}: {}",
+						 GetCallbackTypeName(error.type), error.object, error.cycleNumber, error.message);
+		});
+
+		size_t droppedCount = XP::CallbackErrors::GetDroppedCount();
+		if (droppedCount != g_reportedDroppedCount)
+		{
+			XP_LOG_ERROR(g_callbackLog, "{} callback errors dropped", droppedCount - g_reportedDroppedCount);
+			g_reportedDroppedCount = droppedCount;
+		}
+	}
+
+	XP::PeriodicReport g_report(&ReportErrors);
+}
+
+void XP::CallbackErrors::Record(CallbackType type, const void* object, const char* message) noexcept
+{
+	ErrorRing& ring		= GetRing();
+	const size_t mask	= Capacity - 1;
+
+	// Claim a slot
+	size_t position = ring.writePosition.load(std::memory_order_relaxed);
+	ErrorRing::Slot* slot;
+	for (;;)
+	{
+		slot				= &ring.slots[position & mask];
+		size_t sequence		= slot->sequence.load(std::memory_order_acquire);
+		intptr_t difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+
+		if (difference == 0)
+		{
+			if (ring.writePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+			{
+				break;
+			}
+		}
+		else if (difference < 0)
+		{
+			// Ring is full
+			ring.droppedCount.fetch_add(1, std::memory_order_relaxed);
+			return;
+		}
+		else
+		{
+			position = ring.writePosition.load(std::memory_order_relaxed);
+		}
+	}
+
+	// Fill and publish the slot
+	slot->error.type		= type;
+	slot->error.object		= object;
+	// XPLM mustn't be called off the sim thread, so take the cycle FrameTiming last sampled
+	slot->error.cycleNumber	= FrameTiming::GetCycleNumber();
+	std::strncpy(slot->error.message, message == nullptr ? "" : message, CallbackError::MaxMessageLength - 1);
+	slot->error.message[CallbackError::MaxMessageLength - 1] = '\0';
+
+	slot->sequence.store(position + 1, std::memory_order_release);
+}
+
+size_t XP::CallbackErrors::Drain(std::function<void(const CallbackError&)> handler)
+{
+	ErrorRing& ring		= GetRing();
+	const size_t mask	= Capacity - 1;
+
+	size_t drainedCount = 0;
+	for (;;)
+	{
+		size_t position			= ring.readPosition;
+		ErrorRing::Slot& slot	= ring.slots[position & mask];
+		size_t sequence			= slot.sequence.load(std::memory_order_acquire);
+		if (sequence != position + 1)
+		{
+			// Nothing (fully) written yet
+			break;
+		}
+
+		// Copy the error out so the slot can be reused straight away
+		CallbackError error = slot.error;
+		slot.sequence.store(position + Capacity, std::memory_order_release);
+		ring.readPosition = position + 1;
+
+		if (handler != nullptr)
+		{
+			handler(error);
+		}
+		++drainedCount;
+	}
+
+	return drainedCount;
+}
+
+size_t XP::CallbackErrors::GetDroppedCount()
+{
+	return GetRing().droppedCount.load(std::memory_order_relaxed);
+}
+
+void XP::CallbackErrors::StartReporting(float interval)
+{
+	g_report.Start(interval);
+}
+
+void XP::CallbackErrors::StopReporting()
+{
+	g_report.Stop();
+}
@@ -0,0 +1,355 @@
+#include "XP++/Diagnostics/CallbackWatchdog.hpp"
+
+// STL includes
+#include <algorithm>
+#include <condition_variable>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+// XP++ includes
+#include "XP++/Logging/Logger.hpp"
+#include "XP++/Processing/FrameLoop.hpp"
+
+// Platform includes
+#if !IBM
+#include <cerrno>
+#include <csignal>
+#include <execinfo.h>
+#include <pthread.h>
+#endif
+
+#if IBM
+const int XP::CallbackWatchdog::StackSampleSignal = 0;
+#else
+const int XP::CallbackWatchdog::StackSampleSignal = SIGUSR2;
+#endif
+
+std::atomic<bool> XP::CallbackWatchdog::m_isWatching(false);
+std::atomic<uint32_t> XP::CallbackWatchdog::m_markerSequence(0);
+std::atomic<int> XP::CallbackWatchdog::m_markerType(0);
+std::atomic<const void*> XP::CallbackWatchdog::m_markerObject(nullptr);
+std::atomic<int64_t> XP::CallbackWatchdog::m_markerTime(0);
+
+namespace
+{
+	XP::LogCategory g_watchdogLog("Watchdog");
+
+	// Milliseconds to wait for the sim thread to sample its stack
+	const int StackSampleTimeout = 100;
+
+	// Stack sampled by the sim thread's signal handler
+	struct StackSample
+	{
+		void* frames[XP::CallbackStall::MaxFrames];
+		int frameCount;
+		std::atomic<bool> isSampled;
+	};
+
+	// Stalls waiting to be drained
+	struct StallRing
+	{
+		std::mutex mutex;
+		XP::CallbackStall stalls[XP::CallbackWatchdog::Capacity];
+		size_t first;
+		size_t count;
+		size_t totalCount;
+	};
+
+	StackSample g_stackSample;
+	StallRing g_stallRing;
+
+	// Watchdog thread, woken early when stopping
+	std::thread g_watchdogThread;
+	std::mutex g_stopMutex;
+	std::condition_variable g_stopCondition;
+	bool g_isStopping = false;
+
+	// Flight loop writing the heartbeat, and the steady clock time of the latest frame
+	std::shared_ptr<XP::FrameLoop> g_heartbeatLoop;
+	std::atomic<int64_t> g_heartbeatTime(0);
+
+#if !IBM
+	// Thread signalled to sample its stack, and the handler replaced meanwhile
+	pthread_t g_simThread;
+	struct sigaction g_previousAction;
+
+	// Samples the interrupted thread's stack; only async-signal-safe calls are allowed here
+	void OnStackSampleSignal(int)
+	{
+		int savedErrno = errno;
+		g_stackSample.frameCount = backtrace(g_stackSample.frames, XP::CallbackStall::MaxFrames);
+		g_stackSample.isSampled.store(true, std::memory_order_release);
+		errno = savedErrno;
+	}
+#endif
+
+	const char* GetCallbackTypeName(XP::CallbackType type)
+	{
+		switch (type)
+		{
+		case XP::CallbackType::Plugin:			return "Plug-in";
+		case XP::CallbackType::DataRefRead:		return "DataRef read";
+		case XP::CallbackType::DataRefWrite:	return "DataRef write";
+		case XP::CallbackType::FlightLoop:		return "FlightLoop";
+		case XP::CallbackType::Menu:			return "Menu";
+		case XP::CallbackType::Command:			return "Command";
+		case XP::CallbackType::Destructor:		return "Destructor";
+		default:								return "Unknown";
+		}
+	}
+
+	// Samples the sim thread's stack into a stall
+	void SampleStack(XP::CallbackStall& stall)
+	{
+		stall.frameCount = 0;
+
+#if !IBM
+		g_stackSample.isSampled.store(false, std::memory_order_relaxed);
+		if (pthread_kill(g_simThread, XP::CallbackWatchdog::StackSampleSignal) != 0)
+		{
+			return;
+		}
+
+		for (int waited = 0; waited < StackSampleTimeout; ++waited)
+		{
+			if (g_stackSample.isSampled.load(std::memory_order_acquire))
+			{
+				// The first frame is the signal handler's own
+				for (int i = 1; i < g_stackSample.frameCount; ++i)
+				{
+					stall.frames[stall.frameCount++] = g_stackSample.frames[i];
+				}
+				return;
+			}
+
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+#endif
+	}
+
+	// Records and logs a stall
+	void Report(const XP::CallbackStall& stall)
+	{
+		{
+			std::lock_guard<std::mutex> lock(g_stallRing.mutex);
+
+			++g_stallRing.totalCount;
+			if (g_stallRing.count < XP::CallbackWatchdog::Capacity)
+			{
+				g_stallRing.stalls[(g_stallRing.first + g_stallRing.count) % XP::CallbackWatchdog::Capacity] = stall;
+				++g_stallRing.count;
+			}
+		}
+
+		double milliseconds = stall.duration * 1000.0;
+		if (stall.isInCallback)
+		{
+			XP_LOG_WARNING(g_watchdogLog, "{} callback of {} has run for {} ms", GetCallbackTypeName(stall.type), stall.object, milliseconds);
+		}
+		else
+		{
+			XP_LOG_WARNING(g_watchdogLog, "Frame has run for {} ms outside XP++ callbacks", milliseconds);
+		}
+		if (!stall.isStackValid)
+		{
+			XP_LOG_WARNING(g_watchdogLog, "Stall ended before the stack was sampled, so it may not show the cause");
+		}
+
+#if !IBM
+		// Symbolised here on the watchdog thread, as it allocates
+		char** symbols = backtrace_symbols(stall.frames, stall.frameCount);
+		for (int i = 0; i < stall.frameCount; ++i)
+		{
+			if (symbols != nullptr)
+			{
+				XP_LOG_WARNING(g_watchdogLog, "  #{} {}", i, symbols[i]);
+			}
+			else
+			{
+				XP_LOG_WARNING(g_watchdogLog, "  #{} {}", i, static_cast<const void*>(stall.frames[i]));
+			}
+		}
+		std::free(symbols);
+#endif
+	}
+}
+
+void XP::CallbackWatchdog::Start(float callbackThreshold, float frameThreshold)
+{
+	// Ensure arguments are valid
+	if (!(callbackThreshold > 0.0f))
+	{
+		throw std::invalid_argument("callbackThreshold must be greater than 0");
+	}
+	if (!(frameThreshold >= 0.0f))
+	{
+		throw std::invalid_argument("frameThreshold must not be negative");
+	}
+	if (IsRunning())
+	{
+		throw std::logic_error("Watchdog is already running");
+	}
+
+#if !IBM
+	g_simThread = pthread_self();
+
+	// Sampled once up front, as the first backtrace may load libgcc and allocate
+	void* frame;
+	backtrace(&frame, 1);
+
+	struct sigaction action = {};
+	action.sa_handler	= OnStackSampleSignal;
+	action.sa_flags		= SA_RESTART;
+	sigemptyset(&action.sa_mask);
+	if (sigaction(StackSampleSignal, &action, &g_previousAction) != 0)
+	{
+		throw std::runtime_error("Couldn't install the stack sampling signal handler");
+	}
+#endif
+
+	g_heartbeatTime.store(GetTime(), std::memory_order_relaxed);
+	g_heartbeatLoop = FrameLoop::Create(FlightLoopPhaseType::BeforeFlightModel, [](float)
+	{
+		g_heartbeatTime.store(GetTime(), std::memory_order_relaxed);
+		return true;
+	});
+
+	g_isStopping = false;
+	m_isWatching.store(true, std::memory_order_relaxed);
+	g_watchdogThread = std::thread(&CallbackWatchdog::Watch, callbackThreshold, frameThreshold);
+}
+
+void XP::CallbackWatchdog::Stop()
+{
+	if (!IsRunning())
+	{
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(g_stopMutex);
+		g_isStopping = true;
+	}
+	g_stopCondition.notify_all();
+	g_watchdogThread.join();
+
+	m_isWatching.store(false, std::memory_order_relaxed);
+	g_heartbeatLoop.reset();
+
+#if !IBM
+	// Ignoring the signal discards a sample request still pending on the sim thread, which
+	// would otherwise reach the previous action, by default terminating the process
+	struct sigaction ignoreAction = {};
+	ignoreAction.sa_handler	= SIG_IGN;
+	sigemptyset(&ignoreAction.sa_mask);
+	sigaction(StackSampleSignal, &ignoreAction, nullptr);
+
+	// Restore a handler installed before starting, but leave the signal ignored otherwise
+	if ((g_previousAction.sa_flags & SA_SIGINFO) != 0 || g_previousAction.sa_handler != SIG_DFL)
+	{
+		sigaction(StackSampleSignal, &g_previousAction, nullptr);
+	}
+#endif
+}
+
+size_t XP::CallbackWatchdog::Drain(std::function<void(const CallbackStall&)> handler)
+{
+	// Copied out first, so the handler runs without the lock
+	CallbackStall stalls[Capacity];
+	size_t count;
+	{
+		std::lock_guard<std::mutex> lock(g_stallRing.mutex);
+
+		count = g_stallRing.count;
+		for (size_t i = 0; i < count; ++i)
+		{
+			stalls[i] = g_stallRing.stalls[(g_stallRing.first + i) % Capacity];
+		}
+		g_stallRing.first	= (g_stallRing.first + count) % Capacity;
+		g_stallRing.count	= 0;
+	}
+
+	for (size_t i = 0; i < count; ++i)
+	{
+		handler(stalls[i]);
+	}
+
+	return count;
+}
+
+size_t XP::CallbackWatchdog::GetStallCount()
+{
+	std::lock_guard<std::mutex> lock(g_stallRing.mutex);
+	return g_stallRing.totalCount;
+}
+
+void XP::CallbackWatchdog::Watch(float callbackThreshold, float frameThreshold)
+{
+	const int64_t callbackLimit	= static_cast<int64_t>(callbackThreshold * 1.0e9);
+	const int64_t frameLimit	= static_cast<int64_t>(frameThreshold * 1.0e9);
+	// Checked several times per threshold, so stalls are caught soon after crossing it
+	const std::chrono::nanoseconds checkInterval(std::max<int64_t>(callbackLimit / 4, 1000000));
+
+	// Stalls already reported, by the time they started
+	int64_t reportedCallbackTime	= 0;
+	int64_t reportedHeartbeatTime	= 0;
+
+	std::unique_lock<std::mutex> lock(g_stopMutex);
+	while (!g_stopCondition.wait_for(lock, checkInterval, []() { return g_isStopping; }))
+	{
+		// Read consistently, retrying if the sim thread wrote the marker meanwhile
+		uint32_t sequence;
+		int type;
+		const void* object;
+		int64_t callbackTime;
+		do
+		{
+			sequence		= m_markerSequence.load(std::memory_order_acquire);
+			type			= m_markerType.load(std::memory_order_relaxed);
+			object			= m_markerObject.load(std::memory_order_relaxed);
+			callbackTime	= m_markerTime.load(std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_acquire);
+		} while ((sequence & 1) != 0 || sequence != m_markerSequence.load(std::memory_order_relaxed));
+
+		int64_t heartbeatTime	= g_heartbeatTime.load(std::memory_order_relaxed);
+		int64_t time			= GetTime();
+
+		CallbackStall stall = {};
+		if (callbackTime != 0 && time - callbackTime > callbackLimit && callbackTime != reportedCallbackTime)
+		{
+			stall.isInCallback	= true;
+			stall.type			= static_cast<CallbackType>(type);
+			stall.object		= object;
+			stall.duration		= static_cast<float>((time - callbackTime) * 1.0e-9);
+			SampleStack(stall);
+			stall.isStackValid	= m_markerSequence.load(std::memory_order_acquire) == sequence;
+
+			// The frame is held up by this callback, so isn't reported separately
+			reportedCallbackTime	= callbackTime;
+			reportedHeartbeatTime	= heartbeatTime;
+		}
+		else if (frameLimit > 0 && time - heartbeatTime > frameLimit && heartbeatTime != reportedHeartbeatTime)
+		{
+			stall.isInCallback	= false;
+			stall.duration		= static_cast<float>((time - heartbeatTime) * 1.0e-9);
+			SampleStack(stall);
+			stall.isStackValid	= g_heartbeatTime.load(std::memory_order_relaxed) == heartbeatTime;
+
+			reportedHeartbeatTime = heartbeatTime;
+		}
+		else
+		{
+			continue;
+		}
+
+		// Reported without holding the lock, so stopping isn't held up by logging
+		lock.unlock();
+		Report(stall);
+		lock.lock();
+	}
+
+	Logger::ReleaseThreadRing();
+}
@@ -0,0 +1,149 @@
+#include "XP++/Diagnostics/MemoryTracker.hpp"
+
+// XP++ includes
+#include "XP++/Diagnostics/PeriodicReport.hpp"
+#include "XP++/Logging/Logger.hpp"
+
+namespace
+{
+	const int TagCount = static_cast<int>(XP::MemoryTag::Count);
+
+	// Counters of a single tag; having static storage, they're zero before any constructor runs
+	struct TagCounters
+	{
+		std::atomic<size_t> liveBytes;
+		std::atomic<size_t> peakBytes;
+		std::atomic<size_t> liveAllocations;
+		std::atomic<uint64_t> totalAllocations;
+	};
+
+	TagCounters g_counters[TagCount];
+
+	XP::LogCategory g_memoryLog("Memory");
+
+	// Live bytes of each tag as of the last report
+	size_t g_reportedBytes[TagCount] = {};
+
+	inline TagCounters* GetCounters(XP::MemoryTag tag) noexcept
+	{
+		int index = static_cast<int>(tag);
+		return index >= 0 && index < TagCount ? &g_counters[index] : nullptr;
+	}
+
+	void ReportUsage()
+	{
+		for (int tag = 0; tag < TagCount; ++tag)
+		{
+			XP::MemoryUsage usage = XP::MemoryTracker::GetUsage(static_cast<XP::MemoryTag>(tag));
+			if (usage.totalAllocations == 0)
+			{
+				continue;
+			}
+
+			// Growth since the last report, which shouldn't keep rising while idle
+			long long growth = static_cast<long long>(usage.liveBytes) - static_cast<long long>(g_reportedBytes[tag]);
+			g_reportedBytes[tag] = usage.liveBytes;
+
+			XP_LOG_INFO(g_memoryLog, "{}: {} bytes in {} allocations ({} since last report), peak {} bytes",
+						XP::MemoryTracker::GetTagName(static_cast<XP::MemoryTag>(tag)), usage.liveBytes,
+						usage.liveAllocations, growth, usage.peakBytes);
+		}
+	}
+
+	XP::PeriodicReport g_report(&ReportUsage);
+}
+
+void XP::MemoryTracker::RecordAllocation(MemoryTag tag, size_t size) noexcept
+{
+	TagCounters* counters = GetCounters(tag);
+	if (counters == nullptr)
+	{
+		return;
+	}
+
+	counters->liveAllocations.fetch_add(1, std::memory_order_relaxed);
+	counters->totalAllocations.fetch_add(1, std::memory_order_relaxed);
+	size_t liveBytes = counters->liveBytes.fetch_add(size, std::memory_order_relaxed) + size;
+
+	// Only raised, so a racing allocation with a higher total wins
+	size_t peakBytes = counters->peakBytes.load(std::memory_order_relaxed);
+	while (liveBytes > peakBytes && !counters->peakBytes.compare_exchange_weak(peakBytes, liveBytes, std::memory_order_relaxed))
+	{
+	}
+}
+
+void XP::MemoryTracker::RecordFree(MemoryTag tag, size_t size) noexcept
+{
+	TagCounters* counters = GetCounters(tag);
+	if (counters == nullptr)
+	{
+		return;
+	}
+
+	counters->liveAllocations.fetch_sub(1, std::memory_order_relaxed);
+	counters->liveBytes.fetch_sub(size, std::memory_order_relaxed);
+}
+
+XP::MemoryUsage XP::MemoryTracker::GetUsage(MemoryTag tag) noexcept
+{
+	MemoryUsage usage = {};
+
+	TagCounters* counters = GetCounters(tag);
+	if (counters != nullptr)
+	{
+		usage.liveBytes			= counters->liveBytes.load(std::memory_order_relaxed);
+		usage.peakBytes			= counters->peakBytes.load(std::memory_order_relaxed);
+		usage.liveAllocations	= counters->liveAllocations.load(std::memory_order_relaxed);
+		usage.totalAllocations	= counters->totalAllocations.load(std::memory_order_relaxed);
+	}
+
+	return usage;
+}
+
+XP::MemoryUsage XP::MemoryTracker::GetTotalUsage() noexcept
+{
+	MemoryUsage total = {};
+	for (int tag = 0; tag < TagCount; ++tag)
+	{
+		MemoryUsage usage		= GetUsage(static_cast<MemoryTag>(tag));
+		total.liveBytes			+= usage.liveBytes;
+		total.peakBytes			+= usage.peakBytes;
+		total.liveAllocations	+= usage.liveAllocations;
+		total.totalAllocations	+= usage.totalAllocations;
+	}
+
+	return total;
+}
+
+void XP::MemoryTracker::ResetPeaks() noexcept
+{
+	for (TagCounters& counters : g_counters)
+	{
+		counters.peakBytes.store(counters.liveBytes.load(std::memory_order_relaxed), std::memory_order_relaxed);
+	}
+}
+
+const char* XP::MemoryTracker::GetTagName(MemoryTag tag) noexcept
+{
+	switch (tag)
+	{
+	case MemoryTag::DataRefs:		return "DataRefs";
+	case MemoryTag::Commands:		return "Commands";
+	case MemoryTag::FlightLoops:	return "FlightLoops";
+	case MemoryTag::Menus:			return "Menus";
+	case MemoryTag::Messages:		return "Messages";
+	case MemoryTag::Caches:			return "Caches";
+	case MemoryTag::User:			return "User";
+	default:						return "Unknown";
+	}
+}
+
+void XP::MemoryTracker::StartReporting(float interval)
+{
+	g_report.Start(interval);
+}
+
+void XP::MemoryTracker::StopReporting()
+{
+	g_report.Stop();
+}
@@ -0,0 +1,49 @@
+#include "XP++/Diagnostics/PeriodicReport.hpp"
+
+// STL includes
+#include <stdexcept>
+
+// XP++ includes
+#include "XP++/Logging/Logger.hpp"
+#include "XP++/Processing/FlightLoop.hpp"
+
+XP::PeriodicReport::PeriodicReport(ReportCallback report) :
+	m_report(report), m_interval(0.0f), m_flightLoop()
+{
+	// Ensure arguments are valid
+	if (m_report == nullptr)
+	{
+		throw std::invalid_argument("report is NULL");
+	}
+}
+
+void XP::PeriodicReport::Start(float interval)
+{
+	// Ensure arguments are valid
+	if (!(interval > 0.0f))
+	{
+		throw std::invalid_argument("interval must be positive");
+	}
+
+	m_interval = interval;
+	if (m_flightLoop == nullptr)
+	{
+		m_flightLoop = FlightLoop::CreateFlightLoop(FlightLoopPhaseType::AfterFlightModel, [this](float, float, int)
+		{
+			if (Logger::IsRunning())
+			{
+				m_report();
+			}
+
+			return m_interval;
+		});
+	}
+
+	// Counted from now, so a new interval takes effect straight away
+	m_flightLoop->Schedule(m_interval, 1);
+}
+
+void XP::PeriodicReport::Stop()
+{
+	m_flightLoop.reset();
+}
@@ -0,0 +1,625 @@
+#include "XP++/IO/AssetLoader.hpp"
+
+// STL includes
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <cstring>
+#include <mutex>
+#include <stdexcept>
+
+// XP++ includes
+#include "XP++/Diagnostics/CallbackGuard.hpp"
+#include "XP++/Logging/Logger.hpp"
+#include "XP++/Processing/FrameLoop.hpp"
+#include "XP++/Processing/ThreadPool.hpp"
+
+namespace
+{
+	XP::LogCategory g_assetLog("Assets");
+
+	// Most bytes of free decode buffers kept
+	const size_t DecodePoolCapacity = 32 * 1024 * 1024;
+
+	// DDS header fields, as offsets from the start of the file
+	const uint32_t DDSMagic					= 0x20534444;
+	const size_t DDSHeaderSize				= 128;
+	const size_t DDSHeightOffset			= 12;
+	const size_t DDSWidthOffset				= 16;
+	const size_t DDSMipMapCountOffset		= 28;
+	const size_t DDSFlagsOffset				= 8;
+	const size_t DDSPixelFlagsOffset		= 80;
+	const size_t DDSFourCCOffset			= 84;
+	const size_t DDSBitCountOffset			= 88;
+	const size_t DDSRedMaskOffset			= 92;
+	const size_t DDSCaps2Offset				= 112;
+	const size_t DDSDX10HeaderSize			= 20;
+	const uint32_t DDSFlagMipMapCount		= 0x20000;
+	const uint32_t DDSPixelFlagFourCC		= 0x4;
+	const uint32_t DDSPixelFlagRGB			= 0x40;
+	const uint32_t DDSCaps2CubeOrVolume		= 0x200 | 0x200000;
+	const uint32_t DDSDX10MiscFlagCube		= 0x4;
+
+	inline uint32_t MakeFourCC(char a, char b, char c, char d)
+	{
+		return static_cast<uint32_t>(static_cast<uint8_t>(a)) | (static_cast<uint32_t>(static_cast<uint8_t>(b)) << 8) |
+			   (static_cast<uint32_t>(static_cast<uint8_t>(c)) << 16) | (static_cast<uint32_t>(static_cast<uint8_t>(d)) << 24);
+	}
+
+	// Reads a little-endian field, as every platform X-Plane runs on is
+	inline uint32_t ReadUInt32(const char* data, size_t offset)
+	{
+		uint32_t value;
+		std::memcpy(&value, data + offset, sizeof(value));
+		return value;
+	}
+
+	// Gets the bytes of one level of an image
+	size_t GetLevelSize(XP::ImageFormat format, int width, int height)
+	{
+		size_t blocksWide = static_cast<size_t>(std::max(1, (width + 3) / 4));
+		size_t blocksHigh = static_cast<size_t>(std::max(1, (height + 3) / 4));
+		switch (format)
+		{
+		case XP::ImageFormat::BC1:	return blocksWide * blocksHigh * 8;
+		case XP::ImageFormat::BC2:
+		case XP::ImageFormat::BC3:
+		case XP::ImageFormat::BC7:	return blocksWide * blocksHigh * 16;
+		default:					return static_cast<size_t>(width) * static_cast<size_t>(height) * 4;
+		}
+	}
+
+	inline double ToMegabytes(uint64_t bytes)
+	{
+		return bytes / (1024.0 * 1024.0);
+	}
+}
+
+struct XP::AssetLoader::SharedState
+{
+	SharedState() :
+		pool(BufferPool::Create(DecodePoolCapacity)), isClosed(false), mutex(), decodedLoads() {}
+
+	// Pool decoders take buffers from
+	std::shared_ptr<BufferPool> pool;
+	// Set once the loader is destroyed, so queued decodes are skipped
+	std::atomic<bool> isClosed;
+
+	// Guards the decoded loads
+	std::mutex mutex;
+	std::vector<DecodedLoad> decodedLoads;
+};
+
+XP::AssetLoader::AssetLoader(size_t memoryCap, std::shared_ptr<FileIOService> fileIOService, std::shared_ptr<ThreadPool> threadPool) :
+	m_fileIOService(fileIOService), m_threadPool(threadPool), m_state(std::make_shared<SharedState>()), m_decoders(), m_loads(),
+	m_queuedLoads(), m_decodedLoads(), m_lastLoadID(0), m_readingCount(0), m_decodingCount(0), m_decodingBytes(0),
+	m_measuredLoadCount(0), m_largestLoadBytes(0), m_inFlightBytes(0), m_memoryCap(memoryCap), m_frameBudget(0.002f), m_statistics(), m_reportedStatistics(), m_busyStartTime(), m_frameLoop()
+{
+	m_decoders[".dds"] = &AssetLoader::DecodeDDS;
+	m_decoders[".png"] = &AssetLoader::DecodePNG;
+}
+
+XP::AssetLoader::~AssetLoader()
+{
+	// Reads call back into the loader, so mustn't complete once it's gone
+	for (const std::pair<const AssetLoadID, PendingLoad>& load : m_loads)
+	{
+		if (load.second.stage == LoadStage::Reading)
+		{
+			m_fileIOService->Cancel(load.second.readID);
+		}
+	}
+
+	m_state->isClosed.store(true);
+}
+
+std::shared_ptr<XP::AssetLoader> XP::AssetLoader::Create(size_t memoryCap, std::shared_ptr<FileIOService> fileIOService,
+														 std::shared_ptr<ThreadPool> threadPool)
+{
+	// Ensure arguments are valid
+	if (memoryCap == 0)
+	{
+		throw std::invalid_argument("memoryCap must be greater than 0");
+	}
+
+	if (threadPool == nullptr)
+	{
+		threadPool = ThreadPool::GetShared();
+	}
+	if (fileIOService == nullptr)
+	{
+		fileIOService = FileIOService::Create(threadPool);
+	}
+
+	std::shared_ptr<AssetLoader> assetLoader(new AssetLoader(memoryCap, fileIOService, threadPool), [](AssetLoader* assetLoader)
+	{
+		delete assetLoader;
+	});
+
+	// Woken by the next load once nothing is pending
+	AssetLoader* rawAssetLoader = assetLoader.get();
+	assetLoader->m_frameLoop = FrameLoop::Create(FlightLoopPhaseType::BeforeFlightModel, [rawAssetLoader](float)
+	{
+		rawAssetLoader->DispatchCompletions();
+		return !rawAssetLoader->m_loads.empty();
+	}, false);
+
+	return assetLoader;
+}
+
+void XP::AssetLoader::RegisterDecoder(std::string extension, ImageDecoder decoder)
+{
+	// Ensure arguments are valid
+	if (extension.size() < 2 || extension[0] != '.')
+	{
+		throw std::invalid_argument("extension must start with a dot");
+	}
+	if (decoder == nullptr)
+	{
+		throw std::invalid_argument("decoder is NULL");
+	}
+
+	std::transform(extension.begin(), extension.end(), extension.begin(), [](char character)
+	{
+		return static_cast<char>(std::tolower(static_cast<unsigned char>(character)));
+	});
+	m_decoders[extension] = decoder;
+}
+
+XP::AssetLoadID XP::AssetLoader::Load(std::string filePath, LoadHandler handler)
+{
+	// Ensure arguments are valid
+	if (handler == nullptr)
+	{
+		throw std::invalid_argument("handler is NULL");
+	}
+
+	if (m_loads.empty())
+	{
+		m_busyStartTime = std::chrono::steady_clock::now();
+		m_frameLoop->Wake();
+	}
+
+	AssetLoadID loadID = ++m_lastLoadID;
+
+	PendingLoad& load	= m_loads[loadID];
+	load.filePath		= std::move(filePath);
+	load.handler		= std::move(handler);
+	load.stage			= LoadStage::Queued;
+	load.readID			= 0;
+	load.heldBytes		= 0;
+	m_queuedLoads.push_back(loadID);
+
+	StartLoads();
+
+	return loadID;
+}
+
+void XP::AssetLoader::Cancel(AssetLoadID loadID)
+{
+	auto load = m_loads.find(loadID);
+	if (load == m_loads.end())
+	{
+		return;
+	}
+
+	switch (load->second.stage)
+	{
+	case LoadStage::Queued:
+		m_queuedLoads.erase(std::find(m_queuedLoads.begin(), m_queuedLoads.end(), loadID));
+		m_loads.erase(load);
+		break;
+	case LoadStage::Reading:
+		m_fileIOService->Cancel(load->second.readID);
+		--m_readingCount;
+		m_loads.erase(load);
+		StartLoads();
+		break;
+	default:
+		// Already decoding, so only forgotten once finished, releasing its bytes
+		load->second.handler = nullptr;
+		break;
+	}
+}
+
+void XP::AssetLoader::SetMemoryCap(size_t memoryCap)
+{
+	// Ensure arguments are valid
+	if (memoryCap == 0)
+	{
+		throw std::invalid_argument("memoryCap must be greater than 0");
+	}
+
+	m_memoryCap = memoryCap;
+	StartLoads();
+}
+
+void XP::AssetLoader::SetFrameBudget(float frameBudget)
+{
+	// Ensure arguments are valid
+	if (!(frameBudget >= 0.0f))
+	{
+		throw std::invalid_argument("frameBudget must not be negative");
+	}
+
+	m_frameBudget = frameBudget;
+}
+
+XP::AssetLoaderStatistics XP::AssetLoader::GetStatistics() const
+{
+	return m_statistics;
+}
+
+XP::DecodedImage XP::AssetLoader::DecodeDDS(const PooledBuffer& file, BufferPool&)
+{
+	const char* data	= file.GetData();
+	size_t size			= file.GetSize();
+	if (size < DDSHeaderSize || ReadUInt32(data, 0) != DDSMagic)
+	{
+		throw std::runtime_error("Not a DDS file");
+	}
+	if ((ReadUInt32(data, DDSCaps2Offset) & DDSCaps2CubeOrVolume) != 0)
+	{
+		throw std::runtime_error("DDS cube maps and volume textures aren't supported");
+	}
+
+	DecodedImage image;
+	image.width		= static_cast<int>(ReadUInt32(data, DDSWidthOffset));
+	image.height	= static_cast<int>(ReadUInt32(data, DDSHeightOffset));
+	if (image.width <= 0 || image.height <= 0)
+	{
+		throw std::runtime_error("DDS file has no pixels");
+	}
+
+	size_t dataOffset		= DDSHeaderSize;
+	uint32_t pixelFlags		= ReadUInt32(data, DDSPixelFlagsOffset);
+	uint32_t fourCC			= ReadUInt32(data, DDSFourCCOffset);
+	if ((pixelFlags & DDSPixelFlagFourCC) != 0 && fourCC == MakeFourCC('D', 'X', '1', '0'))
+	{
+		if (size < DDSHeaderSize + DDSDX10HeaderSize)
+		{
+			throw std::runtime_error("DDS file is truncated");
+		}
+
+		uint32_t dxgiFormat	= ReadUInt32(data, DDSHeaderSize);
+		uint32_t miscFlags	= ReadUInt32(data, DDSHeaderSize + 8);
+		uint32_t arraySize	= ReadUInt32(data, DDSHeaderSize + 12);
+		if ((miscFlags & DDSDX10MiscFlagCube) != 0 || arraySize > 1)
+		{
+			throw std::runtime_error("DDS cube maps and texture arrays aren't supported");
+		}
+
+		switch (dxgiFormat)
+		{
+		case 28: case 29:	image.format = ImageFormat::RGBA8;	break;
+		case 87: case 91:	image.format = ImageFormat::BGRA8;	break;
+		case 71: case 72:	image.format = ImageFormat::BC1;	break;
+		case 74: case 75:	image.format = ImageFormat::BC2;	break;
+		case 77: case 78:	image.format = ImageFormat::BC3;	break;
+		case 98: case 99:	image.format = ImageFormat::BC7;	break;
+		default:
+			throw std::runtime_error("DDS DXGI format " + std::to_string(dxgiFormat) + " isn't supported");
+		}
+		dataOffset += DDSDX10HeaderSize;
+	}
+	else if ((pixelFlags & DDSPixelFlagFourCC) != 0)
+	{
+		if (fourCC == MakeFourCC('D', 'X', 'T', '1'))
+		{
+			image.format = ImageFormat::BC1;
+		}
+		else if (fourCC == MakeFourCC('D', 'X', 'T', '3'))
+		{
+			image.format = ImageFormat::BC2;
+		}
+		else if (fourCC == MakeFourCC('D', 'X', 'T', '5'))
+		{
+			image.format = ImageFormat::BC3;
+		}
+		else
+		{
+			throw std::runtime_error("DDS compression " + std::string(data + DDSFourCCOffset, 4) + " isn't supported");
+		}
+	}
+	else if ((pixelFlags & DDSPixelFlagRGB) != 0 && ReadUInt32(data, DDSBitCountOffset) == 32)
+	{
+		// Red in the lowest byte is RGBA in memory
+		image.format = ReadUInt32(data, DDSRedMaskOffset) == 0x000000FF ? ImageFormat::RGBA8 : ImageFormat::BGRA8;
+	}
+	else
+	{
+		throw std::runtime_error("DDS pixel format isn't supported");
+	}
+
+	uint32_t levelCount = 1;
+	if ((ReadUInt32(data, DDSFlagsOffset) & DDSFlagMipMapCount) != 0 && ReadUInt32(data, DDSMipMapCountOffset) > 0)
+	{
+		levelCount = ReadUInt32(data, DDSMipMapCountOffset);
+	}
+
+	// Levels are left within the file, as they're uploaded as they are
+	int width	= image.width;
+	int height	= image.height;
+	for (uint32_t i = 0; i < levelCount; ++i)
+	{
+		size_t levelSize = GetLevelSize(image.format, width, height);
+		if (levelSize > size - dataOffset)
+		{
+			throw std::runtime_error("DDS file is truncated");
+		}
+
+		ImageLevel level;
+		level.width		= width;
+		level.height	= height;
+		level.pixels	= file.Slice(dataOffset, levelSize);
+		image.levels.push_back(level);
+
+		dataOffset	+= levelSize;
+		width		= std::max(1, width / 2);
+		height		= std::max(1, height / 2);
+	}
+
+	return image;
+}
+
+void XP::AssetLoader::StartLoads()
+{
+	while (!m_queuedLoads.empty())
+	{
+		// One load is always allowed, so a single asset larger than the cap still loads
+		bool isIdle = m_inFlightBytes == 0 && m_readingCount == 0 && m_decodingCount == 0;
+		if (!isIdle)
+		{
+			// Loads being read, or decoded, may yet grow as large as the largest so far
+			size_t runningCount		= m_readingCount + m_decodingCount;
+			size_t decodingEstimate	= m_decodingCount * m_largestLoadBytes;
+			size_t projectedBytes	= m_inFlightBytes + (m_readingCount + 1) * m_largestLoadBytes +
+									  (decodingEstimate > m_decodingBytes ? decodingEstimate - m_decodingBytes : 0);
+			if (projectedBytes > m_memoryCap)
+			{
+				return;
+			}
+
+			// Ramped up as sizes are seen, so a small first file can't let a burst of larger ones through
+			if (runningCount + 1 > 2 * m_measuredLoadCount)
+			{
+				return;
+			}
+		}
+
+		AssetLoadID loadID = m_queuedLoads.front();
+		m_queuedLoads.pop_front();
+		PendingLoad& load = m_loads[loadID];
+
+		if (FindDecoder(load.filePath) == nullptr)
+		{
+			Fail(loadID, "No decoder is registered for " + load.filePath);
+			continue;
+		}
+
+		load.stage = LoadStage::Reading;
+		++m_readingCount;
+
+		FileReadRequest request;
+		request.filePath	= load.filePath;
+		request.offset		= 0;
+		request.size		= 0;
+		load.readID			= m_fileIOService->Read(request, [this, loadID](const FileReadResult& result)
+		{
+			--m_readingCount;
+			if (!result.error.empty())
+			{
+				Fail(loadID, result.error);
+			}
+			else
+			{
+				++m_measuredLoadCount;
+				m_largestLoadBytes = std::max(m_largestLoadBytes, result.buffer.GetSize());
+				Decode(loadID, result);
+			}
+			StartLoads();
+		});
+	}
+}
+
+void XP::AssetLoader::Decode(AssetLoadID loadID, const FileReadResult& result)
+{
+	PendingLoad& load	= m_loads[loadID];
+	load.stage			= LoadStage::Decoding;
+	load.heldBytes		= result.buffer.GetSize();
+	m_inFlightBytes		+= load.heldBytes;
+	m_decodingBytes		+= load.heldBytes;
+	++m_decodingCount;
+	m_statistics.peakInFlightBytes = std::max(m_statistics.peakInFlightBytes, m_inFlightBytes);
+
+	std::shared_ptr<SharedState> state	= m_state;
+	ImageDecoder decoder				= *FindDecoder(load.filePath);
+	PooledBuffer file					= result.buffer;
+	std::string filePath				= load.filePath;
+	m_threadPool->Enqueue([state, decoder, file, filePath, loadID]() mutable
+	{
+		if (state->isClosed.load())
+		{
+			return;
+		}
+
+		DecodedLoad decodedLoad;
+		decodedLoad.loadID			= loadID;
+		decodedLoad.result.filePath	= filePath;
+		decodedLoad.heldBytes		= 0;
+		decodedLoad.fileBytes		= file.GetSize();
+		decodedLoad.decodedBytes	= 0;
+
+		std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+		try
+		{
+			decodedLoad.result.image = decoder(file, *state->pool);
+		}
+		catch (const std::exception& exception)
+		{
+			decodedLoad.result.image = DecodedImage();
+			decodedLoad.result.error = exception.what();
+		}
+		catch (...)
+		{
+			decodedLoad.result.image = DecodedImage();
+			decodedLoad.result.error = "Decoder of " + filePath + " threw";
+		}
+		decodedLoad.decodeTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+		// Levels left within the file keep the whole file alive, others hold only their own bytes
+		bool isFileHeld = false;
+		for (const ImageLevel& level : decodedLoad.result.image.levels)
+		{
+			const char* pixels			= level.pixels.GetData();
+			decodedLoad.decodedBytes	+= level.pixels.GetSize();
+			if (pixels >= file.GetData() && pixels < file.GetData() + file.GetSize())
+			{
+				isFileHeld = true;
+			}
+			else
+			{
+				decodedLoad.heldBytes += level.pixels.GetSize();
+			}
+		}
+		if (isFileHeld)
+		{
+			decodedLoad.heldBytes += file.GetSize();
+		}
+
+		// Released here rather than with the task, so the buffer is back in the pool straight away
+		file = PooledBuffer();
+
+		std::lock_guard<std::mutex> lock(state->mutex);
+		state->decodedLoads.push_back(std::move(decodedLoad));
+	});
+}
+
+void XP::AssetLoader::Fail(AssetLoadID loadID, std::string error)
+{
+	PendingLoad& load	= m_loads[loadID];
+	load.stage			= LoadStage::Decoded;
+
+	DecodedLoad decodedLoad;
+	decodedLoad.loadID			= loadID;
+	decodedLoad.result.filePath	= load.filePath;
+	decodedLoad.result.image	= DecodedImage();
+	decodedLoad.result.error	= std::move(error);
+	decodedLoad.heldBytes		= 0;
+	decodedLoad.fileBytes		= 0;
+	decodedLoad.decodedBytes	= 0;
+	decodedLoad.decodeTime		= 0.0;
+	m_decodedLoads.push_back(std::move(decodedLoad));
+}
+
+void XP::AssetLoader::DispatchCompletions()
+{
+	std::vector<DecodedLoad> decodedLoads;
+	{
+		std::lock_guard<std::mutex> lock(m_state->mutex);
+		decodedLoads.swap(m_state->decodedLoads);
+	}
+
+	// Decoded images count against the cap from now on, in place of their files
+	for (DecodedLoad& decodedLoad : decodedLoads)
+	{
+		PendingLoad& load	= m_loads[decodedLoad.loadID];
+		load.stage			= LoadStage::Decoded;
+		--m_decodingCount;
+		m_decodingBytes		-= load.heldBytes;
+		m_inFlightBytes		= m_inFlightBytes - load.heldBytes + decodedLoad.heldBytes;
+		load.heldBytes		= decodedLoad.heldBytes;
+		m_statistics.peakInFlightBytes = std::max(m_statistics.peakInFlightBytes, m_inFlightBytes);
+
+		// Decoders may hold more than they read, which later loads are estimated from
+		m_largestLoadBytes = std::max(m_largestLoadBytes, decodedLoad.heldBytes);
+
+		m_decodedLoads.push_back(std::move(decodedLoad));
+	}
+
+	// At least one handler is called each frame, so loading always progresses
+	std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+	std::chrono::duration<float> budget(m_frameBudget);
+	bool isFirst = true;
+	while (!m_decodedLoads.empty() && (isFirst || std::chrono::steady_clock::now() - begin < budget))
+	{
+		isFirst = false;
+
+		DecodedLoad decodedLoad = std::move(m_decodedLoads.front());
+		m_decodedLoads.pop_front();
+
+		auto load = m_loads.find(decodedLoad.loadID);
+		PendingLoad pendingLoad = std::move(load->second);
+		m_loads.erase(load);
+
+		if (decodedLoad.result.error.empty())
+		{
+			++m_statistics.loadedCount;
+		}
+		else
+		{
+			++m_statistics.failedCount;
+			XP_LOG_WARNING(g_assetLog, "Failed to load {}: {}", decodedLoad.result.filePath, decodedLoad.result.error);
+		}
+		m_statistics.bytesRead		+= decodedLoad.fileBytes;
+		m_statistics.bytesDecoded	+= decodedLoad.decodedBytes;
+		m_statistics.decodeTime		+= decodedLoad.decodeTime;
+
+		if (pendingLoad.handler != nullptr)
+		{
+			CallbackGuard::Invoke(CallbackType::FlightLoop, this, [&pendingLoad, &decodedLoad]()
+			{
+				pendingLoad.handler(decodedLoad.result);
+			});
+		}
+
+		// Images kept by the handler no longer count against the cap
+		m_inFlightBytes -= pendingLoad.heldBytes;
+	}
+
+	StartLoads();
+
+	if (m_loads.empty())
+	{
+		ReportThroughput();
+	}
+}
+
+void XP::AssetLoader::ReportThroughput()
+{
+	uint64_t loadedCount	= m_statistics.loadedCount - m_reportedStatistics.loadedCount;
+	uint64_t failedCount	= m_statistics.failedCount - m_reportedStatistics.failedCount;
+	uint64_t bytesRead		= m_statistics.bytesRead - m_reportedStatistics.bytesRead;
+	uint64_t bytesDecoded	= m_statistics.bytesDecoded - m_reportedStatistics.bytesDecoded;
+	double decodeTime		= m_statistics.decodeTime - m_reportedStatistics.decodeTime;
+	double elapsedTime		= std::chrono::duration<double>(std::chrono::steady_clock::now() - m_busyStartTime).count();
+	m_reportedStatistics	= m_statistics;
+
+	if (loadedCount + failedCount == 0)
+	{
+		return;
+	}
+
+	XP_LOG_INFO(g_assetLog, "Loaded {} assets ({} failed) in {} ms: {} MB read, {} MB decoded at {} MB/s per thread, peak {} MB held",
+				loadedCount, failedCount, elapsedTime * 1000.0, ToMegabytes(bytesRead), ToMegabytes(bytesDecoded),
+				decodeTime > 0.0 ? ToMegabytes(bytesDecoded) / decodeTime : 0.0, ToMegabytes(m_statistics.peakInFlightBytes));
+}
+
+const XP::AssetLoader::ImageDecoder* XP::AssetLoader::FindDecoder(const std::string& filePath) const
+{
+	// Only a dot after the last separator starts an extension
+	size_t dot = filePath.find_last_of('.');
+	if (dot == std::string::npos || filePath.find_first_of("/\\", dot) != std::string::npos)
+	{
+		return nullptr;
+	}
+
+	std::string extension = filePath.substr(dot);
+	std::transform(extension.begin(), extension.end(), extension.begin(), [](char character)
+	{
+		return static_cast<char>(std::tolower(static_cast<unsigned char>(character)));
+	});
+
+	auto decoder = m_decoders.find(extension);
+	return decoder != m_decoders.end() ? &decoder->second : nullptr;
+}
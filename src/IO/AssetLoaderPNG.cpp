@@ -0,0 +1,805 @@
+#include "XP++/IO/AssetLoader.hpp"
+
+// STL includes
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace
+{
+	const unsigned char PNGSignature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+	const size_t PNGChunkOverhead		= 12;
+
+	// Colour types, and the number of samples in each pixel of them
+	const int PNGColorGrey				= 0;
+	const int PNGColorRGB				= 2;
+	const int PNGColorPalette			= 3;
+	const int PNGColorGreyAlpha			= 4;
+	const int PNGColorRGBA				= 6;
+	const int PNGChannelCounts[7]		= { 1, 0, 3, 1, 2, 0, 4 };
+
+	// Adam7 interlacing passes: the first pixel of each pass, and the distance between its pixels
+	const int Adam7StartX[7]			= { 0, 4, 0, 2, 0, 1, 0 };
+	const int Adam7StartY[7]			= { 0, 0, 4, 0, 2, 0, 1 };
+	const int Adam7StepX[7]				= { 8, 8, 4, 4, 2, 2, 1 };
+	const int Adam7StepY[7]				= { 8, 8, 8, 4, 4, 2, 2 };
+
+	// Deflate length and distance symbols, as a base plus a number of extra bits
+	const uint16_t LengthBases[29]		= { 3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+											35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+	const uint8_t LengthExtraBits[29]	= { 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+											3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+	const uint16_t DistanceBases[30]	= { 1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+											257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577 };
+	const uint8_t DistanceExtraBits[30]	= { 0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+											7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
+	// Order the lengths of the code length code are given in
+	const uint8_t CodeLengthOrder[19]	= { 16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15 };
+
+	inline uint32_t ReadBigEndian(const unsigned char* data)
+	{
+		return (static_cast<uint32_t>(data[0]) << 24) | (static_cast<uint32_t>(data[1]) << 16) |
+			   (static_cast<uint32_t>(data[2]) << 8) | static_cast<uint32_t>(data[3]);
+	}
+
+	// A canonical Huffman code of the deflate format
+	class HuffmanCode final
+	{
+	public:
+		// Codes up to this long are decoded by a single table lookup
+		static const int FastBits		= 10;
+		static const int MaxBits		= 15;
+		static const int MaxSymbols		= 288;
+
+		// Builds the code from the length of each symbol's code, 0 for unused symbols
+		void Build(const uint8_t* lengths, int count)
+		{
+			std::fill(m_counts, m_counts + MaxBits + 1, static_cast<uint16_t>(0));
+			for (int i = 0; i < count; ++i)
+			{
+				m_counts[lengths[i]]++;
+			}
+			m_counts[0] = 0;
+
+			// Over-subscribed codes are invalid, but incomplete ones are allowed
+			int left = 1;
+			for (int length = 1; length <= MaxBits; ++length)
+			{
+				left = (left << 1) - m_counts[length];
+				if (left < 0)
+				{
+					throw std::runtime_error("PNG image data has an invalid Huffman code");
+				}
+			}
+
+			// Symbols ordered by code length, then by value, which is the order of their codes
+			uint16_t offsets[MaxBits + 2] = {};
+			for (int length = 1; length <= MaxBits; ++length)
+			{
+				offsets[length + 1] = offsets[length] + m_counts[length];
+			}
+			for (int i = 0; i < count; ++i)
+			{
+				if (lengths[i] != 0)
+				{
+					m_symbols[offsets[lengths[i]]++] = static_cast<uint16_t>(i);
+				}
+			}
+
+			// Codes are packed from their most significant bit, so are looked up bit-reversed
+			std::fill(m_fastTable, m_fastTable + (1 << FastBits), static_cast<uint16_t>(0));
+			int code	= 0;
+			int index	= 0;
+			for (int length = 1; length <= FastBits; ++length)
+			{
+				for (int i = 0; i < m_counts[length]; ++i, ++code, ++index)
+				{
+					int reversed = 0;
+					for (int bit = 0; bit < length; ++bit)
+					{
+						reversed |= ((code >> bit) & 1) << (length - 1 - bit);
+					}
+					for (int entry = reversed; entry < (1 << FastBits); entry += 1 << length)
+					{
+						m_fastTable[entry] = static_cast<uint16_t>((length << 9) | m_symbols[index]);
+					}
+				}
+				code <<= 1;
+			}
+		}
+
+	private:
+		friend class Inflater;
+
+		// Number of codes of each length
+		uint16_t m_counts[MaxBits + 1];
+		// Symbols in code order
+		uint16_t m_symbols[MaxSymbols];
+		// Length and symbol of each short code, by its next bits, or 0 if longer
+		uint16_t m_fastTable[1 << FastBits];
+	};
+
+	// Decompresses a zlib stream whose decompressed size is known
+	class Inflater final
+	{
+	public:
+		Inflater(const unsigned char* input, size_t inputSize, unsigned char* output, size_t outputSize) :
+			m_input(input), m_inputSize(inputSize), m_inputPosition(0), m_bitBuffer(0), m_bitCount(0), m_paddingBits(0),
+			m_output(output), m_outputSize(outputSize), m_outputPosition(0) {}
+
+		// Inflates the whole stream, throwing if it's invalid or doesn't exactly fill the output
+		void Inflate()
+		{
+			uint32_t header = GetBits(8) << 8;
+			header			|= GetBits(8);
+			if ((header >> 8 & 0x0F) != 8 || (header >> 12) > 7 || header % 31 != 0 || (header & 0x20) != 0)
+			{
+				throw std::runtime_error("PNG image data isn't a zlib stream");
+			}
+
+			bool isFinal;
+			do
+			{
+				isFinal		= GetBits(1) != 0;
+				int type	= static_cast<int>(GetBits(2));
+				if (type == 0)
+				{
+					InflateStored();
+				}
+				else if (type == 1)
+				{
+					BuildFixedCodes();
+					InflateCompressed();
+				}
+				else if (type == 2)
+				{
+					BuildDynamicCodes();
+					InflateCompressed();
+				}
+				else
+				{
+					throw std::runtime_error("PNG image data has an invalid block type");
+				}
+			} while (!isFinal);
+
+			if (m_outputPosition != m_outputSize)
+			{
+				throw std::runtime_error("PNG image data is too short");
+			}
+
+			// Adler-32 checksum of the output, following the last block's final byte
+			Consume(m_bitCount % 8);
+			uint32_t checksum = 0;
+			for (int i = 0; i < 4; ++i)
+			{
+				checksum = (checksum << 8) | GetBits(8);
+			}
+			if (checksum != GetAdler32())
+			{
+				throw std::runtime_error("PNG image data is corrupt");
+			}
+		}
+
+	private:
+		// Compressed stream
+		const unsigned char* m_input;
+		size_t m_inputSize;
+		size_t m_inputPosition;
+		// Bits read ahead from the input, least significant first
+		uint64_t m_bitBuffer;
+		int m_bitCount;
+		// Zero bits added to the bit buffer past the end of the input
+		int m_paddingBits;
+		// Decompressed data
+		unsigned char* m_output;
+		size_t m_outputSize;
+		size_t m_outputPosition;
+		// Codes of the current block
+		HuffmanCode m_literalCode;
+		HuffmanCode m_distanceCode;
+
+		// Fills the bit buffer, padding with zero bits past the end of the input
+		inline void Refill()
+		{
+			while (m_bitCount <= 56)
+			{
+				if (m_inputPosition < m_inputSize)
+				{
+					m_bitBuffer |= static_cast<uint64_t>(m_input[m_inputPosition++]) << m_bitCount;
+				}
+				else
+				{
+					m_paddingBits += 8;
+				}
+				m_bitCount += 8;
+			}
+
+			// Padding is read last, so some was used once there's more of it than bits left
+			if (m_paddingBits > m_bitCount)
+			{
+				throw std::runtime_error("PNG image data is truncated");
+			}
+		}
+		inline void Consume(int count)
+		{
+			m_bitBuffer >>= count;
+			m_bitCount	-= count;
+		}
+		inline uint32_t GetBits(int count)
+		{
+			if (count == 0)
+			{
+				return 0;
+			}
+			Refill();
+			uint32_t bits = static_cast<uint32_t>(m_bitBuffer & ((1ull << count) - 1));
+			Consume(count);
+			return bits;
+		}
+
+		// Decodes a symbol of a Huffman code
+		inline int Decode(const HuffmanCode& code)
+		{
+			Refill();
+			uint16_t entry = code.m_fastTable[m_bitBuffer & ((1 << HuffmanCode::FastBits) - 1)];
+			if (entry != 0)
+			{
+				Consume(entry >> 9);
+				return entry & 0x1FF;
+			}
+
+			// Longer codes are decoded a bit at a time
+			int value	= 0;
+			int first	= 0;
+			int index	= 0;
+			for (int length = 1; length <= HuffmanCode::MaxBits; ++length)
+			{
+				value |= static_cast<int>(m_bitBuffer & 1);
+				Consume(1);
+				int count = code.m_counts[length];
+				if (value - first < count)
+				{
+					return code.m_symbols[index + value - first];
+				}
+				index	+= count;
+				first	= (first + count) << 1;
+				value	<<= 1;
+			}
+			throw std::runtime_error("PNG image data has an invalid Huffman code");
+		}
+
+		void InflateStored()
+		{
+			Consume(m_bitCount % 8);
+			uint32_t length			= GetBits(16);
+			uint32_t lengthCheck	= GetBits(16);
+			if ((length ^ 0xFFFF) != lengthCheck)
+			{
+				throw std::runtime_error("PNG image data has an invalid stored block");
+			}
+			if (length > m_outputSize - m_outputPosition)
+			{
+				throw std::runtime_error("PNG image data is too long");
+			}
+
+			// Bytes already read ahead, then the rest straight from the input
+			for (; length > 0 && m_bitCount > m_paddingBits; --length)
+			{
+				m_output[m_outputPosition++] = static_cast<unsigned char>(GetBits(8));
+			}
+			if (length > m_inputSize - m_inputPosition)
+			{
+				throw std::runtime_error("PNG image data is truncated");
+			}
+			std::memcpy(m_output + m_outputPosition, m_input + m_inputPosition, length);
+			m_outputPosition	+= length;
+			m_inputPosition		+= length;
+		}
+
+		void BuildFixedCodes()
+		{
+			uint8_t lengths[HuffmanCode::MaxSymbols];
+			std::fill(lengths, lengths + 144, static_cast<uint8_t>(8));
+			std::fill(lengths + 144, lengths + 256, static_cast<uint8_t>(9));
+			std::fill(lengths + 256, lengths + 280, static_cast<uint8_t>(7));
+			std::fill(lengths + 280, lengths + 288, static_cast<uint8_t>(8));
+			m_literalCode.Build(lengths, 288);
+
+			std::fill(lengths, lengths + 32, static_cast<uint8_t>(5));
+			m_distanceCode.Build(lengths, 32);
+		}
+
+		void BuildDynamicCodes()
+		{
+			int literalCount	= static_cast<int>(GetBits(5)) + 257;
+			int distanceCount	= static_cast<int>(GetBits(5)) + 1;
+			int codeLengthCount	= static_cast<int>(GetBits(4)) + 4;
+
+			uint8_t codeLengthLengths[19] = {};
+			for (int i = 0; i < codeLengthCount; ++i)
+			{
+				codeLengthLengths[CodeLengthOrder[i]] = static_cast<uint8_t>(GetBits(3));
+			}
+			HuffmanCode codeLengthCode;
+			codeLengthCode.Build(codeLengthLengths, 19);
+
+			// Literal and distance code lengths run on from one to the other
+			uint8_t lengths[HuffmanCode::MaxSymbols + 32] = {};
+			int count = literalCount + distanceCount;
+			for (int i = 0; i < count;)
+			{
+				int symbol = Decode(codeLengthCode);
+				if (symbol < 16)
+				{
+					lengths[i++] = static_cast<uint8_t>(symbol);
+					continue;
+				}
+
+				uint8_t repeated	= 0;
+				int repeatCount		= 0;
+				if (symbol == 16)
+				{
+					if (i == 0)
+					{
+						throw std::runtime_error("PNG image data repeats a missing code length");
+					}
+					repeated	= lengths[i - 1];
+					repeatCount	= 3 + static_cast<int>(GetBits(2));
+				}
+				else if (symbol == 17)
+				{
+					repeatCount	= 3 + static_cast<int>(GetBits(3));
+				}
+				else
+				{
+					repeatCount	= 11 + static_cast<int>(GetBits(7));
+				}
+				if (repeatCount > count - i)
+				{
+					throw std::runtime_error("PNG image data has too many code lengths");
+				}
+				std::fill(lengths + i, lengths + i + repeatCount, repeated);
+				i += repeatCount;
+			}
+			if (lengths[256] == 0)
+			{
+				throw std::runtime_error("PNG image data has no end of block code");
+			}
+
+			m_literalCode.Build(lengths, literalCount);
+			m_distanceCode.Build(lengths + literalCount, distanceCount);
+		}
+
+		void InflateCompressed()
+		{
+			for (;;)
+			{
+				int symbol = Decode(m_literalCode);
+				if (symbol < 256)
+				{
+					if (m_outputPosition == m_outputSize)
+					{
+						throw std::runtime_error("PNG image data is too long");
+					}
+					m_output[m_outputPosition++] = static_cast<unsigned char>(symbol);
+					continue;
+				}
+				if (symbol == 256)
+				{
+					return;
+				}
+
+				symbol -= 257;
+				if (symbol >= 29)
+				{
+					throw std::runtime_error("PNG image data has an invalid length");
+				}
+				size_t length			= LengthBases[symbol] + GetBits(LengthExtraBits[symbol]);
+				int distanceSymbol		= Decode(m_distanceCode);
+				if (distanceSymbol >= 30)
+				{
+					throw std::runtime_error("PNG image data has an invalid distance");
+				}
+				size_t distance			= DistanceBases[distanceSymbol] + GetBits(DistanceExtraBits[distanceSymbol]);
+				if (distance > m_outputPosition)
+				{
+					throw std::runtime_error("PNG image data refers back past its start");
+				}
+				if (length > m_outputSize - m_outputPosition)
+				{
+					throw std::runtime_error("PNG image data is too long");
+				}
+
+				// Copied a byte at a time, as the source may overlap what's being written
+				unsigned char* target		= m_output + m_outputPosition;
+				const unsigned char* source	= target - distance;
+				for (size_t i = 0; i < length; ++i)
+				{
+					target[i] = source[i];
+				}
+				m_outputPosition += length;
+			}
+		}
+
+		uint32_t GetAdler32() const
+		{
+			uint32_t a = 1;
+			uint32_t b = 0;
+			for (size_t position = 0; position < m_outputSize;)
+			{
+				// Largest run which can't overflow before taking the modulus
+				size_t end = std::min(m_outputSize, position + 5552);
+				for (; position < end; ++position)
+				{
+					a += m_output[position];
+					b += a;
+				}
+				a %= 65521;
+				b %= 65521;
+			}
+			return (b << 16) | a;
+		}
+	};
+
+	inline unsigned char GetPaethPredictor(int left, int above, int aboveLeft)
+	{
+		int estimate		= left + above - aboveLeft;
+		int leftDistance	= std::abs(estimate - left);
+		int aboveDistance	= std::abs(estimate - above);
+		int cornerDistance	= std::abs(estimate - aboveLeft);
+		if (leftDistance <= aboveDistance && leftDistance <= cornerDistance)
+		{
+			return static_cast<unsigned char>(left);
+		}
+		return static_cast<unsigned char>(aboveDistance <= cornerDistance ? above : aboveLeft);
+	}
+
+	// Reverses the filter of a row, given the previous (unfiltered) row of the same pass
+	void UnfilterRow(int filter, unsigned char* row, const unsigned char* previous, size_t rowSize, size_t pixelSize)
+	{
+		switch (filter)
+		{
+		case 0:
+			break;
+		case 1:
+			for (size_t i = pixelSize; i < rowSize; ++i)
+			{
+				row[i] = static_cast<unsigned char>(row[i] + row[i - pixelSize]);
+			}
+			break;
+		case 2:
+			for (size_t i = 0; i < rowSize; ++i)
+			{
+				row[i] = static_cast<unsigned char>(row[i] + previous[i]);
+			}
+			break;
+		case 3:
+			for (size_t i = 0; i < rowSize; ++i)
+			{
+				int left	= i >= pixelSize ? row[i - pixelSize] : 0;
+				row[i]		= static_cast<unsigned char>(row[i] + ((left + previous[i]) >> 1));
+			}
+			break;
+		case 4:
+			for (size_t i = 0; i < rowSize; ++i)
+			{
+				int left		= i >= pixelSize ? row[i - pixelSize] : 0;
+				int aboveLeft	= i >= pixelSize ? previous[i - pixelSize] : 0;
+				row[i]			= static_cast<unsigned char>(row[i] + GetPaethPredictor(left, previous[i], aboveLeft));
+			}
+			break;
+		default:
+			throw std::runtime_error("PNG row has an invalid filter");
+		}
+	}
+
+	// Image header, palette and transparency of a PNG file
+	struct PNGImage
+	{
+		uint32_t width;
+		uint32_t height;
+		int bitDepth;
+		int colorType;
+		bool isInterlaced;
+		// Palette as RGBA, with alpha from the transparency chunk
+		unsigned char palette[256 * 4];
+		int paletteSize;
+		// Transparent grey or RGB sample values, at the image's bit depth
+		bool hasTransparentColor;
+		uint16_t transparentColor[3];
+	};
+
+	// Reads the sample of a row at an index, at the image's bit depth
+	inline uint16_t ReadSample(const unsigned char* row, size_t index, int bitDepth)
+	{
+		if (bitDepth == 8)
+		{
+			return row[index];
+		}
+		if (bitDepth == 16)
+		{
+			return static_cast<uint16_t>((row[index * 2] << 8) | row[index * 2 + 1]);
+		}
+
+		size_t bit = index * bitDepth;
+		return static_cast<uint16_t>((row[bit / 8] >> (8 - bitDepth - bit % 8)) & ((1 << bitDepth) - 1));
+	}
+
+	// Scales a sample to 8 bits
+	inline unsigned char ScaleSample(uint16_t sample, int bitDepth)
+	{
+		if (bitDepth == 16)
+		{
+			return static_cast<unsigned char>(sample >> 8);
+		}
+		return static_cast<unsigned char>(sample * 255 / ((1 << bitDepth) - 1));
+	}
+
+	// Converts an unfiltered row to RGBA, writing its pixels a given number of bytes apart
+	void ExpandRow(const PNGImage& image, const unsigned char* row, size_t pixelCount, unsigned char* output, size_t outputStep)
+	{
+		const int bitDepth = image.bitDepth;
+		for (size_t i = 0; i < pixelCount; ++i, output += outputStep)
+		{
+			switch (image.colorType)
+			{
+			case PNGColorGrey:
+			{
+				uint16_t grey	= ReadSample(row, i, bitDepth);
+				output[0]		= output[1] = output[2] = ScaleSample(grey, bitDepth);
+				output[3]		= image.hasTransparentColor && grey == image.transparentColor[0] ? 0 : 255;
+				break;
+			}
+			case PNGColorRGB:
+			{
+				uint16_t red	= ReadSample(row, i * 3, bitDepth);
+				uint16_t green	= ReadSample(row, i * 3 + 1, bitDepth);
+				uint16_t blue	= ReadSample(row, i * 3 + 2, bitDepth);
+				output[0]		= ScaleSample(red, bitDepth);
+				output[1]		= ScaleSample(green, bitDepth);
+				output[2]		= ScaleSample(blue, bitDepth);
+				output[3]		= image.hasTransparentColor && red == image.transparentColor[0] &&
+								  green == image.transparentColor[1] && blue == image.transparentColor[2] ? 0 : 255;
+				break;
+			}
+			case PNGColorPalette:
+			{
+				uint16_t index = ReadSample(row, i, bitDepth);
+				if (index >= image.paletteSize)
+				{
+					throw std::runtime_error("PNG pixel is outside the palette");
+				}
+				std::memcpy(output, image.palette + index * 4, 4);
+				break;
+			}
+			case PNGColorGreyAlpha:
+				output[0]		= output[1] = output[2] = ScaleSample(ReadSample(row, i * 2, bitDepth), bitDepth);
+				output[3]		= ScaleSample(ReadSample(row, i * 2 + 1, bitDepth), bitDepth);
+				break;
+			default:
+				for (int channel = 0; channel < 4; ++channel)
+				{
+					output[channel] = ScaleSample(ReadSample(row, i * 4 + channel, bitDepth), bitDepth);
+				}
+				break;
+			}
+		}
+	}
+
+	// Gets the bytes of a pass of the image data, with its rows' filter bytes
+	uint64_t GetPassSize(const PNGImage& image, uint64_t width, uint64_t height)
+	{
+		if (width == 0 || height == 0)
+		{
+			return 0;
+		}
+		uint64_t bitsPerPixel = static_cast<uint64_t>(PNGChannelCounts[image.colorType] * image.bitDepth);
+		return height * (1 + (width * bitsPerPixel + 7) / 8);
+	}
+}
+
+XP::DecodedImage XP::AssetLoader::DecodePNG(const PooledBuffer& file, BufferPool& pool)
+{
+	const unsigned char* data	= reinterpret_cast<const unsigned char*>(file.GetData());
+	size_t size					= file.GetSize();
+	if (size < sizeof(PNGSignature) || std::memcmp(data, PNGSignature, sizeof(PNGSignature)) != 0)
+	{
+		throw std::runtime_error("Not a PNG file");
+	}
+
+	// Read the header, palette and transparency, and find the image data
+	PNGImage image = {};
+	bool isHeaderRead = false;
+	std::vector<std::pair<size_t, size_t>> dataChunks;
+	size_t dataSize = 0;
+	for (size_t offset = sizeof(PNGSignature);;)
+	{
+		if (size - offset < PNGChunkOverhead || ReadBigEndian(data + offset) > size - offset - PNGChunkOverhead)
+		{
+			throw std::runtime_error("PNG file is truncated");
+		}
+		size_t length				= ReadBigEndian(data + offset);
+		const unsigned char* type	= data + offset + 4;
+		const unsigned char* chunk	= data + offset + 8;
+		offset						+= PNGChunkOverhead + length;
+
+		if (std::memcmp(type, "IHDR", 4) == 0)
+		{
+			if (length < 13)
+			{
+				throw std::runtime_error("PNG header is truncated");
+			}
+			image.width			= ReadBigEndian(chunk);
+			image.height		= ReadBigEndian(chunk + 4);
+			image.bitDepth		= chunk[8];
+			image.colorType		= chunk[9];
+			image.isInterlaced	= chunk[12] == 1;
+
+			const int depth		= image.bitDepth;
+			bool isValidDepth	= depth == 8 || (depth == 16 && image.colorType != PNGColorPalette) ||
+								  ((depth == 1 || depth == 2 || depth == 4) && (image.colorType == PNGColorGrey || image.colorType == PNGColorPalette));
+			if (image.colorType > PNGColorRGBA || PNGChannelCounts[image.colorType] == 0 || !isValidDepth)
+			{
+				throw std::runtime_error("PNG colour type or bit depth is invalid");
+			}
+			if (image.width == 0 || image.height == 0 || image.width > 0x7FFFFFFF || image.height > 0x7FFFFFFF)
+			{
+				throw std::runtime_error("PNG file has no pixels");
+			}
+			if (chunk[10] != 0 || chunk[11] != 0 || chunk[12] > 1)
+			{
+				throw std::runtime_error("PNG compression, filter or interlace method isn't supported");
+			}
+			isHeaderRead = true;
+		}
+		else if (!isHeaderRead)
+		{
+			throw std::runtime_error("PNG file doesn't start with a header");
+		}
+		else if (std::memcmp(type, "PLTE", 4) == 0)
+		{
+			if (length % 3 != 0 || length > 256 * 3)
+			{
+				throw std::runtime_error("PNG palette is invalid");
+			}
+			image.paletteSize = static_cast<int>(length / 3);
+			for (int i = 0; i < image.paletteSize; ++i)
+			{
+				std::memcpy(image.palette + i * 4, chunk + i * 3, 3);
+				image.palette[i * 4 + 3] = 255;
+			}
+		}
+		else if (std::memcmp(type, "tRNS", 4) == 0)
+		{
+			if (image.colorType == PNGColorPalette)
+			{
+				for (size_t i = 0; i < length && i < static_cast<size_t>(image.paletteSize); ++i)
+				{
+					image.palette[i * 4 + 3] = chunk[i];
+				}
+			}
+			else if ((image.colorType == PNGColorGrey && length >= 2) || (image.colorType == PNGColorRGB && length >= 6))
+			{
+				image.hasTransparentColor = true;
+				for (int i = 0; i < PNGChannelCounts[image.colorType]; ++i)
+				{
+					image.transparentColor[i] = static_cast<uint16_t>((chunk[i * 2] << 8) | chunk[i * 2 + 1]);
+				}
+			}
+		}
+		else if (std::memcmp(type, "IDAT", 4) == 0)
+		{
+			dataChunks.push_back(std::make_pair(static_cast<size_t>(chunk - data), length));
+			dataSize += length;
+		}
+		else if (std::memcmp(type, "IEND", 4) == 0)
+		{
+			break;
+		}
+		else if ((type[0] & 0x20) == 0)
+		{
+			throw std::runtime_error("PNG chunk " + std::string(reinterpret_cast<const char*>(type), 4) + " isn't supported");
+		}
+	}
+	if (image.colorType == PNGColorPalette && image.paletteSize == 0)
+	{
+		throw std::runtime_error("PNG file has no palette");
+	}
+	if (dataChunks.empty())
+	{
+		throw std::runtime_error("PNG file has no image data");
+	}
+
+	// Image data split over several chunks is joined up first
+	PooledBuffer joinedData;
+	const unsigned char* compressed = data + dataChunks.front().first;
+	if (dataChunks.size() > 1)
+	{
+		joinedData = pool.Acquire(dataSize);
+		size_t joinedSize = 0;
+		for (const std::pair<size_t, size_t>& dataChunk : dataChunks)
+		{
+			std::memcpy(joinedData.GetData() + joinedSize, data + dataChunk.first, dataChunk.second);
+			joinedSize += dataChunk.second;
+		}
+		compressed = reinterpret_cast<const unsigned char*>(joinedData.GetData());
+	}
+
+	// Sizes are checked in 64 bits, so corrupt dimensions can't overflow them
+	const int passCount		= image.isInterlaced ? 7 : 1;
+	uint64_t filteredSize	= 0;
+	for (int pass = 0; pass < passCount; ++pass)
+	{
+		int startX	= image.isInterlaced ? Adam7StartX[pass] : 0;
+		int startY	= image.isInterlaced ? Adam7StartY[pass] : 0;
+		int stepX	= image.isInterlaced ? Adam7StepX[pass] : 1;
+		int stepY	= image.isInterlaced ? Adam7StepY[pass] : 1;
+		filteredSize += GetPassSize(image, image.width > static_cast<uint32_t>(startX) ? (image.width - startX + stepX - 1) / stepX : 0,
+									image.height > static_cast<uint32_t>(startY) ? (image.height - startY + stepY - 1) / stepY : 0);
+	}
+	uint64_t pixelsSize = static_cast<uint64_t>(image.width) * image.height * 4;
+	if (filteredSize > static_cast<size_t>(-1) || pixelsSize > static_cast<size_t>(-1))
+	{
+		throw std::runtime_error("PNG image is too large");
+	}
+
+	// Deflate can't expand data more than 1032 times, so a corrupt header is caught before allocating for it
+	if (filteredSize > static_cast<uint64_t>(dataSize) * 1032 + 1032)
+	{
+		throw std::runtime_error("PNG image data is too short");
+	}
+
+	PooledBuffer filtered = pool.Acquire(static_cast<size_t>(filteredSize));
+	unsigned char* filteredData = reinterpret_cast<unsigned char*>(filtered.GetData());
+	Inflater(compressed, dataSize, filteredData, static_cast<size_t>(filteredSize)).Inflate();
+	joinedData = PooledBuffer();
+
+	// Unfilter each pass a row at a time, expanding its pixels into place
+	DecodedImage decodedImage;
+	decodedImage.format	= ImageFormat::RGBA8;
+	decodedImage.width	= static_cast<int>(image.width);
+	decodedImage.height	= static_cast<int>(image.height);
+
+	ImageLevel level;
+	level.width		= decodedImage.width;
+	level.height	= decodedImage.height;
+	level.pixels	= pool.Acquire(static_cast<size_t>(pixelsSize));
+	unsigned char* pixels = reinterpret_cast<unsigned char*>(level.pixels.GetData());
+
+	const size_t pixelSize = std::max<size_t>(1, PNGChannelCounts[image.colorType] * image.bitDepth / 8);
+	std::vector<unsigned char> emptyRow;
+	for (int pass = 0; pass < passCount; ++pass)
+	{
+		size_t startX	= image.isInterlaced ? Adam7StartX[pass] : 0;
+		size_t startY	= image.isInterlaced ? Adam7StartY[pass] : 0;
+		size_t stepX	= image.isInterlaced ? Adam7StepX[pass] : 1;
+		size_t stepY	= image.isInterlaced ? Adam7StepY[pass] : 1;
+		if (image.width <= startX || image.height <= startY)
+		{
+			continue;
+		}
+		size_t passWidth	= (image.width - startX + stepX - 1) / stepX;
+		size_t passHeight	= (image.height - startY + stepY - 1) / stepY;
+		size_t rowSize		= static_cast<size_t>(GetPassSize(image, passWidth, 1)) - 1;
+
+		// The row above the first is taken as zeros
+		emptyRow.assign(rowSize, 0);
+		const unsigned char* previous = emptyRow.data();
+		for (size_t y = 0; y < passHeight; ++y)
+		{
+			unsigned char* row = filteredData + 1;
+			UnfilterRow(filteredData[0], row, previous, rowSize, pixelSize);
+			ExpandRow(image, row, passWidth, pixels + ((startY + y * stepY) * image.width + startX) * 4, stepX * 4);
+
+			previous		= row;
+			filteredData	+= rowSize + 1;
+		}
+	}
+
+	decodedImage.levels.push_back(level);
+	return decodedImage;
+}
@@ -0,0 +1,125 @@
+#include "XP++/IO/BufferPool.hpp"
+
+// XP++ includes
+#include "XP++/Diagnostics/TaggedAllocator.hpp"
+
+namespace
+{
+	typedef XP::TaggedAllocator<char, XP::MemoryTag::Caches> BufferAllocator;
+}
+
+XP::BufferPool::BufferPool(size_t capacity) :
+	m_mutex(), m_freeBuffers(), m_pooledBytes(0), m_capacity(capacity), m_reuseCount(0)
+{
+
+}
+
+XP::BufferPool::~BufferPool()
+{
+	for (int shift = MinimumShift; shift <= MaximumShift; ++shift)
+	{
+		for (char* buffer : m_freeBuffers[shift - MinimumShift])
+		{
+			BufferAllocator().deallocate(buffer, static_cast<size_t>(1) << shift);
+		}
+	}
+}
+
+std::shared_ptr<XP::BufferPool> XP::BufferPool::Create(size_t capacity)
+{
+	std::shared_ptr<BufferPool> bufferPool(new BufferPool(capacity), [](BufferPool* bufferPool)
+	{
+		delete bufferPool;
+	});
+
+	return bufferPool;
+}
+
+XP::PooledBuffer XP::BufferPool::Acquire(size_t size)
+{
+	int shift = MinimumShift;
+	while (shift <= MaximumShift && (static_cast<size_t>(1) << shift) < size)
+	{
+		++shift;
+	}
+
+	size_t capacity	= shift <= MaximumShift ? static_cast<size_t>(1) << shift : size;
+	char* buffer	= nullptr;
+	if (shift <= MaximumShift)
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		std::vector<char*>& freeBuffers = m_freeBuffers[shift - MinimumShift];
+		if (!freeBuffers.empty())
+		{
+			buffer = freeBuffers.back();
+			freeBuffers.pop_back();
+			m_pooledBytes -= capacity;
+			++m_reuseCount;
+		}
+	}
+	if (buffer == nullptr)
+	{
+		buffer = BufferAllocator().allocate(capacity);
+	}
+
+	// The storage keeps the pool alive, so it can always be returned
+	std::shared_ptr<BufferPool> pool = shared_from_this();
+	std::shared_ptr<char> storage(buffer, [pool, capacity](char* buffer)
+	{
+		pool->Release(buffer, capacity);
+	});
+
+	return PooledBuffer(storage, size);
+}
+
+void XP::BufferPool::SetCapacity(size_t capacity)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_capacity = capacity;
+
+	// Free the largest buffers first, as they're the least likely to be reused
+	for (int shift = MaximumShift; shift >= MinimumShift && m_pooledBytes > m_capacity; --shift)
+	{
+		std::vector<char*>& freeBuffers = m_freeBuffers[shift - MinimumShift];
+		while (!freeBuffers.empty() && m_pooledBytes > m_capacity)
+		{
+			BufferAllocator().deallocate(freeBuffers.back(), static_cast<size_t>(1) << shift);
+			freeBuffers.pop_back();
+			m_pooledBytes -= static_cast<size_t>(1) << shift;
+		}
+	}
+}
+
+size_t XP::BufferPool::GetPooledBytes() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_pooledBytes;
+}
+
+uint64_t XP::BufferPool::GetReuseCount() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_reuseCount;
+}
+
+void XP::BufferPool::Release(char* buffer, size_t capacity)
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		int shift = MinimumShift;
+		while (shift <= MaximumShift && (static_cast<size_t>(1) << shift) != capacity)
+		{
+			++shift;
+		}
+		if (shift <= MaximumShift && m_pooledBytes + capacity <= m_capacity)
+		{
+			m_freeBuffers[shift - MinimumShift].push_back(buffer);
+			m_pooledBytes += capacity;
+			return;
+		}
+	}
+
+	BufferAllocator().deallocate(buffer, capacity);
+}
@@ -0,0 +1,580 @@
+#include "XP++/IO/FileIOService.hpp"
+
+// STL includes
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <stdexcept>
+
+// XP++ includes
+#include "XP++/Diagnostics/CallbackGuard.hpp"
+#include "XP++/Processing/FrameLoop.hpp"
+#include "XP++/Processing/ThreadPool.hpp"
+
+// Platform includes
+#if IBM
+// Keep windows.h from defining min and max macros
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+	// Defaults for the read-ahead and the free buffers kept
+	const size_t DefaultReadAheadSize = 256 * 1024;
+	const size_t DefaultPoolCapacity = 32 * 1024 * 1024;
+	// Number of files whose read-ahead is kept
+	const size_t ReadAheadEntryCount = 8;
+
+	// Size and modification time of a file, which change when it's rewritten
+	struct FileVersion
+	{
+		uint64_t size;
+		uint64_t modifiedTime;
+
+		bool operator==(const FileVersion& other) const
+		{
+			return size == other.size && modifiedTime == other.modifiedTime;
+		}
+	};
+
+#if IBM
+	uint64_t ToTicks(const FILETIME& time)
+	{
+		return (static_cast<uint64_t>(time.dwHighDateTime) << 32) | time.dwLowDateTime;
+	}
+#else
+	FileVersion ToFileVersion(const struct stat& status)
+	{
+		FileVersion version;
+		version.size = static_cast<uint64_t>(status.st_size);
+#if APL
+		version.modifiedTime = static_cast<uint64_t>(status.st_mtimespec.tv_sec) * 1000000000 + status.st_mtimespec.tv_nsec;
+#else
+		version.modifiedTime = static_cast<uint64_t>(status.st_mtim.tv_sec) * 1000000000 + status.st_mtim.tv_nsec;
+#endif
+		return version;
+	}
+#endif
+
+	// Gets the version of a file without opening it, returning false if it doesn't exist
+	bool GetFileVersion(const std::string& filePath, FileVersion& version)
+	{
+#if IBM
+		WIN32_FILE_ATTRIBUTE_DATA attributes;
+		if (!GetFileAttributesExA(filePath.c_str(), GetFileExInfoStandard, &attributes))
+		{
+			return false;
+		}
+
+		version.size			= (static_cast<uint64_t>(attributes.nFileSizeHigh) << 32) | attributes.nFileSizeLow;
+		version.modifiedTime	= ToTicks(attributes.ftLastWriteTime);
+#else
+		struct stat status;
+		if (stat(filePath.c_str(), &status) != 0)
+		{
+			return false;
+		}
+
+		version = ToFileVersion(status);
+#endif
+		return true;
+	}
+
+	// File opened for positioned reads
+	class ReadableFile
+	{
+	public:
+#if IBM
+		ReadableFile(const std::string& filePath) :
+			m_handle(CreateFileA(filePath.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr, OPEN_EXISTING,
+								 FILE_ATTRIBUTE_NORMAL, nullptr)) {}
+		~ReadableFile()
+		{
+			if (IsOpen())
+			{
+				CloseHandle(m_handle);
+			}
+		}
+
+		bool IsOpen() const
+		{
+			return m_handle != INVALID_HANDLE_VALUE;
+		}
+
+		bool GetVersion(FileVersion& version) const
+		{
+			BY_HANDLE_FILE_INFORMATION information;
+			if (!GetFileInformationByHandle(m_handle, &information))
+			{
+				return false;
+			}
+
+			version.size			= (static_cast<uint64_t>(information.nFileSizeHigh) << 32) | information.nFileSizeLow;
+			version.modifiedTime	= ToTicks(information.ftLastWriteTime);
+			return true;
+		}
+
+		// Reads until the buffer is full or the end of the file, returning false on an error
+		bool ReadAt(char* buffer, size_t size, uint64_t offset, size_t& bytesRead) const
+		{
+			bytesRead = 0;
+			while (bytesRead < size)
+			{
+				OVERLAPPED overlapped	= {};
+				uint64_t position		= offset + bytesRead;
+				overlapped.Offset		= static_cast<DWORD>(position);
+				overlapped.OffsetHigh	= static_cast<DWORD>(position >> 32);
+
+				DWORD chunkSize = static_cast<DWORD>(std::min<size_t>(size - bytesRead, 1 << 30));
+				DWORD chunkRead = 0;
+				if (!ReadFile(m_handle, buffer + bytesRead, chunkSize, &chunkRead, &overlapped))
+				{
+					return GetLastError() == ERROR_HANDLE_EOF;
+				}
+				if (chunkRead == 0)
+				{
+					return true;
+				}
+
+				bytesRead += chunkRead;
+			}
+
+			return true;
+		}
+
+	private:
+		HANDLE m_handle;
+#else
+		ReadableFile(const std::string& filePath) :
+			m_descriptor(open(filePath.c_str(), O_RDONLY | O_CLOEXEC)) {}
+		~ReadableFile()
+		{
+			if (IsOpen())
+			{
+				close(m_descriptor);
+			}
+		}
+
+		bool IsOpen() const
+		{
+			return m_descriptor >= 0;
+		}
+
+		bool GetVersion(FileVersion& version) const
+		{
+			struct stat status;
+			if (fstat(m_descriptor, &status) != 0)
+			{
+				return false;
+			}
+
+			version = ToFileVersion(status);
+			return true;
+		}
+
+		// Reads until the buffer is full or the end of the file, returning false on an error
+		bool ReadAt(char* buffer, size_t size, uint64_t offset, size_t& bytesRead) const
+		{
+			bytesRead = 0;
+			while (bytesRead < size)
+			{
+				ssize_t chunkRead = pread(m_descriptor, buffer + bytesRead, size - bytesRead, static_cast<off_t>(offset + bytesRead));
+				if (chunkRead < 0)
+				{
+					if (errno == EINTR)
+					{
+						continue;
+					}
+					return false;
+				}
+				if (chunkRead == 0)
+				{
+					return true;
+				}
+
+				bytesRead += static_cast<size_t>(chunkRead);
+			}
+
+			return true;
+		}
+
+	private:
+		int m_descriptor;
+#endif
+
+		ReadableFile(const ReadableFile&)				= delete;
+		ReadableFile& operator=(const ReadableFile&)	= delete;
+	};
+
+	// Fails every request of a batch with the given error
+	void FailRequests(const std::vector<XP::FileReadRequest>& requests, const char* error, std::vector<XP::FileReadResult>& results)
+	{
+		results.clear();
+		for (const XP::FileReadRequest& request : requests)
+		{
+			XP::FileReadResult result;
+			result.request	= request;
+			result.error	= error;
+			results.push_back(std::move(result));
+		}
+	}
+}
+
+struct XP::FileIOService::SharedState
+{
+	// Bytes read beyond a request which may answer the next one, while the file is unchanged
+	struct ReadAheadEntry
+	{
+		std::string filePath;
+		FileVersion version;
+		uint64_t offset;
+		PooledBuffer buffer;
+	};
+
+	// Batch read, waiting for its handler to be called
+	struct Completion
+	{
+		FileReadID readID;
+		std::shared_ptr<BatchHandler> handler;
+		std::vector<FileReadResult> results;
+	};
+
+	SharedState() :
+		pool(BufferPool::Create(DefaultPoolCapacity)), readAheadSize(DefaultReadAheadSize), isClosed(false), mutex(), readAhead(),
+		completions(), cancelledReadIDs(), requestCount(0), diskReadCount(0), diskBytesRead(0), readAheadHitCount(0) {}
+
+	std::shared_ptr<BufferPool> pool;
+	std::atomic<size_t> readAheadSize;
+	// Set once the service is destroyed, so queued batches are skipped
+	std::atomic<bool> isClosed;
+
+	// Guards the read-ahead, completions and cancellations
+	std::mutex mutex;
+	// Most recently read first, at most one per file
+	std::deque<ReadAheadEntry> readAhead;
+	std::vector<Completion> completions;
+	// Pending batches which were cancelled
+	std::unordered_set<FileReadID> cancelledReadIDs;
+
+	std::atomic<uint64_t> requestCount;
+	std::atomic<uint64_t> diskReadCount;
+	std::atomic<uint64_t> diskBytesRead;
+	std::atomic<uint64_t> readAheadHitCount;
+};
+
+XP::FileIOService::FileIOService(std::shared_ptr<ThreadPool> threadPool) :
+	m_threadPool(threadPool), m_state(std::make_shared<SharedState>()), m_pendingReadIDs(), m_lastReadID(0), m_frameLoop()
+{
+
+}
+
+XP::FileIOService::~FileIOService()
+{
+	// Batches already being read finish, but their results are dropped
+	m_state->isClosed.store(true);
+}
+
+std::shared_ptr<XP::FileIOService> XP::FileIOService::Create(std::shared_ptr<ThreadPool> threadPool)
+{
+	if (threadPool == nullptr)
+	{
+		threadPool = ThreadPool::GetShared();
+	}
+
+	std::shared_ptr<FileIOService> fileIOService(new FileIOService(threadPool), [](FileIOService* fileIOService)
+	{
+		delete fileIOService;
+	});
+
+	// Woken by the next read once nothing is pending
+	FileIOService* rawFileIOService = fileIOService.get();
+	fileIOService->m_frameLoop = FrameLoop::Create(FlightLoopPhaseType::BeforeFlightModel, [rawFileIOService](float)
+	{
+		rawFileIOService->DispatchCompletions();
+		return !rawFileIOService->m_pendingReadIDs.empty();
+	}, false);
+
+	return fileIOService;
+}
+
+XP::FileReadID XP::FileIOService::Read(FileReadRequest request, ReadHandler handler)
+{
+	// Ensure arguments are valid
+	if (handler == nullptr)
+	{
+		throw std::invalid_argument("handler is NULL");
+	}
+
+	std::vector<FileReadRequest> requests;
+	requests.push_back(std::move(request));
+
+	return ReadBatch(std::move(requests), [handler](const std::vector<FileReadResult>& results)
+	{
+		handler(results.front());
+	});
+}
+
+XP::FileReadID XP::FileIOService::ReadBatch(std::vector<FileReadRequest> requests, BatchHandler handler)
+{
+	// Ensure arguments are valid
+	if (requests.empty())
+	{
+		throw std::invalid_argument("requests is empty");
+	}
+	if (handler == nullptr)
+	{
+		throw std::invalid_argument("handler is NULL");
+	}
+
+	FileReadID readID											= ++m_lastReadID;
+	std::shared_ptr<SharedState> state							= m_state;
+	std::shared_ptr<BatchHandler> sharedHandler					= std::make_shared<BatchHandler>(std::move(handler));
+	std::shared_ptr<std::vector<FileReadRequest>> sharedRequests	= std::make_shared<std::vector<FileReadRequest>>(std::move(requests));
+	m_threadPool->Enqueue([readID, state, sharedHandler, sharedRequests]()
+	{
+		if (state->isClosed.load())
+		{
+			return;
+		}
+
+		SharedState::Completion completion;
+		completion.readID	= readID;
+		completion.handler	= sharedHandler;
+
+		bool isCancelled;
+		{
+			std::lock_guard<std::mutex> lock(state->mutex);
+			isCancelled = state->cancelledReadIDs.count(readID) != 0;
+		}
+		if (!isCancelled)
+		{
+			try
+			{
+				ReadRequests(*state, *sharedRequests, completion.results);
+			}
+			catch (const std::exception& exception)
+			{
+				// Every read of the batch fails, so the handler is still called
+				FailRequests(*sharedRequests, exception.what(), completion.results);
+			}
+			catch (...)
+			{
+				FailRequests(*sharedRequests, "Read threw", completion.results);
+			}
+		}
+
+		// Cancelled batches complete too, so the sim thread stops waiting for them
+		std::lock_guard<std::mutex> lock(state->mutex);
+		state->completions.push_back(std::move(completion));
+	});
+
+	if (m_pendingReadIDs.empty())
+	{
+		m_frameLoop->Wake();
+	}
+	m_pendingReadIDs.insert(readID);
+
+	return readID;
+}
+
+void XP::FileIOService::Cancel(FileReadID readID)
+{
+	// Completed or unknown reads have nothing to cancel
+	if (m_pendingReadIDs.count(readID) == 0)
+	{
+		return;
+	}
+
+	std::lock_guard<std::mutex> lock(m_state->mutex);
+	m_state->cancelledReadIDs.insert(readID);
+}
+
+void XP::FileIOService::SetReadAheadSize(size_t readAheadSize)
+{
+	m_state->readAheadSize.store(readAheadSize);
+
+	if (readAheadSize == 0)
+	{
+		std::lock_guard<std::mutex> lock(m_state->mutex);
+		m_state->readAhead.clear();
+	}
+}
+
+void XP::FileIOService::SetPoolCapacity(size_t poolCapacity)
+{
+	m_state->pool->SetCapacity(poolCapacity);
+}
+
+XP::FileIOStatistics XP::FileIOService::GetStatistics() const
+{
+	FileIOStatistics statistics;
+	statistics.requestCount				= m_state->requestCount.load();
+	statistics.diskReadCount			= m_state->diskReadCount.load();
+	statistics.diskBytesRead			= m_state->diskBytesRead.load();
+	statistics.readAheadHitCount		= m_state->readAheadHitCount.load();
+	statistics.pooledBufferReuseCount	= m_state->pool->GetReuseCount();
+	statistics.pooledBytes				= m_state->pool->GetPooledBytes();
+
+	return statistics;
+}
+
+void XP::FileIOService::DispatchCompletions()
+{
+	std::vector<SharedState::Completion> completions;
+	{
+		std::lock_guard<std::mutex> lock(m_state->mutex);
+		completions.swap(m_state->completions);
+	}
+
+	for (SharedState::Completion& completion : completions)
+	{
+		m_pendingReadIDs.erase(completion.readID);
+
+		bool isCancelled;
+		{
+			std::lock_guard<std::mutex> lock(m_state->mutex);
+			isCancelled = m_state->cancelledReadIDs.erase(completion.readID) != 0;
+		}
+		if (isCancelled)
+		{
+			continue;
+		}
+
+		// One handler throwing mustn't drop the remaining completions
+		CallbackGuard::Invoke(CallbackType::FlightLoop, this, [&completion]()
+		{
+			(*completion.handler)(completion.results);
+		});
+	}
+}
+
+void XP::FileIOService::ReadRequests(SharedState& state, const std::vector<FileReadRequest>& requests, std::vector<FileReadResult>& results)
+{
+	results.resize(requests.size());
+
+	// Read in order of file and offset, so each file is opened once and read front to back
+	std::vector<size_t> order(requests.size());
+	for (size_t i = 0; i < order.size(); ++i)
+	{
+		order[i] = i;
+	}
+	std::sort(order.begin(), order.end(), [&requests](size_t left, size_t right)
+	{
+		int comparison = requests[left].filePath.compare(requests[right].filePath);
+		return comparison != 0 ? comparison < 0 : requests[left].offset < requests[right].offset;
+	});
+
+	std::unique_ptr<ReadableFile> file;
+	const std::string* filePath = nullptr;
+	for (size_t index : order)
+	{
+		const FileReadRequest& request	= requests[index];
+		FileReadResult& result			= results[index];
+		result.request					= request;
+		++state.requestCount;
+
+		// Answer from an earlier read-ahead of this file, if it holds the whole request and the file is unchanged
+		if (request.size > 0 && state.readAheadSize.load() > 0)
+		{
+			FileVersion version;
+			bool isFound = GetFileVersion(request.filePath, version);
+
+			std::lock_guard<std::mutex> lock(state.mutex);
+
+			auto entry = std::find_if(state.readAhead.begin(), state.readAhead.end(), [&request](const SharedState::ReadAheadEntry& entry)
+			{
+				return entry.filePath == request.filePath;
+			});
+			if (entry != state.readAhead.end() && !(isFound && entry->version == version))
+			{
+				state.readAhead.erase(entry);
+			}
+			else if (entry != state.readAhead.end() && request.offset >= entry->offset &&
+					 request.offset + request.size <= entry->offset + entry->buffer.GetSize())
+			{
+				result.buffer = entry->buffer.Slice(static_cast<size_t>(request.offset - entry->offset), request.size);
+				++state.readAheadHitCount;
+				continue;
+			}
+		}
+
+		if (filePath == nullptr || *filePath != request.filePath)
+		{
+			file.reset(new ReadableFile(request.filePath));
+			filePath = &request.filePath;
+		}
+		if (!file->IsOpen())
+		{
+			result.error = "Failed to open " + request.filePath;
+			continue;
+		}
+
+		// Taken before reading, so a read-ahead is never newer than its version
+		FileVersion version;
+		if (!file->GetVersion(version))
+		{
+			result.error = "Failed to get the size of " + request.filePath;
+			continue;
+		}
+
+		// Whole file reads aren't read ahead, as there's nothing left to read
+		size_t size			= request.size;
+		size_t readAheadSize	= size > 0 ? state.readAheadSize.load() : 0;
+		if (size == 0)
+		{
+			size = version.size > request.offset ? static_cast<size_t>(version.size - request.offset) : 0;
+		}
+		if (size == 0)
+		{
+			continue;
+		}
+
+		PooledBuffer buffer = state.pool->Acquire(size + readAheadSize);
+		size_t bytesRead;
+		if (!file->ReadAt(buffer.GetData(), buffer.GetSize(), request.offset, bytesRead))
+		{
+			result.error = "Failed to read " + request.filePath;
+			continue;
+		}
+		++state.diskReadCount;
+		state.diskBytesRead += bytesRead;
+
+		result.buffer = buffer.Slice(0, std::min(size, bytesRead));
+		if (bytesRead > size)
+		{
+			// Copied out, so the entry doesn't keep the whole read's buffer alive
+			SharedState::ReadAheadEntry readAheadEntry;
+			readAheadEntry.filePath	= request.filePath;
+			readAheadEntry.version	= version;
+			readAheadEntry.offset	= request.offset + size;
+			readAheadEntry.buffer	= state.pool->Acquire(bytesRead - size);
+			std::memcpy(readAheadEntry.buffer.GetData(), buffer.GetData() + size, bytesRead - size);
+
+			std::lock_guard<std::mutex> lock(state.mutex);
+
+			auto entry = std::find_if(state.readAhead.begin(), state.readAhead.end(), [&request](const SharedState::ReadAheadEntry& entry)
+			{
+				return entry.filePath == request.filePath;
+			});
+			if (entry != state.readAhead.end())
+			{
+				state.readAhead.erase(entry);
+			}
+			state.readAhead.push_front(std::move(readAheadEntry));
+			if (state.readAhead.size() > ReadAheadEntryCount)
+			{
+				state.readAhead.pop_back();
+			}
+		}
+	}
+}
@@ -0,0 +1,29 @@
+#include "XP++/Logging/LogCategory.hpp"
+
+XP::LogCategory::LogCategory(std::string name, LogLevel minimumLevel, int maxPerSecond) :
+	m_name(name), m_minimumLevel(static_cast<int>(minimumLevel)), m_maxPerSecond(maxPerSecond),
+	m_windowSecond(0), m_windowCount(0), m_rateLimitedCount(0)
+{
+
+}
+
+bool XP::LogCategory::TakeRateLimitToken(int maxPerSecond, int64_t timestamp)
+{
+	const int64_t second = timestamp / 1000000000;
+
+	// Start a new window once a second has passed, only one thread wins the reset
+	int64_t windowSecond = m_windowSecond.load(std::memory_order_relaxed);
+	if (windowSecond != second &&
+		m_windowSecond.compare_exchange_strong(windowSecond, second, std::memory_order_relaxed))
+	{
+		m_windowCount.store(0, std::memory_order_relaxed);
+	}
+
+	if (m_windowCount.fetch_add(1, std::memory_order_relaxed) < maxPerSecond)
+	{
+		return true;
+	}
+
+	m_rateLimitedCount.fetch_add(1, std::memory_order_relaxed);
+	return false;
+}
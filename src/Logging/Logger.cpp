@@ -0,0 +1,286 @@
+#include "XP++/Logging/Logger.hpp"
+
+// STL includes
+#include <atomic>
+#include <condition_variable>
+#include <cstdio>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+std::atomic<bool> XP::Logger::m_isRunning(false);
+std::atomic<int> XP::Logger::m_backPressure(static_cast<int>(XP::LogBackPressure::Drop));
+std::atomic<unsigned int> XP::Logger::m_sampleRate(8);
+std::atomic<uint64_t> XP::Logger::m_droppedCount(0);
+std::atomic<uint64_t> XP::Logger::m_sampledOutCount(0);
+
+namespace
+{
+	// Time between passes of the writer thread
+	const std::chrono::milliseconds WriteInterval(20);
+
+	// Every ring which has been logged to, guarded by the mutex
+	struct RingRegistry
+	{
+		std::mutex mutex;
+		std::vector<XP::LogRing*> rings;
+	};
+
+	RingRegistry& GetRegistry()
+	{
+		static RingRegistry registry;
+		return registry;
+	}
+
+	// The calling thread's ring, and the generation it was created in. Kept
+	// trivially destructible, as a thread_local with a destructor keeps the
+	// plug-in loaded while any thread that logged is alive (and the sim thread
+	// never exits), so X-Plane couldn't unload it on a reload
+	thread_local XP::LogRing* t_threadRing = nullptr;
+	thread_local uint32_t t_threadRingGeneration = 0;
+	// Bumped whenever Stop frees every ring, so threads don't reuse theirs
+	std::atomic<uint32_t> g_ringGeneration(1);
+
+	// Writer thread state
+	std::thread g_writerThread;
+	std::mutex g_writerMutex;
+	std::condition_variable g_writerWakeup;
+	bool g_stopRequested = false;
+	FILE* g_logFile = nullptr;
+	int64_t g_startTime = 0;
+
+	const char* GetLevelName(XP::LogLevel level)
+	{
+		switch (level)
+		{
+		case XP::LogLevel::Debug:	return "DEBUG";
+		case XP::LogLevel::Info:	return "INFO";
+		case XP::LogLevel::Warning:	return "WARNING";
+		case XP::LogLevel::Error:	return "ERROR";
+		default:					return "UNKNOWN";
+		}
+	}
+
+	// Appends a single captured argument to the output
+	void AppendArgument(std::string& output, const XP::LogRecord& record, int index)
+	{
+		const XP::LogRecord::Value& value = record.values[index];
+		char buffer[32];
+
+		switch (record.argumentTypes[index])
+		{
+		case XP::LogArgumentType::Signed:
+			std::snprintf(buffer, sizeof(buffer), "%lld", static_cast<long long>(value.signedValue));
+			output += buffer;
+			break;
+		case XP::LogArgumentType::Unsigned:
+			std::snprintf(buffer, sizeof(buffer), "%llu", static_cast<unsigned long long>(value.unsignedValue));
+			output += buffer;
+			break;
+		case XP::LogArgumentType::Double:
+			std::snprintf(buffer, sizeof(buffer), "%g", value.doubleValue);
+			output += buffer;
+			break;
+		case XP::LogArgumentType::Bool:
+			output += value.unsignedValue != 0 ? "true" : "false";
+			break;
+		case XP::LogArgumentType::Pointer:
+			std::snprintf(buffer, sizeof(buffer), "%p", value.pointerValue);
+			output += buffer;
+			break;
+		case XP::LogArgumentType::Text:
+			output.append(record.text + value.text.offset, value.text.length);
+			break;
+		}
+	}
+
+	// Formats a record as a single line of the log file
+	void AppendRecord(std::string& output, const XP::LogRecord& record)
+	{
+		char prefix[64];
+		std::snprintf(prefix, sizeof(prefix), "[%10.3f] %-7s ",
+					  static_cast<double>(record.timestamp - g_startTime) / 1e9, GetLevelName(record.level));
+		output += prefix;
+		output += record.category->GetName();
+		output += ": ";
+
+		int argumentIndex = 0;
+		for (const char* format = record.format; *format != '\0'; ++format)
+		{
+			if (format[0] == '{' && format[1] == '}' && argumentIndex < record.argumentCount)
+			{
+				AppendArgument(output, record, argumentIndex++);
+				++format;
+			}
+			else
+			{
+				output += *format;
+			}
+		}
+		output += '\n';
+	}
+
+	// Formats every pending record into a batch, freeing rings whose thread has released them
+	void CollectRecords(std::string& batch)
+	{
+		RingRegistry& registry = GetRegistry();
+		std::lock_guard<std::mutex> lock(registry.mutex);
+
+		for (auto ring = registry.rings.begin(); ring != registry.rings.end();)
+		{
+			// Check before reading, so nothing written before the thread exited is missed
+			bool isAbandoned = (*ring)->IsAbandoned();
+
+			while (const XP::LogRecord* record = (*ring)->BeginRead())
+			{
+				AppendRecord(batch, *record);
+				(*ring)->EndRead();
+			}
+
+			if (isAbandoned)
+			{
+				delete *ring;
+				ring = registry.rings.erase(ring);
+			}
+			else
+			{
+				++ring;
+			}
+		}
+	}
+
+	// Appends a line whenever more messages have been dropped or sampled out
+	void CollectLossCounts(std::string& batch, uint64_t& reportedDropped, uint64_t& reportedSampledOut)
+	{
+		uint64_t droppedCount		= XP::Logger::GetDroppedCount();
+		uint64_t sampledOutCount	= XP::Logger::GetSampledOutCount();
+		if (droppedCount == reportedDropped && sampledOutCount == reportedSampledOut)
+		{
+			return;
+		}
+
+		char line[128];
+		std::snprintf(line, sizeof(line), "XP++: %llu log messages dropped, %llu sampled out\n",
+					  static_cast<unsigned long long>(droppedCount - reportedDropped),
+					  static_cast<unsigned long long>(sampledOutCount - reportedSampledOut));
+		batch += line;
+
+		reportedDropped		= droppedCount;
+		reportedSampledOut	= sampledOutCount;
+	}
+
+	void WriterThread()
+	{
+		std::string batch;
+		uint64_t reportedDropped	= XP::Logger::GetDroppedCount();
+		uint64_t reportedSampledOut	= XP::Logger::GetSampledOutCount();
+
+		bool isStopping = false;
+		while (!isStopping)
+		{
+			{
+				std::unique_lock<std::mutex> lock(g_writerMutex);
+				g_writerWakeup.wait_for(lock, WriteInterval, []() { return g_stopRequested; });
+				isStopping = g_stopRequested;
+			}
+
+			CollectRecords(batch);
+			CollectLossCounts(batch, reportedDropped, reportedSampledOut);
+
+			if (!batch.empty())
+			{
+				std::fwrite(batch.data(), 1, batch.size(), g_logFile);
+				std::fflush(g_logFile);
+				batch.clear();
+			}
+		}
+	}
+}
+
+bool XP::Logger::Start(std::string filePath)
+{
+	if (IsRunning())
+	{
+		return true;
+	}
+
+	g_logFile = std::fopen(filePath.c_str(), "w");
+	if (g_logFile == nullptr)
+	{
+		return false;
+	}
+
+	g_startTime = std::chrono::duration_cast<std::chrono::nanoseconds>(
+		std::chrono::steady_clock::now().time_since_epoch()).count();
+	g_stopRequested = false;
+	g_writerThread	= std::thread(&WriterThread);
+
+	m_isRunning.store(true, std::memory_order_release);
+	return true;
+}
+
+void XP::Logger::Stop()
+{
+	if (!IsRunning())
+	{
+		return;
+	}
+	m_isRunning.store(false, std::memory_order_release);
+
+	// The writer makes a final pass before exiting
+	{
+		std::lock_guard<std::mutex> lock(g_writerMutex);
+		g_stopRequested = true;
+	}
+	g_writerWakeup.notify_one();
+	g_writerThread.join();
+
+	std::fclose(g_logFile);
+	g_logFile = nullptr;
+
+	// Everything has been written, so free every ring, leaving threads to create new ones if started again
+	RingRegistry& registry = GetRegistry();
+	std::lock_guard<std::mutex> lock(registry.mutex);
+	g_ringGeneration.fetch_add(1, std::memory_order_acq_rel);
+	for (LogRing* ring : registry.rings)
+	{
+		delete ring;
+	}
+	registry.rings.clear();
+}
+
+void XP::Logger::SetBackPressure(LogBackPressure policy, unsigned int sampleRate)
+{
+	m_backPressure.store(static_cast<int>(policy), std::memory_order_relaxed);
+	m_sampleRate.store(sampleRate == 0 ? 1 : sampleRate, std::memory_order_relaxed);
+}
+
+XP::LogRing* XP::Logger::GetThreadRing()
+{
+	if (t_threadRing != nullptr && t_threadRingGeneration == g_ringGeneration.load(std::memory_order_acquire))
+	{
+		return t_threadRing;
+	}
+
+	// First message from this thread since starting, only happens once per thread
+	LogRing* ring = new LogRing();
+	{
+		RingRegistry& registry = GetRegistry();
+		std::lock_guard<std::mutex> lock(registry.mutex);
+		registry.rings.push_back(ring);
+		t_threadRingGeneration = g_ringGeneration.load(std::memory_order_relaxed);
+	}
+	t_threadRing = ring;
+
+	return ring;
+}
+
+void XP::Logger::ReleaseThreadRing()
+{
+	if (t_threadRing != nullptr && t_threadRingGeneration == g_ringGeneration.load(std::memory_order_acquire))
+	{
+		// The writer frees it once everything within has been written
+		t_threadRing->Abandon();
+	}
+	t_threadRing = nullptr;
+}
@@ -5,3 +5,14 @@ XP::Message::Message(int id, void* data) :
 {
 
 }
+
+XP::XPLMMessageType XP::Message::GetType() const
+{
+	// Only X-Plane's own messages have a known type
+	if (m_id >= static_cast<int>(XPLMMessageType::PlaneCrashed) && m_id <= static_cast<int>(XPLMMessageType::ExitingVR))
+	{
+		return static_cast<XPLMMessageType>(m_id);
+	}
+
+	return XPLMMessageType::Unknown;
+}
@@ -0,0 +1,212 @@
+#include "XP++/MessageDispatcher.hpp"
+
+// STL includes
+#include <algorithm>
+#include <stdexcept>
+
+// XP++ includes
+#include "XP++/Diagnostics/CallbackGuard.hpp"
+#include "XP++/Logging/Logger.hpp"
+#include "XP++/Processing/ThreadPool.hpp"
+
+XP::MessageDispatcher::SubscriberList XP::MessageDispatcher::m_xplaneSubscribers[XPlaneMessageCount];
+std::vector<std::pair<int, XP::MessageDispatcher::SubscriberList>, XP::TaggedAllocator<std::pair<int, XP::MessageDispatcher::SubscriberList>, XP::MemoryTag::Messages>>
+	XP::MessageDispatcher::m_otherSubscribers;
+XP::MessageSubscriptionID XP::MessageDispatcher::m_lastSubscriptionID = 0;
+int XP::MessageDispatcher::m_dispatchDepth = 0;
+bool XP::MessageDispatcher::m_hasRemovedSubscribers = false;
+
+namespace
+{
+	XP::LogCategory g_messageLog("Messages");
+}
+
+XP::MessageSubscriptionID XP::MessageDispatcher::Subscribe(XPLMMessageType type, MessageHandler handler,
+														   MessageDelivery delivery, PluginID from)
+{
+	return Subscribe(static_cast<int>(type), handler, delivery, from);
+}
+
+XP::MessageSubscriptionID XP::MessageDispatcher::Subscribe(int messageID, MessageHandler handler,
+														   MessageDelivery delivery, PluginID from)
+{
+	// Ensure arguments are valid
+	if (handler == nullptr)
+	{
+		throw std::invalid_argument("handler is NULL");
+	}
+
+	Subscriber subscriber;
+	subscriber.id		= ++m_lastSubscriptionID;
+	subscriber.handler	= handler;
+	subscriber.delivery	= delivery;
+	subscriber.from		= from.GetIndex();
+
+	FindSubscribers(messageID, true)->push_back(subscriber);
+
+	return subscriber.id;
+}
+
+void XP::MessageDispatcher::Unsubscribe(MessageSubscriptionID subscriptionID)
+{
+	auto unsubscribe = [subscriptionID](SubscriberList& subscribers)
+	{
+		for (Subscriber& subscriber : subscribers)
+		{
+			if (subscriber.id == subscriptionID)
+			{
+				// Removed once no dispatch is iterating over the list
+				subscriber.handler		= nullptr;
+				m_hasRemovedSubscribers	= true;
+				return true;
+			}
+		}
+		return false;
+	};
+
+	bool isFound = false;
+	for (size_t i = 0; i < XPlaneMessageCount && !isFound; ++i)
+	{
+		isFound = unsubscribe(m_xplaneSubscribers[i]);
+	}
+	for (size_t i = 0; i < m_otherSubscribers.size() && !isFound; ++i)
+	{
+		isFound = unsubscribe(m_otherSubscribers[i].second);
+	}
+
+	RemoveUnsubscribed();
+}
+
+void XP::MessageDispatcher::Clear()
+{
+	for (SubscriberList& subscribers : m_xplaneSubscribers)
+	{
+		for (Subscriber& subscriber : subscribers)
+		{
+			subscriber.handler = nullptr;
+		}
+	}
+	for (auto& subscribers : m_otherSubscribers)
+	{
+		for (Subscriber& subscriber : subscribers.second)
+		{
+			subscriber.handler = nullptr;
+		}
+	}
+	m_hasRemovedSubscribers = true;
+
+	RemoveUnsubscribed();
+}
+
+void XP::MessageDispatcher::Dispatch(int from, int messageID, void* param)
+{
+	SubscriberList* subscribers = FindSubscribers(messageID, false);
+	if (subscribers == nullptr)
+	{
+		return;
+	}
+
+	++m_dispatchDepth;
+
+	// Handlers added while dispatching wait for the next message
+	const size_t subscriberCount = subscribers->size();
+	for (size_t i = 0; i < subscriberCount; ++i)
+	{
+		// Look the list up again, handlers may have subscribed to other messages and moved it
+		subscribers = FindSubscribers(messageID, false);
+
+		const Subscriber& subscriber = (*subscribers)[i];
+		if (subscriber.handler == nullptr || (subscriber.from >= 0 && subscriber.from != from))
+		{
+			continue;
+		}
+
+		// Copied, as the handler may subscribe and move the list it's stored within
+		MessageHandler handler = subscriber.handler;
+		if (subscriber.delivery == MessageDelivery::Deferred)
+		{
+			ThreadPool::GetShared()->Enqueue([handler, from, messageID, param]()
+			{
+				try
+				{
+					handler(PluginID(from), Message(messageID, param));
+				}
+				catch (const std::exception& exception)
+				{
+					XP_LOG_ERROR(g_messageLog, "Deferred handler of message {} threw: {}", messageID, exception.what());
+				}
+				catch (...)
+				{
+					XP_LOG_ERROR(g_messageLog, "Deferred handler of message {} threw", messageID);
+				}
+			});
+		}
+		else
+		{
+			CallbackGuard::Invoke(CallbackType::Plugin, nullptr, [&handler, from, messageID, param]()
+			{
+				handler(PluginID(from), Message(messageID, param));
+			});
+		}
+	}
+
+	--m_dispatchDepth;
+	RemoveUnsubscribed();
+}
+
+XP::MessageDispatcher::SubscriberList* XP::MessageDispatcher::FindSubscribers(int messageID, bool create)
+{
+	// X-Plane's messages are indexed directly
+	if (messageID >= FirstXPlaneMessage && messageID < FirstXPlaneMessage + XPlaneMessageCount)
+	{
+		return &m_xplaneSubscribers[messageID - FirstXPlaneMessage];
+	}
+
+	auto foundSubscribers = std::lower_bound(m_otherSubscribers.begin(), m_otherSubscribers.end(), messageID,
+											 [](const std::pair<int, SubscriberList>& subscribers, int messageID)
+	{
+		return subscribers.first < messageID;
+	});
+	if (foundSubscribers != m_otherSubscribers.end() && foundSubscribers->first == messageID)
+	{
+		return &foundSubscribers->second;
+	}
+	if (!create)
+	{
+		return nullptr;
+	}
+
+	return &m_otherSubscribers.insert(foundSubscribers, std::make_pair(messageID, SubscriberList()))->second;
+}
+
+void XP::MessageDispatcher::RemoveUnsubscribed()
+{
+	if (m_dispatchDepth > 0 || !m_hasRemovedSubscribers)
+	{
+		return;
+	}
+
+	auto isUnsubscribed = [](const Subscriber& subscriber)
+	{
+		return subscriber.handler == nullptr;
+	};
+
+	for (SubscriberList& subscribers : m_xplaneSubscribers)
+	{
+		subscribers.erase(std::remove_if(subscribers.begin(), subscribers.end(), isUnsubscribed), subscribers.end());
+	}
+	for (auto& subscribers : m_otherSubscribers)
+	{
+		subscribers.second.erase(std::remove_if(subscribers.second.begin(), subscribers.second.end(), isUnsubscribed),
+								 subscribers.second.end());
+	}
+
+	// Drop messages nobody is subscribed to any more
+	m_otherSubscribers.erase(std::remove_if(m_otherSubscribers.begin(), m_otherSubscribers.end(),
+											[](const std::pair<int, SubscriberList>& subscribers)
+	{
+		return subscribers.second.empty();
+	}), m_otherSubscribers.end());
+
+	m_hasRemovedSubscribers = false;
+}
@@ -0,0 +1,106 @@
+#include "XP++/Navigation/NavDatabase.hpp"
+
+// STL includes
+#include <memory>
+#include <vector>
+
+// XP++ includes
+#include "XP++/Exceptions/XPException.hpp"
+#include "XP++/Logging/Logger.hpp"
+#include "XP++/Plugins/StateHandoff.hpp"
+
+// X-Plane SDK includes
+#include "XPLMNavigation.h"
+
+namespace
+{
+	XP::LogCategory g_navigationLog("Navigation");
+
+	// Identifies the layout of a handed off snapshot, changed whenever NavSnapshot::Save changes
+	const char* const SnapshotFormat = "NavSnapshot v1";
+}
+
+std::shared_ptr<const XP::NavSnapshot> XP::NavDatabase::m_snapshot;
+
+std::shared_ptr<const XP::NavSnapshot> XP::NavDatabase::Load()
+{
+	std::vector<NavSnapshot::Entry> entries;
+
+	for (XPLMNavRef navRef = XPLMGetFirstNavAid(); navRef != XPLM_NAV_NOT_FOUND; navRef = XPLMGetNextNavAid(navRef))
+	{
+		XPLMNavType type	= xplm_Nav_Unknown;
+		float latitude		= 0.0f;
+		float longitude		= 0.0f;
+		float elevation		= 0.0f;
+		int frequency		= 0;
+		float heading		= 0.0f;
+		char id[32]			= "";
+		char name[256]		= "";
+
+		XPLMGetNavAidInfo(navRef, &type, &latitude, &longitude, &elevation, &frequency, &heading, id, name, nullptr);
+
+		NavSnapshot::Entry entry;
+		entry.type		= static_cast<NavAidType>(type);
+		entry.latitude	= latitude;
+		entry.longitude	= longitude;
+		entry.elevation	= elevation;
+		entry.frequency	= frequency;
+		entry.heading	= heading;
+		entry.navRef	= navRef;
+		entry.id		= id;
+		entry.name		= name;
+		entries.push_back(entry);
+	}
+
+	std::shared_ptr<const NavSnapshot> snapshot = std::make_shared<const NavSnapshot>(std::move(entries));
+	std::atomic_store(&m_snapshot, snapshot);
+
+	return snapshot;
+}
+
+bool XP::NavDatabase::Save(const std::string& filePath, uint64_t versionHash)
+{
+	std::shared_ptr<const NavSnapshot> snapshot = GetSnapshot();
+	if (snapshot == nullptr)
+	{
+		return false;
+	}
+
+	return StateHandoff::Save(filePath, StateHandoff::HashVersion(SnapshotFormat, versionHash), [&snapshot](HandoffWriter& writer)
+	{
+		snapshot->Save(writer);
+	});
+}
+
+std::shared_ptr<const XP::NavSnapshot> XP::NavDatabase::Attach(const std::string& filePath, uint64_t versionHash)
+{
+	std::shared_ptr<HandoffReader> reader = StateHandoff::Attach(filePath, StateHandoff::HashVersion(SnapshotFormat, versionHash));
+	if (reader == nullptr)
+	{
+		return nullptr;
+	}
+
+	std::shared_ptr<const NavSnapshot> snapshot;
+	try
+	{
+		snapshot = std::make_shared<const NavSnapshot>(*reader);
+	}
+	catch (const XPException& exception)
+	{
+		XP_LOG_WARNING(g_navigationLog, "Ignored navaids in {}: {}", filePath, exception.what());
+		return nullptr;
+	}
+	std::atomic_store(&m_snapshot, snapshot);
+
+	return snapshot;
+}
+
+void XP::NavDatabase::Unload()
+{
+	std::atomic_store(&m_snapshot, std::shared_ptr<const NavSnapshot>());
+}
+
+std::shared_ptr<const XP::NavSnapshot> XP::NavDatabase::GetSnapshot()
+{
+	return std::atomic_load(&m_snapshot);
+}
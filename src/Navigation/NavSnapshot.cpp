@@ -0,0 +1,448 @@
+#include "XP++/Navigation/NavSnapshot.hpp"
+
+// STL includes
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <queue>
+#include <string>
+
+// XP++ includes
+#include "XP++/Exceptions/XPException.hpp"
+
+namespace
+{
+	// Mean radius of the earth, in meters
+	const double EarthRadius = 6371008.8;
+	const double DegreesToRadians = 3.14159265358979323846 / 180.0;
+
+	// Converts a position to a unit vector
+	void ToUnitVector(double latitude, double longitude, float* outPoint)
+	{
+		double phi		= latitude * DegreesToRadians;
+		double lambda	= longitude * DegreesToRadians;
+
+		outPoint[0] = static_cast<float>(std::cos(phi) * std::cos(lambda));
+		outPoint[1] = static_cast<float>(std::cos(phi) * std::sin(lambda));
+		outPoint[2] = static_cast<float>(std::sin(phi));
+	}
+
+	// Converts a squared chord length between unit vectors to a great circle distance
+	float ChordToDistance(float chordSquared)
+	{
+		double halfChord = std::min(1.0, std::sqrt(static_cast<double>(chordSquared)) / 2.0);
+		return static_cast<float>(2.0 * std::asin(halfChord) * EarthRadius);
+	}
+
+	// Converts a great circle distance to the squared chord length between unit vectors
+	float DistanceToChord(double distance)
+	{
+		double angle = std::min(distance / EarthRadius, 3.14159265358979323846);
+		double chord = 2.0 * std::sin(angle / 2.0);
+		return static_cast<float>(chord * chord);
+	}
+
+	// Gets the slot of a single navaid type, or -1 if unknown
+	int GetTypeSlot(XP::NavAidType type)
+	{
+		int value = static_cast<int>(type);
+		for (int slot = 0; value != 0; ++slot, value >>= 1)
+		{
+			if ((value & 1) != 0)
+			{
+				return slot;
+			}
+		}
+
+		return -1;
+	}
+
+	// Views a vector's values as an array
+	template<typename T>
+	XP::HandoffArray<T> ToArray(const std::vector<T>& values)
+	{
+		XP::HandoffArray<T> array;
+		array.data = values.data();
+		array.size = values.size();
+		return array;
+	}
+
+	// Keeps the closest navaids seen, furthest on top
+	struct NearestVisitor
+	{
+		typedef std::pair<float, int> Candidate;
+
+		NearestVisitor(int count) :
+			count(static_cast<size_t>(count)), limit(std::numeric_limits<float>::infinity()) {}
+
+		void Visit(int index, float distanceSquared)
+		{
+			candidates.push(Candidate(distanceSquared, index));
+			if (candidates.size() > count)
+			{
+				candidates.pop();
+			}
+			if (candidates.size() == count)
+			{
+				limit = candidates.top().first;
+			}
+		}
+
+		size_t count;
+		float limit;
+		std::priority_queue<Candidate> candidates;
+	};
+
+	// Keeps every navaid within a fixed distance
+	struct RadiusVisitor
+	{
+		RadiusVisitor(float limit) : limit(limit) {}
+
+		void Visit(int index, float distanceSquared)
+		{
+			matches.push_back(XP::NavAidMatch{ index, distanceSquared });
+		}
+
+		float limit;
+		std::vector<XP::NavAidMatch> matches;
+	};
+}
+
+struct XP::NavSnapshot::Storage
+{
+	std::vector<NavAidType> type;
+	std::vector<float> latitude;
+	std::vector<float> longitude;
+	std::vector<float> elevation;
+	std::vector<int> frequency;
+	std::vector<float> heading;
+	std::vector<int> navRef;
+	std::vector<uint32_t> idOffset;
+	std::vector<uint32_t> nameOffset;
+	std::string text;
+	std::vector<float> pointX;
+	std::vector<float> pointY;
+	std::vector<float> pointZ;
+	std::vector<uint8_t> splitAxis;
+};
+
+XP::NavSnapshot::NavSnapshot(std::vector<Entry> entries)
+{
+	const int entryCount = static_cast<int>(entries.size());
+
+	// Unit vectors of every entry, by entry index
+	std::vector<float> points[3];
+	for (std::vector<float>& axis : points)
+	{
+		axis.resize(entryCount);
+	}
+	for (int i = 0; i < entryCount; ++i)
+	{
+		float point[3];
+		ToUnitVector(entries[i].latitude, entries[i].longitude, point);
+
+		points[0][i] = point[0];
+		points[1][i] = point[1];
+		points[2][i] = point[2];
+	}
+
+	// Group by type, dropping unknown navaids
+	std::vector<int> order;
+	order.reserve(entryCount);
+	for (int i = 0; i < entryCount; ++i)
+	{
+		if (GetTypeSlot(entries[i].type) >= 0)
+		{
+			order.push_back(i);
+		}
+	}
+	std::stable_sort(order.begin(), order.end(), [&entries](int lhs, int rhs)
+	{
+		return GetTypeSlot(entries[lhs].type) < GetTypeSlot(entries[rhs].type);
+	});
+
+	// Build a k-d tree over each type
+	std::shared_ptr<Storage> storage = std::make_shared<Storage>();
+	storage->splitAxis.resize(order.size());
+	int begin = 0;
+	for (int slot = 0; slot < TypeCount; ++slot)
+	{
+		int end = begin;
+		while (end < static_cast<int>(order.size()) && GetTypeSlot(entries[order[end]].type) == slot)
+		{
+			++end;
+		}
+
+		BuildTree(order, points, storage->splitAxis, begin, end);
+		m_typeBegin[slot]	= begin;
+		m_typeEnd[slot]		= end;
+		begin				= end;
+	}
+
+	// Store the fields in tree order
+	const size_t count = order.size();
+	storage->type.reserve(count);
+	storage->latitude.reserve(count);
+	storage->longitude.reserve(count);
+	storage->elevation.reserve(count);
+	storage->frequency.reserve(count);
+	storage->heading.reserve(count);
+	storage->navRef.reserve(count);
+	storage->idOffset.reserve(count);
+	storage->nameOffset.reserve(count);
+	storage->pointX.reserve(count);
+	storage->pointY.reserve(count);
+	storage->pointZ.reserve(count);
+
+	for (int index : order)
+	{
+		const Entry& entry = entries[index];
+
+		storage->type.push_back(entry.type);
+		storage->latitude.push_back(entry.latitude);
+		storage->longitude.push_back(entry.longitude);
+		storage->elevation.push_back(entry.elevation);
+		storage->frequency.push_back(entry.frequency);
+		storage->heading.push_back(entry.heading);
+		storage->navRef.push_back(entry.navRef);
+
+		storage->idOffset.push_back(static_cast<uint32_t>(storage->text.size()));
+		storage->text.append(entry.id).push_back('\0');
+		storage->nameOffset.push_back(static_cast<uint32_t>(storage->text.size()));
+		storage->text.append(entry.name).push_back('\0');
+
+		storage->pointX.push_back(points[0][index]);
+		storage->pointY.push_back(points[1][index]);
+		storage->pointZ.push_back(points[2][index]);
+	}
+
+	m_type			= ToArray(storage->type);
+	m_latitude		= ToArray(storage->latitude);
+	m_longitude		= ToArray(storage->longitude);
+	m_elevation		= ToArray(storage->elevation);
+	m_frequency		= ToArray(storage->frequency);
+	m_heading		= ToArray(storage->heading);
+	m_navRef		= ToArray(storage->navRef);
+	m_idOffset		= ToArray(storage->idOffset);
+	m_nameOffset	= ToArray(storage->nameOffset);
+	m_text.data		= storage->text.data();
+	m_text.size		= storage->text.size();
+	m_pointX		= ToArray(storage->pointX);
+	m_pointY		= ToArray(storage->pointY);
+	m_pointZ		= ToArray(storage->pointZ);
+	m_splitAxis		= ToArray(storage->splitAxis);
+	m_storage		= storage;
+}
+
+XP::NavSnapshot::NavSnapshot(HandoffReader& reader)
+{
+	m_type			= reader.ReadArray<NavAidType>();
+	m_latitude		= reader.ReadArray<float>();
+	m_longitude		= reader.ReadArray<float>();
+	m_elevation		= reader.ReadArray<float>();
+	m_frequency		= reader.ReadArray<int>();
+	m_heading		= reader.ReadArray<float>();
+	m_navRef		= reader.ReadArray<int>();
+	m_idOffset		= reader.ReadArray<uint32_t>();
+	m_nameOffset	= reader.ReadArray<uint32_t>();
+	m_text			= reader.ReadArray<char>();
+	m_pointX		= reader.ReadArray<float>();
+	m_pointY		= reader.ReadArray<float>();
+	m_pointZ		= reader.ReadArray<float>();
+	m_splitAxis		= reader.ReadArray<uint8_t>();
+	HandoffArray<int> typeBegin	= reader.ReadArray<int>();
+	HandoffArray<int> typeEnd	= reader.ReadArray<int>();
+	m_storage		= reader.GetMapping();
+
+	// Indices are checked once here, so queries can trust them
+	const size_t count = m_type.size;
+	if (m_latitude.size != count || m_longitude.size != count || m_elevation.size != count || m_frequency.size != count ||
+		m_heading.size != count || m_navRef.size != count || m_idOffset.size != count || m_nameOffset.size != count ||
+		m_pointX.size != count || m_pointY.size != count || m_pointZ.size != count || m_splitAxis.size != count ||
+		typeBegin.size != TypeCount || typeEnd.size != TypeCount || count > static_cast<size_t>(std::numeric_limits<int>::max()))
+	{
+		throw XPException("Handed off navaid snapshot has mismatched arrays");
+	}
+	if (count > 0 && (m_text.size == 0 || m_text[m_text.size - 1] != '\0'))
+	{
+		throw XPException("Handed off navaid snapshot has unterminated text");
+	}
+	for (size_t i = 0; i < count; ++i)
+	{
+		if (m_idOffset[i] >= m_text.size || m_nameOffset[i] >= m_text.size || m_splitAxis[i] > 2)
+		{
+			throw XPException("Handed off navaid snapshot has an invalid navaid");
+		}
+	}
+	for (int slot = 0; slot < TypeCount; ++slot)
+	{
+		if (typeBegin[slot] < 0 || typeBegin[slot] > typeEnd[slot] || typeEnd[slot] > static_cast<int>(count))
+		{
+			throw XPException("Handed off navaid snapshot has an invalid tree");
+		}
+		m_typeBegin[slot]	= typeBegin[slot];
+		m_typeEnd[slot]		= typeEnd[slot];
+	}
+}
+
+void XP::NavSnapshot::Save(HandoffWriter& writer) const
+{
+	// Written in the order the handoff constructor reads them
+	writer.WriteArray(m_type.data, m_type.size);
+	writer.WriteArray(m_latitude.data, m_latitude.size);
+	writer.WriteArray(m_longitude.data, m_longitude.size);
+	writer.WriteArray(m_elevation.data, m_elevation.size);
+	writer.WriteArray(m_frequency.data, m_frequency.size);
+	writer.WriteArray(m_heading.data, m_heading.size);
+	writer.WriteArray(m_navRef.data, m_navRef.size);
+	writer.WriteArray(m_idOffset.data, m_idOffset.size);
+	writer.WriteArray(m_nameOffset.data, m_nameOffset.size);
+	writer.WriteArray(m_text.data, m_text.size);
+	writer.WriteArray(m_pointX.data, m_pointX.size);
+	writer.WriteArray(m_pointY.data, m_pointY.size);
+	writer.WriteArray(m_pointZ.data, m_pointZ.size);
+	writer.WriteArray(m_splitAxis.data, m_splitAxis.size);
+	writer.WriteArray(m_typeBegin, TypeCount);
+	writer.WriteArray(m_typeEnd, TypeCount);
+}
+
+std::vector<XP::NavAidMatch> XP::NavSnapshot::FindNearest(double latitude, double longitude, int count, NavAidType types) const
+{
+	std::vector<NavAidMatch> matches;
+	if (count <= 0)
+	{
+		return matches;
+	}
+
+	float query[3];
+	ToUnitVector(latitude, longitude, query);
+
+	NearestVisitor visitor(count);
+	for (int slot = 0; slot < TypeCount; ++slot)
+	{
+		if ((static_cast<int>(types) & (1 << slot)) != 0)
+		{
+			VisitTree(query, m_typeBegin[slot], m_typeEnd[slot], visitor);
+		}
+	}
+
+	// Heap pops furthest first
+	matches.resize(visitor.candidates.size());
+	for (size_t i = matches.size(); i > 0; --i)
+	{
+		const NearestVisitor::Candidate& candidate = visitor.candidates.top();
+		matches[i - 1].index	= candidate.second;
+		matches[i - 1].distance	= ChordToDistance(candidate.first);
+		visitor.candidates.pop();
+	}
+
+	return matches;
+}
+
+std::vector<XP::NavAidMatch> XP::NavSnapshot::FindWithinRadius(double latitude, double longitude, double radius, NavAidType types) const
+{
+	float query[3];
+	ToUnitVector(latitude, longitude, query);
+
+	RadiusVisitor visitor(DistanceToChord(radius));
+	for (int slot = 0; slot < TypeCount; ++slot)
+	{
+		if ((static_cast<int>(types) & (1 << slot)) != 0)
+		{
+			VisitTree(query, m_typeBegin[slot], m_typeEnd[slot], visitor);
+		}
+	}
+
+	// Matches hold squared chords until sorted
+	std::sort(visitor.matches.begin(), visitor.matches.end(), [](const NavAidMatch& lhs, const NavAidMatch& rhs)
+	{
+		return lhs.distance < rhs.distance;
+	});
+	for (NavAidMatch& match : visitor.matches)
+	{
+		match.distance = ChordToDistance(match.distance);
+	}
+
+	return visitor.matches;
+}
+
+void XP::NavSnapshot::BuildTree(std::vector<int>& order, const std::vector<float>* points, std::vector<uint8_t>& splitAxis, int begin, int end)
+{
+	if (end - begin < 1)
+	{
+		return;
+	}
+
+	// Split on the axis the points are most spread along
+	int axis			= 0;
+	float widestExtent	= -1.0f;
+	for (int candidate = 0; candidate < 3; ++candidate)
+	{
+		float minimum = std::numeric_limits<float>::max();
+		float maximum = std::numeric_limits<float>::lowest();
+		for (int i = begin; i < end; ++i)
+		{
+			float value = points[candidate][order[i]];
+			minimum		= std::min(minimum, value);
+			maximum		= std::max(maximum, value);
+		}
+
+		if (maximum - minimum > widestExtent)
+		{
+			widestExtent	= maximum - minimum;
+			axis			= candidate;
+		}
+	}
+
+	int middle = begin + (end - begin) / 2;
+	const std::vector<float>& values = points[axis];
+	std::nth_element(order.begin() + begin, order.begin() + middle, order.begin() + end, [&values](int lhs, int rhs)
+	{
+		return values[lhs] < values[rhs];
+	});
+	splitAxis[middle] = static_cast<uint8_t>(axis);
+
+	BuildTree(order, points, splitAxis, begin, middle);
+	BuildTree(order, points, splitAxis, middle + 1, end);
+}
+
+template<typename Visitor>
+void XP::NavSnapshot::VisitTree(const float* query, int begin, int end, Visitor& visitor) const
+{
+	if (end - begin < 1)
+	{
+		return;
+	}
+
+	int middle				= begin + (end - begin) / 2;
+	const float point[3]	= { m_pointX[middle], m_pointY[middle], m_pointZ[middle] };
+
+	float dx				= query[0] - point[0];
+	float dy				= query[1] - point[1];
+	float dz				= query[2] - point[2];
+	float distanceSquared	= dx * dx + dy * dy + dz * dz;
+	if (distanceSquared <= visitor.limit)
+	{
+		visitor.Visit(middle, distanceSquared);
+	}
+
+	// Search the query's side of the split first, then the other side if it could be close enough
+	int axis			= m_splitAxis[middle];
+	float difference	= query[axis] - point[axis];
+	if (difference < 0.0f)
+	{
+		VisitTree(query, begin, middle, visitor);
+		if (difference * difference <= visitor.limit)
+		{
+			VisitTree(query, middle + 1, end, visitor);
+		}
+	}
+	else
+	{
+		VisitTree(query, middle + 1, end, visitor);
+		if (difference * difference <= visitor.limit)
+		{
+			VisitTree(query, begin, middle, visitor);
+		}
+	}
+}
@@ -1,4 +1,57 @@
 #include "XP++/Planes.hpp"
 
 // XP++ includes
+#include "XP++/Diagnostics/CallbackGuard.hpp"
 #include "XP++/Plugins/PluginID.hpp"
+
+// X-Plane SDK includes
+#include "XPLMPlanes.h"
+
+std::function<void()> XP::Planes::m_onAvailable;
+
+void XP::Planes::Count(int& totalAircraft, int& activeAircraft, PluginID& controller)
+{
+	XPLMPluginID controllerID = XPLM_NO_PLUGIN_ID;
+	XPLMCountAircraft(&totalAircraft, &activeAircraft, &controllerID);
+
+	controller = PluginID(controllerID);
+}
+
+bool XP::Planes::Acquire(std::function<void()> onAvailable)
+{
+	m_onAvailable = onAvailable;
+
+	return XPLMAcquirePlanes(nullptr, &Planes::PlanesAvailableCallback, nullptr) != 0;
+}
+
+void XP::Planes::Release()
+{
+	m_onAvailable = nullptr;
+
+	XPLMReleasePlanes();
+}
+
+void XP::Planes::SetActiveCount(int count)
+{
+	XPLMSetActiveAircraftCount(count);
+}
+
+void XP::Planes::DisableAI(int index)
+{
+	XPLMDisableAIForPlane(index);
+}
+
+void XP::Planes::PlanesAvailableCallback(void*)
+{
+	// Copy, as the callback may call Acquire
+	std::function<void()> onAvailable = m_onAvailable;
+	if (onAvailable == nullptr)
+	{
+		return;
+	}
+
+	CallbackGuard::Invoke(CallbackType::Plugin, nullptr, [&onAvailable]()
+	{
+		onAvailable();
+	});
+}
@@ -1 +1,12 @@
 #include "XP++/Plugins/PluginID.hpp"
+
+XP::PluginID::PluginID(int id) :
+	m_id(id)
+{
+
+}
+
+XP::PluginID::~PluginID()
+{
+
+}
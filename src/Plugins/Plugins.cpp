@@ -5,6 +5,9 @@
 #include "XP++/Message.hpp"
 #include "XP++/Plugins/PluginID.hpp"
 
+// X-Plane SDK includes
+#include "XPLMPlugin.h"
+
 int XP::Plugins::Count()
 {
 	throw NotImplementedException();
@@ -27,7 +30,7 @@ XP::PluginID XP::Plugins::FindBySignature(std::string signature)
 
 void XP::Plugins::Reload()
 {
-	throw NotImplementedException();
+	XPLMReloadPlugins();
 }
 
 void XP::Plugins::SendMessageToPlugin(PluginID& plugin, Message message, void* param)
@@ -0,0 +1,271 @@
+#include "XP++/Plugins/StateHandoff.hpp"
+
+// STL includes
+#include <cstring>
+#include <exception>
+#include <stdexcept>
+
+// XP++ includes
+#include "XP++/Logging/Logger.hpp"
+
+// Platform includes
+#if IBM
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+	XP::LogCategory g_handoffLog("Handoff");
+
+	// Identifies a state handoff file
+	const char FileMagic[4] = { 'X', 'P', 'S', 'H' };
+	// Version of the file layout
+	const uint32_t FileVersion = 1;
+
+	// Start of every state handoff file
+	struct FileHeader
+	{
+		char magic[4];
+		uint32_t fileVersion;
+		uint64_t versionHash;
+		// Number of bytes of state following the header
+		uint64_t stateSize;
+		uint64_t reserved;
+	};
+
+	// Maps a whole file read-only, returning NULL if it doesn't exist
+	std::shared_ptr<const char> MapFile(const std::string& filePath, size_t& outSize)
+	{
+		outSize = 0;
+
+#if IBM
+		HANDLE file = CreateFileA(filePath.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, nullptr,
+								  OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+		if (file == INVALID_HANDLE_VALUE)
+		{
+			return nullptr;
+		}
+
+		LARGE_INTEGER fileSize;
+		GetFileSizeEx(file, &fileSize);
+		size_t size = static_cast<size_t>(fileSize.QuadPart);
+
+		// The view keeps the file open once mapped
+		HANDLE mapping = size > 0 ? CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr) : nullptr;
+		const char* data = mapping != nullptr ? static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0)) : nullptr;
+		if (mapping != nullptr)
+		{
+			CloseHandle(mapping);
+		}
+		CloseHandle(file);
+		if (data == nullptr)
+		{
+			return nullptr;
+		}
+
+		outSize = size;
+		return std::shared_ptr<const char>(data, [](const char* data)
+		{
+			UnmapViewOfFile(data);
+		});
+#else
+		int descriptor = open(filePath.c_str(), O_RDONLY);
+		if (descriptor < 0)
+		{
+			return nullptr;
+		}
+
+		struct stat status;
+		fstat(descriptor, &status);
+		size_t size = static_cast<size_t>(status.st_size);
+
+		// The mapping keeps the file open once mapped
+		void* mapped = size > 0 ? mmap(nullptr, size, PROT_READ, MAP_PRIVATE, descriptor, 0) : MAP_FAILED;
+		close(descriptor);
+		if (mapped == MAP_FAILED)
+		{
+			return nullptr;
+		}
+
+		outSize = size;
+		return std::shared_ptr<const char>(static_cast<const char*>(mapped), [size](const char* data)
+		{
+			munmap(const_cast<char*>(data), size);
+		});
+#endif
+	}
+
+	// Replaces a file with another, as a single step
+	bool ReplaceFile(const std::string& sourcePath, const std::string& targetPath)
+	{
+#if IBM
+		return MoveFileExA(sourcePath.c_str(), targetPath.c_str(), MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+		return std::rename(sourcePath.c_str(), targetPath.c_str()) == 0;
+#endif
+	}
+}
+
+XP::HandoffWriter::HandoffWriter(FILE* file, uint64_t offset) :
+	m_file(file), m_offset(offset)
+{
+
+}
+
+void XP::HandoffWriter::Write(const void* data, size_t size, size_t alignment)
+{
+	static const char padding[64] = {};
+
+	// Offsets within the file match offsets within the page aligned mapping
+	size_t paddingSize = static_cast<size_t>((alignment - m_offset % alignment) % alignment);
+	if (paddingSize > sizeof(padding))
+	{
+		throw std::invalid_argument("alignment must be at most 64");
+	}
+
+	if (std::fwrite(padding, 1, paddingSize, m_file) != paddingSize ||
+		(size > 0 && std::fwrite(data, 1, size, m_file) != size))
+	{
+		throw std::runtime_error("Failed to write handed off state");
+	}
+
+	m_offset += paddingSize + size;
+}
+
+XP::HandoffReader::HandoffReader(std::shared_ptr<const char> mapping, size_t size, size_t offset) :
+	m_mapping(mapping), m_size(size), m_offset(offset)
+{
+
+}
+
+const void* XP::HandoffReader::Read(size_t size, size_t alignment)
+{
+	size_t offset = m_offset + (alignment - m_offset % alignment) % alignment;
+	if (offset > m_size || size > m_size - offset)
+	{
+		throw XPException("Read past the end of the handed off state");
+	}
+
+	m_offset = offset + size;
+	return m_mapping.get() + offset;
+}
+
+uint64_t XP::StateHandoff::HashVersion(const std::string& text, uint64_t hash)
+{
+	// FNV-1a
+	for (char character : text)
+	{
+		hash ^= static_cast<uint8_t>(character);
+		hash *= 1099511628211ull;
+	}
+
+	return hash;
+}
+
+bool XP::StateHandoff::Save(const std::string& filePath, uint64_t versionHash, std::function<void(HandoffWriter&)> serialize)
+{
+	// Ensure arguments are valid
+	if (serialize == nullptr)
+	{
+		throw std::invalid_argument("serialize is NULL");
+	}
+
+	// Written beside the file, then swapped in once complete
+	std::string temporaryPath = filePath + ".tmp";
+	FILE* file = std::fopen(temporaryPath.c_str(), "wb");
+	if (file == nullptr)
+	{
+		XP_LOG_ERROR(g_handoffLog, "Failed to create {}", temporaryPath);
+		return false;
+	}
+
+	FileHeader header = {};
+	std::memcpy(header.magic, FileMagic, sizeof(FileMagic));
+	header.fileVersion	= FileVersion;
+	header.versionHash	= versionHash;
+
+	bool isSaved = false;
+	try
+	{
+		// The header is rewritten with the size of the state once it's known
+		HandoffWriter writer(file, 0);
+		writer.Write(&header, sizeof(header));
+		serialize(writer);
+
+		header.stateSize = writer.GetSize() - sizeof(header);
+		isSaved = std::fseek(file, 0, SEEK_SET) == 0 && std::fwrite(&header, sizeof(header), 1, file) == 1;
+		if (!isSaved)
+		{
+			XP_LOG_ERROR(g_handoffLog, "Failed to write {}", temporaryPath);
+		}
+	}
+	catch (const std::exception& exception)
+	{
+		XP_LOG_ERROR(g_handoffLog, "Failed to save {}: {}", filePath, exception.what());
+	}
+	catch (...)
+	{
+		XP_LOG_ERROR(g_handoffLog, "Failed to save {}", filePath);
+	}
+
+	isSaved = std::fclose(file) == 0 && isSaved;
+	if (isSaved && !ReplaceFile(temporaryPath, filePath))
+	{
+		XP_LOG_ERROR(g_handoffLog, "Failed to replace {}, is it still attached?", filePath);
+		isSaved = false;
+	}
+	if (!isSaved)
+	{
+		std::remove(temporaryPath.c_str());
+		return false;
+	}
+
+	XP_LOG_INFO(g_handoffLog, "Saved {} bytes of state to {}", header.stateSize, filePath);
+	return true;
+}
+
+std::shared_ptr<XP::HandoffReader> XP::StateHandoff::Attach(const std::string& filePath, uint64_t versionHash)
+{
+	size_t size;
+	std::shared_ptr<const char> mapping = MapFile(filePath, size);
+	if (mapping == nullptr)
+	{
+		return nullptr;
+	}
+
+	FileHeader header;
+	if (size < sizeof(header))
+	{
+		XP_LOG_WARNING(g_handoffLog, "Ignored truncated state {}", filePath);
+		return nullptr;
+	}
+	std::memcpy(&header, mapping.get(), sizeof(header));
+
+	if (std::memcmp(header.magic, FileMagic, sizeof(FileMagic)) != 0 || header.fileVersion != FileVersion ||
+		header.stateSize != size - sizeof(header))
+	{
+		XP_LOG_WARNING(g_handoffLog, "Ignored invalid state {}", filePath);
+		return nullptr;
+	}
+	if (header.versionHash != versionHash)
+	{
+		XP_LOG_INFO(g_handoffLog, "Ignored state {} saved by another version", filePath);
+		return nullptr;
+	}
+
+	XP_LOG_INFO(g_handoffLog, "Attached to {} bytes of state from {}", header.stateSize, filePath);
+	return std::shared_ptr<HandoffReader>(new HandoffReader(mapping, size, sizeof(header)), [](HandoffReader* reader)
+	{
+		delete reader;
+	});
+}
+
+void XP::StateHandoff::Discard(const std::string& filePath)
+{
+	std::remove(filePath.c_str());
+}
@@ -0,0 +1,371 @@
+#include "XP++/Plugins/SubsystemRegistry.hpp"
+
+// STL includes
+#include <algorithm>
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <set>
+#include <stdexcept>
+#include <unordered_map>
+
+// XP++ includes
+#include "XP++/Logging/Logger.hpp"
+
+namespace
+{
+	XP::LogCategory g_subsystemLog("Subsystems");
+
+	// Worker subsystems which finished starting, handed back to the starting thread
+	struct StartCompletions
+	{
+		std::mutex mutex;
+		std::condition_variable finished;
+		std::deque<size_t> subsystems;
+	};
+
+	// Runs a subsystem's start, recording how long it took and whether it failed
+	void StartSubsystem(const std::function<void()>& start, XP::SubsystemTiming& timing,
+						std::chrono::steady_clock::time_point startTime)
+	{
+		std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+		timing.offset = std::chrono::duration_cast<std::chrono::microseconds>(begin - startTime);
+
+		try
+		{
+			start();
+			timing.status = XP::SubsystemStatus::Started;
+		}
+		catch (const std::exception& exception)
+		{
+			timing.status	= XP::SubsystemStatus::Failed;
+			timing.error	= exception.what();
+		}
+		catch (...)
+		{
+			timing.status	= XP::SubsystemStatus::Failed;
+			timing.error	= "Unknown exception";
+		}
+
+		timing.duration = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - begin);
+	}
+
+	// Converts microseconds to milliseconds, for logging
+	inline double ToMilliseconds(std::chrono::microseconds duration)
+	{
+		return duration.count() / 1000.0;
+	}
+}
+
+XP::SubsystemRegistry::SubsystemRegistry() :
+	m_subsystems(), m_startOrder(), m_startDuration(0)
+{
+
+}
+
+std::shared_ptr<XP::SubsystemRegistry> XP::SubsystemRegistry::Create()
+{
+	std::shared_ptr<SubsystemRegistry> registry(new SubsystemRegistry(), [](SubsystemRegistry* registry)
+	{
+		delete registry;
+	});
+
+	return registry;
+}
+
+void XP::SubsystemRegistry::Add(std::string name, std::vector<std::string> dependencies, SubsystemThread thread,
+								std::function<void()> start, std::function<void()> stop)
+{
+	// Ensure arguments are valid
+	if (start == nullptr)
+	{
+		throw std::invalid_argument("start is NULL");
+	}
+	for (const Subsystem& subsystem : m_subsystems)
+	{
+		if (subsystem.timing.name == name)
+		{
+			throw std::invalid_argument("Subsystem already added: " + name);
+		}
+	}
+
+	Subsystem subsystem;
+	subsystem.dependencyNames	= std::move(dependencies);
+	subsystem.start				= start;
+	subsystem.stop				= stop;
+	subsystem.timing.name		= std::move(name);
+	subsystem.timing.thread		= thread;
+	subsystem.timing.status		= SubsystemStatus::Pending;
+	subsystem.timing.offset		= std::chrono::microseconds(0);
+	subsystem.timing.duration	= std::chrono::microseconds(0);
+
+	m_subsystems.push_back(std::move(subsystem));
+}
+
+bool XP::SubsystemRegistry::Start(std::shared_ptr<ThreadPool> threadPool)
+{
+	if (!m_startOrder.empty())
+	{
+		throw std::logic_error("Subsystems already started");
+	}
+
+	std::vector<size_t> remainingDependencies = ResolveDependencies();
+	if (threadPool == nullptr)
+	{
+		threadPool = ThreadPool::GetShared();
+	}
+
+	for (Subsystem& subsystem : m_subsystems)
+	{
+		subsystem.timing.status		= SubsystemStatus::Pending;
+		subsystem.timing.offset		= std::chrono::microseconds(0);
+		subsystem.timing.duration	= std::chrono::microseconds(0);
+		subsystem.timing.error.clear();
+	}
+
+	std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+	std::shared_ptr<StartCompletions> completions = std::make_shared<StartCompletions>();
+	// Sim subsystems ready to start, run in the order they were added
+	std::set<size_t> readySimSubsystems;
+	size_t finishedCount = 0;
+
+	auto schedule = [&](size_t index)
+	{
+		Subsystem& subsystem = m_subsystems[index];
+		if (subsystem.timing.thread == SubsystemThread::Sim)
+		{
+			readySimSubsystems.insert(index);
+			return;
+		}
+
+		std::function<void()> start	= subsystem.start;
+		SubsystemTiming* timing		= &subsystem.timing;
+		threadPool->Enqueue([start, timing, startTime, completions, index]()
+		{
+			StartSubsystem(start, *timing, startTime);
+
+			std::lock_guard<std::mutex> lock(completions->mutex);
+			completions->subsystems.push_back(index);
+			completions->finished.notify_one();
+		});
+	};
+
+	// Releases the dependents of a finished subsystem, skipping them if it didn't start
+	std::function<void(size_t)> finish = [&](size_t index)
+	{
+		const SubsystemTiming& timing = m_subsystems[index].timing;
+		switch (timing.status)
+		{
+		case SubsystemStatus::Started:
+			m_startOrder.push_back(index);
+			XP_LOG_INFO(g_subsystemLog, "Started {} in {} ms", timing.name, ToMilliseconds(timing.duration));
+			break;
+		case SubsystemStatus::Failed:
+			XP_LOG_ERROR(g_subsystemLog, "Failed to start {}: {}", timing.name, timing.error);
+			break;
+		default:
+			XP_LOG_WARNING(g_subsystemLog, "Skipped {}, as a dependency didn't start", timing.name);
+			break;
+		}
+		++finishedCount;
+
+		for (size_t dependentIndex : m_subsystems[index].dependents)
+		{
+			SubsystemTiming& dependentTiming = m_subsystems[dependentIndex].timing;
+			if (timing.status != SubsystemStatus::Started)
+			{
+				dependentTiming.status = SubsystemStatus::Skipped;
+			}
+
+			if (--remainingDependencies[dependentIndex] == 0)
+			{
+				if (dependentTiming.status == SubsystemStatus::Skipped)
+				{
+					finish(dependentIndex);
+				}
+				else
+				{
+					schedule(dependentIndex);
+				}
+			}
+		}
+	};
+
+	for (size_t i = 0; i < m_subsystems.size(); ++i)
+	{
+		if (remainingDependencies[i] == 0)
+		{
+			schedule(i);
+		}
+	}
+
+	while (finishedCount < m_subsystems.size())
+	{
+		// Sim subsystems run while the workers carry on in the background
+		if (!readySimSubsystems.empty())
+		{
+			size_t index = *readySimSubsystems.begin();
+			readySimSubsystems.erase(readySimSubsystems.begin());
+
+			StartSubsystem(m_subsystems[index].start, m_subsystems[index].timing, startTime);
+			finish(index);
+			continue;
+		}
+
+		std::deque<size_t> finishedWorkers;
+		{
+			std::unique_lock<std::mutex> lock(completions->mutex);
+			completions->finished.wait(lock, [&completions]() { return !completions->subsystems.empty(); });
+			finishedWorkers.swap(completions->subsystems);
+		}
+		for (size_t index : finishedWorkers)
+		{
+			finish(index);
+		}
+	}
+
+	m_startDuration = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - startTime);
+	XP_LOG_INFO(g_subsystemLog, "Started {} of {} subsystems in {} ms",
+				m_startOrder.size(), m_subsystems.size(), ToMilliseconds(m_startDuration));
+
+	return m_startOrder.size() == m_subsystems.size();
+}
+
+void XP::SubsystemRegistry::Stop()
+{
+	for (auto index = m_startOrder.rbegin(); index != m_startOrder.rend(); ++index)
+	{
+		Subsystem& subsystem = m_subsystems[*index];
+		if (subsystem.stop == nullptr)
+		{
+			continue;
+		}
+
+		// One subsystem failing to stop mustn't leave the others running
+		try
+		{
+			subsystem.stop();
+		}
+		catch (const std::exception& exception)
+		{
+			XP_LOG_ERROR(g_subsystemLog, "Failed to stop {}: {}", subsystem.timing.name, exception.what());
+		}
+		catch (...)
+		{
+			XP_LOG_ERROR(g_subsystemLog, "Failed to stop {}", subsystem.timing.name);
+		}
+	}
+
+	m_startOrder.clear();
+}
+
+std::vector<XP::SubsystemTiming> XP::SubsystemRegistry::GetTimings() const
+{
+	std::vector<SubsystemTiming> timings;
+	timings.reserve(m_subsystems.size());
+	for (const Subsystem& subsystem : m_subsystems)
+	{
+		timings.push_back(subsystem.timing);
+	}
+
+	return timings;
+}
+
+std::string XP::SubsystemRegistry::GetReport() const
+{
+	// Subsystems which never ran are listed last
+	std::vector<SubsystemTiming> timings = GetTimings();
+	std::stable_sort(timings.begin(), timings.end(), [](const SubsystemTiming& left, const SubsystemTiming& right)
+	{
+		bool isLeftRun	= left.status == SubsystemStatus::Started || left.status == SubsystemStatus::Failed;
+		bool isRightRun	= right.status == SubsystemStatus::Started || right.status == SubsystemStatus::Failed;
+		if (isLeftRun != isRightRun)
+		{
+			return isLeftRun;
+		}
+		return left.offset < right.offset;
+	});
+
+	static const char* statusNames[] = { "Pending", "Started", "Failed", "Skipped" };
+
+	std::string report;
+	char line[256];
+	for (const SubsystemTiming& timing : timings)
+	{
+		std::snprintf(line, sizeof(line), "%-32s %-6s %-7s +%9.1f ms %9.1f ms",
+					  timing.name.c_str(), timing.thread == SubsystemThread::Sim ? "Sim" : "Worker",
+					  statusNames[static_cast<int>(timing.status)],
+					  ToMilliseconds(timing.offset), ToMilliseconds(timing.duration));
+		report += line;
+		if (!timing.error.empty())
+		{
+			report += " " + timing.error;
+		}
+		report += "\n";
+	}
+	std::snprintf(line, sizeof(line), "Total %9.1f ms\n", ToMilliseconds(m_startDuration));
+	report += line;
+
+	return report;
+}
+
+std::vector<size_t> XP::SubsystemRegistry::ResolveDependencies()
+{
+	std::unordered_map<std::string, size_t> indices;
+	for (size_t i = 0; i < m_subsystems.size(); ++i)
+	{
+		indices[m_subsystems[i].timing.name] = i;
+		m_subsystems[i].dependents.clear();
+	}
+
+	std::vector<size_t> dependencyCounts(m_subsystems.size(), 0);
+	for (size_t i = 0; i < m_subsystems.size(); ++i)
+	{
+		for (const std::string& dependencyName : m_subsystems[i].dependencyNames)
+		{
+			auto dependency = indices.find(dependencyName);
+			if (dependency == indices.end())
+			{
+				throw std::invalid_argument(m_subsystems[i].timing.name + " depends on unknown subsystem " + dependencyName);
+			}
+
+			m_subsystems[dependency->second].dependents.push_back(i);
+			++dependencyCounts[i];
+		}
+	}
+
+	// Every subsystem is reachable by removing those without dependencies, unless there's a cycle
+	std::vector<size_t> remainingCounts = dependencyCounts;
+	std::vector<size_t> ready;
+	for (size_t i = 0; i < m_subsystems.size(); ++i)
+	{
+		if (remainingCounts[i] == 0)
+		{
+			ready.push_back(i);
+		}
+	}
+
+	size_t orderedCount = 0;
+	while (!ready.empty())
+	{
+		size_t index = ready.back();
+		ready.pop_back();
+		++orderedCount;
+
+		for (size_t dependentIndex : m_subsystems[index].dependents)
+		{
+			if (--remainingCounts[dependentIndex] == 0)
+			{
+				ready.push_back(dependentIndex);
+			}
+		}
+	}
+	if (orderedCount != m_subsystems.size())
+	{
+		throw std::invalid_argument("Subsystem dependencies form a cycle");
+	}
+
+	return dependencyCounts;
+}
@@ -1,13 +1,14 @@
 #include "XP++/Processing/FlightLoop.hpp"
 
 // XP++ includes
+#include "XP++/Diagnostics/CallbackGuard.hpp"
 #include "XP++/Exceptions/NotImplementedException.hpp"
 
 // X-Plane SDK includes
 #include "XPLMProcessing.h"
 
 XP::FlightLoop::FlightLoop(void* id, std::function<float(float, float, int)> callback) :
-	m_id(id), m_callback(callback)
+	m_id(id), m_callback(callback), m_lastInterval(0.0f)
 {
 	
 }
@@ -23,7 +24,7 @@ std::shared_ptr<XP::FlightLoop> XP::FlightLoop::CreateFlightLoop(FlightLoopPhase
 	std::shared_ptr<FlightLoop> flightLoop(new FlightLoop(nullptr, callback), [](FlightLoop* flightLoop)
 	{
 		delete flightLoop;
-	});
+	}, TaggedAllocator<FlightLoop, MemoryTag::FlightLoops>());
 
 	// Create FlightLoop X-Plane structure
 	XPLMCreateFlightLoop_t flightLoopOptions;
@@ -45,7 +46,7 @@ std::shared_ptr<XP::FlightLoop> XP::FlightLoop::CreateFlightLoop(FlightLoopPhase
 	}
 	// Set refcon and callback function
 	flightLoopOptions.refcon		= flightLoop.get();
-	flightLoopOptions.callbackFunc	= callback.target;
+	flightLoopOptions.callbackFunc	= &FlightLoop::FlightLoopCallback;
 
 	// Create X-Plane flight loop
 	flightLoop->m_id = XPLMCreateFlightLoop(&flightLoopOptions);
@@ -55,10 +56,28 @@ std::shared_ptr<XP::FlightLoop> XP::FlightLoop::CreateFlightLoop(FlightLoopPhase
 
 void XP::FlightLoop::Schedule(float interval, int relativeToNow)
 {
+	m_lastInterval = interval;
 	XPLMScheduleFlightLoop(m_id, interval, relativeToNow);
 }
 
 void XP::FlightLoop::SetCallbackInterval(float interval, int relativeToNow)
 {
-	XPLMSetFlightLoopCallbackInterval(m_callback.target, interval, relativeToNow, this);
+	m_lastInterval = interval;
+	XPLMScheduleFlightLoop(m_id, interval, relativeToNow);
+}
+
+float XP::FlightLoop::FlightLoopCallback(float inElapsedSinceLastCall,
+										 float inElapsedTimeSinceLastFlightLoop,
+										 int inCounter,
+										 void* inRefcon)
+{
+	FlightLoop* flightLoop = static_cast<FlightLoop*>(inRefcon);
+
+	// Keep the previous schedule if the callback throws
+	flightLoop->m_lastInterval = CallbackGuard::Invoke(CallbackType::FlightLoop, flightLoop, flightLoop->m_lastInterval, [&]()
+	{
+		return flightLoop->m_callback(inElapsedSinceLastCall, inElapsedTimeSinceLastFlightLoop, inCounter);
+	});
+
+	return flightLoop->m_lastInterval;
 }
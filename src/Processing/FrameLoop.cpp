@@ -0,0 +1,41 @@
+#include "XP++/Processing/FrameLoop.hpp"
+
+// STL includes
+#include <stdexcept>
+
+XP::FrameLoop::FrameLoop() :
+	m_flightLoop()
+{
+
+}
+
+std::shared_ptr<XP::FrameLoop> XP::FrameLoop::Create(FlightLoopPhaseType phase, FrameCallback callback, bool isAwake)
+{
+	// Ensure arguments are valid
+	if (callback == nullptr)
+	{
+		throw std::invalid_argument("callback is NULL");
+	}
+
+	std::shared_ptr<FrameLoop> frameLoop(new FrameLoop(), [](FrameLoop* frameLoop)
+	{
+		delete frameLoop;
+	});
+
+	// Every frame while the callback has more to do, otherwise paused until woken
+	frameLoop->m_flightLoop = FlightLoop::CreateFlightLoop(phase, [callback](float, float elapsedSinceLastFrame, int)
+	{
+		return callback(elapsedSinceLastFrame) ? -1.0f : 0.0f;
+	});
+	if (isAwake)
+	{
+		frameLoop->Wake();
+	}
+
+	return frameLoop;
+}
+
+void XP::FrameLoop::Wake()
+{
+	m_flightLoop->Schedule(-1.0f, 1);
+}
@@ -0,0 +1,279 @@
+#include "XP++/Processing/FrameScheduler.hpp"
+
+// STL includes
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+
+// XP++ includes
+#include "XP++/Diagnostics/CallbackGuard.hpp"
+#include "XP++/Processing/FrameLoop.hpp"
+
+namespace
+{
+	// Cost assumed of every job on top of its measured time, so unmeasured jobs are still spread
+	const double MinimumJobCost = 10.0e-6;
+	// Weight of the latest measurement within smoothed times
+	const double SmoothingFactor = 0.1;
+	// Seconds between converting job rates into frames
+	const float RateCheckInterval = 1.0f;
+
+	// Greatest common divisor of two frame intervals
+	int GreatestCommonDivisor(int a, int b)
+	{
+		while (b != 0)
+		{
+			int remainder = a % b;
+			a = b;
+			b = remainder;
+		}
+
+		return a;
+	}
+}
+
+XP::FrameScheduler::FrameScheduler() :
+	m_jobs(), m_lastJobID(0), m_frameNumber(0), m_frameTime(1.0 / 60.0),
+	m_timeSinceRateCheck(0.0f), m_isRunning(false), m_frameLoads(), m_frameLoop()
+{
+
+}
+
+std::shared_ptr<XP::FrameScheduler> XP::FrameScheduler::Create()
+{
+	std::shared_ptr<FrameScheduler> scheduler(new FrameScheduler(), [](FrameScheduler* scheduler)
+	{
+		delete scheduler;
+	});
+
+	FrameScheduler* rawScheduler = scheduler.get();
+	scheduler->m_frameLoop = FrameLoop::Create(FlightLoopPhaseType::BeforeFlightModel, [rawScheduler](float elapsedSinceLastFrame)
+	{
+		rawScheduler->RunFrame(elapsedSinceLastFrame);
+		return true;
+	});
+
+	return scheduler;
+}
+
+XP::ScheduledJobID XP::FrameScheduler::AddEveryFrames(int frameInterval, Job job)
+{
+	// Ensure arguments are valid
+	if (frameInterval < 1)
+	{
+		throw std::invalid_argument("frameInterval must be at least 1");
+	}
+
+	return Add(0.0f, frameInterval, job);
+}
+
+XP::ScheduledJobID XP::FrameScheduler::AddAtRate(float hertz, Job job)
+{
+	// Ensure arguments are valid
+	if (!(hertz > 0.0f))
+	{
+		throw std::invalid_argument("hertz must be greater than 0");
+	}
+
+	return Add(hertz, ToFrameInterval(hertz), job);
+}
+
+void XP::FrameScheduler::Remove(ScheduledJobID jobID)
+{
+	for (ScheduledJob& job : m_jobs)
+	{
+		if (job.id == jobID)
+		{
+			job.isRemoved = true;
+		}
+	}
+
+	// Jobs removed while running a frame are erased once it's finished
+	if (!m_isRunning)
+	{
+		Rebalance();
+	}
+}
+
+void XP::FrameScheduler::Rebalance()
+{
+	// Jobs are only erased between frames, as a frame walks the list by index
+	if (!m_isRunning)
+	{
+		m_jobs.erase(std::remove_if(m_jobs.begin(), m_jobs.end(), [](const ScheduledJob& job)
+		{
+			return job.isRemoved;
+		}), m_jobs.end());
+	}
+
+	// Placing the most expensive jobs first keeps them furthest apart
+	std::vector<size_t> order(m_jobs.size());
+	std::iota(order.begin(), order.end(), 0);
+	std::stable_sort(order.begin(), order.end(), [this](size_t left, size_t right)
+	{
+		return m_jobs[left].cost > m_jobs[right].cost;
+	});
+
+	for (ScheduledJob& job : m_jobs)
+	{
+		job.phase = -1;
+	}
+	for (size_t index : order)
+	{
+		ChoosePhase(index);
+	}
+}
+
+std::vector<float> XP::FrameScheduler::GetFrameLoads() const
+{
+	std::vector<float> frameLoads;
+	frameLoads.reserve(HistorySize);
+
+	uint64_t frameCount = std::min<uint64_t>(m_frameNumber, HistorySize);
+	for (uint64_t frame = m_frameNumber - frameCount; frame < m_frameNumber; ++frame)
+	{
+		frameLoads.push_back(m_frameLoads[frame % HistorySize] * 1000.0f);
+	}
+
+	return frameLoads;
+}
+
+XP::ScheduledJobID XP::FrameScheduler::Add(float hertz, int frameInterval, Job job)
+{
+	// Ensure arguments are valid
+	if (job == nullptr)
+	{
+		throw std::invalid_argument("job is NULL");
+	}
+
+	ScheduledJob scheduledJob;
+	scheduledJob.id				= ++m_lastJobID;
+	scheduledJob.job			= std::make_shared<Job>(job);
+	scheduledJob.hertz			= hertz;
+	scheduledJob.frameInterval	= frameInterval;
+	scheduledJob.phase			= -1;
+	scheduledJob.cost			= 0.0;
+	scheduledJob.lastRunTime	= std::chrono::steady_clock::now();
+	scheduledJob.isRemoved		= false;
+
+	m_jobs.push_back(scheduledJob);
+	ChoosePhase(m_jobs.size() - 1);
+
+	return scheduledJob.id;
+}
+
+void XP::FrameScheduler::ChoosePhase(size_t index)
+{
+	ScheduledJob& job = m_jobs[index];
+
+	// Two jobs collide once every lcm(intervals) frames if their phases match modulo gcd(intervals),
+	// so the expected time spent colliding with each placed job can be found for every phase
+	int bestPhase		= 0;
+	double bestCost		= std::numeric_limits<double>::max();
+	for (int phase = 0; phase < job.frameInterval; ++phase)
+	{
+		double cost = 0.0;
+		for (const ScheduledJob& other : m_jobs)
+		{
+			if (&other == &job || other.isRemoved || other.phase < 0)
+			{
+				continue;
+			}
+
+			int divisor = GreatestCommonDivisor(job.frameInterval, other.frameInterval);
+			if ((phase - other.phase) % divisor == 0)
+			{
+				double leastCommonMultiple = static_cast<double>(job.frameInterval / divisor) * other.frameInterval;
+				cost += (other.cost + MinimumJobCost) / leastCommonMultiple;
+			}
+		}
+
+		if (cost < bestCost)
+		{
+			bestCost	= cost;
+			bestPhase	= phase;
+		}
+	}
+
+	job.phase = bestPhase;
+}
+
+int XP::FrameScheduler::ToFrameInterval(float hertz) const
+{
+	double frameInterval = std::floor(1.0 / (hertz * m_frameTime) + 0.5);
+	return static_cast<int>(std::max(frameInterval, 1.0));
+}
+
+void XP::FrameScheduler::RunFrame(float frameDelta)
+{
+	if (frameDelta > 0.0f)
+	{
+		m_frameTime += (frameDelta - m_frameTime) * SmoothingFactor;
+	}
+
+	// Rates become a different number of frames as the frame rate changes
+	m_timeSinceRateCheck += frameDelta;
+	if (m_timeSinceRateCheck >= RateCheckInterval)
+	{
+		m_timeSinceRateCheck = 0.0f;
+
+		bool isChanged = false;
+		for (ScheduledJob& job : m_jobs)
+		{
+			int frameInterval = job.hertz > 0.0f ? ToFrameInterval(job.hertz) : job.frameInterval;
+			isChanged			= isChanged || frameInterval != job.frameInterval;
+			job.frameInterval	= frameInterval;
+		}
+		if (isChanged)
+		{
+			Rebalance();
+		}
+	}
+
+	m_isRunning = true;
+
+	float frameLoad = 0.0f;
+	// Jobs added while running wait for the next frame
+	const size_t jobCount = m_jobs.size();
+	for (size_t i = 0; i < jobCount; ++i)
+	{
+		ScheduledJob& job = m_jobs[i];
+		if (job.isRemoved || m_frameNumber % job.frameInterval != static_cast<uint64_t>(job.phase))
+		{
+			continue;
+		}
+
+		std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+		float elapsedSinceLastRun	= std::chrono::duration<float>(begin - job.lastRunTime).count();
+		std::shared_ptr<Job> run	= job.job;
+
+		CallbackGuard::Invoke(CallbackType::FlightLoop, this, [&run, elapsedSinceLastRun]()
+		{
+			(*run)(elapsedSinceLastRun);
+		});
+
+		// Looked up again, as the job may have added jobs and moved the list
+		std::chrono::steady_clock::time_point end	= std::chrono::steady_clock::now();
+		double duration								= std::chrono::duration<double>(end - begin).count();
+		ScheduledJob& ranJob						= m_jobs[i];
+		ranJob.cost									= ranJob.cost == 0.0 ? duration : ranJob.cost + (duration - ranJob.cost) * SmoothingFactor;
+		ranJob.lastRunTime							= begin;
+		frameLoad									+= static_cast<float>(duration);
+	}
+
+	m_isRunning = false;
+
+	bool hasRemovedJobs = std::any_of(m_jobs.begin(), m_jobs.end(), [](const ScheduledJob& job)
+	{
+		return job.isRemoved;
+	});
+	if (hasRemovedJobs)
+	{
+		Rebalance();
+	}
+
+	m_frameLoads[m_frameNumber % HistorySize] = frameLoad;
+	++m_frameNumber;
+}
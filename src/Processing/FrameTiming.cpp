@@ -0,0 +1,118 @@
+#include "XP++/Processing/FrameTiming.hpp"
+
+// STL includes
+#include <algorithm>
+#include <stdexcept>
+
+// XP++ includes
+#include "XP++/Processing/FrameLoop.hpp"
+
+// X-Plane SDK includes
+#include "XPLMProcessing.h"
+
+double XP::FrameTiming::m_elapsedTime = 0.0;
+float XP::FrameTiming::m_frameDelta = 0.0f;
+std::atomic<int> XP::FrameTiming::m_cycleNumber(0);
+std::chrono::steady_clock::time_point XP::FrameTiming::m_frameTime;
+XP::FrameStatistics XP::FrameTiming::m_statistics = {};
+std::shared_ptr<XP::FrameLoop> XP::FrameTiming::m_sampleLoop;
+
+namespace
+{
+	// Rolling window of the most recent frame times
+	struct FrameWindow
+	{
+		float frameTimes[XP::FrameTiming::WindowSize];
+		bool isJank[XP::FrameTiming::WindowSize];
+		int count;
+		int next;
+		double sum;
+		int jankCount;
+	};
+
+	FrameWindow g_window = {};
+	// Frames longer than this multiple of the mean are janks
+	float g_jankMultiple = 2.0f;
+}
+
+void XP::FrameTiming::Start()
+{
+	if (IsRunning())
+	{
+		return;
+	}
+
+	// Seed from X-Plane, then accumulate from here on
+	m_elapsedTime	= XPLMGetElapsedTime();
+	m_frameDelta	= 0.0f;
+	m_cycleNumber.store(XPLMGetCycleNumber(), std::memory_order_relaxed);
+	m_frameTime		= std::chrono::steady_clock::now();
+	m_statistics	= FrameStatistics();
+	g_window		= FrameWindow();
+
+	m_sampleLoop = FrameLoop::Create(FlightLoopPhaseType::BeforeFlightModel, [](float elapsedSinceLastFrame)
+	{
+		Sample(elapsedSinceLastFrame);
+		return true;
+	});
+}
+
+void XP::FrameTiming::Stop()
+{
+	m_sampleLoop.reset();
+}
+
+int XP::FrameTiming::GetCurrentCycleNumber()
+{
+	return IsRunning() ? GetCycleNumber() : XPLMGetCycleNumber();
+}
+
+void XP::FrameTiming::SetJankThreshold(float meanMultiple)
+{
+	// Ensure arguments are valid
+	if (meanMultiple <= 1.0f)
+	{
+		throw std::invalid_argument("meanMultiple must be greater than 1");
+	}
+
+	g_jankMultiple = meanMultiple;
+}
+
+void XP::FrameTiming::Sample(float frameDelta)
+{
+	m_elapsedTime	+= frameDelta;
+	m_frameDelta	= frameDelta;
+	m_cycleNumber.store(XPLMGetCycleNumber(), std::memory_order_relaxed);
+	m_frameTime		= std::chrono::steady_clock::now();
+
+	// Evict the oldest frame once the window is full
+	FrameWindow& window = g_window;
+	if (window.count == WindowSize)
+	{
+		window.sum			-= window.frameTimes[window.next];
+		window.jankCount	-= window.isJank[window.next] ? 1 : 0;
+		--window.count;
+	}
+
+	// Janks are judged against the mean of the frames before them
+	bool isJank = window.count > 0 && frameDelta > g_jankMultiple * static_cast<float>(window.sum / window.count);
+
+	window.frameTimes[window.next]	= frameDelta;
+	window.isJank[window.next]		= isJank;
+	window.next						= (window.next + 1) % WindowSize;
+	window.sum						+= frameDelta;
+	window.jankCount				+= isJank ? 1 : 0;
+	++window.count;
+
+	// Percentile needs a partial sort, done on a copy to keep the window in order
+	float sorted[WindowSize];
+	std::copy(window.frameTimes, window.frameTimes + window.count, sorted);
+	int percentileIndex = (window.count * 95 + 99) / 100 - 1;
+	std::nth_element(sorted, sorted + percentileIndex, sorted + window.count);
+
+	m_statistics.sampleCount	= window.count;
+	m_statistics.mean			= static_cast<float>(window.sum / window.count);
+	m_statistics.percentile95	= sorted[percentileIndex];
+	m_statistics.maximum		= *std::max_element(sorted + percentileIndex, sorted + window.count);
+	m_statistics.jankCount		= window.jankCount;
+}
@@ -0,0 +1,238 @@
+#include "XP++/Processing/LoadShedder.hpp"
+
+// STL includes
+#include <algorithm>
+#include <stdexcept>
+
+// XP++ includes
+#include "XP++/Diagnostics/CallbackGuard.hpp"
+#include "XP++/Logging/Logger.hpp"
+#include "XP++/Processing/FrameLoop.hpp"
+#include "XP++/Processing/FrameTiming.hpp"
+
+namespace
+{
+	XP::LogCategory g_loadSheddingLog("LoadShedding");
+
+	inline double ToMilliseconds(float seconds)
+	{
+		return seconds * 1000.0;
+	}
+}
+
+XP::LoadShedder::LoadShedder(float targetFrameTime, int qualityLevels) :
+	m_tasks(), m_lastTaskID(0), m_quality(qualityLevels - 1), m_qualityLevels(qualityLevels),
+	m_targetFrameTime(targetFrameTime), m_degradeRatio(1.05f), m_restoreRatio(0.8f), m_degradeDelay(0.5f),
+	m_restoreDelay(5.0f), m_pressureTime(0.0f), m_headroomTime(0.0f), m_framesSinceChange(0), m_decisions(),
+	m_frameLoop()
+{
+
+}
+
+std::shared_ptr<XP::LoadShedder> XP::LoadShedder::Create(float targetFrameTime, int qualityLevels)
+{
+	// Ensure arguments are valid
+	if (!(targetFrameTime > 0.0f))
+	{
+		throw std::invalid_argument("targetFrameTime must be greater than 0");
+	}
+	if (qualityLevels < 2)
+	{
+		throw std::invalid_argument("qualityLevels must be at least 2");
+	}
+
+	std::shared_ptr<LoadShedder> loadShedder(new LoadShedder(targetFrameTime, qualityLevels), [](LoadShedder* loadShedder)
+	{
+		delete loadShedder;
+	});
+
+	FrameTiming::Start();
+
+	LoadShedder* rawLoadShedder = loadShedder.get();
+	loadShedder->m_frameLoop = FrameLoop::Create(FlightLoopPhaseType::AfterFlightModel, [rawLoadShedder](float elapsedSinceLastFrame)
+	{
+		rawLoadShedder->Update(elapsedSinceLastFrame);
+		return true;
+	});
+
+	return loadShedder;
+}
+
+XP::SheddableTaskID XP::LoadShedder::AddTask(std::string name, QualityHandler handler)
+{
+	// Ensure arguments are valid
+	if (handler == nullptr)
+	{
+		throw std::invalid_argument("handler is NULL");
+	}
+
+	SheddableTask task;
+	task.id			= ++m_lastTaskID;
+	task.name		= name;
+	task.handler	= std::make_shared<QualityHandler>(handler);
+
+	m_tasks.push_back(task);
+	Notify(task);
+
+	return task.id;
+}
+
+void XP::LoadShedder::RemoveTask(SheddableTaskID taskID)
+{
+	m_tasks.erase(std::remove_if(m_tasks.begin(), m_tasks.end(), [taskID](const SheddableTask& task)
+	{
+		return task.id == taskID;
+	}), m_tasks.end());
+}
+
+void XP::LoadShedder::SetTargetFrameTime(float targetFrameTime)
+{
+	// Ensure arguments are valid
+	if (!(targetFrameTime > 0.0f))
+	{
+		throw std::invalid_argument("targetFrameTime must be greater than 0");
+	}
+
+	m_targetFrameTime = targetFrameTime;
+}
+
+void XP::LoadShedder::SetThresholds(float degradeRatio, float restoreRatio)
+{
+	// Ensure arguments are valid
+	if (!(restoreRatio > 0.0f))
+	{
+		throw std::invalid_argument("restoreRatio must be greater than 0");
+	}
+	if (!(degradeRatio > restoreRatio))
+	{
+		throw std::invalid_argument("degradeRatio must be greater than restoreRatio");
+	}
+
+	m_degradeRatio	= degradeRatio;
+	m_restoreRatio	= restoreRatio;
+}
+
+void XP::LoadShedder::SetDelays(float degradeDelay, float restoreDelay)
+{
+	// Ensure arguments are valid
+	if (!(degradeDelay >= 0.0f) || !(restoreDelay >= 0.0f))
+	{
+		throw std::invalid_argument("Delays must not be negative");
+	}
+
+	m_degradeDelay	= degradeDelay;
+	m_restoreDelay	= restoreDelay;
+}
+
+std::vector<XP::LoadSheddingDecision> XP::LoadShedder::GetDecisions() const
+{
+	return std::vector<LoadSheddingDecision>(m_decisions.begin(), m_decisions.end());
+}
+
+void XP::LoadShedder::Update(float frameDelta)
+{
+	// Statistics stop updating if someone else stopped the timing
+	if (!FrameTiming::IsRunning())
+	{
+		return;
+	}
+
+	const FrameStatistics& statistics = FrameTiming::GetStatistics();
+	float frameTime = statistics.percentile95;
+
+	// The window still holds frames from before the last change until it refills
+	if (m_framesSinceChange < FrameTiming::WindowSize)
+	{
+		if (++m_framesSinceChange == FrameTiming::WindowSize && !m_decisions.empty())
+		{
+			LoadSheddingDecision& decision	= m_decisions.back();
+			decision.frameTimeAfter			= frameTime;
+			XP_LOG_INFO(g_loadSheddingLog, "Quality {} -> {} took the 95th percentile frame time from {} ms to {} ms",
+						decision.fromQuality, decision.toQuality, ToMilliseconds(decision.frameTimeBefore),
+						ToMilliseconds(decision.frameTimeAfter));
+		}
+
+		return;
+	}
+	if (statistics.sampleCount < FrameTiming::WindowSize)
+	{
+		return;
+	}
+
+	// Frames between the thresholds reset both timers, so the quality only changes on a sustained trend
+	if (frameTime > m_targetFrameTime * m_degradeRatio)
+	{
+		m_pressureTime += frameDelta;
+		m_headroomTime = 0.0f;
+	}
+	else if (frameTime < m_targetFrameTime * m_restoreRatio)
+	{
+		m_headroomTime += frameDelta;
+		m_pressureTime = 0.0f;
+	}
+	else
+	{
+		m_pressureTime = 0.0f;
+		m_headroomTime = 0.0f;
+	}
+
+	if (m_pressureTime >= m_degradeDelay && m_quality > 0)
+	{
+		XP_LOG_WARNING(g_loadSheddingLog, "Lowering quality to {}, as the 95th percentile frame time is {} ms (target {} ms)",
+					   m_quality - 1, ToMilliseconds(frameTime), ToMilliseconds(m_targetFrameTime));
+		SetQuality(m_quality - 1, frameTime);
+	}
+	else if (m_headroomTime >= m_restoreDelay && m_quality < m_qualityLevels - 1)
+	{
+		XP_LOG_INFO(g_loadSheddingLog, "Raising quality to {}, as the 95th percentile frame time is {} ms (target {} ms)",
+					m_quality + 1, ToMilliseconds(frameTime), ToMilliseconds(m_targetFrameTime));
+		SetQuality(m_quality + 1, frameTime);
+	}
+}
+
+void XP::LoadShedder::SetQuality(int quality, float frameTime)
+{
+	LoadSheddingDecision decision;
+	decision.time				= FrameTiming::GetElapsedTime();
+	decision.fromQuality		= m_quality;
+	decision.toQuality			= quality;
+	decision.frameTimeBefore	= frameTime;
+	decision.frameTimeAfter		= -1.0f;
+
+	m_decisions.push_back(decision);
+	if (m_decisions.size() > static_cast<size_t>(HistorySize))
+	{
+		m_decisions.pop_front();
+	}
+
+	m_quality			= quality;
+	m_pressureTime		= 0.0f;
+	m_headroomTime		= 0.0f;
+	m_framesSinceChange	= 0;
+
+	// Handlers may add or remove tasks, so walk a copy, skipping tasks removed along the way
+	std::vector<SheddableTask> tasks = m_tasks;
+	for (const SheddableTask& task : tasks)
+	{
+		bool isRegistered = std::any_of(m_tasks.begin(), m_tasks.end(), [&task](const SheddableTask& registeredTask)
+		{
+			return registeredTask.id == task.id;
+		});
+		if (isRegistered)
+		{
+			Notify(task);
+		}
+	}
+}
+
+void XP::LoadShedder::Notify(const SheddableTask& task)
+{
+	std::shared_ptr<QualityHandler> handler = task.handler;
+	int quality = m_quality;
+
+	CallbackGuard::Invoke(CallbackType::FlightLoop, this, [&handler, quality]()
+	{
+		(*handler)(quality);
+	});
+	XP_LOG_DEBUG(g_loadSheddingLog, "{} set to quality {}", task.name, quality);
+}
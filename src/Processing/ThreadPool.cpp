@@ -0,0 +1,214 @@
+#include "XP++/Processing/ThreadPool.hpp"
+
+// STL includes
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <stdexcept>
+
+// XP++ includes
+#include "XP++/Logging/Logger.hpp"
+
+std::shared_ptr<XP::ThreadPool> XP::ThreadPool::m_shared;
+std::mutex XP::ThreadPool::m_sharedMutex;
+
+namespace
+{
+	XP::LogCategory g_threadPoolLog("ThreadPool");
+
+	// State shared between the threads running a ParallelFor
+	struct ParallelForState
+	{
+		ParallelForState(int begin, int end, int grainSize, std::function<void(int, int)> body) :
+			begin(begin), end(end), grainSize(grainSize), chunkCount((end - begin + grainSize - 1) / grainSize),
+			body(body), nextChunk(0), completedChunks(0), error() {}
+
+		// Runs chunks until none are left
+		void RunChunks()
+		{
+			for (int chunk = nextChunk.fetch_add(1); chunk < chunkCount; chunk = nextChunk.fetch_add(1))
+			{
+				int chunkBegin	= begin + chunk * grainSize;
+				int chunkEnd	= std::min(chunkBegin + grainSize, end);
+
+				try
+				{
+					body(chunkBegin, chunkEnd);
+				}
+				catch (...)
+				{
+					std::lock_guard<std::mutex> lock(mutex);
+					if (error == nullptr)
+					{
+						error = std::current_exception();
+					}
+				}
+
+				if (completedChunks.fetch_add(1) + 1 == chunkCount)
+				{
+					std::lock_guard<std::mutex> lock(mutex);
+					finished.notify_all();
+				}
+			}
+		}
+
+		const int begin;
+		const int end;
+		const int grainSize;
+		const int chunkCount;
+		std::function<void(int, int)> body;
+		std::atomic<int> nextChunk;
+		std::atomic<int> completedChunks;
+		std::mutex mutex;
+		std::condition_variable finished;
+		std::exception_ptr error;
+	};
+}
+
+XP::ThreadPool::ThreadPool(unsigned int threadCount) :
+	m_threads(), m_mutex(), m_wakeup(), m_tasks(), m_isStopping(false)
+{
+	for (unsigned int i = 0; i < threadCount; ++i)
+	{
+		m_threads.emplace_back(&ThreadPool::WorkerThread, this);
+	}
+}
+
+XP::ThreadPool::~ThreadPool()
+{
+	// Queued tasks are still run before the threads exit
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_isStopping = true;
+	}
+	m_wakeup.notify_all();
+
+	for (std::thread& thread : m_threads)
+	{
+		thread.join();
+	}
+}
+
+std::shared_ptr<XP::ThreadPool> XP::ThreadPool::Create(unsigned int threadCount)
+{
+	if (threadCount == 0)
+	{
+		// Leave a core for the sim thread
+		unsigned int coreCount	= std::thread::hardware_concurrency();
+		threadCount				= coreCount > 2 ? coreCount - 1 : 1;
+	}
+
+	std::shared_ptr<ThreadPool> threadPool(new ThreadPool(threadCount), [](ThreadPool* threadPool)
+	{
+		delete threadPool;
+	});
+
+	return threadPool;
+}
+
+std::shared_ptr<XP::ThreadPool> XP::ThreadPool::GetShared()
+{
+	std::lock_guard<std::mutex> lock(m_sharedMutex);
+	if (m_shared == nullptr)
+	{
+		m_shared = Create();
+	}
+
+	return m_shared;
+}
+
+void XP::ThreadPool::ReleaseShared()
+{
+	std::shared_ptr<ThreadPool> shared;
+	{
+		std::lock_guard<std::mutex> lock(m_sharedMutex);
+		shared.swap(m_shared);
+	}
+}
+
+void XP::ThreadPool::Enqueue(std::function<void()> task)
+{
+	// Ensure arguments are valid
+	if (task == nullptr)
+	{
+		throw std::invalid_argument("task is NULL");
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_tasks.push_back(std::move(task));
+	}
+	m_wakeup.notify_one();
+}
+
+void XP::ThreadPool::ParallelFor(int begin, int end, int grainSize, std::function<void(int, int)> body)
+{
+	// Ensure arguments are valid
+	if (grainSize < 1)
+	{
+		throw std::invalid_argument("grainSize must be at least 1");
+	}
+	if (end <= begin)
+	{
+		return;
+	}
+
+	std::shared_ptr<ParallelForState> state = std::make_shared<ParallelForState>(begin, end, grainSize, body);
+
+	// The calling thread takes chunks too, so only wake as many workers as could help
+	int helperCount = std::min(static_cast<int>(m_threads.size()), state->chunkCount - 1);
+	for (int i = 0; i < helperCount; ++i)
+	{
+		Enqueue([state]()
+		{
+			state->RunChunks();
+		});
+	}
+
+	state->RunChunks();
+
+	{
+		std::unique_lock<std::mutex> lock(state->mutex);
+		state->finished.wait(lock, [&state]() { return state->completedChunks.load() == state->chunkCount; });
+	}
+
+	if (state->error != nullptr)
+	{
+		std::rethrow_exception(state->error);
+	}
+}
+
+void XP::ThreadPool::WorkerThread()
+{
+	for (;;)
+	{
+		std::function<void()> task;
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_wakeup.wait(lock, [this]() { return m_isStopping || !m_tasks.empty(); });
+			if (m_tasks.empty())
+			{
+				// Stopping, with nothing left to run
+				Logger::ReleaseThreadRing();
+				return;
+			}
+
+			task = std::move(m_tasks.front());
+			m_tasks.pop_front();
+		}
+
+		// Tasks should report their own errors, but one escaping mustn't take the thread down
+		try
+		{
+			task();
+		}
+		catch (const std::exception& exception)
+		{
+			XP_LOG_ERROR(g_threadPoolLog, "Task threw: {}", exception.what());
+		}
+		catch (...)
+		{
+			XP_LOG_ERROR(g_threadPoolLog, "Task threw");
+		}
+	}
+}
@@ -0,0 +1,357 @@
+#include "XP++/Processing/TimerWheel.hpp"
+
+// STL includes
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <stdexcept>
+
+// XP++ includes
+#include "XP++/Diagnostics/CallbackGuard.hpp"
+#include "XP++/Processing/FrameLoop.hpp"
+
+// X-Plane SDK includes
+#include "XPLMDataAccess.h"
+
+namespace
+{
+	// Data ref of the sim time, which stops while paused
+	const char* SimTimeDataRefName = "sim/time/total_running_time_sec";
+	// Longest delay the wheels can hold, in ticks; longer delays fire early and are added again
+	const uint64_t MaximumDelayTicks = 0xFFFFFFFF;
+
+	// Reads the monotonic wall clock
+	double GetWallTime()
+	{
+		return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+}
+
+XP::TimerWheel::TimerWheel(double tickLength) :
+	m_tickLength(tickLength), m_wheels(), m_nodes(), m_freeNodes(NullNode), m_pendingCount(0), m_frameLoop()
+{
+	for (Wheel& wheel : m_wheels)
+	{
+		wheel.time			= 0.0;
+		wheel.origin		= 0.0;
+		wheel.currentTick	= 0;
+		wheel.pendingCount	= 0;
+		for (uint32_t& list : wheel.lists)
+		{
+			list = NullNode;
+		}
+	}
+}
+
+std::shared_ptr<XP::TimerWheel> XP::TimerWheel::Create(double tickLength)
+{
+	// Ensure arguments are valid
+	if (!(tickLength > 0.0))
+	{
+		throw std::invalid_argument("tickLength must be greater than 0");
+	}
+
+	std::shared_ptr<TimerWheel> timerWheel(new TimerWheel(tickLength), [](TimerWheel* timerWheel)
+	{
+		delete timerWheel;
+	});
+
+	// Each clock starts its first tick now
+	XPLMDataRef simTimeDataRef = XPLMFindDataRef(SimTimeDataRefName);
+	Wheel& simWheel		= timerWheel->m_wheels[static_cast<int>(TimerClock::Sim)];
+	simWheel.time		= simTimeDataRef != nullptr ? XPLMGetDataf(simTimeDataRef) : 0.0;
+	simWheel.origin		= simWheel.time;
+	Wheel& wallWheel	= timerWheel->m_wheels[static_cast<int>(TimerClock::Wall)];
+	wallWheel.time		= GetWallTime();
+	wallWheel.origin	= wallWheel.time;
+
+	TimerWheel* rawTimerWheel = timerWheel.get();
+	timerWheel->m_frameLoop = FrameLoop::Create(FlightLoopPhaseType::BeforeFlightModel, [rawTimerWheel, simTimeDataRef](float)
+	{
+		if (simTimeDataRef != nullptr)
+		{
+			rawTimerWheel->Advance(TimerClock::Sim, XPLMGetDataf(simTimeDataRef));
+		}
+		rawTimerWheel->Advance(TimerClock::Wall, GetWallTime());
+		return true;
+	});
+
+	return timerWheel;
+}
+
+XP::TimerID XP::TimerWheel::After(TimerClock clock, double delay, std::function<void()> callback)
+{
+	// Ensure arguments are valid
+	if (!(delay >= 0.0))
+	{
+		throw std::invalid_argument("delay must not be negative");
+	}
+
+	return Add(clock, delay, 0, callback);
+}
+
+XP::TimerID XP::TimerWheel::Every(TimerClock clock, double interval, std::function<void()> callback)
+{
+	// Ensure arguments are valid
+	if (!(interval > 0.0))
+	{
+		throw std::invalid_argument("interval must be greater than 0");
+	}
+
+	// Intervals shorter than a tick fire every tick
+	double intervalTicks = std::ceil(interval / m_tickLength);
+	return Add(clock, interval, intervalTicks < MaximumDelayTicks ? static_cast<uint64_t>(intervalTicks) : MaximumDelayTicks, callback);
+}
+
+bool XP::TimerWheel::Cancel(TimerID timerID)
+{
+	TimerNode* timerNode = FindNode(timerID);
+	if (timerNode == nullptr)
+	{
+		return false;
+	}
+
+	uint32_t node = static_cast<uint32_t>(timerID);
+	Unlink(m_wheels[static_cast<int>(timerNode->clock)], node);
+	Free(node);
+
+	return true;
+}
+
+bool XP::TimerWheel::IsPending(TimerID timerID) const
+{
+	return const_cast<TimerWheel*>(this)->FindNode(timerID) != nullptr;
+}
+
+void XP::TimerWheel::Advance(TimerClock clock, double time)
+{
+	Wheel& wheel = m_wheels[static_cast<int>(clock)];
+	if (!(time > wheel.time))
+	{
+		return;
+	}
+	wheel.time = time;
+
+	uint64_t targetTick = static_cast<uint64_t>((time - wheel.origin) / m_tickLength);
+	if (wheel.pendingCount == 0)
+	{
+		// Nothing to fire or cascade, so skip straight to the new tick
+		wheel.currentTick = std::max(wheel.currentTick, targetTick);
+		return;
+	}
+
+	while (wheel.currentTick < targetTick)
+	{
+		++wheel.currentTick;
+
+		// Each time a level wraps around, the next slot of the level above is due within it
+		for (int level = 1; level < LevelCount; ++level)
+		{
+			if ((wheel.currentTick & ((static_cast<uint64_t>(1) << (SlotBits * level)) - 1)) != 0)
+			{
+				break;
+			}
+
+			Cascade(wheel, level);
+		}
+
+		Fire(wheel);
+	}
+}
+
+XP::TimerID XP::TimerWheel::Add(TimerClock clock, double delay, uint64_t intervalTicks, std::function<void()> callback)
+{
+	// Ensure arguments are valid
+	if (callback == nullptr)
+	{
+		throw std::invalid_argument("callback is NULL");
+	}
+	if (clock != TimerClock::Sim && clock != TimerClock::Wall)
+	{
+		throw std::invalid_argument("clock is invalid");
+	}
+
+	// Nodes are only allocated once the pool is empty
+	uint32_t node = m_freeNodes;
+	if (node != NullNode)
+	{
+		m_freeNodes = m_nodes[node].next;
+	}
+	else
+	{
+		if (m_nodes.size() >= NullNode)
+		{
+			throw std::length_error("Too many timers");
+		}
+
+		node = static_cast<uint32_t>(m_nodes.size());
+		m_nodes.emplace_back();
+		m_nodes[node].generation = 1;
+	}
+
+	// Due at the first tick boundary at or after the delay, and never in the current tick
+	Wheel& wheel			= m_wheels[static_cast<int>(clock)];
+	double dueTick			= std::ceil((wheel.time + delay - wheel.origin) / m_tickLength);
+	double maximumDueTick	= static_cast<double>(wheel.currentTick + MaximumDelayTicks);
+
+	TimerNode& timerNode	= m_nodes[node];
+	timerNode.clock			= clock;
+	timerNode.dueTick		= dueTick < maximumDueTick ? std::max(static_cast<uint64_t>(dueTick), wheel.currentTick + 1) : wheel.currentTick + MaximumDelayTicks;
+	timerNode.intervalTicks	= intervalTicks;
+	timerNode.callback		= std::move(callback);
+
+	Schedule(wheel, node);
+	++wheel.pendingCount;
+	++m_pendingCount;
+
+	return (static_cast<TimerID>(timerNode.generation) << 32) | node;
+}
+
+XP::TimerWheel::TimerNode* XP::TimerWheel::FindNode(TimerID timerID)
+{
+	uint32_t node		= static_cast<uint32_t>(timerID);
+	uint32_t generation	= static_cast<uint32_t>(timerID >> 32);
+	if (node >= m_nodes.size() || m_nodes[node].generation != generation || m_nodes[node].list < 0)
+	{
+		return nullptr;
+	}
+
+	return &m_nodes[node];
+}
+
+void XP::TimerWheel::Schedule(Wheel& wheel, uint32_t node)
+{
+	// The lowest level whose span covers the delay, in the slot of the due tick at that level
+	uint64_t dueTick	= m_nodes[node].dueTick;
+	uint64_t delay		= dueTick - wheel.currentTick;
+	int level			= 0;
+	while (level < LevelCount - 1 && delay >= (static_cast<uint64_t>(1) << (SlotBits * (level + 1))))
+	{
+		++level;
+	}
+
+	int slot = static_cast<int>((dueTick >> (SlotBits * level)) & (SlotCount - 1));
+	Link(wheel, level * SlotCount + slot, node);
+}
+
+void XP::TimerWheel::Link(Wheel& wheel, int list, uint32_t node)
+{
+	TimerNode& timerNode	= m_nodes[node];
+	timerNode.list			= list;
+	timerNode.previous		= NullNode;
+	timerNode.next			= wheel.lists[list];
+	if (timerNode.next != NullNode)
+	{
+		m_nodes[timerNode.next].previous = node;
+	}
+	wheel.lists[list] = node;
+}
+
+void XP::TimerWheel::Unlink(Wheel& wheel, uint32_t node)
+{
+	TimerNode& timerNode = m_nodes[node];
+	if (timerNode.previous != NullNode)
+	{
+		m_nodes[timerNode.previous].next = timerNode.next;
+	}
+	else
+	{
+		wheel.lists[timerNode.list] = timerNode.next;
+	}
+	if (timerNode.next != NullNode)
+	{
+		m_nodes[timerNode.next].previous = timerNode.previous;
+	}
+
+	timerNode.list = -1;
+}
+
+void XP::TimerWheel::Free(uint32_t node)
+{
+	TimerNode& timerNode = m_nodes[node];
+	Wheel& wheel = m_wheels[static_cast<int>(timerNode.clock)];
+	--wheel.pendingCount;
+	--m_pendingCount;
+
+	// Stale IDs of the node no longer match once reused; 0 is skipped so IDs are never 0
+	timerNode.callback = nullptr;
+	if (++timerNode.generation == 0)
+	{
+		timerNode.generation = 1;
+	}
+	timerNode.list	= -1;
+	timerNode.next	= m_freeNodes;
+	m_freeNodes		= node;
+}
+
+void XP::TimerWheel::Cascade(Wheel& wheel, int level)
+{
+	int list = level * SlotCount + static_cast<int>((wheel.currentTick >> (SlotBits * level)) & (SlotCount - 1));
+
+	// Every timer in the slot is now due within the span of a lower level
+	uint32_t node = wheel.lists[list];
+	wheel.lists[list] = NullNode;
+	while (node != NullNode)
+	{
+		uint32_t next = m_nodes[node].next;
+		Schedule(wheel, node);
+		node = next;
+	}
+}
+
+void XP::TimerWheel::Fire(Wheel& wheel)
+{
+	// Moved to the firing list, so callbacks can cancel timers due this tick
+	int list = static_cast<int>(wheel.currentTick & (SlotCount - 1));
+	uint32_t node = wheel.lists[list];
+	wheel.lists[list] = NullNode;
+	while (node != NullNode)
+	{
+		uint32_t next = m_nodes[node].next;
+		Link(wheel, FiringList, node);
+		node = next;
+	}
+
+	while (wheel.lists[FiringList] != NullNode)
+	{
+		node = wheel.lists[FiringList];
+		Unlink(wheel, node);
+
+		// Timers longer than the wheels can hold are added again for the remainder
+		TimerNode& timerNode = m_nodes[node];
+		if (timerNode.dueTick > wheel.currentTick)
+		{
+			Schedule(wheel, node);
+			continue;
+		}
+
+		// Periodic timers are added again before firing, so they can cancel themselves
+		TimerID timerID = (static_cast<TimerID>(timerNode.generation) << 32) | node;
+		std::function<void()> callback = std::move(timerNode.callback);
+		if (timerNode.intervalTicks > 0)
+		{
+			timerNode.dueTick += timerNode.intervalTicks;
+			if (timerNode.dueTick <= wheel.currentTick)
+			{
+				timerNode.dueTick = wheel.currentTick + timerNode.intervalTicks;
+			}
+			Schedule(wheel, node);
+		}
+		else
+		{
+			Free(node);
+		}
+
+		CallbackGuard::Invoke(CallbackType::FlightLoop, this, [&callback]()
+		{
+			callback();
+		});
+
+		// Given back to the timer, unless it was cancelled while firing
+		TimerNode* firedNode = FindNode(timerID);
+		if (firedNode != nullptr)
+		{
+			firedNode->callback = std::move(callback);
+		}
+	}
+}
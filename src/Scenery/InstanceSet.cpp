@@ -0,0 +1,195 @@
+#include "XP++/Scenery/InstanceSet.hpp"
+
+// STL includes
+#include <stdexcept>
+
+// XP++ includes
+#include "XP++/Exceptions/XPException.hpp"
+#include "XP++/Processing/ThreadPool.hpp"
+
+// X-Plane SDK includes
+#include "XPLMInstance.h"
+#include "XPLMScenery.h"
+
+XP::InstanceSet::InstanceSet(void* objectRef, std::vector<std::string> dataRefs) :
+	m_objectRef(objectRef), m_dataRefs(dataRefs), m_instances(),
+	m_x(), m_y(), m_z(), m_pitch(), m_heading(), m_roll(), m_values(), m_isDirty()
+{
+
+}
+
+XP::InstanceSet::~InstanceSet()
+{
+	for (void* instance : m_instances)
+	{
+		XPLMDestroyInstance(instance);
+	}
+
+	XPLMUnloadObject(m_objectRef);
+}
+
+std::shared_ptr<XP::InstanceSet> XP::InstanceSet::Create(std::string objectPath, std::vector<std::string> dataRefs)
+{
+	XPLMObjectRef objectRef = XPLMLoadObject(objectPath.c_str());
+	if (objectRef == nullptr)
+	{
+		throw XPException("Failed to load object: " + objectPath);
+	}
+
+	std::shared_ptr<InstanceSet> instanceSet(new InstanceSet(objectRef, dataRefs), [](InstanceSet* instanceSet)
+	{
+		delete instanceSet;
+	});
+
+	return instanceSet;
+}
+
+int XP::InstanceSet::Add()
+{
+	// Dataref names are passed as a NULL terminated array
+	std::vector<const char*> dataRefNames;
+	dataRefNames.reserve(m_dataRefs.size() + 1);
+	for (const std::string& dataRef : m_dataRefs)
+	{
+		dataRefNames.push_back(dataRef.c_str());
+	}
+	dataRefNames.push_back(nullptr);
+
+	XPLMInstanceRef instance = XPLMCreateInstance(m_objectRef, dataRefNames.data());
+	if (instance == nullptr)
+	{
+		throw XPException("Failed to create instance");
+	}
+
+	m_instances.push_back(instance);
+	m_x.push_back(0.0f);
+	m_y.push_back(0.0f);
+	m_z.push_back(0.0f);
+	m_pitch.push_back(0.0f);
+	m_heading.push_back(0.0f);
+	m_roll.push_back(0.0f);
+	m_values.resize(m_values.size() + m_dataRefs.size(), 0.0f);
+	m_isDirty.push_back(1);
+
+	return GetCount() - 1;
+}
+
+void XP::InstanceSet::Remove(int index)
+{
+	CheckIndex(index);
+
+	XPLMDestroyInstance(m_instances[index]);
+
+	// Move the last instance into the removed one's place
+	const int last			= GetCount() - 1;
+	const size_t valueCount	= m_dataRefs.size();
+	if (index != last)
+	{
+		m_instances[index]	= m_instances[last];
+		m_x[index]			= m_x[last];
+		m_y[index]			= m_y[last];
+		m_z[index]			= m_z[last];
+		m_pitch[index]		= m_pitch[last];
+		m_heading[index]	= m_heading[last];
+		m_roll[index]		= m_roll[last];
+		m_isDirty[index]	= m_isDirty[last];
+		for (size_t value = 0; value < valueCount; ++value)
+		{
+			m_values[index * valueCount + value] = m_values[last * valueCount + value];
+		}
+	}
+
+	m_instances.pop_back();
+	m_x.pop_back();
+	m_y.pop_back();
+	m_z.pop_back();
+	m_pitch.pop_back();
+	m_heading.pop_back();
+	m_roll.pop_back();
+	m_isDirty.pop_back();
+	m_values.resize(m_values.size() - valueCount);
+}
+
+void XP::InstanceSet::SetTransform(int index, float x, float y, float z, float pitch, float heading, float roll)
+{
+	CheckIndex(index);
+
+	m_x[index]			= x;
+	m_y[index]			= y;
+	m_z[index]			= z;
+	m_pitch[index]		= pitch;
+	m_heading[index]	= heading;
+	m_roll[index]		= roll;
+	m_isDirty[index]	= 1;
+}
+
+void XP::InstanceSet::SetValue(int index, int dataRefIndex, float value)
+{
+	CheckIndex(index);
+	if (dataRefIndex < 0 || dataRefIndex >= static_cast<int>(m_dataRefs.size()))
+	{
+		throw std::out_of_range("DataRef index out of range");
+	}
+
+	m_values[index * m_dataRefs.size() + dataRefIndex]	= value;
+	m_isDirty[index]									= 1;
+}
+
+void XP::InstanceSet::Compute(ThreadPool& threadPool, int grainSize, std::function<void(InstanceArrays&, int, int)> compute)
+{
+	InstanceArrays arrays;
+	arrays.x			= m_x.data();
+	arrays.y			= m_y.data();
+	arrays.z			= m_z.data();
+	arrays.pitch		= m_pitch.data();
+	arrays.heading		= m_heading.data();
+	arrays.roll			= m_roll.data();
+	arrays.values		= m_values.data();
+	arrays.valueCount	= static_cast<int>(m_dataRefs.size());
+	arrays.isDirty		= m_isDirty.data();
+
+	threadPool.ParallelFor(0, GetCount(), grainSize, [&arrays, &compute](int begin, int end)
+	{
+		// Each chunk gets its own copy of the pointers
+		InstanceArrays chunkArrays = arrays;
+		compute(chunkArrays, begin, end);
+	});
+}
+
+int XP::InstanceSet::Flush()
+{
+	const size_t valueCount = m_dataRefs.size();
+
+	XPLMDrawInfo_t drawInfo;
+	drawInfo.structSize = sizeof(drawInfo);
+
+	int flushedCount = 0;
+	for (int i = 0; i < GetCount(); ++i)
+	{
+		if (m_isDirty[i] == 0)
+		{
+			continue;
+		}
+
+		drawInfo.x			= m_x[i];
+		drawInfo.y			= m_y[i];
+		drawInfo.z			= m_z[i];
+		drawInfo.pitch		= m_pitch[i];
+		drawInfo.heading	= m_heading[i];
+		drawInfo.roll		= m_roll[i];
+		XPLMInstanceSetPosition(m_instances[i], &drawInfo, valueCount == 0 ? nullptr : &m_values[i * valueCount]);
+
+		m_isDirty[i] = 0;
+		++flushedCount;
+	}
+
+	return flushedCount;
+}
+
+void XP::InstanceSet::CheckIndex(int index) const
+{
+	if (index < 0 || index >= GetCount())
+	{
+		throw std::out_of_range("Instance index out of range");
+	}
+}
@@ -0,0 +1,246 @@
+#include "XP++/Scenery/TerrainProbe.hpp"
+
+// STL includes
+#include <cmath>
+#include <stdexcept>
+
+// XP++ includes
+#include "XP++/Exceptions/XPException.hpp"
+#include "XP++/Processing/FrameLoop.hpp"
+
+// X-Plane SDK includes
+#include "XPLMScenery.h"
+
+namespace
+{
+	// Time between sweeps of expired results
+	const std::chrono::seconds SweepInterval(1);
+
+	// Packs a cell's coordinates into a cache key
+	uint64_t GetCellKey(float x, float z, float cellSize)
+	{
+		int32_t cellX = static_cast<int32_t>(std::floor(x / cellSize));
+		int32_t cellZ = static_cast<int32_t>(std::floor(z / cellSize));
+
+		return (static_cast<uint64_t>(static_cast<uint32_t>(cellX)) << 32) | static_cast<uint32_t>(cellZ);
+	}
+}
+
+XP::TerrainProbe::TerrainProbe(ProbeFunction probeFunction, float cellSize, float timeToLive) :
+	m_probeFunction(probeFunction), m_probeRef(nullptr), m_cellSize(cellSize),
+	m_timeToLive(std::chrono::duration_cast<Clock::duration>(std::chrono::duration<float>(timeToLive))),
+	m_cache(), m_nextSweep(), m_statistics(), m_pendingMutex(), m_pending(), m_processing(), m_processLoop(),
+	m_sceneryLoadedID(0)
+{
+
+}
+
+XP::TerrainProbe::~TerrainProbe()
+{
+	Stop();
+	if (m_sceneryLoadedID != 0)
+	{
+		MessageDispatcher::Unsubscribe(m_sceneryLoadedID);
+	}
+
+	// Don't leave anyone waiting on a request
+	for (PendingRequest& request : m_pending)
+	{
+		request.promise.set_exception(std::make_exception_ptr(XPException("TerrainProbe destroyed")));
+	}
+
+	if (m_probeRef != nullptr)
+	{
+		XPLMDestroyProbe(m_probeRef);
+	}
+}
+
+std::shared_ptr<XP::TerrainProbe> XP::TerrainProbe::Create(float cellSize, float timeToLive)
+{
+	std::shared_ptr<TerrainProbe> terrainProbe = Create(nullptr, cellSize, timeToLive);
+
+	XPLMProbeRef probeRef		= XPLMCreateProbe(xplm_ProbeY);
+	terrainProbe->m_probeRef	= probeRef;
+	if (probeRef == nullptr)
+	{
+		throw XPException("Failed to create terrain probe");
+	}
+
+	terrainProbe->m_probeFunction = [probeRef](float x, float y, float z, ProbeResult& outResult)
+	{
+		XPLMProbeInfo_t probeInfo;
+		probeInfo.structSize = sizeof(probeInfo);
+
+		XPLMProbeResult probeResult = XPLMProbeTerrainXYZ(probeRef, x, y, z, &probeInfo);
+		if (probeResult == xplm_ProbeError)
+		{
+			return false;
+		}
+
+		outResult.isHit		= probeResult == xplm_ProbeHitTerrain;
+		outResult.isWet		= probeInfo.is_wet != 0;
+		outResult.x			= probeInfo.locationX;
+		outResult.y			= probeInfo.locationY;
+		outResult.z			= probeInfo.locationZ;
+		outResult.normalX	= probeInfo.normalX;
+		outResult.normalY	= probeInfo.normalY;
+		outResult.normalZ	= probeInfo.normalZ;
+		return true;
+	};
+
+	return terrainProbe;
+}
+
+std::shared_ptr<XP::TerrainProbe> XP::TerrainProbe::Create(ProbeFunction probeFunction, float cellSize, float timeToLive)
+{
+	// Ensure arguments are valid
+	if (cellSize <= 0.0f)
+	{
+		throw std::invalid_argument("cellSize must be greater than 0");
+	}
+	if (timeToLive < 0.0f)
+	{
+		throw std::invalid_argument("timeToLive must not be negative");
+	}
+
+	std::shared_ptr<TerrainProbe> terrainProbe(new TerrainProbe(probeFunction, cellSize, timeToLive), [](TerrainProbe* terrainProbe)
+	{
+		delete terrainProbe;
+	});
+
+	// Scenery loads shift the local origin under the cached results; unsubscribed when destroyed
+	TerrainProbe* rawTerrainProbe	= terrainProbe.get();
+	terrainProbe->m_sceneryLoadedID	= MessageDispatcher::Subscribe(XPLMMessageType::SceneryLoaded, [rawTerrainProbe](PluginID, const Message&)
+	{
+		rawTerrainProbe->Clear();
+	});
+
+	return terrainProbe;
+}
+
+XP::ProbeResult XP::TerrainProbe::Probe(float x, float y, float z)
+{
+	return ProbeCached(x, y, z, Clock::now());
+}
+
+void XP::TerrainProbe::Probe(const float* x, const float* y, const float* z, ProbeResult* outResults, int count)
+{
+	Clock::time_point now = Clock::now();
+	for (int i = 0; i < count; ++i)
+	{
+		outResults[i] = ProbeCached(x[i], y[i], z[i], now);
+	}
+}
+
+std::future<XP::ProbeResult> XP::TerrainProbe::Request(float x, float y, float z)
+{
+	PendingRequest request;
+	request.x = x;
+	request.y = y;
+	request.z = z;
+	std::future<ProbeResult> result = request.promise.get_future();
+
+	std::lock_guard<std::mutex> lock(m_pendingMutex);
+	m_pending.push_back(std::move(request));
+
+	return result;
+}
+
+void XP::TerrainProbe::ProcessRequests()
+{
+	// Take the whole batch, so requesting threads aren't held up while probing
+	{
+		std::lock_guard<std::mutex> lock(m_pendingMutex);
+		m_processing.swap(m_pending);
+	}
+
+	Clock::time_point now = Clock::now();
+	for (PendingRequest& request : m_processing)
+	{
+		try
+		{
+			request.promise.set_value(ProbeCached(request.x, request.y, request.z, now));
+		}
+		catch (...)
+		{
+			request.promise.set_exception(std::current_exception());
+		}
+	}
+	m_processing.clear();
+
+	if (now >= m_nextSweep)
+	{
+		Sweep(now);
+		m_nextSweep = now + SweepInterval;
+	}
+}
+
+void XP::TerrainProbe::Start()
+{
+	if (m_processLoop == nullptr)
+	{
+		m_processLoop = FrameLoop::Create(FlightLoopPhaseType::AfterFlightModel, [this](float)
+		{
+			ProcessRequests();
+			return true;
+		});
+	}
+
+	m_processLoop->Wake();
+}
+
+void XP::TerrainProbe::Stop()
+{
+	m_processLoop.reset();
+}
+
+void XP::TerrainProbe::Clear()
+{
+	m_cache.clear();
+}
+
+XP::ProbeResult XP::TerrainProbe::ProbeCached(float x, float y, float z, Clock::time_point now)
+{
+	++m_statistics.requestCount;
+
+	uint64_t key = GetCellKey(x, z, m_cellSize);
+	auto foundEntry = m_cache.find(key);
+	if (foundEntry != m_cache.end() && foundEntry->second.expiry > now)
+	{
+		++m_statistics.cacheHitCount;
+
+		// Terrain height of the cell, at the point asked for
+		ProbeResult result	= foundEntry->second.result;
+		result.x			= x;
+		result.z			= z;
+		return result;
+	}
+
+	++m_statistics.probeCount;
+	ProbeResult result = {};
+	if (!m_probeFunction(x, y, z, result))
+	{
+		throw XPException("Terrain probe failed");
+	}
+
+	CacheEntry& entry	= m_cache[key];
+	entry.result		= result;
+	entry.expiry		= now + m_timeToLive;
+
+	return result;
+}
+
+void XP::TerrainProbe::Sweep(Clock::time_point now)
+{
+	for (auto entry = m_cache.begin(); entry != m_cache.end();)
+	{
+		if (entry->second.expiry <= now)
+		{
+			entry = m_cache.erase(entry);
+		}
+		else
+		{
+			++entry;
+		}
+	}
+}
@@ -0,0 +1,627 @@
+#include "XP++/Settings/SettingsStore.hpp"
+
+// STL includes
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+
+// XP++ includes
+#include "XP++/Exceptions/XPException.hpp"
+#include "XP++/Logging/Logger.hpp"
+#include "XP++/Message.hpp"
+
+// Platform includes
+#if IBM
+#include <io.h>
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+	XP::LogCategory g_settingsLog("Settings");
+
+	// Identifies a settings file, followed by the format version
+	const char FileMagic[4] = { 'X', 'P', 'P', 'S' };
+	const uint32_t FileVersion = 1;
+	const size_t FileHeaderSize = sizeof(FileMagic) + sizeof(FileVersion);
+	// Each record starts with its checksum and the length of the rest of the record
+	const size_t RecordHeaderSize = 2 * sizeof(uint32_t);
+	// Files smaller than this are never compacted
+	const uint64_t MinimumCompactionSize = 64 * 1024;
+
+	// Lookup table for the CRC-32 polynomial
+	struct Crc32Table
+	{
+		Crc32Table()
+		{
+			for (uint32_t i = 0; i < 256; ++i)
+			{
+				uint32_t value = i;
+				for (int bit = 0; bit < 8; ++bit)
+				{
+					value = (value & 1) != 0 ? 0xEDB88320u ^ (value >> 1) : value >> 1;
+				}
+				values[i] = value;
+			}
+		}
+
+		uint32_t values[256];
+	};
+
+	uint32_t Crc32(const char* data, size_t length)
+	{
+		static const Crc32Table table;
+
+		uint32_t crc = 0xFFFFFFFFu;
+		for (size_t i = 0; i < length; ++i)
+		{
+			crc = table.values[(crc ^ static_cast<uint8_t>(data[i])) & 0xFF] ^ (crc >> 8);
+		}
+		return crc ^ 0xFFFFFFFFu;
+	}
+
+	template<typename T>
+	void AppendValue(std::string& output, T value)
+	{
+		output.append(reinterpret_cast<const char*>(&value), sizeof(value));
+	}
+
+	template<typename T>
+	T ReadValue(const char* input)
+	{
+		T value;
+		std::memcpy(&value, input, sizeof(value));
+		return value;
+	}
+
+	// Read-only view of a whole file
+	class MappedFile
+	{
+	public:
+		MappedFile() : data(nullptr), size(0)
+#if IBM
+			, file(INVALID_HANDLE_VALUE), mapping(nullptr)
+#endif
+		{
+		}
+
+		~MappedFile()
+		{
+#if IBM
+			if (data != nullptr)
+			{
+				UnmapViewOfFile(data);
+			}
+			if (mapping != nullptr)
+			{
+				CloseHandle(mapping);
+			}
+			if (file != INVALID_HANDLE_VALUE)
+			{
+				CloseHandle(file);
+			}
+#else
+			if (data != nullptr)
+			{
+				munmap(const_cast<char*>(data), size);
+			}
+#endif
+		}
+
+		// Maps the file, returning false if it doesn't exist
+		bool Open(const std::string& filePath)
+		{
+#if IBM
+			file = CreateFileA(filePath.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, nullptr,
+							   OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+			if (file == INVALID_HANDLE_VALUE)
+			{
+				return false;
+			}
+
+			LARGE_INTEGER fileSize;
+			GetFileSizeEx(file, &fileSize);
+			size = static_cast<size_t>(fileSize.QuadPart);
+			if (size == 0)
+			{
+				return true;
+			}
+
+			mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+			if (mapping == nullptr)
+			{
+				throw XP::XPException("Failed to map settings file: " + filePath);
+			}
+			data = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+#else
+			int descriptor = open(filePath.c_str(), O_RDONLY);
+			if (descriptor < 0)
+			{
+				return false;
+			}
+
+			struct stat status;
+			fstat(descriptor, &status);
+			size = static_cast<size_t>(status.st_size);
+			if (size == 0)
+			{
+				close(descriptor);
+				return true;
+			}
+
+			void* mapped = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+			close(descriptor);
+			data = mapped == MAP_FAILED ? nullptr : static_cast<const char*>(mapped);
+#endif
+			if (data == nullptr)
+			{
+				throw XP::XPException("Failed to map settings file: " + filePath);
+			}
+
+			return true;
+		}
+
+		const char* data;
+		size_t size;
+
+	private:
+#if IBM
+		HANDLE file;
+		HANDLE mapping;
+#endif
+	};
+
+	// Writes a buffer to the end of a file and waits for it to reach the disk
+	void WriteDurably(const std::string& filePath, const char* mode, const std::string& buffer)
+	{
+		FILE* file = std::fopen(filePath.c_str(), mode);
+		if (file == nullptr)
+		{
+			throw std::runtime_error("Failed to open " + filePath);
+		}
+
+		bool isWritten = std::fwrite(buffer.data(), 1, buffer.size(), file) == buffer.size() && std::fflush(file) == 0;
+#if IBM
+		isWritten = isWritten && _commit(_fileno(file)) == 0;
+#else
+		isWritten = isWritten && fsync(fileno(file)) == 0;
+#endif
+		std::fclose(file);
+
+		if (!isWritten)
+		{
+			throw std::runtime_error("Failed to write " + filePath);
+		}
+	}
+
+	// Replaces a file with another, as a single step
+	void ReplaceFile(const std::string& sourcePath, const std::string& targetPath)
+	{
+#if IBM
+		bool isReplaced = MoveFileExA(sourcePath.c_str(), targetPath.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+#else
+		bool isReplaced = std::rename(sourcePath.c_str(), targetPath.c_str()) == 0;
+#endif
+		if (!isReplaced)
+		{
+			throw std::runtime_error("Failed to replace " + targetPath);
+		}
+	}
+}
+
+XP::SettingsStore::SettingsStore(std::string filePath) :
+	m_filePath(filePath), m_entries(), m_pending(), m_fileSize(0), m_liveSize(FileHeaderSize),
+	m_writerThread(), m_writerMutex(), m_writerWakeup(), m_writerIdle(), m_writes(),
+	m_isWriting(false), m_isStopping(false), m_lastError()
+{
+
+}
+
+XP::SettingsStore::~SettingsStore()
+{
+	Flush();
+
+	// Queued writes are finished before the thread exits
+	{
+		std::lock_guard<std::mutex> lock(m_writerMutex);
+		m_isStopping = true;
+	}
+	m_writerWakeup.notify_one();
+
+	// Not started if the file failed to load
+	if (m_writerThread.joinable())
+	{
+		m_writerThread.join();
+	}
+}
+
+std::shared_ptr<XP::SettingsStore> XP::SettingsStore::Open(std::string filePath)
+{
+	std::shared_ptr<SettingsStore> settingsStore(new SettingsStore(filePath), [](SettingsStore* settingsStore)
+	{
+		delete settingsStore;
+	});
+
+	bool isIntact = settingsStore->Load();
+	settingsStore->m_writerThread = std::thread(&SettingsStore::WriterThread, settingsStore.get());
+
+	// Rewrite a damaged file straight away, so new records aren't appended after the damage
+	if (!isIntact)
+	{
+		XP_LOG_WARNING(g_settingsLog, "Damaged records found at the end of {}, rewriting it", filePath);
+		settingsStore->QueueCompaction();
+	}
+
+	return settingsStore;
+}
+
+bool XP::SettingsStore::Contains(const std::string& name) const
+{
+	return m_entries.find(name) != m_entries.end();
+}
+
+bool XP::SettingsStore::GetBool(const std::string& name, bool defaultValue) const
+{
+	auto foundEntry = m_entries.find(name);
+	return foundEntry != m_entries.end() && foundEntry->second.type == SettingType::Bool ?
+		foundEntry->second.integer != 0 : defaultValue;
+}
+
+int64_t XP::SettingsStore::GetInteger(const std::string& name, int64_t defaultValue) const
+{
+	auto foundEntry = m_entries.find(name);
+	return foundEntry != m_entries.end() && foundEntry->second.type == SettingType::Integer ?
+		foundEntry->second.integer : defaultValue;
+}
+
+double XP::SettingsStore::GetDouble(const std::string& name, double defaultValue) const
+{
+	auto foundEntry = m_entries.find(name);
+	return foundEntry != m_entries.end() && foundEntry->second.type == SettingType::Double ?
+		foundEntry->second.real : defaultValue;
+}
+
+std::string XP::SettingsStore::GetString(const std::string& name, const std::string& defaultValue) const
+{
+	auto foundEntry = m_entries.find(name);
+	return foundEntry != m_entries.end() && foundEntry->second.type == SettingType::String ?
+		foundEntry->second.text : defaultValue;
+}
+
+void XP::SettingsStore::SetBool(const std::string& name, bool value)
+{
+	Entry entry = { SettingType::Bool, value ? 1 : 0, 0.0, std::string() };
+	Store(name, entry);
+}
+
+void XP::SettingsStore::SetInteger(const std::string& name, int64_t value)
+{
+	Entry entry = { SettingType::Integer, value, 0.0, std::string() };
+	Store(name, entry);
+}
+
+void XP::SettingsStore::SetDouble(const std::string& name, double value)
+{
+	Entry entry = { SettingType::Double, 0, value, std::string() };
+	Store(name, entry);
+}
+
+void XP::SettingsStore::SetString(const std::string& name, const std::string& value)
+{
+	Entry entry = { SettingType::String, 0, 0.0, value };
+	Store(name, entry);
+}
+
+void XP::SettingsStore::Remove(const std::string& name)
+{
+	if (!Contains(name))
+	{
+		return;
+	}
+
+	Entry entry = { SettingType::Removed, 0, 0.0, std::string() };
+	Store(name, entry);
+}
+
+void XP::SettingsStore::Flush()
+{
+	if (m_pending.empty())
+	{
+		return;
+	}
+
+	// A new file starts with its header
+	std::string records;
+	if (m_fileSize == 0)
+	{
+		records.append(FileMagic, sizeof(FileMagic));
+		AppendValue(records, FileVersion);
+	}
+	records.append(m_pending);
+	m_pending.clear();
+	m_fileSize += records.size();
+
+	std::string filePath = m_filePath;
+	QueueWrite([filePath, records]()
+	{
+		WriteDurably(filePath, "ab", records);
+	});
+
+	// Compact once at least half the file is overwritten records
+	if (m_fileSize >= MinimumCompactionSize && m_fileSize > 2 * m_liveSize)
+	{
+		QueueCompaction();
+	}
+}
+
+void XP::SettingsStore::WaitForWrites()
+{
+	std::unique_lock<std::mutex> lock(m_writerMutex);
+	m_writerIdle.wait(lock, [this]() { return m_writes.empty() && !m_isWriting; });
+}
+
+bool XP::SettingsStore::HandleMessage(const Message& message)
+{
+	if (message.GetType() != XPLMMessageType::WillWritePrefs)
+	{
+		return false;
+	}
+
+	Flush();
+	return true;
+}
+
+std::string XP::SettingsStore::GetLastError() const
+{
+	std::lock_guard<std::mutex> lock(m_writerMutex);
+	return m_lastError;
+}
+
+namespace
+{
+	// Encodes a record, returning its size
+	template<typename Entry>
+	size_t AppendRecord(std::string& output, const std::string& name, const Entry& entry)
+	{
+		size_t start = output.size();
+		output.append(RecordHeaderSize, '\0');
+
+		AppendValue(output, static_cast<uint8_t>(entry.type));
+		AppendValue(output, static_cast<uint16_t>(name.size()));
+		output.append(name);
+		switch (entry.type)
+		{
+		case XP::SettingType::Bool:
+			AppendValue(output, static_cast<uint8_t>(entry.integer));
+			break;
+		case XP::SettingType::Integer:
+			AppendValue(output, entry.integer);
+			break;
+		case XP::SettingType::Double:
+			AppendValue(output, entry.real);
+			break;
+		case XP::SettingType::String:
+			AppendValue(output, static_cast<uint32_t>(entry.text.size()));
+			output.append(entry.text);
+			break;
+		default:
+			break;
+		}
+
+		// Fill in the header, now the body is known
+		const char* body	= output.data() + start + RecordHeaderSize;
+		size_t bodyLength	= output.size() - start - RecordHeaderSize;
+		uint32_t header[2]	= { Crc32(body, bodyLength), static_cast<uint32_t>(bodyLength) };
+		std::memcpy(&output[start], header, sizeof(header));
+
+		return output.size() - start;
+	}
+
+	// Size of an entry's record
+	template<typename Entry>
+	size_t GetRecordSize(const std::string& name, const Entry& entry)
+	{
+		size_t valueSize = 0;
+		switch (entry.type)
+		{
+		case XP::SettingType::Bool:		valueSize = 1; break;
+		case XP::SettingType::Integer:	valueSize = 8; break;
+		case XP::SettingType::Double:	valueSize = 8; break;
+		case XP::SettingType::String:	valueSize = 4 + entry.text.size(); break;
+		default:						break;
+		}
+
+		return RecordHeaderSize + 1 + 2 + name.size() + valueSize;
+	}
+}
+
+bool XP::SettingsStore::Load()
+{
+	MappedFile file;
+	if (!file.Open(m_filePath) || file.size == 0)
+	{
+		return true;
+	}
+
+	std::string header(FileMagic, sizeof(FileMagic));
+	AppendValue(header, FileVersion);
+
+	// A crash while the header was first written leaves part of it, which is as good as empty
+	if (file.size < FileHeaderSize && std::memcmp(file.data, header.data(), file.size) == 0)
+	{
+		return false;
+	}
+	if (file.size < FileHeaderSize || std::memcmp(file.data, header.data(), FileHeaderSize) != 0)
+	{
+		throw XPException("Not a settings file: " + m_filePath);
+	}
+
+	// Read records until the end, or the first damaged record
+	size_t offset = FileHeaderSize;
+	while (file.size - offset >= RecordHeaderSize)
+	{
+		uint32_t crc		= ReadValue<uint32_t>(file.data + offset);
+		uint32_t bodyLength	= ReadValue<uint32_t>(file.data + offset + sizeof(uint32_t));
+		const char* body	= file.data + offset + RecordHeaderSize;
+		if (bodyLength < 3 || bodyLength > file.size - offset - RecordHeaderSize || Crc32(body, bodyLength) != crc)
+		{
+			break;
+		}
+
+		SettingType type		= static_cast<SettingType>(ReadValue<uint8_t>(body));
+		uint16_t nameLength		= ReadValue<uint16_t>(body + 1);
+		const char* value		= body + 3 + nameLength;
+		size_t valueLength		= bodyLength - 3 - nameLength;
+		if (nameLength > bodyLength - 3)
+		{
+			break;
+		}
+		std::string name(body + 3, nameLength);
+
+		Entry entry = { type, 0, 0.0, std::string() };
+		switch (type)
+		{
+		case SettingType::Bool:
+			entry.integer = valueLength >= 1 ? ReadValue<uint8_t>(value) : 0;
+			break;
+		case SettingType::Integer:
+			entry.integer = valueLength >= 8 ? ReadValue<int64_t>(value) : 0;
+			break;
+		case SettingType::Double:
+			entry.real = valueLength >= 8 ? ReadValue<double>(value) : 0.0;
+			break;
+		case SettingType::String:
+			if (valueLength >= 4)
+			{
+				entry.text.assign(value + 4, std::min<size_t>(ReadValue<uint32_t>(value), valueLength - 4));
+			}
+			break;
+		default:
+			break;
+		}
+
+		// Later records replace earlier ones
+		auto foundEntry = m_entries.find(name);
+		if (foundEntry != m_entries.end())
+		{
+			m_liveSize -= GetRecordSize(name, foundEntry->second);
+			m_entries.erase(foundEntry);
+		}
+		if (type != SettingType::Removed)
+		{
+			m_liveSize += GetRecordSize(name, entry);
+			m_entries.emplace(std::move(name), std::move(entry));
+		}
+
+		offset += RecordHeaderSize + bodyLength;
+	}
+
+	m_fileSize = offset;
+	return offset == file.size;
+}
+
+void XP::SettingsStore::Store(const std::string& name, const Entry& entry)
+{
+	if (name.size() > UINT16_MAX)
+	{
+		throw std::invalid_argument("Setting name is too long");
+	}
+
+	AppendRecord(m_pending, name, entry);
+
+	auto foundEntry = m_entries.find(name);
+	if (foundEntry != m_entries.end())
+	{
+		m_liveSize -= GetRecordSize(name, foundEntry->second);
+		m_entries.erase(foundEntry);
+	}
+	if (entry.type != SettingType::Removed)
+	{
+		m_liveSize += GetRecordSize(name, entry);
+		m_entries.emplace(name, entry);
+	}
+}
+
+void XP::SettingsStore::QueueWrite(std::function<void()> write)
+{
+	{
+		std::lock_guard<std::mutex> lock(m_writerMutex);
+		m_writes.push_back(std::move(write));
+	}
+	m_writerWakeup.notify_one();
+}
+
+void XP::SettingsStore::QueueCompaction()
+{
+	// Snapshot every live setting now, so later changes are appended after the rewrite
+	std::string contents;
+	contents.reserve(static_cast<size_t>(m_liveSize));
+	contents.append(FileMagic, sizeof(FileMagic));
+	AppendValue(contents, FileVersion);
+	for (const auto& entry : m_entries)
+	{
+		AppendRecord(contents, entry.first, entry.second);
+	}
+
+	// Pending changes are already within the snapshot
+	m_pending.clear();
+
+	m_fileSize = contents.size();
+	m_liveSize = contents.size();
+
+	std::string filePath = m_filePath;
+	QueueWrite([filePath, contents]()
+	{
+		std::string temporaryPath = filePath + ".tmp";
+		WriteDurably(temporaryPath, "wb", contents);
+		ReplaceFile(temporaryPath, filePath);
+	});
+}
+
+void XP::SettingsStore::WriterThread()
+{
+	std::unique_lock<std::mutex> lock(m_writerMutex);
+	for (;;)
+	{
+		m_writerWakeup.wait(lock, [this]() { return m_isStopping || !m_writes.empty(); });
+		if (m_writes.empty())
+		{
+			// Stopping, with nothing left to write
+			Logger::ReleaseThreadRing();
+			return;
+		}
+
+		std::function<void()> write = std::move(m_writes.front());
+		m_writes.pop_front();
+		m_isWriting = true;
+
+		lock.unlock();
+		std::string error;
+		try
+		{
+			write();
+		}
+		catch (const std::exception& exception)
+		{
+			error = exception.what();
+			XP_LOG_ERROR(g_settingsLog, "{}", error);
+		}
+		lock.lock();
+
+		if (!error.empty())
+		{
+			m_lastError = error;
+		}
+		m_isWriting = false;
+		if (m_writes.empty())
+		{
+			m_writerIdle.notify_all();
+		}
+	}
+}
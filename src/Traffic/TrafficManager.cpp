@@ -0,0 +1,287 @@
+#include "XP++/Traffic/TrafficManager.hpp"
+
+// STL includes
+#include <stdexcept>
+#include <string>
+
+// XP++ includes
+#include "XP++/Exceptions/XPException.hpp"
+#include "XP++/Planes.hpp"
+#include "XP++/Processing/FrameLoop.hpp"
+
+// X-Plane SDK includes
+#include "XPLMDataAccess.h"
+#include "XPLMGraphics.h"
+
+namespace
+{
+	// TCAS target arrays, in the order of TrafficManager::Field
+	const char* const FieldDataRefNames[] =
+	{
+		"sim/cockpit2/tcas/targets/position/x",
+		"sim/cockpit2/tcas/targets/position/y",
+		"sim/cockpit2/tcas/targets/position/z",
+		"sim/cockpit2/tcas/targets/position/vx",
+		"sim/cockpit2/tcas/targets/position/vy",
+		"sim/cockpit2/tcas/targets/position/vz",
+		"sim/cockpit2/tcas/targets/position/the",
+		"sim/cockpit2/tcas/targets/position/phi",
+		"sim/cockpit2/tcas/targets/position/psi",
+		"sim/cockpit2/tcas/targets/position/lat",
+		"sim/cockpit2/tcas/targets/position/lon",
+		"sim/cockpit2/tcas/targets/position/ele"
+	};
+
+	const char* const OverrideDataRefName = "sim/operation/override/override_TCAS";
+
+	// Index 0 of the TCAS arrays is the user's aircraft
+	const int FirstTargetIndex = 1;
+
+	void ResizeAll(XP::TrafficState& state, int count)
+	{
+		state.latitude.assign(count, 0.0);
+		state.longitude.assign(count, 0.0);
+		state.elevation.assign(count, 0.0);
+		state.x.assign(count, 0.0f);
+		state.y.assign(count, 0.0f);
+		state.z.assign(count, 0.0f);
+		state.velocityX.assign(count, 0.0f);
+		state.velocityY.assign(count, 0.0f);
+		state.velocityZ.assign(count, 0.0f);
+		state.pitch.assign(count, 0.0f);
+		state.roll.assign(count, 0.0f);
+		state.heading.assign(count, 0.0f);
+		state.isStale.assign(count, 1.0f);
+	}
+
+	// Moves positions along velocities, scaled per aircraft so fresh
+	// aircraft stay put without a branch in the loop
+	void Advance(float* position, const float* velocity, const float* isStale, float elapsed, int count)
+	{
+		for (int i = 0; i < count; ++i)
+		{
+			position[i] += velocity[i] * (elapsed * isStale[i]);
+		}
+	}
+}
+
+XP::TrafficManager::TrafficManager(int aircraftCount) :
+	m_aircraftCount(aircraftCount), m_state(), m_scratch(aircraftCount, 0.0f),
+	m_overrideDataRef(nullptr), m_isAcquired(false), m_updateLoop()
+{
+	ResizeAll(m_state, aircraftCount);
+}
+
+XP::TrafficManager::~TrafficManager()
+{
+	Release();
+}
+
+std::shared_ptr<XP::TrafficManager> XP::TrafficManager::Create(int aircraftCount)
+{
+	// Ensure arguments are valid
+	if (aircraftCount < 1 || aircraftCount > MaxAircraft)
+	{
+		throw std::out_of_range("aircraftCount must be between 1 and " + std::to_string(MaxAircraft));
+	}
+
+	std::shared_ptr<TrafficManager> trafficManager(new TrafficManager(aircraftCount), [](TrafficManager* trafficManager)
+	{
+		delete trafficManager;
+	});
+
+	// Find the TCAS target arrays, which only exist from X-Plane 11.50
+	for (int field = 0; field < FieldCount; ++field)
+	{
+		trafficManager->m_fieldDataRefs[field] = XPLMFindDataRef(FieldDataRefNames[field]);
+		if (trafficManager->m_fieldDataRefs[field] == nullptr)
+		{
+			throw XPException(std::string("TrafficManager requires X-Plane 11.50 or later, missing: ") + FieldDataRefNames[field]);
+		}
+	}
+	trafficManager->m_overrideDataRef = XPLMFindDataRef(OverrideDataRefName);
+	if (trafficManager->m_overrideDataRef == nullptr)
+	{
+		throw XPException(std::string("TrafficManager requires X-Plane 11.50 or later, missing: ") + OverrideDataRefName);
+	}
+
+	return trafficManager;
+}
+
+bool XP::TrafficManager::Acquire()
+{
+	if (m_isAcquired)
+	{
+		return true;
+	}
+
+	if (!Planes::Acquire(nullptr))
+	{
+		return false;
+	}
+	m_isAcquired = true;
+
+	// Aircraft count includes the user's aircraft
+	Planes::SetActiveCount(m_aircraftCount + 1);
+	for (int i = 0; i < m_aircraftCount; ++i)
+	{
+		Planes::DisableAI(i + FirstTargetIndex);
+	}
+	XPLMSetDatai(m_overrideDataRef, 1);
+
+	return true;
+}
+
+void XP::TrafficManager::Release()
+{
+	Stop();
+
+	if (!m_isAcquired)
+	{
+		return;
+	}
+
+	XPLMSetDatai(m_overrideDataRef, 0);
+	Planes::Release();
+	m_isAcquired = false;
+}
+
+void XP::TrafficManager::Start()
+{
+	if (m_updateLoop == nullptr)
+	{
+		m_updateLoop = FrameLoop::Create(FlightLoopPhaseType::AfterFlightModel, [this](float elapsed)
+		{
+			Update(elapsed);
+			return true;
+		});
+	}
+
+	m_updateLoop->Wake();
+}
+
+void XP::TrafficManager::Stop()
+{
+	m_updateLoop.reset();
+}
+
+void XP::TrafficManager::SetPosition(int index, double latitude, double longitude, double elevation)
+{
+	CheckIndex(index);
+
+	double x, y, z;
+	XPLMWorldToLocal(latitude, longitude, elevation, &x, &y, &z);
+
+	m_state.latitude[index]		= latitude;
+	m_state.longitude[index]	= longitude;
+	m_state.elevation[index]	= elevation;
+	m_state.x[index]			= static_cast<float>(x);
+	m_state.y[index]			= static_cast<float>(y);
+	m_state.z[index]			= static_cast<float>(z);
+	m_state.isStale[index]		= 0.0f;
+}
+
+void XP::TrafficManager::SetVelocity(int index, float x, float y, float z)
+{
+	CheckIndex(index);
+
+	m_state.velocityX[index] = x;
+	m_state.velocityY[index] = y;
+	m_state.velocityZ[index] = z;
+}
+
+void XP::TrafficManager::SetAttitude(int index, float pitch, float roll, float heading)
+{
+	CheckIndex(index);
+
+	m_state.pitch[index]	= pitch;
+	m_state.roll[index]		= roll;
+	m_state.heading[index]	= heading;
+}
+
+void XP::TrafficManager::ReadAll()
+{
+	float* const floatFields[] =
+	{
+		m_state.x.data(), m_state.y.data(), m_state.z.data(),
+		m_state.velocityX.data(), m_state.velocityY.data(), m_state.velocityZ.data(),
+		m_state.pitch.data(), m_state.roll.data(), m_state.heading.data()
+	};
+	for (int field = FieldX; field <= FieldHeading; ++field)
+	{
+		XPLMGetDatavf(m_fieldDataRefs[field], floatFields[field], FirstTargetIndex, m_aircraftCount);
+	}
+
+	// World position is published as floats, widened into the double arrays
+	std::vector<double>* const doubleFields[] = { &m_state.latitude, &m_state.longitude, &m_state.elevation };
+	for (int field = FieldLatitude; field <= FieldElevation; ++field)
+	{
+		XPLMGetDatavf(m_fieldDataRefs[field], m_scratch.data(), FirstTargetIndex, m_aircraftCount);
+
+		std::vector<double>& values = *doubleFields[field - FieldLatitude];
+		for (int i = 0; i < m_aircraftCount; ++i)
+		{
+			values[i] = m_scratch[i];
+		}
+	}
+}
+
+void XP::TrafficManager::WriteAll()
+{
+	// Only the local position is written, X-Plane derives the world position from it
+	float* const floatFields[] =
+	{
+		m_state.x.data(), m_state.y.data(), m_state.z.data(),
+		m_state.velocityX.data(), m_state.velocityY.data(), m_state.velocityZ.data(),
+		m_state.pitch.data(), m_state.roll.data(), m_state.heading.data()
+	};
+	for (int field = FieldX; field <= FieldHeading; ++field)
+	{
+		XPLMSetDatavf(m_fieldDataRefs[field], floatFields[field], FirstTargetIndex, m_aircraftCount);
+	}
+}
+
+void XP::TrafficManager::Extrapolate(float elapsed)
+{
+	const float* isStale = m_state.isStale.data();
+
+	Advance(m_state.x.data(), m_state.velocityX.data(), isStale, elapsed, m_aircraftCount);
+	Advance(m_state.y.data(), m_state.velocityY.data(), isStale, elapsed, m_aircraftCount);
+	Advance(m_state.z.data(), m_state.velocityZ.data(), isStale, elapsed, m_aircraftCount);
+
+	// Keep the world position of moved aircraft in step with their local position
+	if (elapsed == 0.0f)
+	{
+		return;
+	}
+	for (int i = 0; i < m_aircraftCount; ++i)
+	{
+		if (isStale[i] != 0.0f)
+		{
+			XPLMLocalToWorld(m_state.x[i], m_state.y[i], m_state.z[i],
+							 &m_state.latitude[i], &m_state.longitude[i], &m_state.elevation[i]);
+		}
+	}
+}
+
+void XP::TrafficManager::Update(float elapsed)
+{
+	if (!m_isAcquired)
+	{
+		return;
+	}
+
+	Extrapolate(elapsed);
+	WriteAll();
+
+	// Aircraft are stale until given a fresh position next frame
+	m_state.isStale.assign(m_aircraftCount, 1.0f);
+}
+
+void XP::TrafficManager::CheckIndex(int index) const
+{
+	if (index < 0 || index >= m_aircraftCount)
+	{
+		throw std::out_of_range("Aircraft index out of range");
+	}
+}
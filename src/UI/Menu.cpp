@@ -2,19 +2,19 @@
 
 // STL includes
 #include <algorithm>
+#include <stdexcept>
 
 // XP++ includes
 #include "XP++/UI/MenuItem.hpp"
+#include "XP++/Diagnostics/CallbackGuard.hpp"
 #include "XP++/Exceptions/NotImplementedException.hpp"
 #include "XP++/Exceptions/XPException.hpp"
 
 // X-Plane SDK includes
 #include "XPLMMenus.h"
 
-std::list<std::weak_ptr<XP::Menu>> XP::Menu::m_menus;
-
 XP::Menu::Menu(std::string name, std::weak_ptr<MenuItem> parentMenuItem) :
-	m_menuItems(), m_id(nullptr), m_parentMenuItem(parentMenuItem.lock()), m_name(name)
+	m_menuItems(), m_id(nullptr), m_isOwned(true), m_parentMenuItem(parentMenuItem), m_name(name)
 {
 	// Ensure arguments are valid
 	if (parentMenuItem.expired())
@@ -23,12 +23,11 @@ XP::Menu::Menu(std::string name, std::weak_ptr<MenuItem> parentMenuItem) :
 		throw std::invalid_argument("parentMenuItem is NULL");
 	}
 
-	// Get parent menu item and parent menu references
-	std::shared_ptr<MenuItem> lockedParentItem	= parentMenuItem.lock();
-	std::shared_ptr<Menu> parentMenu			= lockedParentItem->GetParentMenu().lock();
+	// Get parent menu item, the parent menu's ID is cached by the item
+	std::shared_ptr<MenuItem> lockedParentItem = parentMenuItem.lock();
 
 	// Create X-Plane Menu
-	m_id = XPLMCreateMenu(m_name.c_str(), parentMenu->m_id, lockedParentItem->GetIndex(), &Menu::MenuHandler, this);
+	m_id = XPLMCreateMenu(m_name.c_str(), lockedParentItem->m_parentMenuID, lockedParentItem->GetIndex(), &Menu::MenuHandler, this);
 	if (m_id == nullptr)
 	{
 		throw XP::XPException("Unable to create Menu");
@@ -36,7 +35,7 @@ XP::Menu::Menu(std::string name, std::weak_ptr<MenuItem> parentMenuItem) :
 }
 
 XP::Menu::Menu(std::string name, std::weak_ptr<MenuItem> parentMenuItem, void* id) :
-	m_menuItems(), m_id(id), m_parentMenuItem(parentMenuItem.lock()), m_name(name)
+	m_menuItems(), m_id(id), m_isOwned(false), m_parentMenuItem(parentMenuItem), m_name(name)
 {
 	// For creating Menu objects which represent X-Plane
 	// already created Menus
@@ -45,7 +44,12 @@ XP::Menu::Menu(std::string name, std::weak_ptr<MenuItem> parentMenuItem, void* i
 XP::Menu::~Menu()
 {
 	ClearAllMenuItems();
-	XPLMDestroyMenu(m_id);
+
+	// Menus created by X-Plane are only borrowed
+	if (m_isOwned)
+	{
+		XPLMDestroyMenu(m_id);
+	}
 }
 
 std::weak_ptr<XP::Menu> XP::Menu::FindPluginsMenu()
@@ -67,14 +71,26 @@ std::weak_ptr<XP::Menu> XP::Menu::FindAircraftMenu()
 std::shared_ptr<XP::MenuItem> XP::Menu::AppendMenuItem(std::string name, std::function<void(MenuItem&)> onClick)
 {
 	// Create Menu Item
-	std::shared_ptr<MenuItem> menuItem(new MenuItem(GetPtrToThisMenu(), name, onClick), [](MenuItem* menuItem)
+	std::shared_ptr<MenuItem> menuItem(new MenuItem(shared_from_this(), name, onClick), [](MenuItem* menuItem)
 	{
 		delete menuItem;
-	});
+	}, TaggedAllocator<MenuItem, MemoryTag::Menus>());
+
+	// X-Plane indices are plug-in relative, so the index
+	// of the new item lines up with our own list of entries
 	m_menuItems.push_back(menuItem);
 
-	// Add created menu item to master list
-	XP::MenuItem::m_menuItems.push_back(menuItem);
+	return menuItem;
+}
+
+std::weak_ptr<XP::MenuItem> XP::Menu::AppendMenuItemWithCommand(std::string name, std::weak_ptr<Command> command)
+{
+	// Create Menu Item
+	std::shared_ptr<MenuItem> menuItem(new MenuItem(shared_from_this(), name, command), [](MenuItem* menuItem)
+	{
+		delete menuItem;
+	}, TaggedAllocator<MenuItem, MemoryTag::Menus>());
+	m_menuItems.push_back(menuItem);
 
 	return menuItem;
 }
@@ -82,6 +98,9 @@ std::shared_ptr<XP::MenuItem> XP::Menu::AppendMenuItem(std::string name, std::fu
 void XP::Menu::AppendMenuSeparator()
 {
 	XPLMAppendMenuSeparator(m_id);
+
+	// Separators occupy an index within X-Plane
+	m_menuItems.push_back(nullptr);
 }
 
 bool XP::Menu::HasMenuItem(std::weak_ptr<MenuItem> menuItem)
@@ -92,65 +111,123 @@ bool XP::Menu::HasMenuItem(std::weak_ptr<MenuItem> menuItem)
 		return false;
 	}
 
-	// Search for given menu item
+	// Menu items know both their parent and their index
 	std::shared_ptr<MenuItem> lockedMenuItem = menuItem.lock();
-	return std::find(m_menuItems.begin(), m_menuItems.end(), lockedMenuItem) != m_menuItems.end();
+	int index = lockedMenuItem->GetIndex();
+
+	return index >= 0 &&
+		   index < static_cast<int>(m_menuItems.size()) &&
+		   m_menuItems[index] == lockedMenuItem;
 }
 
 void XP::Menu::RemoveMenuItem(std::weak_ptr<MenuItem> menuItem)
 {
-	// Ensure given argument isn't NULL
-	if (!menuItem.expired())
+	// Ensure given argument is a part of this menu
+	if (!HasMenuItem(menuItem))
 	{
-		std::shared_ptr<MenuItem> lockedItem = menuItem.lock();
-
-		// Remove given argument
-		auto firstReturnVal = std::remove_if(m_menuItems.begin(), m_menuItems.end(), [lockedItem](const std::shared_ptr<MenuItem>& menuItemToRemove)
-		{
-			return lockedItem == menuItemToRemove;
-		});
-		auto secondReturnVal = std::remove_if(XP::MenuItem::m_menuItems.begin(), XP::MenuItem::m_menuItems.end(), [lockedItem](const std::weak_ptr<MenuItem>& menuItemToRemove)
-		{
-			if (menuItemToRemove.expired())
-			{
-				return false;
-			}
-			else
-			{
-				std::shared_ptr<MenuItem> lockedItemToDelete = menuItemToRemove.lock();
-				return lockedItem == lockedItemToDelete;
-			}
-		});
+		return;
 	}
+
+	RemoveEntryAt(menuItem.lock()->GetIndex());
 }
 
 void XP::Menu::ClearAllMenuItems()
 {
+	XPLMClearAllMenuItems(m_id);
+
+	// Ensure removed menu items no longer refer to this menu
+	for (const std::shared_ptr<MenuItem>& menuItem : m_menuItems)
+	{
+		if (menuItem != nullptr)
+		{
+			menuItem->Detach();
+		}
+	}
 	m_menuItems.clear();
 }
 
-std::shared_ptr<XP::Menu> XP::Menu::GetPtrToThisMenu() const
+void XP::Menu::Rebuild(const std::vector<MenuItemDefinition>& definitions)
 {
-	// Find pointer to this menu
-	auto pointerItr = std::find_if(m_menus.begin(), m_menus.end(), [this](const std::weak_ptr<Menu>& menu)
+	// Reuse existing entries until the structure of the menu differs
+	size_t reusedCount	= std::min(m_menuItems.size(), definitions.size());
+	size_t index		= 0;
+	for (; index < reusedCount; ++index)
 	{
-		if (menu.expired())
+		const std::shared_ptr<MenuItem>& menuItem	= m_menuItems[index];
+		const MenuItemDefinition& definition		= definitions[index];
+
+		if ((menuItem == nullptr) != definition.isSeparator)
 		{
-			return false;
+			break;
 		}
-		else 
+
+		if (menuItem != nullptr)
 		{
-			std::shared_ptr<Menu> lockedMenu = menu.lock();
-			return lockedMenu.get() == this;
+			menuItem->Apply(definition);
 		}
-	});
-	// Ensure we found a pointer
-	if (pointerItr == m_menus.end())
+	}
+
+	// Remove the remaining entries, bottom first
+	TruncateEntries(static_cast<int>(index));
+
+	// Append the remaining definitions
+	for (; index < definitions.size(); ++index)
 	{
-		throw std::exception("Unable to find pointer to this menu");
+		const MenuItemDefinition& definition = definitions[index];
+		if (definition.isSeparator)
+		{
+			AppendMenuSeparator();
+			continue;
+		}
+
+		std::shared_ptr<MenuItem> menuItem = AppendMenuItem(definition.name, definition.onClick);
+		menuItem->Apply(definition);
+	}
+}
+
+std::shared_ptr<XP::MenuItem> XP::Menu::GetMenuItem(int index) const
+{
+	if (index < 0 || index >= static_cast<int>(m_menuItems.size()))
+	{
+		throw std::out_of_range("index is outside the bounds of this menu");
+	}
+
+	return m_menuItems[index];
+}
+
+void XP::Menu::RemoveEntryAt(int index)
+{
+	XPLMRemoveMenuItem(m_id, index);
+
+	if (m_menuItems[index] != nullptr)
+	{
+		m_menuItems[index]->Detach();
+	}
+	m_menuItems.erase(m_menuItems.begin() + index);
+
+	// X-Plane moves the remaining entries up by one
+	for (size_t i = static_cast<size_t>(index); i < m_menuItems.size(); ++i)
+	{
+		if (m_menuItems[i] != nullptr)
+		{
+			m_menuItems[i]->m_index = static_cast<int>(i);
+		}
 	}
+}
+
+void XP::Menu::TruncateEntries(int count)
+{
+	// Removing from the bottom up means no other indices move
+	for (int index = static_cast<int>(m_menuItems.size()) - 1; index >= count; --index)
+	{
+		XPLMRemoveMenuItem(m_id, index);
 
-	return (*pointerItr).lock();
+		if (m_menuItems[index] != nullptr)
+		{
+			m_menuItems[index]->Detach();
+		}
+		m_menuItems.pop_back();
+	}
 }
 
 std::shared_ptr<XP::Menu> XP::Menu::CreateAircraftMenu()
@@ -163,9 +240,7 @@ std::shared_ptr<XP::Menu> XP::Menu::CreateAircraftMenu()
 									   static_cast<void*>(menuID)), [](Menu* menu)
 	{
 		delete menu;
-	});
-	// Add created menu to master list
-	m_menus.push_back(menu);
+	}, TaggedAllocator<Menu, MemoryTag::Menus>());
 
 	return menu;
 }
@@ -181,9 +256,7 @@ std::shared_ptr<XP::Menu> XP::Menu::CreatePluginsMenu()
 										static_cast<void*>(menuID)), [](Menu* menu)
 	{
 		delete menu;
-	});
-	// Add created menu to master list
-	m_menus.push_back(menu);
+	}, TaggedAllocator<Menu, MemoryTag::Menus>());
 
 	return menu;
 }
@@ -198,6 +271,14 @@ void XP::Menu::MenuHandler(void* inMenuRef, void* inItemRef)
 		return;
 	}
 
+	// The handler may rebuild or remove this menu item (e.g. when
+	// changing pages), so keep both the item and the function alive
+	std::shared_ptr<MenuItem> lockedMenuItem	= menuItem->shared_from_this();
+	std::function<void(MenuItem&)> onClick		= menuItem->m_onClick;
+
 	// Execute onClick for given menu item
-	menuItem->m_onClick((*menuItem));
+	CallbackGuard::Invoke(CallbackType::Menu, menuItem, [&]()
+	{
+		onClick((*lockedMenuItem));
+	});
 }
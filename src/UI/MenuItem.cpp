@@ -9,29 +9,28 @@
 // XP++ includes
 #include "XP++/UI/Menu.hpp"
 #include "XP++/Exceptions/XPException.hpp"
-//#include "XP++/Commands/Command.hpp"
-
-std::list<std::weak_ptr<XP::MenuItem>> XP::MenuItem::m_menuItems;
+#include "XP++/Commands/Command.hpp"
 
 XP::MenuItem::MenuItem(std::weak_ptr<Menu> menu,
 					   std::string name,
 					   std::function<void(MenuItem&)> onClick) :
-	m_childMenu(nullptr), m_index(-1), m_isEnabled(false), 
-	m_name(name), m_onClick(onClick), m_parentMenu(nullptr)
+	m_childMenu(nullptr), m_index(-1), m_isEnabled(true), m_checkState(MenuCheck::NoCheck),
+	m_name(name), m_onClick(onClick), m_parentMenu(menu), m_parentMenuID(nullptr)
 {
 	// Ensure given menu isn't NULL
 	if (menu.expired())
 	{
 		throw std::invalid_argument("menu is NULL");
 	}
-	m_parentMenu = menu.lock();
 
 	// Lock given parent menu
 	std::shared_ptr<Menu> lockedMenu = menu.lock();
+	m_parentMenuID = lockedMenu->m_id;
+
 	// Create X-Plane menu item
-	m_index = XPLMAppendMenuItem(lockedMenu == nullptr ? nullptr : lockedMenu->m_id, 
-								 name.c_str(), 
-								 this, 
+	m_index = XPLMAppendMenuItem(m_parentMenuID,
+								 name.c_str(),
+								 this,
 								 NULL);
 
 	// Ensure X-Plane SDK call succeeded
@@ -41,108 +40,150 @@ XP::MenuItem::MenuItem(std::weak_ptr<Menu> menu,
 	}
 }
 
-XP::MenuItem::~MenuItem()
+XP::MenuItem::MenuItem(std::weak_ptr<Menu> menu,
+					   std::string name,
+					   std::weak_ptr<Command> command) :
+	m_childMenu(nullptr), m_index(-1), m_isEnabled(true), m_checkState(MenuCheck::NoCheck),
+	m_name(name), m_onClick(), m_parentMenu(menu), m_parentMenuID(nullptr)
 {
-	// Destroy child menu
-	if (m_childMenu != nullptr)
+	// Ensure arguments are valid
+	if (menu.expired())
+	{
+		throw std::invalid_argument("menu is NULL");
+	}
+	if (command.expired())
+	{
+		throw std::invalid_argument("command is NULL");
+	}
+
+	// Lock given parent menu
+	std::shared_ptr<Menu> lockedMenu = menu.lock();
+	m_parentMenuID = lockedMenu->m_id;
+
+	// Create X-Plane menu item, executing the command when clicked
+	m_index = XPLMAppendMenuItemWithCommand(m_parentMenuID,
+											name.c_str(),
+											command.lock()->GetID());
+
+	// Ensure X-Plane SDK call succeeded
+	if (m_index < 0)
 	{
-		m_childMenu.reset();
+		throw XPException("Unable to create X-Plane Menu Item");
 	}
+}
 
-	// Removing X-Plane internal MenuItem moves other menu items on same
-	// parent up by one, and assumes we're tracking this
-	XPLMRemoveMenuItem(m_parentMenu == nullptr ? nullptr : m_parentMenu->m_id, m_index);
+XP::MenuItem::~MenuItem()
+{
+	// Destroy child menu
+	DestroyChildMenu();
+
+	// The X-Plane menu item itself is removed by the parent menu,
+	// which holds a reference to this item until it is removed
 }
 
 std::shared_ptr<XP::Menu> XP::MenuItem::CreateChildMenu(std::string name)
 {
-	// Find this MenuItem's shared pointer
-	auto thisMenuInList = std::find_if(m_menuItems.begin(), m_menuItems.end(),
-									   [this](const std::weak_ptr<MenuItem>& menuItem)
+	// Only a single child menu may exist
+	if (m_childMenu != nullptr)
 	{
-		if (menuItem.expired())
-		{
-			return false;
-		}
-		else
-		{
-			std::shared_ptr<MenuItem> lockedMenuItem = menuItem.lock();
-			return lockedMenuItem.get() == this;
-		}
-	});
-	// Ensure this MenuItem's shared pointer exists within list
-	if (thisMenuInList == m_menuItems.end())
+		return m_childMenu;
+	}
+
+	// Ensure this menu item is still within a menu
+	if (m_parentMenuID == nullptr)
 	{
-		throw std::logic_error("Unable to find this MenuItem in list of created MenuItems");
+		throw std::logic_error("Unable to create a child menu for a removed MenuItem");
 	}
 
 	// Create Child Menu
-	m_childMenu = std::shared_ptr<Menu>(new Menu(name, (*thisMenuInList)), [](Menu* menu)
+	m_childMenu = std::shared_ptr<Menu>(new Menu(name, shared_from_this()), [](Menu* menu)
 	{
 		delete menu;
-	});
-
-	// Add created child menu to master list
-	Menu::m_menus.push_back(m_childMenu);
+	}, TaggedAllocator<Menu, MemoryTag::Menus>());
 
 	return m_childMenu;
 }
 
 void XP::MenuItem::DestroyChildMenu()
 {
-	// Remove child menu from master list
-	auto returnVal = std::remove_if(Menu::m_menus.begin(), Menu::m_menus.end(), [&](const std::weak_ptr<Menu>& menu)
-	{
-		if (menu.expired())
-		{
-			return false;
-		}
-		else
-		{
-			std::shared_ptr<Menu> lockedMenu = menu.lock();
-			return lockedMenu == m_childMenu;
-		}
-	});
-
 	// Destroy child menu
 	m_childMenu.reset();
 }
 
 void XP::MenuItem::SetName(std::string name)
 {
-	XPLMSetMenuItemName(m_parentMenu == nullptr ? nullptr : m_parentMenu->m_id, 
-						m_index, 
-						name.c_str(), 
-						NULL);
+	m_name = name;
+
+	if (m_parentMenuID != nullptr)
+	{
+		XPLMSetMenuItemName(m_parentMenuID,
+							m_index,
+							name.c_str(),
+							NULL);
+	}
 }
 
 void XP::MenuItem::Disable()
 {
-	XPLMEnableMenuItem(m_parentMenu == nullptr ? nullptr : m_parentMenu->m_id,
-					   m_index,
-					   TRUE);
+	m_isEnabled = false;
+
+	if (m_parentMenuID != nullptr)
+	{
+		XPLMEnableMenuItem(m_parentMenuID,
+						   m_index,
+						   FALSE);
+	}
 }
 
 void XP::MenuItem::Enable()
 {
-	XPLMEnableMenuItem(m_parentMenu == nullptr ? nullptr : m_parentMenu->m_id,
-					   m_index,
-					   FALSE);
+	m_isEnabled = true;
+
+	if (m_parentMenuID != nullptr)
+	{
+		XPLMEnableMenuItem(m_parentMenuID,
+						   m_index,
+						   TRUE);
+	}
 }
 
-XP::MenuCheck XP::MenuItem::GetCheckState() const
+void XP::MenuItem::SetCheckState(MenuCheck state)
 {
-	XPLMMenuCheck state;
-	XPLMCheckMenuItemState(m_parentMenu == nullptr ? nullptr : m_parentMenu->m_id,
-						   m_index,
-						   &state);
+	m_checkState = state;
 
-	return static_cast<MenuCheck>(state);
+	if (m_parentMenuID != nullptr)
+	{
+		XPLMCheckMenuItem(m_parentMenuID,
+						  m_index,
+						  static_cast<XPLMMenuCheck>(state));
+	}
 }
 
-void XP::MenuItem::SetCheckState(MenuCheck state)
+void XP::MenuItem::Apply(const MenuItemDefinition& definition)
+{
+	// Only call X-Plane for state which has changed
+	if (m_name != definition.name)
+	{
+		SetName(definition.name);
+	}
+	if (m_checkState != definition.checkState)
+	{
+		SetCheckState(definition.checkState);
+	}
+	if (m_isEnabled != definition.isEnabled)
+	{
+		definition.isEnabled ? Enable() : Disable();
+	}
+
+	m_onClick = definition.onClick;
+}
+
+void XP::MenuItem::Detach()
 {
-	XPLMCheckMenuItem(m_parentMenu == nullptr ? nullptr : m_parentMenu->m_id,
-					  m_index,
-					  static_cast<XPLMMenuCheck>(state));
+	// A child menu can't outlive the X-Plane menu item it hangs off
+	DestroyChildMenu();
+
+	m_parentMenu.reset();
+	m_parentMenuID	= nullptr;
+	m_index			= -1;
 }
@@ -0,0 +1,235 @@
+#include "XP++/UI/PagedMenu.hpp"
+
+// STL includes
+#include <algorithm>
+#include <cctype>
+#include <stdexcept>
+
+// XP++ includes
+#include "XP++/UI/Menu.hpp"
+#include "XP++/UI/MenuItem.hpp"
+
+XP::PagedMenu::PagedMenu(std::weak_ptr<Menu> menu,
+						 int pageSize,
+						 std::function<int()> getCount,
+						 std::function<std::string(int)> getName,
+						 std::function<void(int)> onSelect) :
+	m_menu(menu), m_pageSize(pageSize), m_page(0), m_count(0),
+	m_areBucketsEnabled(false), m_bucketCount(-1),
+	m_getCount(getCount), m_getName(getName), m_onSelect(onSelect)
+{
+	// Ensure arguments are valid
+	if (menu.expired())
+	{
+		throw std::invalid_argument("menu is NULL");
+	}
+	if (pageSize <= 0)
+	{
+		throw std::invalid_argument("pageSize must be greater than zero");
+	}
+	if (getCount == nullptr || getName == nullptr)
+	{
+		throw std::invalid_argument("getCount and getName must be assigned");
+	}
+}
+
+XP::PagedMenu::~PagedMenu()
+{
+	// Menu items refer back to this object, so remove them with it
+	std::shared_ptr<Menu> menu = m_menu.lock();
+	if (menu != nullptr)
+	{
+		menu->ClearAllMenuItems();
+	}
+}
+
+std::shared_ptr<XP::PagedMenu> XP::PagedMenu::Create(std::weak_ptr<Menu> menu,
+													 int pageSize,
+													 std::function<int()> getCount,
+													 std::function<std::string(int)> getName,
+													 std::function<void(int)> onSelect)
+{
+	std::shared_ptr<PagedMenu> pagedMenu(new PagedMenu(menu, pageSize, getCount, getName, onSelect), [](PagedMenu* pagedMenu)
+	{
+		delete pagedMenu;
+	});
+
+	// Start from an empty menu, then show the first page
+	menu.lock()->ClearAllMenuItems();
+	pagedMenu->Refresh();
+
+	return pagedMenu;
+}
+
+void XP::PagedMenu::Refresh()
+{
+	m_count = std::max(0, m_getCount());
+	ShowPage(m_page);
+}
+
+void XP::PagedMenu::ShowPage(int page)
+{
+	m_page = std::max(0, std::min(page, GetPageCount() - 1));
+	Build();
+}
+
+void XP::PagedMenu::ShowEntry(int index)
+{
+	ShowPage(index / m_pageSize);
+}
+
+int XP::PagedMenu::GetPageCount() const
+{
+	return std::max(1, (m_count + m_pageSize - 1) / m_pageSize);
+}
+
+void XP::PagedMenu::SetBucketsEnabled(bool enabled)
+{
+	if (m_areBucketsEnabled == enabled)
+	{
+		return;
+	}
+	m_areBucketsEnabled	= enabled;
+	m_bucketCount		= -1;
+
+	// The "Jump to" item owns a child menu, so it
+	// mustn't be reused for another item
+	std::shared_ptr<Menu> menu = m_menu.lock();
+	if (menu != nullptr)
+	{
+		menu->ClearAllMenuItems();
+		Build();
+	}
+}
+
+void XP::PagedMenu::Build()
+{
+	std::shared_ptr<Menu> menu = m_menu.lock();
+	if (menu == nullptr)
+	{
+		return;
+	}
+
+	int firstEntry	= m_page * m_pageSize;
+	int lastEntry	= std::min(firstEntry + m_pageSize, m_count);
+
+	std::vector<MenuItemDefinition> definitions;
+	definitions.reserve(static_cast<size_t>(m_pageSize) + 5);
+
+	// Navigation
+	if (m_areBucketsEnabled)
+	{
+		definitions.push_back(MenuItemDefinition("Jump to"));
+	}
+	definitions.push_back(MenuItemDefinition("< Previous page (" + std::to_string(m_page + 1) +
+											 " of " + std::to_string(GetPageCount()) + ")",
+											 [this](MenuItem&) { PreviousPage(); },
+											 MenuCheck::NoCheck,
+											 m_page > 0));
+	definitions.push_back(MenuItemDefinition::Separator());
+
+	// Entries of the current page
+	if (m_count == 0)
+	{
+		definitions.push_back(MenuItemDefinition("(Empty)",
+												 std::function<void(MenuItem&)>(),
+												 MenuCheck::NoCheck,
+												 false));
+	}
+	for (int index = firstEntry; index < lastEntry; ++index)
+	{
+		definitions.push_back(MenuItemDefinition(m_getName(index), [this, index](MenuItem&)
+		{
+			if (m_onSelect != nullptr)
+			{
+				m_onSelect(index);
+			}
+		}));
+	}
+
+	definitions.push_back(MenuItemDefinition::Separator());
+	definitions.push_back(MenuItemDefinition("Next page >",
+											 [this](MenuItem&) { NextPage(); },
+											 MenuCheck::NoCheck,
+											 m_page < GetPageCount() - 1));
+
+	menu->Rebuild(definitions);
+
+	if (m_areBucketsEnabled)
+	{
+		BuildBuckets(menu->GetMenuItem(0));
+	}
+}
+
+void XP::PagedMenu::BuildBuckets(std::shared_ptr<MenuItem> jumpToItem)
+{
+	// Buckets only change when the data source does
+	if (m_bucketCount == m_count && jumpToItem->HasChildMenu())
+	{
+		return;
+	}
+	m_bucketCount = m_count;
+
+	// Entries starting with a letter are bucketed by it, and bucket '#' holds
+	// every entry sorting before 'A' or after 'Z'
+	static const std::string letters = "ABCDEFGHIJKLMNOPQRSTUVWXYZ";
+
+	// First entry of each letter, followed by the first entry after 'Z'
+	std::vector<int> letterStarts;
+	letterStarts.reserve(letters.size() + 1);
+	for (char letter : letters)
+	{
+		letterStarts.push_back(FindFirstEntry(static_cast<unsigned char>(letter)));
+	}
+	letterStarts.push_back(FindFirstEntry(static_cast<unsigned char>('Z' + 1)));
+
+	std::vector<MenuItemDefinition> definitions;
+	int otherEntry = letterStarts.front() > 0 ? 0 : letterStarts.back() < m_count ? letterStarts.back() : -1;
+	if (otherEntry >= 0)
+	{
+		definitions.push_back(MenuItemDefinition("#", [this, otherEntry](MenuItem&)
+		{
+			ShowEntry(otherEntry);
+		}));
+	}
+	for (size_t letter = 0; letter < letters.size(); ++letter)
+	{
+		if (letterStarts[letter + 1] > letterStarts[letter])
+		{
+			int firstEntry = letterStarts[letter];
+			definitions.push_back(MenuItemDefinition(std::string(1, letters[letter]), [this, firstEntry](MenuItem&)
+			{
+				ShowEntry(firstEntry);
+			}));
+		}
+	}
+
+	jumpToItem->CreateChildMenu("Jump to")->Rebuild(definitions);
+}
+
+int XP::PagedMenu::FindFirstEntry(unsigned char letter) const
+{
+	// Binary search the (sorted) data source
+	int first = 0;
+	int count = m_count;
+	while (count > 0)
+	{
+		int step	= count / 2;
+		int middle	= first + step;
+
+		// Compared unsigned, so names starting with UTF-8 sequences sort after 'Z'
+		std::string name			= m_getName(middle);
+		unsigned char nameLetter	= name.empty() ? 0 : static_cast<unsigned char>(std::toupper(static_cast<unsigned char>(name[0])));
+		if (nameLetter < letter)
+		{
+			first = middle + 1;
+			count -= step + 1;
+		}
+		else
+		{
+			count = step;
+		}
+	}
+
+	return first;
+}
@@ -0,0 +1,167 @@
+// Benchmark of a command storm, such as bouncing hardware switches, dispatched
+// through XP::Command's shared handler table and through handlers registered
+// with X-Plane directly, which is the cost XP++ adds to
+
+// STL includes
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <string>
+#include <vector>
+
+// XP++ includes
+#include "XP++/Commands/Command.hpp"
+
+// X-Plane SDK includes
+#include "XPLMStandIn.hpp"
+#include "XPLMUtilities.h"
+
+namespace
+{
+	// Number of allocations made through the global operator new
+	std::atomic<uint64_t> g_allocationCount(0);
+
+	// Number of handler calls, by phase
+	uint64_t g_phaseCounts[3] = { 0, 0, 0 };
+
+	bool CountingHandler(XP::Command&, XP::CommandPhase phase, void* userData)
+	{
+		g_phaseCounts[static_cast<int>(phase)]++;
+		(*static_cast<uint64_t*>(userData))++;
+		return true;
+	}
+
+	int RawCountingHandler(XPLMCommandRef, XPLMCommandPhase phase, void* refcon)
+	{
+		g_phaseCounts[phase]++;
+		(*static_cast<uint64_t*>(refcon))++;
+		return 1;
+	}
+
+	typedef std::chrono::steady_clock Clock;
+
+	double NanosecondsPer(Clock::time_point start, uint64_t count)
+	{
+		return std::chrono::duration<double, std::nano>(Clock::now() - start).count() / static_cast<double>(count);
+	}
+}
+
+void* operator new(std::size_t size)
+{
+	g_allocationCount.fetch_add(1, std::memory_order_relaxed);
+	void* memory = std::malloc(size != 0 ? size : 1);
+	if (memory == nullptr)
+	{
+		throw std::bad_alloc();
+	}
+	return memory;
+}
+
+void operator delete(void* memory) noexcept
+{
+	std::free(memory);
+}
+
+int main(int argc, char** argv)
+{
+	bool isQuick = argc > 1 && std::strcmp(argv[1], "--quick") == 0;
+
+	// A panel's worth of commands, each with a handler before and after X-Plane's
+	const int commandCount		= 300;
+	const int bounceCount		= isQuick ? 20000 : 2000000;
+	const int heldFrameCount	= isQuick ? 100 : 10000;
+
+	XPLMStandIn::SetDebugEcho(false);
+
+	std::vector<std::shared_ptr<XP::Command>> commands;
+	std::vector<XPLMCommandRef> rawCommands;
+	std::vector<uint64_t> callCounts(commandCount, 0);
+	std::vector<uint64_t> rawCallCounts(commandCount, 0);
+	for (int i = 0; i < commandCount; ++i)
+	{
+		commands.push_back(XP::Command::CreateCommand("xpp/bench/switch_" + std::to_string(i), "Switch"));
+		rawCommands.push_back(XPLMCreateCommand(("xpp/bench/raw_switch_" + std::to_string(i)).c_str(), "Raw switch"));
+	}
+
+	// Register and unregister handlers, as when rebinding a panel
+	Clock::time_point start = Clock::now();
+	for (int i = 0; i < commandCount; ++i)
+	{
+		XP::CommandHandlerID before = commands[i]->RegisterHandler(CountingHandler, &callCounts[i], true);
+		XP::CommandHandlerID after = commands[i]->RegisterHandler(CountingHandler, &callCounts[i], false);
+		commands[i]->UnregisterHandler(after);
+		commands[i]->UnregisterHandler(before);
+	}
+	double registerTime = NanosecondsPer(start, 2 * commandCount);
+
+	for (int i = 0; i < commandCount; ++i)
+	{
+		commands[i]->RegisterHandler(CountingHandler, &callCounts[i], true);
+		commands[i]->RegisterHandler(CountingHandler, &callCounts[i], false);
+		XPLMRegisterCommandHandler(rawCommands[i], RawCountingHandler, 1, &rawCallCounts[i]);
+		XPLMRegisterCommandHandler(rawCommands[i], RawCountingHandler, 0, &rawCallCounts[i]);
+	}
+
+	// Switch bounce: every switch flips on and off again, over and over
+	uint64_t allocationCount = g_allocationCount.load();
+	start = Clock::now();
+	for (int i = 0; i < bounceCount; ++i)
+	{
+		XPLMCommandBegin(rawCommands[i % commandCount]);
+		XPLMCommandEnd(rawCommands[i % commandCount]);
+	}
+	double rawBounceTime = NanosecondsPer(start, 2 * static_cast<uint64_t>(bounceCount));
+
+	start = Clock::now();
+	for (int i = 0; i < bounceCount; ++i)
+	{
+		commands[i % commandCount]->Begin();
+		commands[i % commandCount]->End();
+	}
+	double bounceTime = NanosecondsPer(start, 2 * static_cast<uint64_t>(bounceCount));
+
+	// Every switch held down, dispatching its continue phase each frame
+	for (int i = 0; i < commandCount; ++i)
+	{
+		commands[i]->Begin();
+	}
+	start = Clock::now();
+	for (int i = 0; i < heldFrameCount; ++i)
+	{
+		XPLMStandIn::RunFrame();
+	}
+	double heldTime = NanosecondsPer(start, static_cast<uint64_t>(heldFrameCount) * commandCount);
+	for (int i = 0; i < commandCount; ++i)
+	{
+		commands[i]->End();
+	}
+	uint64_t dispatchAllocations = g_allocationCount.load() - allocationCount;
+
+	std::printf("Command storm over %d commands with 2 handlers each\n", commandCount);
+	std::printf("  Register + unregister:        %8.1f ns per handler\n", registerTime);
+	std::printf("  Switch bounce, raw XPLM:      %8.1f ns per phase\n", rawBounceTime);
+	std::printf("  Switch bounce, XP::Command:   %8.1f ns per phase\n", bounceTime);
+	std::printf("  Held, XP::Command:            %8.1f ns per command per frame\n", heldTime);
+	std::printf("  Allocations while dispatching: %llu\n", static_cast<unsigned long long>(dispatchAllocations));
+
+	// Every phase must have reached both handlers of its command, without allocating
+	bool isPassed = dispatchAllocations == 0;
+	for (int i = 0; i < commandCount; ++i)
+	{
+		uint64_t bounces		= bounceCount / commandCount + (i < bounceCount % commandCount ? 1 : 0);
+		uint64_t expectedCalls	= 2 * (2 * bounces + 2 + heldFrameCount);
+		isPassed				= isPassed && callCounts[i] == expectedCalls && rawCallCounts[i] == 4 * bounces;
+	}
+	isPassed = isPassed && g_phaseCounts[static_cast<int>(XP::CommandPhase::Continue)] == 2 * static_cast<uint64_t>(heldFrameCount) * commandCount;
+
+	if (!isPassed)
+	{
+		std::printf("FAILED: handlers weren't called as expected, or dispatching allocated\n");
+		return EXIT_FAILURE;
+	}
+	return EXIT_SUCCESS;
+}
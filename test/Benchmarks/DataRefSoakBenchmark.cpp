@@ -0,0 +1,102 @@
+// Soak benchmark of the DataRef registry over a long session, registering,
+// looking up and destroying datarefs while finding X-Plane's own, to show
+// lookup latency and memory stay flat
+
+// STL includes
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+// XP++ includes
+#include "XP++/DataAccess/DataRefType.hpp"
+#include "XP++/DataAccess/UserDataRef.hpp"
+#include "XP++/Diagnostics/MemoryTracker.hpp"
+
+// X-Plane SDK includes
+#include "XPLMDataAccess.h"
+#include "XPLMStandIn.hpp"
+
+int main(int argc, char** argv)
+{
+	bool isQuick = argc > 1 && std::strcmp(argv[1], "--quick") == 0;
+
+	const long cycleCount		= isQuick ? 20000 : 1000000;
+	const long reportInterval	= cycleCount / 10;
+	// Found datarefs are released every so often, as on an aircraft reload
+	const long releaseInterval	= 10000;
+
+	XPLMStandIn::SetDebugEcho(false);
+	std::vector<std::string> foundNames;
+	for (int i = 0; i < 200; ++i)
+	{
+		foundNames.push_back("sim/found/" + std::to_string(i));
+		XPLMStandIn::DefineDataRef(foundNames.back(), xplmType_Int);
+	}
+
+	std::printf("DataRef registry soak over %ld create/find/destroy cycles\n", cycleCount);
+
+	double lookupTime		= 0.0;
+	long lookupCount		= 0;
+	bool isPassed			= true;
+	size_t firstLiveBytes	= 0;
+	size_t largestRegistry	= 0;
+	for (long cycle = 1; cycle <= cycleCount; ++cycle)
+	{
+		std::string name = "soak/" + std::to_string(cycle);
+		std::shared_ptr<XP::UserDataRef> dataRef = XP::UserDataRef::RegisterDataAccessor(name, XP::DataRefType(1), false);
+
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		std::weak_ptr<XP::DataRef> found	= XP::DataRef::FindDataRef(foundNames[cycle % foundNames.size()]);
+		std::weak_ptr<XP::DataRef> owned	= XP::DataRef::FindDataRef(name);
+		lookupTime	+= std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+		lookupCount	+= 2;
+
+		if (found.expired() || owned.expired())
+		{
+			std::printf("FAILED: lookup failed at cycle %ld\n", cycle);
+			return EXIT_FAILURE;
+		}
+
+		if (cycle % releaseInterval == 0)
+		{
+			XP::DataRef::ReleaseFoundDataRefs();
+		}
+		largestRegistry = std::max(largestRegistry, XP::DataRef::GetRegistrySize());
+
+		if (cycle % reportInterval == 0)
+		{
+			XP::MemoryUsage usage = XP::MemoryTracker::GetUsage(XP::MemoryTag::DataRefs);
+			std::printf("  %8ld cycles: lookup %6.1f ns, registry %4zu entries, %zu bytes live in %zu allocations\n",
+						cycle, lookupTime / lookupCount, XP::DataRef::GetRegistrySize(), usage.liveBytes, usage.liveAllocations);
+
+			// Memory mustn't grow from one report to the next
+			if (firstLiveBytes == 0)
+			{
+				firstLiveBytes = usage.liveBytes;
+			}
+			else if (usage.liveBytes > 2 * firstLiveBytes)
+			{
+				isPassed = false;
+			}
+			lookupTime	= 0.0;
+			lookupCount	= 0;
+		}
+	}
+
+	// The registry only ever holds the found datarefs, the current one, and whatever awaits a sweep
+	if (largestRegistry > 4 * (foundNames.size() + 1))
+	{
+		isPassed = false;
+	}
+
+	if (!isPassed)
+	{
+		std::printf("FAILED: the registry grew over the session (largest %zu entries)\n", largestRegistry);
+		return EXIT_FAILURE;
+	}
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,253 @@
+// Benchmark of nearest navaid queries on a NavDatabase snapshot, against the
+// linear searches the SDK offers: XPLMFindNavAid for the nearest navaid, and
+// a walk over every navaid with XPLMGetNavAidInfo for the nearest few. Also
+// times handing the snapshot over to a reloaded plug-in instead of loading it
+
+// STL includes
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+// XP++ includes
+#include "XP++/Navigation/NavDatabase.hpp"
+#include "XP++/Plugins/StateHandoff.hpp"
+
+// X-Plane SDK includes
+#include "XPLMNavigation.h"
+#include "XPLMStandIn.hpp"
+
+namespace
+{
+	typedef std::chrono::steady_clock Clock;
+
+	double MicrosecondsPer(Clock::time_point start, int count)
+	{
+		return std::chrono::duration<double, std::micro>(Clock::now() - start).count() / count;
+	}
+
+	double GetDistance(double latitude1, double longitude1, double latitude2, double longitude2)
+	{
+		const double radiansPerDegree = 3.14159265358979323846 / 180.0;
+		latitude1 *= radiansPerDegree;
+		latitude2 *= radiansPerDegree;
+		double cosAngle = std::sin(latitude1) * std::sin(latitude2) +
+						  std::cos(latitude1) * std::cos(latitude2) * std::cos((longitude2 - longitude1) * radiansPerDegree);
+		return std::acos(std::max(-1.0, std::min(1.0, cosAngle))) * 6371008.8;
+	}
+
+	// The nearest navaids of a type, found by walking every navaid through the SDK
+	std::vector<std::pair<double, XPLMNavRef>> FindNearestBySDK(float latitude, float longitude, int count, XPLMNavType types)
+	{
+		std::vector<std::pair<double, XPLMNavRef>> found;
+		for (XPLMNavRef navRef = XPLMGetFirstNavAid(); navRef != XPLM_NAV_NOT_FOUND; navRef = XPLMGetNextNavAid(navRef))
+		{
+			XPLMNavType type		= xplm_Nav_Unknown;
+			float navLatitude		= 0.0f;
+			float navLongitude		= 0.0f;
+			XPLMGetNavAidInfo(navRef, &type, &navLatitude, &navLongitude, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr);
+			if ((type & types) != 0)
+			{
+				found.push_back(std::make_pair(GetDistance(latitude, longitude, navLatitude, navLongitude), navRef));
+			}
+		}
+
+		count = std::min(count, static_cast<int>(found.size()));
+		std::partial_sort(found.begin(), found.begin() + count, found.end());
+		found.resize(count);
+		return found;
+	}
+
+	// Distances found by the snapshot are single precision
+	bool IsSameDistance(double expected, double actual)
+	{
+		return std::fabs(expected - actual) <= 1.0 + expected * 1e-5;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	bool isQuick = argc > 1 && std::strcmp(argv[1], "--quick") == 0;
+
+	const int navAidCount	= isQuick ? 20000 : 200000;
+	const int sdkQueryCount	= isQuick ? 50 : 100;
+	const int queryCount	= isQuick ? 2000 : 200000;
+
+	// Navaids spread over the globe, mostly fixes, like X-Plane's database
+	std::mt19937 random(1);
+	std::uniform_real_distribution<float> latitudes(-90.0f, 90.0f);
+	std::uniform_real_distribution<float> longitudes(-180.0f, 180.0f);
+	for (int i = 0; i < navAidCount; ++i)
+	{
+		int kind			= i % 20;
+		XPLMNavType type	= kind < 4 ? xplm_Nav_Airport : kind == 4 ? xplm_Nav_VOR : kind == 5 ? xplm_Nav_NDB : xplm_Nav_Fix;
+		XPLMStandIn::AddNavAid(type, latitudes(random), longitudes(random), "ID" + std::to_string(i), "Navaid " + std::to_string(i));
+	}
+
+	Clock::time_point start = Clock::now();
+	std::shared_ptr<const XP::NavSnapshot> snapshot = XP::NavDatabase::Load();
+	double loadTime = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+	std::vector<std::pair<float, float>> positions;
+	for (int i = 0; i < queryCount; ++i)
+	{
+		positions.push_back(std::make_pair(latitudes(random), longitudes(random)));
+	}
+
+	// Nearest VOR
+	start = Clock::now();
+	std::vector<XPLMNavRef> sdkNearest;
+	for (int i = 0; i < sdkQueryCount; ++i)
+	{
+		sdkNearest.push_back(XPLMFindNavAid(nullptr, nullptr, &positions[i].first, &positions[i].second, nullptr, xplm_Nav_VOR));
+	}
+	double sdkNearestTime = MicrosecondsPer(start, sdkQueryCount);
+
+	start = Clock::now();
+	size_t matchCount = 0;
+	for (int i = 0; i < queryCount; ++i)
+	{
+		matchCount += snapshot->FindNearest(positions[i].first, positions[i].second, 1, XP::NavAidType::VOR).size();
+	}
+	double nearestTime = MicrosecondsPer(start, queryCount);
+
+	// Nearest 10 fixes
+	start = Clock::now();
+	std::vector<std::vector<std::pair<double, XPLMNavRef>>> sdkNearestFixes;
+	for (int i = 0; i < sdkQueryCount; ++i)
+	{
+		sdkNearestFixes.push_back(FindNearestBySDK(positions[i].first, positions[i].second, 10, xplm_Nav_Fix));
+	}
+	double sdkNearestFixesTime = MicrosecondsPer(start, sdkQueryCount);
+
+	start = Clock::now();
+	for (int i = 0; i < queryCount; ++i)
+	{
+		matchCount += snapshot->FindNearest(positions[i].first, positions[i].second, 10, XP::NavAidType::Fix).size();
+	}
+	double nearestFixesTime = MicrosecondsPer(start, queryCount);
+
+	// Airports within 200 km
+	start = Clock::now();
+	for (int i = 0; i < queryCount; ++i)
+	{
+		matchCount += snapshot->FindWithinRadius(positions[i].first, positions[i].second, 200000.0, XP::NavAidType::Airport).size();
+	}
+	double radiusTime = MicrosecondsPer(start, queryCount);
+
+	// Hand the snapshot over as on a plug-in reload, which must attach to it rather than load it again
+	const char* handoffPath = "NavSearchBenchmark.handoff";
+	start = Clock::now();
+	bool isHandedOff = XP::NavDatabase::Save(handoffPath, 1);
+	double saveTime = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+	XP::NavDatabase::Unload();
+	start = Clock::now();
+	std::shared_ptr<const XP::NavSnapshot> attached = XP::NavDatabase::Attach(handoffPath, 1);
+	double attachTime = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+	isHandedOff = isHandedOff && attached != nullptr && XP::NavDatabase::GetSnapshot() == attached &&
+				  XP::NavDatabase::Attach(handoffPath, 2) == nullptr && XP::NavDatabase::GetSnapshot() == attached;
+
+	std::printf("Navaid search over %d navaids (%zu matches)\n", navAidCount, matchCount);
+	std::printf("  Snapshot load:                 %10.1f ms\n", loadTime);
+	std::printf("  Snapshot save for handoff:     %10.1f ms\n", saveTime);
+	std::printf("  Snapshot attach after reload:  %10.1f ms\n", attachTime);
+	std::printf("  Nearest VOR, XPLMFindNavAid:   %10.2f us per query\n", sdkNearestTime);
+	std::printf("  Nearest VOR, snapshot:         %10.2f us per query\n", nearestTime);
+	std::printf("  Nearest 10 fixes, SDK walk:    %10.2f us per query\n", sdkNearestFixesTime);
+	std::printf("  Nearest 10 fixes, snapshot:    %10.2f us per query\n", nearestFixesTime);
+	std::printf("  Airports within 200 km:        %10.2f us per query\n", radiusTime);
+
+	// The snapshot must find the same navaids as the SDK searches, give or take ties
+	int mismatchCount = 0;
+	for (int i = 0; i < sdkQueryCount; ++i)
+	{
+		float latitude	= positions[i].first;
+		float longitude	= positions[i].second;
+
+		std::vector<XP::NavAidMatch> nearest = snapshot->FindNearest(latitude, longitude, 1, XP::NavAidType::VOR);
+		float sdkLatitude	= 0.0f;
+		float sdkLongitude	= 0.0f;
+		XPLMGetNavAidInfo(sdkNearest[i], nullptr, &sdkLatitude, &sdkLongitude, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr);
+		if (nearest.size() != 1 || !IsSameDistance(GetDistance(latitude, longitude, sdkLatitude, sdkLongitude), nearest[0].distance))
+		{
+			mismatchCount++;
+		}
+
+		std::vector<XP::NavAidMatch> nearestFixes = snapshot->FindNearest(latitude, longitude, 10, XP::NavAidType::Fix);
+		if (nearestFixes.size() != sdkNearestFixes[i].size())
+		{
+			mismatchCount++;
+			continue;
+		}
+		for (size_t j = 0; j < nearestFixes.size(); ++j)
+		{
+			if (!IsSameDistance(sdkNearestFixes[i][j].first, nearestFixes[j].distance))
+			{
+				mismatchCount++;
+			}
+		}
+
+		std::vector<XP::NavAidMatch> airports = snapshot->FindWithinRadius(latitude, longitude, 200000.0, XP::NavAidType::Airport);
+		std::vector<std::pair<double, XPLMNavRef>> sdkAirports = FindNearestBySDK(latitude, longitude, navAidCount, xplm_Nav_Airport);
+		// Airports within a meter of the radius may fall either side of it
+		size_t sdkAirportCount = 0;
+		while (sdkAirportCount < sdkAirports.size() && sdkAirports[sdkAirportCount].first <= 200000.0 - 1.0)
+		{
+			sdkAirportCount++;
+		}
+		size_t sdkAirportLimit = sdkAirportCount;
+		while (sdkAirportLimit < sdkAirports.size() && sdkAirports[sdkAirportLimit].first <= 200000.0 + 1.0)
+		{
+			sdkAirportLimit++;
+		}
+		if (airports.size() < sdkAirportCount || airports.size() > sdkAirportLimit)
+		{
+			mismatchCount++;
+		}
+	}
+
+	// The attached snapshot must answer exactly as the one it was saved from
+	int handoffMismatchCount = 0;
+	for (int i = 0; isHandedOff && i < sdkQueryCount; ++i)
+	{
+		std::vector<XP::NavAidMatch> expected	= snapshot->FindNearest(positions[i].first, positions[i].second, 10);
+		std::vector<XP::NavAidMatch> actual		= attached->FindNearest(positions[i].first, positions[i].second, 10);
+		if (expected.size() != actual.size())
+		{
+			handoffMismatchCount++;
+			continue;
+		}
+		for (size_t j = 0; j < expected.size(); ++j)
+		{
+			if (expected[j].index != actual[j].index || expected[j].distance != actual[j].distance ||
+				std::string(snapshot->GetID(expected[j].index)) != attached->GetID(actual[j].index) ||
+				std::string(snapshot->GetName(expected[j].index)) != attached->GetName(actual[j].index))
+			{
+				handoffMismatchCount++;
+			}
+		}
+	}
+	attached.reset();
+	XP::NavDatabase::Unload();
+	XP::StateHandoff::Discard(handoffPath);
+
+	if (!isHandedOff || handoffMismatchCount != 0)
+	{
+		std::printf("FAILED: the handed off snapshot didn't match (%d queries)\n", handoffMismatchCount);
+		return EXIT_FAILURE;
+	}
+	if (mismatchCount != 0)
+	{
+		std::printf("FAILED: %d queries didn't match the SDK search\n", mismatchCount);
+		return EXIT_FAILURE;
+	}
+	return EXIT_SUCCESS;
+}
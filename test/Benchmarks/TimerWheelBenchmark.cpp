@@ -0,0 +1,185 @@
+// Benchmark of inserting, cancelling and firing timers on a TimerWheel, after
+// checking that timers driven by its flight loop fire on time, and only once
+
+// STL includes
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <random>
+#include <thread>
+#include <vector>
+
+// XP++ includes
+#include "XP++/Processing/TimerWheel.hpp"
+
+// X-Plane SDK includes
+#include "XPLMDataAccess.h"
+#include "XPLMStandIn.hpp"
+
+namespace
+{
+	typedef std::chrono::steady_clock Clock;
+
+	double NanosecondsPer(Clock::time_point start, size_t count)
+	{
+		return std::chrono::duration<double, std::nano>(Clock::now() - start).count() / static_cast<double>(count);
+	}
+}
+
+int main(int argc, char** argv)
+{
+	bool isQuick = argc > 1 && std::strcmp(argv[1], "--quick") == 0;
+
+	const double tickLength		= 0.01;
+	const int checkedCount		= isQuick ? 2000 : 20000;
+	const double longestDelay	= isQuick ? 600.0 : 50000.0;
+	const size_t timerCount		= isQuick ? 20000 : 1000000;
+	const double timerSpan		= 600.0;
+
+	XPLMStandIn::SetDebugEcho(false);
+	XPLMStandIn::DefineDataRef("sim/time/total_running_time_sec", xplmType_Float);
+	XPLMDataRef simTimeDataRef = XPLMFindDataRef("sim/time/total_running_time_sec");
+
+	// Timers from 7 ms to the longest delay, a third of them cancelled, fired by the
+	// wheel's own flight loop over uneven frames
+	std::shared_ptr<XP::TimerWheel> timerWheel = XP::TimerWheel::Create(tickLength);
+	std::mt19937 random(1);
+	std::uniform_real_distribution<double> logDelays(-5.0, std::log(longestDelay));
+	double simTime = 0.0;
+	std::vector<double> dueTimes(checkedCount);
+	std::vector<double> firedTimes(checkedCount, -1.0);
+	std::vector<int> fireCounts(checkedCount, 0);
+	std::vector<XP::TimerID> timerIDs(checkedCount);
+	for (int i = 0; i < checkedCount; ++i)
+	{
+		dueTimes[i] = std::exp(logDelays(random));
+		timerIDs[i] = timerWheel->After(XP::TimerClock::Sim, dueTimes[i], [&, i]()
+		{
+			firedTimes[i] = simTime;
+			fireCounts[i]++;
+		});
+	}
+	std::vector<bool> isCancelled(checkedCount, false);
+	for (int i = 0; i < checkedCount; i += 3)
+	{
+		isCancelled[i] = timerWheel->Cancel(timerIDs[i]);
+	}
+
+	// A periodic timer cancelling itself, and a timer re-adding itself
+	int periodicCount	= 0;
+	XP::TimerID periodicID = timerWheel->Every(XP::TimerClock::Sim, 0.5, [&]()
+	{
+		if (++periodicCount == 10)
+		{
+			timerWheel->Cancel(periodicID);
+		}
+	});
+	int chainedCount	= 0;
+	std::function<void()> chained = [&]()
+	{
+		if (++chainedCount < 5)
+		{
+			timerWheel->After(XP::TimerClock::Sim, 1.0, chained);
+		}
+	};
+	timerWheel->After(XP::TimerClock::Sim, 1.0, chained);
+	bool isWallFired = false;
+	timerWheel->After(XP::TimerClock::Wall, 0.0, [&]()
+	{
+		isWallFired = true;
+	});
+
+	// Frames of 1/60 s, with every fifth frame a 0.5 s stutter
+	const double longestFrame = 31.0 / 60.0;
+	for (int frame = 0; simTime < longestDelay + 1.0; ++frame)
+	{
+		simTime += frame % 5 == 0 ? longestFrame : 1.0 / 60.0;
+		XPLMSetDataf(simTimeDataRef, static_cast<float>(simTime));
+		XPLMStandIn::RunFrame();
+	}
+
+	// The wall clock only moves on in real time, so wait up to a second for its first tick
+	for (int frame = 0; !isWallFired && frame < 100; ++frame)
+	{
+		std::this_thread::sleep_for(std::chrono::milliseconds(10));
+		XPLMStandIn::RunFrame();
+	}
+
+	// Timers may fire up to a tick plus a frame late, allowing for the float dataref
+	int lateCount		= 0;
+	int misfiredCount	= 0;
+	for (int i = 0; i < checkedCount; ++i)
+	{
+		if (isCancelled[i])
+		{
+			misfiredCount += fireCounts[i];
+		}
+		else if (fireCounts[i] != 1)
+		{
+			misfiredCount++;
+		}
+		else if (firedTimes[i] < dueTimes[i] - 0.01 || firedTimes[i] > dueTimes[i] + tickLength + longestFrame + 0.01)
+		{
+			lateCount++;
+		}
+	}
+
+	// Throughput, over timers spread across 10 minutes, with half of them cancelled
+	std::shared_ptr<XP::TimerWheel> benchmarkWheel = XP::TimerWheel::Create(tickLength);
+	std::uniform_real_distribution<double> delays(0.0, timerSpan);
+	std::vector<double> benchmarkDelays(timerCount);
+	for (double& delay : benchmarkDelays)
+	{
+		delay = delays(random);
+	}
+	std::vector<XP::TimerID> benchmarkIDs(timerCount);
+	size_t firedCount = 0;
+
+	Clock::time_point start = Clock::now();
+	for (size_t i = 0; i < timerCount; ++i)
+	{
+		benchmarkIDs[i] = benchmarkWheel->After(XP::TimerClock::Sim, benchmarkDelays[i], [&firedCount]()
+		{
+			firedCount++;
+		});
+	}
+	double insertTime = NanosecondsPer(start, timerCount);
+
+	start = Clock::now();
+	for (size_t i = 0; i < timerCount; i += 2)
+	{
+		benchmarkWheel->Cancel(benchmarkIDs[i]);
+	}
+	double cancelTime = NanosecondsPer(start, timerCount / 2);
+
+	start = Clock::now();
+	double benchmarkTime = benchmarkWheel->GetTime(XP::TimerClock::Sim);
+	int frameCount = 0;
+	while (benchmarkWheel->GetPendingCount() != 0)
+	{
+		benchmarkTime += 1.0 / 60.0;
+		benchmarkWheel->Advance(XP::TimerClock::Sim, benchmarkTime);
+		frameCount++;
+	}
+	double fireTime = NanosecondsPer(start, timerCount - timerCount / 2);
+
+	std::printf("Timer wheel with %.0f ms ticks\n", tickLength * 1000.0);
+	std::printf("  %d timers up to %.0f s: %d late, %d misfired, %d periodic, %d chained\n",
+				checkedCount, longestDelay, lateCount, misfiredCount, periodicCount, chainedCount);
+	std::printf("  %zu timers over %.0f s (%d frames)\n", timerCount, timerSpan, frameCount);
+	std::printf("    Insert:  %8.1f ns per timer\n", insertTime);
+	std::printf("    Cancel:  %8.1f ns per timer\n", cancelTime);
+	std::printf("    Fire:    %8.1f ns per timer, frames included\n", fireTime);
+
+	if (lateCount != 0 || misfiredCount != 0 || periodicCount != 10 || chainedCount != 5 || !isWallFired ||
+		firedCount != timerCount - (timerCount + 1) / 2)
+	{
+		std::printf("FAILED: timers didn't fire as expected\n");
+		return EXIT_FAILURE;
+	}
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,11 @@
+#pragma once
+
+/*
+ * Stand-in for the X-Plane SDK, declaring only what XP++ uses so it can be
+ * built and tested without X-Plane. Implemented by XPLMStandIn.cpp.
+ */
+
+typedef int XPLMPluginID;
+
+#define XPLM_NO_PLUGIN_ID	(-1)
+#define XPLM_PLUGIN_XPLANE	(0)
@@ -0,0 +1,6 @@
+#pragma once
+
+#include "XPLMDefs.h"
+
+void XPLMWorldToLocal(double inLatitude, double inLongitude, double inAltitude, double* outX, double* outY, double* outZ);
+void XPLMLocalToWorld(double inX, double inY, double inZ, double* outLatitude, double* outLongitude, double* outAltitude);
@@ -0,0 +1,9 @@
+#pragma once
+
+#include "XPLMScenery.h"
+
+typedef void* XPLMInstanceRef;
+
+XPLMInstanceRef XPLMCreateInstance(XPLMObjectRef inObject, const char** inDataRefs);
+void XPLMDestroyInstance(XPLMInstanceRef inInstance);
+void XPLMInstanceSetPosition(XPLMInstanceRef inInstance, const XPLMDrawInfo_t* inNewPosition, const float* inData);
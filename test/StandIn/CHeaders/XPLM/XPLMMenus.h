@@ -0,0 +1,35 @@
+#pragma once
+
+#include "XPLMDefs.h"
+#include "XPLMUtilities.h"
+
+typedef int XPLMMenuCheck;
+enum
+{
+	xplm_Menu_NoCheck	= 0,
+	xplm_Menu_Unchecked	= 1,
+	xplm_Menu_Checked	= 2
+};
+
+typedef void* XPLMMenuID;
+
+typedef void (*XPLMMenuHandler_f)(void* inMenuRef, void* inItemRef);
+
+XPLMMenuID XPLMFindPluginsMenu();
+XPLMMenuID XPLMFindAircraftMenu();
+XPLMMenuID XPLMCreateMenu(const char* inName, XPLMMenuID inParentMenu, int inParentItem, XPLMMenuHandler_f inHandler, void* inMenuRef);
+void XPLMDestroyMenu(XPLMMenuID inMenuID);
+void XPLMClearAllMenuItems(XPLMMenuID inMenuID);
+int XPLMAppendMenuItem(XPLMMenuID inMenu, const char* inItemName, void* inItemRef, int inDeprecatedAndIgnored);
+int XPLMAppendMenuItemWithCommand(XPLMMenuID inMenu, const char* inItemName, XPLMCommandRef inCommandToExecute);
+void XPLMAppendMenuSeparator(XPLMMenuID inMenu);
+void XPLMSetMenuItemName(XPLMMenuID inMenu, int inIndex, const char* inItemName, int inDeprecatedAndIgnored);
+void XPLMCheckMenuItem(XPLMMenuID inMenu, int index, XPLMMenuCheck inCheck);
+void XPLMCheckMenuItemState(XPLMMenuID inMenu, int index, XPLMMenuCheck* outCheck);
+void XPLMEnableMenuItem(XPLMMenuID inMenu, int index, int enabled);
+void XPLMRemoveMenuItem(XPLMMenuID inMenu, int inIndex);
+
+#ifndef TRUE
+#define TRUE	1
+#define FALSE	0
+#endif
@@ -0,0 +1,44 @@
+#pragma once
+
+#include "XPLMDefs.h"
+
+typedef int XPLMNavType;
+enum
+{
+	xplm_Nav_Unknown		= 0,
+	xplm_Nav_Airport		= 1,
+	xplm_Nav_NDB			= 2,
+	xplm_Nav_VOR			= 4,
+	xplm_Nav_ILS			= 8,
+	xplm_Nav_Localizer		= 16,
+	xplm_Nav_GlideSlope		= 32,
+	xplm_Nav_OuterMarker	= 64,
+	xplm_Nav_MiddleMarker	= 128,
+	xplm_Nav_InnerMarker	= 256,
+	xplm_Nav_Fix			= 512,
+	xplm_Nav_DME			= 1024,
+	xplm_Nav_LatLon			= 2048
+};
+
+typedef int XPLMNavRef;
+
+#define XPLM_NAV_NOT_FOUND	(-1)
+
+XPLMNavRef XPLMGetFirstNavAid();
+XPLMNavRef XPLMGetNextNavAid(XPLMNavRef inNavAidRef);
+void XPLMGetNavAidInfo(XPLMNavRef inRef,
+					   XPLMNavType* outType,
+					   float* outLatitude,
+					   float* outLongitude,
+					   float* outHeight,
+					   int* outFrequency,
+					   float* outHeading,
+					   char* outID,
+					   char* outName,
+					   char* outReg);
+XPLMNavRef XPLMFindNavAid(const char* inNameFragment,
+						  const char* inIDFragment,
+						  float* inLat,
+						  float* inLon,
+						  int* inFrequency,
+						  XPLMNavType inType);
@@ -0,0 +1,11 @@
+#pragma once
+
+#include "XPLMDefs.h"
+
+typedef void (*XPLMPlanesAvailable_f)(void* inRefcon);
+
+void XPLMCountAircraft(int* outTotalAircraft, int* outActiveAircraft, XPLMPluginID* outController);
+int XPLMAcquirePlanes(char** inAircraft, XPLMPlanesAvailable_f inCallback, void* inRefcon);
+void XPLMReleasePlanes();
+void XPLMSetActiveAircraftCount(int inCount);
+void XPLMDisableAIForPlane(int inPlaneIndex);
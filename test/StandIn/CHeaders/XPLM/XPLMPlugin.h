@@ -0,0 +1,21 @@
+#pragma once
+
+#include "XPLMDefs.h"
+
+XPLMPluginID XPLMGetMyID();
+int XPLMCountPlugins();
+XPLMPluginID XPLMGetNthPlugin(int inIndex);
+XPLMPluginID XPLMFindPluginByPath(const char* inPath);
+XPLMPluginID XPLMFindPluginBySignature(const char* inSignature);
+void XPLMGetPluginInfo(XPLMPluginID inPlugin, char* outName, char* outFilePath, char* outSignature, char* outDescription);
+int XPLMIsPluginEnabled(XPLMPluginID inPluginID);
+int XPLMEnablePlugin(XPLMPluginID inPluginID);
+void XPLMDisablePlugin(XPLMPluginID inPluginID);
+void XPLMReloadPlugins();
+void XPLMSendMessageToPlugin(XPLMPluginID inPlugin, int inMessage, void* inParam);
+
+int XPLMHasFeature(const char* inFeature);
+int XPLMIsFeatureEnabled(const char* inFeature);
+void XPLMEnableFeature(const char* inFeature, int inEnable);
+typedef void (*XPLMFeatureEnumerator_f)(const char* inFeature, void* inRef);
+void XPLMEnumerateFeatures(XPLMFeatureEnumerator_f inEnumerator, void* inRef);
@@ -0,0 +1,30 @@
+#pragma once
+
+#include "XPLMDefs.h"
+
+typedef int XPLMFlightLoopPhaseType;
+enum
+{
+	xplm_FlightLoop_Phase_BeforeFlightModel	= 0,
+	xplm_FlightLoop_Phase_AfterFlightModel	= 1
+};
+
+typedef void* XPLMFlightLoopID;
+
+typedef float (*XPLMFlightLoop_f)(float inElapsedSinceLastCall, float inElapsedTimeSinceLastFlightLoop, int inCounter, void* inRefcon);
+
+typedef struct
+{
+	int structSize;
+	XPLMFlightLoopPhaseType phase;
+	XPLMFlightLoop_f callbackFunc;
+	void* refcon;
+} XPLMCreateFlightLoop_t;
+
+float XPLMGetElapsedTime();
+int XPLMGetCycleNumber();
+
+XPLMFlightLoopID XPLMCreateFlightLoop(XPLMCreateFlightLoop_t* inParams);
+void XPLMDestroyFlightLoop(XPLMFlightLoopID inFlightLoopID);
+void XPLMScheduleFlightLoop(XPLMFlightLoopID inFlightLoopID, float inInterval, int inRelativeToNow);
+void XPLMSetFlightLoopCallbackInterval(XPLMFlightLoop_f inFlightLoop, float inInterval, int inRelativeToNow, void* inRefcon);
@@ -0,0 +1,54 @@
+#pragma once
+
+#include "XPLMDefs.h"
+
+typedef int XPLMProbeType;
+enum
+{
+	xplm_ProbeY	= 0
+};
+
+typedef int XPLMProbeResult;
+enum
+{
+	xplm_ProbeHitTerrain	= 0,
+	xplm_ProbeError			= 1,
+	xplm_ProbeMissed		= 2
+};
+
+typedef void* XPLMProbeRef;
+
+typedef struct
+{
+	int structSize;
+	float locationX;
+	float locationY;
+	float locationZ;
+	float normalX;
+	float normalY;
+	float normalZ;
+	float velocityX;
+	float velocityY;
+	float velocityZ;
+	int is_wet;
+} XPLMProbeInfo_t;
+
+XPLMProbeRef XPLMCreateProbe(XPLMProbeType inProbeType);
+void XPLMDestroyProbe(XPLMProbeRef inProbe);
+XPLMProbeResult XPLMProbeTerrainXYZ(XPLMProbeRef inProbe, float inX, float inY, float inZ, XPLMProbeInfo_t* outInfo);
+
+typedef void* XPLMObjectRef;
+
+typedef struct
+{
+	int structSize;
+	float x;
+	float y;
+	float z;
+	float pitch;
+	float heading;
+	float roll;
+} XPLMDrawInfo_t;
+
+XPLMObjectRef XPLMLoadObject(const char* inPath);
+void XPLMUnloadObject(XPLMObjectRef inObject);
@@ -0,0 +1,27 @@
+#pragma once
+
+#include "XPLMDefs.h"
+
+typedef void* XPLMCommandRef;
+
+typedef int XPLMCommandPhase;
+enum
+{
+	xplm_CommandBegin		= 0,
+	xplm_CommandContinue	= 1,
+	xplm_CommandEnd			= 2
+};
+
+typedef int (*XPLMCommandCallback_f)(XPLMCommandRef inCommand, XPLMCommandPhase inPhase, void* inRefcon);
+
+void XPLMDebugString(const char* inString);
+void XPLMGetSystemPath(char* outSystemPath);
+void XPLMGetPrefsPath(char* outPrefsPath);
+
+XPLMCommandRef XPLMFindCommand(const char* inName);
+void XPLMCommandBegin(XPLMCommandRef inCommand);
+void XPLMCommandEnd(XPLMCommandRef inCommand);
+void XPLMCommandOnce(XPLMCommandRef inCommand);
+XPLMCommandRef XPLMCreateCommand(const char* inName, const char* inDescription);
+void XPLMRegisterCommandHandler(XPLMCommandRef inComand, XPLMCommandCallback_f inHandler, int inBefore, void* inRefcon);
+void XPLMUnregisterCommandHandler(XPLMCommandRef inComand, XPLMCommandCallback_f inHandler, int inBefore, void* inRefcon);
@@ -0,0 +1,1046 @@
+#include "XPLMStandIn.hpp"
+
+// STL includes
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+// X-Plane SDK includes
+#include "XPLMDataAccess.h"
+#include "XPLMGraphics.h"
+#include "XPLMInstance.h"
+#include "XPLMMenus.h"
+#include "XPLMNavigation.h"
+#include "XPLMPlanes.h"
+#include "XPLMPlugin.h"
+#include "XPLMProcessing.h"
+#include "XPLMScenery.h"
+#include "XPLMUtilities.h"
+
+namespace
+{
+	// Meters per degree, for the flat projection between world and local coordinates
+	const double MetersPerDegree = 111319.49;
+
+	struct DataRefEntry
+	{
+		std::string name;
+		XPLMDataTypeID types;
+		bool isWritable;
+
+		// Accessors, when registered by a plug-in
+		XPLMGetDatai_f readInt;
+		XPLMSetDatai_f writeInt;
+		XPLMGetDataf_f readFloat;
+		XPLMSetDataf_f writeFloat;
+		XPLMGetDatad_f readDouble;
+		XPLMSetDatad_f writeDouble;
+		XPLMGetDatavi_f readIntArray;
+		XPLMSetDatavi_f writeIntArray;
+		XPLMGetDatavf_f readFloatArray;
+		XPLMSetDatavf_f writeFloatArray;
+		XPLMGetDatab_f readData;
+		XPLMSetDatab_f writeData;
+		void* readRefcon;
+		void* writeRefcon;
+
+		// Values, when owned by the sim
+		int intValue;
+		float floatValue;
+		double doubleValue;
+		std::vector<int> intValues;
+		std::vector<float> floatValues;
+		std::vector<char> dataValue;
+	};
+
+	struct FlightLoopEntry
+	{
+		XPLMCreateFlightLoop_t params;
+		bool isScheduled;
+		// Due by cycle number for negative intervals, otherwise by time
+		bool isDueByCycle;
+		int dueCycle;
+		double dueTime;
+		double lastCallTime;
+	};
+
+	struct CommandHandler
+	{
+		XPLMCommandCallback_f callback;
+		int before;
+		void* refcon;
+	};
+
+	struct CommandEntry
+	{
+		std::string name;
+		std::vector<CommandHandler> handlers;
+		bool isHeld;
+	};
+
+	struct NavAid
+	{
+		XPLMNavType type;
+		float latitude;
+		float longitude;
+		std::string id;
+		std::string name;
+	};
+
+	struct StandInState
+	{
+		StandInState() :
+			elapsedTime(0.0), frameTime(0.0f), cycleNumber(0), dataRefs(), dataRefNames(), flightLoops(), commands(),
+			heightfield(), probeCount(0), navAids(), menuItemCounts(), lastHandle(0), isDebugEchoed(true) {}
+
+		double elapsedTime;
+		float frameTime;
+		int cycleNumber;
+
+		// Live datarefs, and the dataref currently found by each name
+		std::unordered_map<XPLMDataRef, std::unique_ptr<DataRefEntry>> dataRefs;
+		std::unordered_map<std::string, DataRefEntry*> dataRefNames;
+		// Flight loops, in order of creation
+		std::map<uintptr_t, std::unique_ptr<FlightLoopEntry>> flightLoops;
+		std::unordered_map<std::string, std::unique_ptr<CommandEntry>> commands;
+
+		std::function<float(float, float)> heightfield;
+		uint64_t probeCount;
+
+		std::vector<NavAid> navAids;
+
+		// Number of items in each menu
+		std::unordered_map<XPLMMenuID, int> menuItemCounts;
+		// Last opaque handle given out for objects, instances, menus and probes
+		uintptr_t lastHandle;
+
+		bool isDebugEchoed;
+	};
+
+	StandInState& GetState()
+	{
+		static StandInState state;
+		return state;
+	}
+
+	void* CreateHandle()
+	{
+		return reinterpret_cast<void*>(++GetState().lastHandle);
+	}
+
+	// Gets a live dataref, or NULL if it was unregistered
+	DataRefEntry* FindEntry(XPLMDataRef dataRef)
+	{
+		StandInState& state = GetState();
+
+		auto foundEntry = state.dataRefs.find(dataRef);
+		return foundEntry != state.dataRefs.end() ? foundEntry->second.get() : nullptr;
+	}
+
+	DataRefEntry* CreateEntry(const std::string& name, XPLMDataTypeID types, bool isWritable)
+	{
+		StandInState& state = GetState();
+
+		std::unique_ptr<DataRefEntry> entry(new DataRefEntry());
+		entry->name			= name;
+		entry->types		= types;
+		entry->isWritable	= isWritable;
+
+		DataRefEntry* rawEntry		= entry.get();
+		state.dataRefs[rawEntry]	= std::move(entry);
+		state.dataRefNames[name]	= rawEntry;
+		return rawEntry;
+	}
+
+	// Finds the loop with the given ID, or NULL if destroyed
+	FlightLoopEntry* FindFlightLoop(XPLMFlightLoopID flightLoopID)
+	{
+		StandInState& state = GetState();
+
+		auto foundLoop = state.flightLoops.find(reinterpret_cast<uintptr_t>(flightLoopID));
+		return foundLoop != state.flightLoops.end() ? foundLoop->second.get() : nullptr;
+	}
+
+	void ScheduleFlightLoop(FlightLoopEntry& flightLoop, float interval, bool relativeToNow)
+	{
+		StandInState& state = GetState();
+
+		flightLoop.isScheduled	= interval != 0.0f;
+		flightLoop.isDueByCycle	= interval < 0.0f;
+		flightLoop.dueCycle		= state.cycleNumber + static_cast<int>(-interval);
+		flightLoop.dueTime		= (relativeToNow ? state.elapsedTime : flightLoop.lastCallTime) + interval;
+	}
+
+	void RunFlightLoops(XPLMFlightLoopPhaseType phase)
+	{
+		StandInState& state = GetState();
+
+		// Loops created while running wait for the next frame
+		std::vector<uintptr_t> dueLoops;
+		for (const auto& flightLoop : state.flightLoops)
+		{
+			const FlightLoopEntry& entry = *flightLoop.second;
+			if (entry.params.phase == phase && entry.isScheduled &&
+				(entry.isDueByCycle ? state.cycleNumber >= entry.dueCycle : state.elapsedTime >= entry.dueTime - 1e-6))
+			{
+				dueLoops.push_back(flightLoop.first);
+			}
+		}
+
+		for (uintptr_t flightLoopID : dueLoops)
+		{
+			// Earlier loops may have destroyed or unscheduled this one
+			FlightLoopEntry* entry = FindFlightLoop(reinterpret_cast<XPLMFlightLoopID>(flightLoopID));
+			if (entry == nullptr || !entry->isScheduled)
+			{
+				continue;
+			}
+
+			float elapsedSinceLastCall	= static_cast<float>(state.elapsedTime - entry->lastCallTime);
+			entry->lastCallTime			= state.elapsedTime;
+
+			XPLMCreateFlightLoop_t params = entry->params;
+			float interval = params.callbackFunc(elapsedSinceLastCall, state.frameTime, state.cycleNumber, params.refcon);
+
+			entry = FindFlightLoop(reinterpret_cast<XPLMFlightLoopID>(flightLoopID));
+			if (entry != nullptr)
+			{
+				ScheduleFlightLoop(*entry, interval, true);
+			}
+		}
+	}
+
+	void DispatchCommand(CommandEntry& command, XPLMCommandPhase phase)
+	{
+		// Indexed rather than iterated, as handlers may register or unregister handlers,
+		// and not copied, so dispatching doesn't allocate
+		for (int before = 1; before >= 0; --before)
+		{
+			for (size_t i = 0; i < command.handlers.size(); ++i)
+			{
+				CommandHandler handler = command.handlers[i];
+				if (handler.before == before && handler.callback(&command, phase, handler.refcon) == 0)
+				{
+					return;
+				}
+			}
+		}
+	}
+}
+
+void XPLMStandIn::RunFrame(float frameTime)
+{
+	StandInState& state = GetState();
+	state.elapsedTime	+= frameTime;
+	state.frameTime		= frameTime;
+	++state.cycleNumber;
+
+	for (auto& command : state.commands)
+	{
+		if (command.second->isHeld)
+		{
+			DispatchCommand(*command.second, xplm_CommandContinue);
+		}
+	}
+
+	RunFlightLoops(xplm_FlightLoop_Phase_BeforeFlightModel);
+	RunFlightLoops(xplm_FlightLoop_Phase_AfterFlightModel);
+}
+
+void XPLMStandIn::DefineDataRef(const std::string& name, int types, bool isWritable)
+{
+	CreateEntry(name, types, isWritable);
+}
+
+void XPLMStandIn::SetHeightfield(std::function<float(float x, float z)> heightfield)
+{
+	GetState().heightfield = heightfield;
+}
+
+uint64_t XPLMStandIn::GetProbeCount()
+{
+	return GetState().probeCount;
+}
+
+void XPLMStandIn::AddNavAid(int type, float latitude, float longitude, const std::string& id, const std::string& name)
+{
+	NavAid navAid = { type, latitude, longitude, id, name };
+	GetState().navAids.push_back(navAid);
+}
+
+void XPLMStandIn::ClearNavAids()
+{
+	GetState().navAids.clear();
+}
+
+void XPLMStandIn::SetDebugEcho(bool isEchoed)
+{
+	GetState().isDebugEchoed = isEchoed;
+}
+
+// XPLMDataAccess
+
+XPLMDataRef XPLMFindDataRef(const char* inDataRefName)
+{
+	StandInState& state = GetState();
+
+	auto foundName = state.dataRefNames.find(inDataRefName);
+	return foundName != state.dataRefNames.end() ? foundName->second : nullptr;
+}
+
+int XPLMCanWriteDataRef(XPLMDataRef inDataRef)
+{
+	DataRefEntry* entry = FindEntry(inDataRef);
+	return entry != nullptr && entry->isWritable ? 1 : 0;
+}
+
+int XPLMIsDataRefGood(XPLMDataRef inDataRef)
+{
+	return FindEntry(inDataRef) != nullptr ? 1 : 0;
+}
+
+XPLMDataTypeID XPLMGetDataRefTypes(XPLMDataRef inDataRef)
+{
+	DataRefEntry* entry = FindEntry(inDataRef);
+	return entry != nullptr ? entry->types : xplmType_Unknown;
+}
+
+int XPLMGetDatai(XPLMDataRef inDataRef)
+{
+	DataRefEntry* entry = FindEntry(inDataRef);
+	if (entry == nullptr)
+	{
+		return 0;
+	}
+
+	return entry->readInt != nullptr ? entry->readInt(entry->readRefcon) : entry->intValue;
+}
+
+void XPLMSetDatai(XPLMDataRef inDataRef, int inValue)
+{
+	DataRefEntry* entry = FindEntry(inDataRef);
+	if (entry == nullptr || !entry->isWritable)
+	{
+		return;
+	}
+
+	if (entry->writeInt != nullptr)
+	{
+		entry->writeInt(entry->writeRefcon, inValue);
+	}
+	else
+	{
+		entry->intValue = inValue;
+	}
+}
+
+float XPLMGetDataf(XPLMDataRef inDataRef)
+{
+	DataRefEntry* entry = FindEntry(inDataRef);
+	if (entry == nullptr)
+	{
+		return 0.0f;
+	}
+
+	return entry->readFloat != nullptr ? entry->readFloat(entry->readRefcon) : entry->floatValue;
+}
+
+void XPLMSetDataf(XPLMDataRef inDataRef, float inValue)
+{
+	DataRefEntry* entry = FindEntry(inDataRef);
+	if (entry == nullptr || !entry->isWritable)
+	{
+		return;
+	}
+
+	if (entry->writeFloat != nullptr)
+	{
+		entry->writeFloat(entry->writeRefcon, inValue);
+	}
+	else
+	{
+		entry->floatValue = inValue;
+	}
+}
+
+double XPLMGetDatad(XPLMDataRef inDataRef)
+{
+	DataRefEntry* entry = FindEntry(inDataRef);
+	if (entry == nullptr)
+	{
+		return 0.0;
+	}
+
+	return entry->readDouble != nullptr ? entry->readDouble(entry->readRefcon) : entry->doubleValue;
+}
+
+void XPLMSetDatad(XPLMDataRef inDataRef, double inValue)
+{
+	DataRefEntry* entry = FindEntry(inDataRef);
+	if (entry == nullptr || !entry->isWritable)
+	{
+		return;
+	}
+
+	if (entry->writeDouble != nullptr)
+	{
+		entry->writeDouble(entry->writeRefcon, inValue);
+	}
+	else
+	{
+		entry->doubleValue = inValue;
+	}
+}
+
+namespace
+{
+	// Reads from an array owned by the sim, returning its size if no output is given
+	template<typename T>
+	int ReadArray(const std::vector<T>& values, T* outValues, int inOffset, int inMax)
+	{
+		if (outValues == nullptr)
+		{
+			return static_cast<int>(values.size());
+		}
+
+		int count = std::max(0, std::min(inMax, static_cast<int>(values.size()) - inOffset));
+		std::copy(values.begin() + inOffset, values.begin() + inOffset + count, outValues);
+		return count;
+	}
+
+	// Writes to an array owned by the sim, growing it as needed
+	template<typename T>
+	void WriteArray(std::vector<T>& values, const T* inValues, int inOffset, int inCount)
+	{
+		if (inValues == nullptr || inOffset < 0 || inCount <= 0)
+		{
+			return;
+		}
+
+		if (values.size() < static_cast<size_t>(inOffset + inCount))
+		{
+			values.resize(static_cast<size_t>(inOffset + inCount));
+		}
+		std::copy(inValues, inValues + inCount, values.begin() + inOffset);
+	}
+}
+
+int XPLMGetDatavi(XPLMDataRef inDataRef, int* outValues, int inOffset, int inMax)
+{
+	DataRefEntry* entry = FindEntry(inDataRef);
+	if (entry == nullptr)
+	{
+		return 0;
+	}
+
+	return entry->readIntArray != nullptr ? entry->readIntArray(entry->readRefcon, outValues, inOffset, inMax) :
+		ReadArray(entry->intValues, outValues, inOffset, inMax);
+}
+
+void XPLMSetDatavi(XPLMDataRef inDataRef, int* inValues, int inOffset, int inCount)
+{
+	DataRefEntry* entry = FindEntry(inDataRef);
+	if (entry == nullptr || !entry->isWritable)
+	{
+		return;
+	}
+
+	if (entry->writeIntArray != nullptr)
+	{
+		entry->writeIntArray(entry->writeRefcon, inValues, inOffset, inCount);
+	}
+	else
+	{
+		WriteArray(entry->intValues, inValues, inOffset, inCount);
+	}
+}
+
+int XPLMGetDatavf(XPLMDataRef inDataRef, float* outValues, int inOffset, int inMax)
+{
+	DataRefEntry* entry = FindEntry(inDataRef);
+	if (entry == nullptr)
+	{
+		return 0;
+	}
+
+	return entry->readFloatArray != nullptr ? entry->readFloatArray(entry->readRefcon, outValues, inOffset, inMax) :
+		ReadArray(entry->floatValues, outValues, inOffset, inMax);
+}
+
+void XPLMSetDatavf(XPLMDataRef inDataRef, float* inValues, int inOffset, int inCount)
+{
+	DataRefEntry* entry = FindEntry(inDataRef);
+	if (entry == nullptr || !entry->isWritable)
+	{
+		return;
+	}
+
+	if (entry->writeFloatArray != nullptr)
+	{
+		entry->writeFloatArray(entry->writeRefcon, inValues, inOffset, inCount);
+	}
+	else
+	{
+		WriteArray(entry->floatValues, inValues, inOffset, inCount);
+	}
+}
+
+int XPLMGetDatab(XPLMDataRef inDataRef, void* outValue, int inOffset, int inMaxBytes)
+{
+	DataRefEntry* entry = FindEntry(inDataRef);
+	if (entry == nullptr)
+	{
+		return 0;
+	}
+
+	return entry->readData != nullptr ? entry->readData(entry->readRefcon, outValue, inOffset, inMaxBytes) :
+		ReadArray(entry->dataValue, static_cast<char*>(outValue), inOffset, inMaxBytes);
+}
+
+void XPLMSetDatab(XPLMDataRef inDataRef, void* inValue, int inOffset, int inLength)
+{
+	DataRefEntry* entry = FindEntry(inDataRef);
+	if (entry == nullptr || !entry->isWritable)
+	{
+		return;
+	}
+
+	if (entry->writeData != nullptr)
+	{
+		entry->writeData(entry->writeRefcon, inValue, inOffset, inLength);
+	}
+	else
+	{
+		WriteArray(entry->dataValue, static_cast<const char*>(inValue), inOffset, inLength);
+	}
+}
+
+XPLMDataRef XPLMRegisterDataAccessor(const char* inDataName,
+									 XPLMDataTypeID inDataType,
+									 int inIsWritable,
+									 XPLMGetDatai_f inReadInt,
+									 XPLMSetDatai_f inWriteInt,
+									 XPLMGetDataf_f inReadFloat,
+									 XPLMSetDataf_f inWriteFloat,
+									 XPLMGetDatad_f inReadDouble,
+									 XPLMSetDatad_f inWriteDouble,
+									 XPLMGetDatavi_f inReadIntArray,
+									 XPLMSetDatavi_f inWriteIntArray,
+									 XPLMGetDatavf_f inReadFloatArray,
+									 XPLMSetDatavf_f inWriteFloatArray,
+									 XPLMGetDatab_f inReadData,
+									 XPLMSetDatab_f inWriteData,
+									 void* inReadRefcon,
+									 void* inWriteRefcon)
+{
+	DataRefEntry* entry		= CreateEntry(inDataName, inDataType, inIsWritable != 0);
+	entry->readInt			= inReadInt;
+	entry->writeInt			= inWriteInt;
+	entry->readFloat		= inReadFloat;
+	entry->writeFloat		= inWriteFloat;
+	entry->readDouble		= inReadDouble;
+	entry->writeDouble		= inWriteDouble;
+	entry->readIntArray		= inReadIntArray;
+	entry->writeIntArray	= inWriteIntArray;
+	entry->readFloatArray	= inReadFloatArray;
+	entry->writeFloatArray	= inWriteFloatArray;
+	entry->readData			= inReadData;
+	entry->writeData		= inWriteData;
+	entry->readRefcon		= inReadRefcon;
+	entry->writeRefcon		= inWriteRefcon;
+
+	return entry;
+}
+
+void XPLMUnregisterDataAccessor(XPLMDataRef inDataRef)
+{
+	StandInState& state = GetState();
+
+	DataRefEntry* entry = FindEntry(inDataRef);
+	if (entry == nullptr)
+	{
+		return;
+	}
+
+	auto foundName = state.dataRefNames.find(entry->name);
+	if (foundName != state.dataRefNames.end() && foundName->second == entry)
+	{
+		state.dataRefNames.erase(foundName);
+	}
+	state.dataRefs.erase(inDataRef);
+}
+
+// XPLMGraphics
+
+void XPLMWorldToLocal(double inLatitude, double inLongitude, double inAltitude, double* outX, double* outY, double* outZ)
+{
+	*outX = inLongitude * MetersPerDegree;
+	*outY = inAltitude;
+	*outZ = -inLatitude * MetersPerDegree;
+}
+
+void XPLMLocalToWorld(double inX, double inY, double inZ, double* outLatitude, double* outLongitude, double* outAltitude)
+{
+	*outLatitude	= -inZ / MetersPerDegree;
+	*outLongitude	= inX / MetersPerDegree;
+	*outAltitude	= inY;
+}
+
+// XPLMScenery and XPLMInstance
+
+XPLMProbeRef XPLMCreateProbe(XPLMProbeType)
+{
+	return CreateHandle();
+}
+
+void XPLMDestroyProbe(XPLMProbeRef)
+{
+
+}
+
+XPLMProbeResult XPLMProbeTerrainXYZ(XPLMProbeRef, float inX, float, float inZ, XPLMProbeInfo_t* outInfo)
+{
+	StandInState& state = GetState();
+	++state.probeCount;
+
+	if (state.heightfield == nullptr)
+	{
+		return xplm_ProbeMissed;
+	}
+
+	// Normal from the slope over a meter either way
+	float height	= state.heightfield(inX, inZ);
+	float slopeX	= (state.heightfield(inX + 1.0f, inZ) - state.heightfield(inX - 1.0f, inZ)) / 2.0f;
+	float slopeZ	= (state.heightfield(inX, inZ + 1.0f) - state.heightfield(inX, inZ - 1.0f)) / 2.0f;
+	float length	= std::sqrt(slopeX * slopeX + 1.0f + slopeZ * slopeZ);
+
+	outInfo->locationX	= inX;
+	outInfo->locationY	= height;
+	outInfo->locationZ	= inZ;
+	outInfo->normalX	= -slopeX / length;
+	outInfo->normalY	= 1.0f / length;
+	outInfo->normalZ	= -slopeZ / length;
+	outInfo->velocityX	= 0.0f;
+	outInfo->velocityY	= 0.0f;
+	outInfo->velocityZ	= 0.0f;
+	outInfo->is_wet		= 0;
+
+	return xplm_ProbeHitTerrain;
+}
+
+XPLMObjectRef XPLMLoadObject(const char*)
+{
+	return CreateHandle();
+}
+
+void XPLMUnloadObject(XPLMObjectRef)
+{
+
+}
+
+XPLMInstanceRef XPLMCreateInstance(XPLMObjectRef, const char**)
+{
+	return CreateHandle();
+}
+
+void XPLMDestroyInstance(XPLMInstanceRef)
+{
+
+}
+
+void XPLMInstanceSetPosition(XPLMInstanceRef, const XPLMDrawInfo_t*, const float*)
+{
+
+}
+
+// XPLMUtilities
+
+void XPLMDebugString(const char* inString)
+{
+	if (GetState().isDebugEchoed)
+	{
+		std::fputs(inString, stderr);
+	}
+}
+
+void XPLMGetSystemPath(char* outSystemPath)
+{
+	std::strcpy(outSystemPath, "./");
+}
+
+void XPLMGetPrefsPath(char* outPrefsPath)
+{
+	std::strcpy(outPrefsPath, "./StandIn.prf");
+}
+
+XPLMCommandRef XPLMFindCommand(const char* inName)
+{
+	StandInState& state = GetState();
+
+	auto foundCommand = state.commands.find(inName);
+	return foundCommand != state.commands.end() ? foundCommand->second.get() : nullptr;
+}
+
+void XPLMCommandBegin(XPLMCommandRef inCommand)
+{
+	CommandEntry* command	= static_cast<CommandEntry*>(inCommand);
+	command->isHeld			= true;
+	DispatchCommand(*command, xplm_CommandBegin);
+}
+
+void XPLMCommandEnd(XPLMCommandRef inCommand)
+{
+	CommandEntry* command	= static_cast<CommandEntry*>(inCommand);
+	command->isHeld			= false;
+	DispatchCommand(*command, xplm_CommandEnd);
+}
+
+void XPLMCommandOnce(XPLMCommandRef inCommand)
+{
+	XPLMCommandBegin(inCommand);
+	XPLMCommandEnd(inCommand);
+}
+
+XPLMCommandRef XPLMCreateCommand(const char* inName, const char*)
+{
+	StandInState& state = GetState();
+
+	std::unique_ptr<CommandEntry>& command = state.commands[inName];
+	if (command == nullptr)
+	{
+		command.reset(new CommandEntry());
+		command->name	= inName;
+		command->isHeld	= false;
+	}
+
+	return command.get();
+}
+
+void XPLMRegisterCommandHandler(XPLMCommandRef inComand, XPLMCommandCallback_f inHandler, int inBefore, void* inRefcon)
+{
+	CommandHandler handler = { inHandler, inBefore != 0 ? 1 : 0, inRefcon };
+	static_cast<CommandEntry*>(inComand)->handlers.push_back(handler);
+}
+
+void XPLMUnregisterCommandHandler(XPLMCommandRef inComand, XPLMCommandCallback_f inHandler, int inBefore, void* inRefcon)
+{
+	std::vector<CommandHandler>& handlers = static_cast<CommandEntry*>(inComand)->handlers;
+
+	auto foundHandler = std::find_if(handlers.begin(), handlers.end(), [&](const CommandHandler& handler)
+	{
+		return handler.callback == inHandler && handler.before == (inBefore != 0 ? 1 : 0) && handler.refcon == inRefcon;
+	});
+	if (foundHandler != handlers.end())
+	{
+		handlers.erase(foundHandler);
+	}
+}
+
+// XPLMMenus
+
+XPLMMenuID XPLMFindPluginsMenu()
+{
+	static XPLMMenuID pluginsMenu = CreateHandle();
+	return pluginsMenu;
+}
+
+XPLMMenuID XPLMFindAircraftMenu()
+{
+	static XPLMMenuID aircraftMenu = CreateHandle();
+	return aircraftMenu;
+}
+
+XPLMMenuID XPLMCreateMenu(const char*, XPLMMenuID, int, XPLMMenuHandler_f, void*)
+{
+	XPLMMenuID menuID = CreateHandle();
+	GetState().menuItemCounts[menuID] = 0;
+	return menuID;
+}
+
+void XPLMDestroyMenu(XPLMMenuID inMenuID)
+{
+	GetState().menuItemCounts.erase(inMenuID);
+}
+
+void XPLMClearAllMenuItems(XPLMMenuID inMenuID)
+{
+	GetState().menuItemCounts[inMenuID] = 0;
+}
+
+int XPLMAppendMenuItem(XPLMMenuID inMenu, const char*, void*, int)
+{
+	return GetState().menuItemCounts[inMenu]++;
+}
+
+int XPLMAppendMenuItemWithCommand(XPLMMenuID inMenu, const char*, XPLMCommandRef)
+{
+	return GetState().menuItemCounts[inMenu]++;
+}
+
+void XPLMAppendMenuSeparator(XPLMMenuID inMenu)
+{
+	++GetState().menuItemCounts[inMenu];
+}
+
+void XPLMSetMenuItemName(XPLMMenuID, int, const char*, int)
+{
+
+}
+
+void XPLMCheckMenuItem(XPLMMenuID, int, XPLMMenuCheck)
+{
+
+}
+
+void XPLMCheckMenuItemState(XPLMMenuID, int, XPLMMenuCheck* outCheck)
+{
+	*outCheck = xplm_Menu_NoCheck;
+}
+
+void XPLMEnableMenuItem(XPLMMenuID, int, int)
+{
+
+}
+
+void XPLMRemoveMenuItem(XPLMMenuID inMenu, int)
+{
+	int& itemCount = GetState().menuItemCounts[inMenu];
+	itemCount = std::max(0, itemCount - 1);
+}
+
+// XPLMNavigation
+
+XPLMNavRef XPLMGetFirstNavAid()
+{
+	return GetState().navAids.empty() ? XPLM_NAV_NOT_FOUND : 0;
+}
+
+XPLMNavRef XPLMGetNextNavAid(XPLMNavRef inNavAidRef)
+{
+	return inNavAidRef + 1 < static_cast<int>(GetState().navAids.size()) ? inNavAidRef + 1 : XPLM_NAV_NOT_FOUND;
+}
+
+void XPLMGetNavAidInfo(XPLMNavRef inRef,
+					   XPLMNavType* outType,
+					   float* outLatitude,
+					   float* outLongitude,
+					   float* outHeight,
+					   int* outFrequency,
+					   float* outHeading,
+					   char* outID,
+					   char* outName,
+					   char* outReg)
+{
+	const NavAid& navAid = GetState().navAids.at(static_cast<size_t>(inRef));
+
+	if (outType != nullptr)			*outType		= navAid.type;
+	if (outLatitude != nullptr)		*outLatitude	= navAid.latitude;
+	if (outLongitude != nullptr)	*outLongitude	= navAid.longitude;
+	if (outHeight != nullptr)		*outHeight		= 0.0f;
+	if (outFrequency != nullptr)	*outFrequency	= 0;
+	if (outHeading != nullptr)		*outHeading		= 0.0f;
+	if (outID != nullptr)			std::strcpy(outID, navAid.id.c_str());
+	if (outName != nullptr)			std::strcpy(outName, navAid.name.c_str());
+	if (outReg != nullptr)			*outReg			= 0;
+}
+
+XPLMNavRef XPLMFindNavAid(const char* inNameFragment,
+						  const char* inIDFragment,
+						  float* inLat,
+						  float* inLon,
+						  int* inFrequency,
+						  XPLMNavType inType)
+{
+	// Like X-Plane, a linear scan for the matching navaid closest to the position, if any
+	const double radiansPerDegree	= 3.14159265358979323846 / 180.0;
+	const std::vector<NavAid>& navAids = GetState().navAids;
+	XPLMNavRef foundRef				= XPLM_NAV_NOT_FOUND;
+	double foundDistance			= 0.0;
+	for (size_t i = 0; i < navAids.size(); ++i)
+	{
+		const NavAid& navAid = navAids[i];
+		if ((navAid.type & inType) == 0 ||
+			(inFrequency != nullptr && *inFrequency != 0) ||
+			(inNameFragment != nullptr && navAid.name.find(inNameFragment) == std::string::npos) ||
+			(inIDFragment != nullptr && navAid.id.find(inIDFragment) == std::string::npos))
+		{
+			continue;
+		}
+		if (inLat == nullptr || inLon == nullptr)
+		{
+			return static_cast<XPLMNavRef>(i);
+		}
+
+		// Great circle distance, by the spherical law of cosines
+		double latitude1	= *inLat * radiansPerDegree;
+		double latitude2	= navAid.latitude * radiansPerDegree;
+		double cosAngle		= std::sin(latitude1) * std::sin(latitude2) +
+							  std::cos(latitude1) * std::cos(latitude2) * std::cos((navAid.longitude - *inLon) * radiansPerDegree);
+		double distance		= std::acos(std::max(-1.0, std::min(1.0, cosAngle)));
+		if (foundRef == XPLM_NAV_NOT_FOUND || distance < foundDistance)
+		{
+			foundRef		= static_cast<XPLMNavRef>(i);
+			foundDistance	= distance;
+		}
+	}
+	return foundRef;
+}
+
+// XPLMPlanes
+
+void XPLMCountAircraft(int* outTotalAircraft, int* outActiveAircraft, XPLMPluginID* outController)
+{
+	*outTotalAircraft	= 20;
+	*outActiveAircraft	= 1;
+	*outController		= XPLM_NO_PLUGIN_ID;
+}
+
+int XPLMAcquirePlanes(char**, XPLMPlanesAvailable_f, void*)
+{
+	return 1;
+}
+
+void XPLMReleasePlanes()
+{
+
+}
+
+void XPLMSetActiveAircraftCount(int)
+{
+
+}
+
+void XPLMDisableAIForPlane(int)
+{
+
+}
+
+// XPLMPlugin
+
+XPLMPluginID XPLMGetMyID()
+{
+	return 1;
+}
+
+int XPLMCountPlugins()
+{
+	return 1;
+}
+
+XPLMPluginID XPLMGetNthPlugin(int inIndex)
+{
+	return inIndex == 0 ? 1 : XPLM_NO_PLUGIN_ID;
+}
+
+XPLMPluginID XPLMFindPluginByPath(const char*)
+{
+	return XPLM_NO_PLUGIN_ID;
+}
+
+XPLMPluginID XPLMFindPluginBySignature(const char*)
+{
+	return XPLM_NO_PLUGIN_ID;
+}
+
+void XPLMGetPluginInfo(XPLMPluginID, char* outName, char* outFilePath, char* outSignature, char* outDescription)
+{
+	if (outName != nullptr)			std::strcpy(outName, "StandIn");
+	if (outFilePath != nullptr)		std::strcpy(outFilePath, "./StandIn.xpl");
+	if (outSignature != nullptr)	std::strcpy(outSignature, "xpplusplus.standin");
+	if (outDescription != nullptr)	std::strcpy(outDescription, "Stand-in plug-in for tests");
+}
+
+int XPLMIsPluginEnabled(XPLMPluginID)
+{
+	return 1;
+}
+
+int XPLMEnablePlugin(XPLMPluginID)
+{
+	return 1;
+}
+
+void XPLMDisablePlugin(XPLMPluginID)
+{
+
+}
+
+void XPLMReloadPlugins()
+{
+
+}
+
+void XPLMSendMessageToPlugin(XPLMPluginID, int, void*)
+{
+
+}
+
+int XPLMHasFeature(const char*)
+{
+	return 0;
+}
+
+int XPLMIsFeatureEnabled(const char*)
+{
+	return 0;
+}
+
+void XPLMEnableFeature(const char*, int)
+{
+
+}
+
+void XPLMEnumerateFeatures(XPLMFeatureEnumerator_f, void*)
+{
+
+}
+
+// XPLMProcessing
+
+float XPLMGetElapsedTime()
+{
+	return static_cast<float>(GetState().elapsedTime);
+}
+
+int XPLMGetCycleNumber()
+{
+	return GetState().cycleNumber;
+}
+
+XPLMFlightLoopID XPLMCreateFlightLoop(XPLMCreateFlightLoop_t* inParams)
+{
+	StandInState& state = GetState();
+
+	std::unique_ptr<FlightLoopEntry> flightLoop(new FlightLoopEntry());
+	flightLoop->params			= *inParams;
+	flightLoop->isScheduled		= false;
+	flightLoop->lastCallTime	= state.elapsedTime;
+
+	uintptr_t flightLoopID				= reinterpret_cast<uintptr_t>(CreateHandle());
+	state.flightLoops[flightLoopID]		= std::move(flightLoop);
+	return reinterpret_cast<XPLMFlightLoopID>(flightLoopID);
+}
+
+void XPLMDestroyFlightLoop(XPLMFlightLoopID inFlightLoopID)
+{
+	GetState().flightLoops.erase(reinterpret_cast<uintptr_t>(inFlightLoopID));
+}
+
+void XPLMScheduleFlightLoop(XPLMFlightLoopID inFlightLoopID, float inInterval, int inRelativeToNow)
+{
+	FlightLoopEntry* flightLoop = FindFlightLoop(inFlightLoopID);
+	if (flightLoop != nullptr)
+	{
+		ScheduleFlightLoop(*flightLoop, inInterval, inRelativeToNow != 0);
+	}
+}
+
+void XPLMSetFlightLoopCallbackInterval(XPLMFlightLoop_f, float, int, void*)
+{
+
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+// STL includes
+#include <cstdint>
+#include <functional>
+#include <string>
+
+namespace XPLMStandIn
+{
+	/// <summary>
+	/// Runs a frame of the stand-in sim
+	/// </summary>
+	/// <remarks>
+	/// Advances the elapsed time and cycle number, sends the continue phase of held
+	/// commands, then calls the flight loops due this frame, those before the flight
+	/// model first, and reschedules them with the intervals they return.
+	/// </remarks>
+	/// <param name="frameTime">Seconds the frame takes</param>
+	void RunFrame(float frameTime = 1.0f / 60.0f);
+
+	/// <summary>
+	/// Defines a dataref owned by the sim, initially zero
+	/// </summary>
+	/// <param name="name">Name of the dataref</param>
+	/// <param name="types">Types of the dataref (XPLMDataTypeID flags)</param>
+	/// <param name="isWritable">Can plug-ins write the dataref?</param>
+	void DefineDataRef(const std::string& name, int types, bool isWritable = true);
+
+	/// <summary>
+	/// Sets the terrain probed by XPLMProbeTerrainXYZ
+	/// </summary>
+	/// <param name="heightfield">Height of the terrain below a local X and Z, or NULL for no terrain</param>
+	void SetHeightfield(std::function<float(float x, float z)> heightfield);
+	/// <summary>
+	/// Gets the number of terrain probes made so far
+	/// </summary>
+	/// <returns>Number of calls to XPLMProbeTerrainXYZ</returns>
+	uint64_t GetProbeCount();
+
+	/// <summary>
+	/// Adds a navaid to the navigation database
+	/// </summary>
+	/// <param name="type">Type of the navaid (XPLMNavType)</param>
+	/// <param name="latitude">Latitude, in degrees</param>
+	/// <param name="longitude">Longitude, in degrees</param>
+	/// <param name="id">Identifier of the navaid</param>
+	/// <param name="name">Name of the navaid</param>
+	void AddNavAid(int type, float latitude, float longitude, const std::string& id, const std::string& name);
+	/// <summary>
+	/// Removes every navaid from the navigation database
+	/// </summary>
+	void ClearNavAids();
+
+	/// <summary>
+	/// Sets whether XPLMDebugString writes to the standard error stream
+	/// </summary>
+	/// <param name="isEchoed">True to echo debug strings</param>
+	void SetDebugEcho(bool isEchoed);
+}
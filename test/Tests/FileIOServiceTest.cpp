@@ -0,0 +1,173 @@
+// Tests of FileIOService reads, completed through the stand-in XPLM's flight loops
+
+// STL includes
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <future>
+#include <memory>
+#include <string>
+#include <thread>
+
+// XP++ includes
+#include "XP++/IO/FileIOService.hpp"
+#include "XP++/Processing/ThreadPool.hpp"
+
+// X-Plane SDK includes
+#include "XPLMStandIn.hpp"
+
+namespace
+{
+	const char* const FilePath = "FileIOServiceTest.bin";
+
+	int g_failureCount = 0;
+
+	void Check(bool isPassed, const char* description)
+	{
+		if (!isPassed)
+		{
+			std::printf("FAILED: %s\n", description);
+			g_failureCount++;
+		}
+	}
+
+	// Writes a file of the given size, filled with one character
+	void WriteFile(size_t size, char fill)
+	{
+		std::ofstream file(FilePath, std::ios::binary | std::ios::trunc);
+		file << std::string(size, fill);
+	}
+
+	// Runs frames until every read has completed, or a few seconds have passed
+	void RunUntilComplete(const XP::FileIOService& service)
+	{
+		std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+		while (service.GetPendingCount() != 0 && std::chrono::steady_clock::now() < deadline)
+		{
+			XPLMStandIn::RunFrame();
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+	}
+
+	// Reads part of the file and waits for the result
+	XP::FileReadResult ReadNow(XP::FileIOService& service, uint64_t offset, size_t size)
+	{
+		XP::FileReadRequest request;
+		request.filePath	= FilePath;
+		request.offset		= offset;
+		request.size		= size;
+
+		XP::FileReadResult readResult;
+		service.Read(request, [&readResult](const XP::FileReadResult& result)
+		{
+			readResult = result;
+		});
+		RunUntilComplete(service);
+
+		return readResult;
+	}
+
+	// Is every byte of the result the given character?
+	bool IsFilledWith(const XP::FileReadResult& result, char fill)
+	{
+		for (size_t i = 0; i < result.buffer.GetSize(); ++i)
+		{
+			if (result.buffer.GetData()[i] != fill)
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+}
+
+int main()
+{
+	XPLMStandIn::SetDebugEcho(false);
+
+	WriteFile(1000, 'a');
+
+	// Reads past the end of the file are cut short, without an error
+	{
+		std::shared_ptr<XP::FileIOService> service = XP::FileIOService::Create(XP::ThreadPool::Create(1));
+
+		XP::FileReadResult result = ReadNow(*service, 900, 200);
+		Check(result.error.empty(), "Read across the end of the file fails");
+		Check(result.buffer.GetSize() == 100 && IsFilledWith(result, 'a'), "Read across the end of the file isn't cut short");
+
+		result = ReadNow(*service, 2000, 100);
+		Check(result.error.empty(), "Read beyond the end of the file fails");
+		Check(result.buffer.GetSize() == 0, "Read beyond the end of the file returns bytes");
+
+		result = ReadNow(*service, 0, 0);
+		Check(result.buffer.GetSize() == 1000, "Whole file read isn't the whole file");
+
+		XP::FileReadRequest request;
+		request.filePath	= "FileIOServiceTest.missing";
+		request.offset		= 0;
+		request.size		= 100;
+		bool isFailed		= false;
+		service->Read(request, [&isFailed](const XP::FileReadResult& result)
+		{
+			isFailed = !result.error.empty() && result.buffer.GetSize() == 0;
+		});
+		RunUntilComplete(*service);
+		Check(isFailed, "Read of a missing file doesn't fail");
+	}
+
+	// Batches cancelled before they start are never read, and their handlers never called
+	{
+		std::shared_ptr<XP::ThreadPool> threadPool	= XP::ThreadPool::Create(1);
+		std::shared_ptr<XP::FileIOService> service	= XP::FileIOService::Create(threadPool);
+
+		// Hold the only worker, so the read can't start
+		std::promise<void> release;
+		std::shared_future<void> released = release.get_future().share();
+		threadPool->Enqueue([released]()
+		{
+			released.wait();
+		});
+
+		XP::FileReadRequest request;
+		request.filePath	= FilePath;
+		request.offset		= 0;
+		request.size		= 100;
+		bool isHandled		= false;
+		XP::FileReadID readID = service->Read(request, [&isHandled](const XP::FileReadResult&)
+		{
+			isHandled = true;
+		});
+		service->Cancel(readID);
+		release.set_value();
+
+		RunUntilComplete(*service);
+		Check(service->GetPendingCount() == 0, "Cancelled read stays pending");
+		Check(!isHandled, "Handler of a cancelled read is called");
+		Check(service->GetStatistics().requestCount == 0, "Read cancelled before starting is read");
+	}
+
+	// Read-ahead answers following reads, until the file is rewritten
+	{
+		std::shared_ptr<XP::FileIOService> service = XP::FileIOService::Create(XP::ThreadPool::Create(1));
+
+		ReadNow(*service, 0, 100);
+		XP::FileReadResult result = ReadNow(*service, 100, 100);
+		Check(service->GetStatistics().readAheadHitCount == 1, "Following read isn't answered by read-ahead");
+		Check(result.buffer.GetSize() == 100 && IsFilledWith(result, 'a'), "Read-ahead gives the wrong bytes");
+
+		WriteFile(1200, 'b');
+		result = ReadNow(*service, 200, 100);
+		Check(service->GetStatistics().readAheadHitCount == 1, "Read-ahead of a rewritten file is used");
+		Check(result.buffer.GetSize() == 100 && IsFilledWith(result, 'b'), "Read of a rewritten file gives stale bytes");
+	}
+
+	std::remove(FilePath);
+
+	if (g_failureCount != 0)
+	{
+		return EXIT_FAILURE;
+	}
+	std::printf("FileIOService tests passed\n");
+	return EXIT_SUCCESS;
+}
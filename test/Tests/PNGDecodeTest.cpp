@@ -0,0 +1,154 @@
+// Tests of the PNG decoder of AssetLoader against small fixtures
+
+// STL includes
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+
+// XP++ includes
+#include "XP++/IO/AssetLoader.hpp"
+#include "XP++/IO/BufferPool.hpp"
+
+// X-Plane SDK includes
+#include "XPLMStandIn.hpp"
+
+namespace
+{
+	int g_failureCount = 0;
+
+	void Check(bool isPassed, const char* description)
+	{
+		if (!isPassed)
+		{
+			std::printf("FAILED: %s\n", description);
+			g_failureCount++;
+		}
+	}
+
+	// 2x2 RGBA with 16-bit samples
+	const unsigned char RGBA16[] =
+	{
+		0x89, 0x50, 0x4E, 0x47, 0x0D, 0x0A, 0x1A, 0x0A, 0x00, 0x00, 0x00, 0x0D, 0x49, 0x48, 0x44, 0x52,
+		0x00, 0x00, 0x00, 0x02, 0x00, 0x00, 0x00, 0x02, 0x10, 0x06, 0x00, 0x00, 0x00, 0x22, 0x26, 0xD1,
+		0x67, 0x00, 0x00, 0x00, 0x1E, 0x49, 0x44, 0x41, 0x54, 0x78, 0xDA, 0x63, 0xF8, 0xCF, 0xD0, 0xC0,
+		0xC0, 0xC0, 0xF0, 0xFF, 0x3F, 0x03, 0x83, 0xC0, 0x7F, 0x05, 0x30, 0x1B, 0x0A, 0xFE, 0x83, 0x01,
+		0x23, 0x03, 0x00, 0xA9, 0xA7, 0x0B, 0x28, 0x38, 0x38, 0x1E, 0x3A, 0x00, 0x00, 0x00, 0x00, 0x49,
+		0x45, 0x4E, 0x44, 0xAE, 0x42, 0x60, 0x82
+	};
+
+	// 3x3 palette with 2-bit indices, palette alpha and Adam7 interlacing, over three IDAT chunks
+	const unsigned char Palette2Interlaced[] =
+	{
+		0x89, 0x50, 0x4E, 0x47, 0x0D, 0x0A, 0x1A, 0x0A, 0x00, 0x00, 0x00, 0x0D, 0x49, 0x48, 0x44, 0x52,
+		0x00, 0x00, 0x00, 0x03, 0x00, 0x00, 0x00, 0x03, 0x02, 0x03, 0x00, 0x00, 0x01, 0x5C, 0x41, 0x6D,
+		0xBA, 0x00, 0x00, 0x00, 0x0C, 0x50, 0x4C, 0x54, 0x45, 0xFF, 0x00, 0x00, 0x00, 0xFF, 0x00, 0x00,
+		0x00, 0xFF, 0xFF, 0xFF, 0xFF, 0xFB, 0x00, 0x60, 0xF6, 0x00, 0x00, 0x00, 0x03, 0x74, 0x52, 0x4E,
+		0x53, 0xFF, 0x80, 0x00, 0x7F, 0x6D, 0x68, 0x78, 0x00, 0x00, 0x00, 0x07, 0x49, 0x44, 0x41, 0x54,
+		0x78, 0xDA, 0x63, 0x60, 0x60, 0x68, 0x00, 0x25, 0x33, 0xAA, 0x30, 0x00, 0x00, 0x00, 0x07, 0x49,
+		0x44, 0x41, 0x54, 0x42, 0x07, 0x86, 0x03, 0x0C, 0x47, 0x00, 0x1D, 0xF6, 0x45, 0xB6, 0x00, 0x00,
+		0x00, 0x04, 0x49, 0x44, 0x41, 0x54, 0x0C, 0x50, 0x02, 0xC5, 0x15, 0x71, 0x22, 0xB2, 0x00, 0x00,
+		0x00, 0x00, 0x49, 0x45, 0x4E, 0x44, 0xAE, 0x42, 0x60, 0x82
+	};
+
+	// 4x1 8-bit grey with a transparent grey level, Paeth filtered
+	const unsigned char GreyKey[] =
+	{
+		0x89, 0x50, 0x4E, 0x47, 0x0D, 0x0A, 0x1A, 0x0A, 0x00, 0x00, 0x00, 0x0D, 0x49, 0x48, 0x44, 0x52,
+		0x00, 0x00, 0x00, 0x04, 0x00, 0x00, 0x00, 0x01, 0x08, 0x00, 0x00, 0x00, 0x00, 0xDC, 0x57, 0x50,
+		0x11, 0x00, 0x00, 0x00, 0x02, 0x74, 0x52, 0x4E, 0x53, 0x00, 0x40, 0x00, 0x4F, 0x8C, 0xA8, 0x00,
+		0x00, 0x00, 0x0D, 0x49, 0x44, 0x41, 0x54, 0x78, 0xDA, 0x63, 0x71, 0x70, 0x38, 0xC0, 0x00, 0x00,
+		0x03, 0x59, 0x01, 0x45, 0xC0, 0xD5, 0x08, 0x18, 0x00, 0x00, 0x00, 0x00, 0x49, 0x45, 0x4E, 0x44,
+		0xAE, 0x42, 0x60, 0x82
+	};
+
+	XP::DecodedImage Decode(XP::BufferPool& pool, const unsigned char* data, size_t size)
+	{
+		XP::PooledBuffer file = pool.Acquire(size);
+		std::memcpy(file.GetData(), data, size);
+		return XP::AssetLoader::DecodePNG(file, pool);
+	}
+
+	bool IsImage(const XP::DecodedImage& image, int width, int height, const unsigned char* pixels)
+	{
+		return image.format == XP::ImageFormat::RGBA8 && image.width == width && image.height == height &&
+			   image.levels.size() == 1 && image.levels[0].pixels.GetSize() >= static_cast<size_t>(width * height * 4) &&
+			   std::memcmp(image.levels[0].pixels.GetData(), pixels, width * height * 4) == 0;
+	}
+}
+
+int main()
+{
+	XPLMStandIn::SetDebugEcho(false);
+	std::shared_ptr<XP::BufferPool> pool = XP::BufferPool::Create();
+
+	// 16-bit samples keep their high byte
+	{
+		const unsigned char expected[] =
+		{
+			0xFF, 0x80, 0x00, 0xFF,		0x00, 0x10, 0x20, 0x80,
+			0x00, 0x00, 0x00, 0x00,		0xFF, 0xFF, 0xFF, 0x01
+		};
+		Check(IsImage(Decode(*pool, RGBA16, sizeof(RGBA16)), 2, 2, expected), "16-bit RGBA decoded wrongly");
+	}
+
+	// Interlaced passes land in place, with alpha from the palette
+	{
+		const unsigned char expected[] =
+		{
+			0xFF, 0x00, 0x00, 0xFF,		0x00, 0xFF, 0x00, 0x80,		0x00, 0x00, 0xFF, 0x00,
+			0xFF, 0xFF, 0xFF, 0xFF,		0xFF, 0x00, 0x00, 0xFF,		0x00, 0xFF, 0x00, 0x80,
+			0x00, 0x00, 0xFF, 0x00,		0xFF, 0xFF, 0xFF, 0xFF,		0xFF, 0x00, 0x00, 0xFF
+		};
+		Check(IsImage(Decode(*pool, Palette2Interlaced, sizeof(Palette2Interlaced)), 3, 3, expected),
+			  "Interlaced palette image decoded wrongly");
+	}
+
+	// Only the transparent grey level is transparent
+	{
+		const unsigned char expected[] =
+		{
+			0x40, 0x40, 0x40, 0x00,		0x80, 0x80, 0x80, 0xFF,		0x40, 0x40, 0x40, 0x00,		0x40, 0x40, 0x40, 0x00
+		};
+		Check(IsImage(Decode(*pool, GreyKey, sizeof(GreyKey)), 4, 1, expected), "Grey image with a transparent level decoded wrongly");
+	}
+
+	// Truncated and corrupt files are rejected
+	{
+		for (size_t size = 0; size < sizeof(Palette2Interlaced); ++size)
+		{
+			bool isThrown = false;
+			try
+			{
+				Decode(*pool, Palette2Interlaced, size);
+			}
+			catch (const std::runtime_error&)
+			{
+				isThrown = true;
+			}
+			Check(isThrown, "Truncated file accepted");
+		}
+
+		unsigned char corrupt[sizeof(RGBA16)];
+		std::memcpy(corrupt, RGBA16, sizeof(RGBA16));
+		corrupt[sizeof(RGBA16) - 17]++;
+		bool isThrown = false;
+		try
+		{
+			Decode(*pool, corrupt, sizeof(corrupt));
+		}
+		catch (const std::runtime_error&)
+		{
+			isThrown = true;
+		}
+		Check(isThrown, "File with a bad checksum accepted");
+	}
+
+	if (g_failureCount != 0)
+	{
+		return EXIT_FAILURE;
+	}
+	std::printf("PNG decoding tests passed\n");
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,191 @@
+// Tests of TerrainProbe against a synthetic heightfield in the stand-in XPLM
+
+// STL includes
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <future>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+
+// XP++ includes
+#include "XP++/MessageDispatcher.hpp"
+#include "XP++/Scenery/TerrainProbe.hpp"
+
+// X-Plane SDK includes
+#include "XPLMStandIn.hpp"
+
+namespace
+{
+	int g_failureCount = 0;
+
+	void Check(bool isPassed, const char* description)
+	{
+		if (!isPassed)
+		{
+			std::printf("FAILED: %s\n", description);
+			g_failureCount++;
+		}
+	}
+
+	bool IsNear(float expected, float actual)
+	{
+		return std::fabs(expected - actual) <= 1e-3f;
+	}
+
+	// A slope rising to the east and to the north (-Z)
+	float GetHeight(float x, float z)
+	{
+		return 20.0f + 0.1f * x - 0.05f * z;
+	}
+}
+
+int main()
+{
+	XPLMStandIn::SetDebugEcho(false);
+
+	// Without terrain, probes miss
+	{
+		std::shared_ptr<XP::TerrainProbe> terrainProbe = XP::TerrainProbe::Create();
+		Check(!terrainProbe->Probe(0.0f, 100.0f, 0.0f).isHit, "Probe hits without terrain");
+	}
+
+	XPLMStandIn::SetHeightfield(GetHeight);
+
+	// Heights and normals come from the heightfield
+	{
+		std::shared_ptr<XP::TerrainProbe> terrainProbe = XP::TerrainProbe::Create(2.0f, 10.0f);
+		XP::ProbeResult result = terrainProbe->Probe(100.0f, 500.0f, 200.0f);
+		float length = std::sqrt(0.1f * 0.1f + 1.0f + 0.05f * 0.05f);
+		Check(result.isHit && !result.isWet, "Probe misses the heightfield");
+		Check(IsNear(100.0f, result.x) && IsNear(GetHeight(100.0f, 200.0f), result.y) && IsNear(200.0f, result.z),
+			  "Probe gives the wrong point");
+		Check(IsNear(-0.1f / length, result.normalX) && IsNear(1.0f / length, result.normalY) && IsNear(0.05f / length, result.normalZ),
+			  "Probe gives the wrong normal");
+	}
+
+	// Nearby points and repeated points share a probe
+	{
+		std::shared_ptr<XP::TerrainProbe> terrainProbe = XP::TerrainProbe::Create(2.0f, 10.0f);
+		uint64_t probeCount = XPLMStandIn::GetProbeCount();
+		for (int frame = 0; frame < 10; ++frame)
+		{
+			for (int i = 0; i < 60; ++i)
+			{
+				terrainProbe->Probe(i * 0.5f, 100.0f, 0.0f);
+			}
+		}
+		const XP::ProbeStatistics& statistics = terrainProbe->GetStatistics();
+		Check(statistics.requestCount == 600, "Requests aren't counted");
+		Check(statistics.probeCount == 15 && XPLMStandIn::GetProbeCount() - probeCount == 15, "Points in the same cell aren't probed once");
+		Check(statistics.cacheHitCount == 585 && IsNear(0.975f, terrainProbe->GetCacheHitRatio()), "Cache hits aren't counted");
+
+		// Cached results are for the point asked for, at the height of the cell
+		XP::ProbeResult result = terrainProbe->Probe(1.5f, 100.0f, 0.0f);
+		Check(IsNear(1.5f, result.x) && IsNear(GetHeight(0.0f, 0.0f), result.y), "Cached result isn't for the point asked for");
+
+		terrainProbe->ResetStatistics();
+		Check(terrainProbe->GetStatistics().requestCount == 0 && terrainProbe->GetCacheHitRatio() == 0.0f, "Statistics aren't reset");
+	}
+
+	// Batches match single probes
+	{
+		std::shared_ptr<XP::TerrainProbe> terrainProbe = XP::TerrainProbe::Create(1.0f, 10.0f);
+		const float x[] = { -50.5f, 0.0f, 75.25f };
+		const float y[] = { 100.0f, 100.0f, 100.0f };
+		const float z[] = { 10.0f, -20.5f, 300.0f };
+		XP::ProbeResult results[3];
+		terrainProbe->Probe(x, y, z, results, 3);
+		for (int i = 0; i < 3; ++i)
+		{
+			Check(results[i].isHit && IsNear(GetHeight(x[i], z[i]), results[i].y), "Batched probe gives the wrong height");
+		}
+		Check(terrainProbe->GetStatistics().probeCount == 3, "Batched points in different cells aren't all probed");
+	}
+
+	// Results expire, and can be cleared
+	{
+		std::shared_ptr<XP::TerrainProbe> terrainProbe = XP::TerrainProbe::Create(1.0f, 0.05f);
+		terrainProbe->Probe(0.0f, 100.0f, 0.0f);
+		terrainProbe->Probe(0.0f, 100.0f, 0.0f);
+		Check(terrainProbe->GetStatistics().probeCount == 1, "Result isn't cached");
+		std::this_thread::sleep_for(std::chrono::milliseconds(100));
+		terrainProbe->Probe(0.0f, 100.0f, 0.0f);
+		Check(terrainProbe->GetStatistics().probeCount == 2, "Result outlives its time to live");
+		terrainProbe->Clear();
+		terrainProbe->Probe(0.0f, 100.0f, 0.0f);
+		Check(terrainProbe->GetStatistics().probeCount == 3, "Result survives clearing");
+	}
+
+	// Loading scenery, which may shift the local origin, clears the cache
+	{
+		std::shared_ptr<XP::TerrainProbe> terrainProbe = XP::TerrainProbe::Create(1.0f, 10.0f);
+		terrainProbe->Probe(0.0f, 100.0f, 0.0f);
+		XP::MessageDispatcher::Dispatch(0, static_cast<int>(XP::XPLMMessageType::SceneryLoaded), nullptr);
+		terrainProbe->Probe(0.0f, 100.0f, 0.0f);
+		Check(terrainProbe->GetStatistics().probeCount == 2, "Result survives loading scenery");
+
+		terrainProbe.reset();
+		XP::MessageDispatcher::Dispatch(0, static_cast<int>(XP::XPLMMessageType::SceneryLoaded), nullptr);
+	}
+
+	// Requests from other threads are answered in the next frame once started
+	{
+		std::shared_ptr<XP::TerrainProbe> terrainProbe = XP::TerrainProbe::Create(1.0f, 10.0f);
+		std::future<XP::ProbeResult> result;
+		std::thread requester([&]()
+		{
+			result = terrainProbe->Request(10.0f, 100.0f, 20.0f);
+		});
+		requester.join();
+
+		XPLMStandIn::RunFrame();
+		Check(result.wait_for(std::chrono::seconds(0)) == std::future_status::timeout, "Request answered before starting");
+		terrainProbe->Start();
+		XPLMStandIn::RunFrame();
+		Check(result.wait_for(std::chrono::seconds(0)) == std::future_status::ready, "Request not answered within a frame");
+		XP::ProbeResult answer = result.get();
+		Check(answer.isHit && IsNear(GetHeight(10.0f, 20.0f), answer.y), "Request gives the wrong height");
+
+		terrainProbe->Stop();
+		result = terrainProbe->Request(-10.0f, 100.0f, -20.0f);
+		XPLMStandIn::RunFrame();
+		Check(result.wait_for(std::chrono::seconds(0)) == std::future_status::timeout, "Request answered after stopping");
+		terrainProbe->ProcessRequests();
+		Check(IsNear(GetHeight(-10.0f, -20.0f), result.get().y), "Request not answered when processed directly");
+	}
+
+	// Invalid arguments are rejected
+	{
+		bool isThrown = false;
+		try
+		{
+			XP::TerrainProbe::Create(0.0f, 1.0f);
+		}
+		catch (const std::invalid_argument&)
+		{
+			isThrown = true;
+		}
+		Check(isThrown, "Zero cell size accepted");
+
+		isThrown = false;
+		try
+		{
+			XP::TerrainProbe::Create(1.0f, -1.0f);
+		}
+		catch (const std::invalid_argument&)
+		{
+			isThrown = true;
+		}
+		Check(isThrown, "Negative time to live accepted");
+	}
+
+	if (g_failureCount != 0)
+	{
+		return EXIT_FAILURE;
+	}
+	std::printf("TerrainProbe tests passed\n");
+	return EXIT_SUCCESS;
+}